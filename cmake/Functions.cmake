@@ -181,6 +181,13 @@ function(holon_make_corelib)
     $<$<CXX_COMPILER_ID:MSVC>:/W4 $<$<CONFIG:Debug>:/Od> $<$<CONFIG:Release>:/O2>>
     )
   target_link_libraries(holon PUBLIC roki)
+  find_package(Threads REQUIRED)
+  target_link_libraries(holon PUBLIC Threads::Threads)
+  # shm_open() resides in librt before glibc 2.34
+  find_library(HOLON_RT_LIBRARY rt)
+  if(HOLON_RT_LIBRARY)
+    target_link_libraries(holon PUBLIC ${HOLON_RT_LIBRARY})
+  endif()
 endfunction(holon_make_corelib)
 
 
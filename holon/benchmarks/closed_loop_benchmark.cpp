@@ -0,0 +1,230 @@
+/* closed_loop_benchmark - benchmark of closed-loop example scenarios
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <roki/rk_g.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/humanoid/com_ctrl_scenario.hpp"
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
+
+// Every example scenario in HOLON_SCENARIO_DIR is replayed headlessly by
+// ComCtrlScenarioRunner, and the pd_ctrl example and a bare ComZmpModel are
+// run likewise. They are reported in JSON, along with the build type, with
+//   ns_per_update: wall-clock time per control tick
+//   rhs_evals_per_step: evaluations of system equations per control tick
+//   allocs_per_step: heap allocations per control tick
+// Usage: closed_loop_benchmark [repetitions] [output.json]
+
+namespace holon {
+namespace {
+
+const char* const kScenarioNames[] = {
+    "com_regulation",
+    "com_regulation_vertical",
+    "com_oscillation",
+    "com_longitudinal_moving",
+    "com_sideward_moving",
+    "com_regulation_with_disturbance",
+    "com_regulation_with_random_disturbance",
+};
+
+const double kTime = 10;
+const double kTimeStep = 0.01;
+
+// steps of a run and evaluations of system equations counted by the models
+struct Count {
+  std::size_t steps;
+  std::size_t evaluations;
+};
+
+// a run for a given duration
+using Run = std::function<Count(double)>;
+
+Count runScenario(const ComCtrlScenario& t_scenario, double t_time) {
+  ComCtrlScenario scenario = t_scenario;
+  scenario.time = t_time;
+  ComCtrlScenarioRunner runner(scenario);
+  runner.run();
+  return Count{runner.step_count(), runner.evaluation_count()};
+}
+
+// ComZmpModel driven by a ZMP regulator without a controller, which
+// isolates ComZmpModel::update
+Count runComZmpModel(double t_time) {
+  ComZmpModel model;
+  model.reset(Vec3D(0.1, -0.1, 1));
+  std::size_t steps = 0;
+  while (model.time() < t_time) {
+    const auto& p = model.states().com_position;
+    const auto& v = model.states().com_velocity;
+    model.setZmpPosition(Vec3D(2 * p.x() + v.x() / std::sqrt(RK_G),
+                               2 * p.y() + v.y() / std::sqrt(RK_G), 0));
+    if (!model.update(kTimeStep)) break;
+    ++steps;
+  }
+  return Count{steps, model.evaluation_count()};
+}
+
+// the pd_ctrl example without logging
+Count runPdCtrl(double t_time) {
+  PdCtrl<double> ctrl;
+  ctrl.refs().stiffness = 100;
+  ctrl.refs().damping = 10;
+  std::size_t steps = 0;
+  while (ctrl.time() < t_time) {
+    double t = ctrl.time();
+    ctrl.refs().position = std::sin(2 * t);
+    ctrl.refs().velocity = 2 * std::cos(2 * t);
+    if (!ctrl.update(kTimeStep)) break;
+    ++steps;
+  }
+  return Count{steps, ctrl.model().evaluation_count()};
+}
+
+struct Result {
+  std::string name;
+  std::size_t steps;
+  double ns_per_update;
+  double ns_per_update_min;
+  double rhs_evals_per_step;
+  double allocs_per_step;
+};
+
+// allocations done by a run, where the step count is given
+std::size_t countAllocations(const Run& t_run, double t_time,
+                             std::size_t* t_steps) {
+  NoAllocRegion region;
+  *t_steps = t_run(t_time).steps;
+  return region.allocations();
+}
+
+Result measure(const std::string& t_name, const Run& t_run, double t_time,
+               double t_dt, int t_repetitions) {
+  using clock = std::chrono::steady_clock;
+  Result res{t_name, 0, 0, 0, 0, 0};
+  double total_ns = 0;
+  for (int i = 0; i < t_repetitions; ++i) {
+    auto start = clock::now();
+    Count count = t_run(t_time);
+    auto stop = clock::now();
+    if (count.steps == 0) return res;
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    total_ns += ns;
+    res.steps = count.steps;
+    res.ns_per_update_min = i == 0 ? ns / count.steps
+                                   : std::min(res.ns_per_update_min,
+                                              ns / count.steps);
+    res.rhs_evals_per_step = static_cast<double>(count.evaluations) /
+                             static_cast<double>(count.steps);
+  }
+  res.ns_per_update = total_ns / (res.steps * t_repetitions);
+
+  // allocations to set up a run are cancelled by those of a one-step run
+  std::size_t short_steps, steps;
+  std::size_t short_allocs = countAllocations(t_run, t_dt, &short_steps);
+  std::size_t allocs = countAllocations(t_run, t_time, &steps);
+  if (steps > short_steps)
+    res.allocs_per_step =
+        (static_cast<double>(allocs) - static_cast<double>(short_allocs)) /
+        static_cast<double>(steps - short_steps);
+  return res;
+}
+
+bool readScenario(const std::string& t_name, ComCtrlScenario* t_scenario) {
+  ComCtrlScenarioReader reader;
+  std::string path = std::string(HOLON_SCENARIO_DIR) + "/" + t_name + ".ztk";
+  return reader.readFile(path) && reader.build(t_scenario);
+}
+
+void writeJson(std::ostream& os, const std::vector<Result>& t_results,
+               int t_repetitions) {
+  os << "{\n";
+  os << "  \"benchmark\": \"closed_loop\",\n";
+  os << "  \"build_type\": \"" << HOLON_BUILD_TYPE << "\",\n";
+  os << "  \"repetitions\": " << t_repetitions << ",\n";
+  os << "  \"scenarios\": [\n";
+  for (std::size_t i = 0; i < t_results.size(); ++i) {
+    const auto& r = t_results[i];
+    os << "    {\"name\": \"" << r.name << "\", ";
+    os << "\"steps\": " << r.steps << ", ";
+    os << "\"ns_per_update\": " << r.ns_per_update << ", ";
+    os << "\"ns_per_update_min\": " << r.ns_per_update_min << ", ";
+    os << "\"rhs_evals_per_step\": " << r.rhs_evals_per_step << ", ";
+    os << "\"allocs_per_step\": " << r.allocs_per_step << "}";
+    os << (i + 1 < t_results.size() ? ",\n" : "\n");
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
+
+}  // namespace
+}  // namespace holon
+
+int main(int argc, char* argv[]) {
+  int repetitions = argc > 1 ? std::atoi(argv[1]) : 10;
+  if (repetitions <= 0) {
+    std::cerr << "usage: " << argv[0] << " [repetitions] [output.json]\n";
+    return 1;
+  }
+
+  std::vector<holon::ComCtrlScenario> scenarios;
+  for (const char* name : holon::kScenarioNames) {
+    scenarios.emplace_back();
+    if (!holon::readScenario(name, &scenarios.back())) {
+      std::cerr << "failed to read scenario " << name << "\n";
+      return 1;
+    }
+  }
+
+  std::vector<holon::Result> results;
+  auto report = [&results](const holon::Result& r) {
+    results.push_back(r);
+    std::cerr << r.name << ": " << r.ns_per_update << " ns/update, "
+              << r.rhs_evals_per_step << " evals/step, " << r.allocs_per_step
+              << " allocs/step\n";
+  };
+  for (const auto& scenario : scenarios) {
+    report(holon::measure(
+        scenario.name,
+        [&scenario](double t) { return holon::runScenario(scenario, t); },
+        scenario.time, scenario.dt, repetitions));
+  }
+  report(holon::measure("com_zmp_model", holon::runComZmpModel, holon::kTime,
+                        holon::kTimeStep, repetitions));
+  report(holon::measure("pd_ctrl", holon::runPdCtrl, holon::kTime,
+                        holon::kTimeStep, repetitions));
+
+  if (argc > 2) {
+    std::ofstream ofs(argv[2]);
+    holon::writeJson(ofs, results, repetitions);
+  } else {
+    holon::writeJson(std::cout, results, repetitions);
+  }
+  return 0;
+}
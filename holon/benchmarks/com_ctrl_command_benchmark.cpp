@@ -0,0 +1,63 @@
+/* com_ctrl_command_benchmark - benchmark test for remote commands
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_command_socket.hpp"
+
+#include <unistd.h>
+#include <string>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+// a stand-in sender in the same process streams velocity commands to the
+// receiver with its side thread running, and the control thread polls
+// the receiver until the command is applied
+class ComCtrlCommandBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    std::string path =
+        "/tmp/holon_com_ctrl_command_benchmark_" + std::to_string(getpid());
+    receiver.open(path);
+    sender.open(path);
+    receiver.start(1);
+    values.vxd = 0;
+  }
+  virtual void TearDown() {
+    receiver.stop();
+    sender.close();
+    receiver.close();
+  }
+
+  ComCtrl ctrl;
+  ComCtrlCommandReceiver receiver;
+  ComCtrlCommandSender sender;
+  ComCtrlCommandsRawData values;
+};
+
+// from sending a command till it is applied
+BENCHMARK_F(ComCtrlCommandBenchmark, latency, 100, 100) {
+  values.vxd = *values.vxd + 1;
+  sender.send(values);
+  while (receiver.last_sequence() != sender.sequence()) receiver.apply(&ctrl);
+}
+
+}  // namespace
+}  // namespace holon
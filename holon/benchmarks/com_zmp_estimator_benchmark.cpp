@@ -0,0 +1,53 @@
+/* com_zmp_estimator_benchmark - benchmark test for COM-ZMP estimator
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_zmp_estimator.hpp"
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+// one update at 20 kHz
+class ComZmpEstimatorBenchmark : public ::hayai::Fixture {
+ public:
+  ComZmpEstimatorBenchmark() { estimator.setup(p, zmp, 0.00005); }
+  virtual void SetUp() { estimator.reset(p); }
+  virtual void TearDown() {}
+
+  ComZmpEstimator estimator;
+  Vec3D p = {0.01, -0.02, 0.42};
+  Vec3D zmp = {0.0, 0.0, 0.0};
+};
+
+BENCHMARK_F(ComZmpEstimatorBenchmark, kalman_gain, 100, 10000) {
+  estimator.update(p, zmp);
+}
+
+class SteadyComZmpEstimatorBenchmark : public ComZmpEstimatorBenchmark {
+ public:
+  SteadyComZmpEstimatorBenchmark() { estimator.computeSteadyStateGain(); }
+};
+
+BENCHMARK_F(SteadyComZmpEstimatorBenchmark, steady_state_gain, 100, 10000) {
+  estimator.update(p, zmp);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,92 @@
+/* com_zmp_model_benchmark - benchmark test for COM-ZMP model
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_system.hpp"
+#include <roki/rk_g.h>
+#include <array>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+class LinearizationBenchmark : public ::hayai::Fixture {
+ public:
+  LinearizationBenchmark() : sys(make_data<ComZmpModelData>()) {}
+  virtual void SetUp() {
+    p = {0.1, -0.1, 1};
+    v = {0.2, 0.1, 0};
+    zmp = {0.05, 0.02, 0};
+    fz = RK_G;
+    sys.set_zmp_position_f(
+        [this](const Vec3D&, const Vec3D&, const double) { return zmp; });
+    sys.set_reaction_force_f([this](const Vec3D&, const Vec3D&,
+                                    const double) { return Vec3D(0, 0, fz); });
+  }
+  virtual void TearDown() {}
+
+  ComZmpModelSystem sys;
+  Vec3D p, v, zmp;
+  double fz;
+  std::array<Vec3D, 2> dxdt0, dxdt;
+  double jacobian[6][10];
+};
+
+// Jacobian with respect to (p, v, zmp, fz) by forward differences through
+// ComZmpModelSystem::operator(), which costs 11 evaluations.
+BENCHMARK_F(LinearizationBenchmark, finite_difference, 100, 1000) {
+  const double eps = 1e-6;
+  std::array<Vec3D, 2> x{{p, v}};
+  dxdt0 = sys(x, 0);
+  for (std::size_t j = 0; j < 6; ++j) {
+    x[j / 3][j % 3] += eps;
+    dxdt = sys(x, 0);
+    x[j / 3][j % 3] -= eps;
+    for (std::size_t i = 0; i < 6; ++i)
+      jacobian[i][j] = (dxdt[i / 3][i % 3] - dxdt0[i / 3][i % 3]) / eps;
+  }
+  for (std::size_t j = 0; j < 3; ++j) {
+    zmp[j] += eps;
+    dxdt = sys(x, 0);
+    zmp[j] -= eps;
+    for (std::size_t i = 0; i < 6; ++i)
+      jacobian[i][6 + j] = (dxdt[i / 3][i % 3] - dxdt0[i / 3][i % 3]) / eps;
+  }
+  fz += eps;
+  dxdt = sys(x, 0);
+  fz -= eps;
+  for (std::size_t i = 0; i < 6; ++i)
+    jacobian[i][9] = (dxdt[i / 3][i % 3] - dxdt0[i / 3][i % 3]) / eps;
+}
+
+BENCHMARK_F(LinearizationBenchmark, analytic, 100, 1000) {
+  auto jac = com_zmp_model_formula::computeComAccJacobian(
+      p, zmp, fz, sys.data().get().mass);
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      jacobian[3 + i][j] = zMat3DElem(&jac.com_position, i, j);
+      jacobian[3 + i][6 + j] = zMat3DElem(&jac.zmp_position, i, j);
+    }
+    jacobian[3 + i][9] = jac.reaction_force[i];
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,84 @@
+/* dataflow_benchmark - benchmark test for static dataflow graph
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/dataflow.hpp"
+#include "holon/corelib/control/dataflow_blocks.hpp"
+#include <dzco/dz_sys.h>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+const double kDt = 0.001;
+const double kTc1 = 0.05, kGain1 = 2, kGain2 = 0.5, kTc2 = 0.02, kGain3 = 1;
+const double kMax = 0.8, kMin = -0.8;
+
+// input -> lag -> gain -> lag -> limiter, built as a chain of dzco systems
+// updated one by one through their function tables.
+class DzcoChainBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    zArrayAlloc(&arr, dzSys, 4);
+    dzSysCreateFOL(zArrayElem(&arr, 0), kTc1, kGain1);
+    dzSysCreateP(zArrayElem(&arr, 1), kGain2);
+    dzSysCreateFOL(zArrayElem(&arr, 2), kTc2, kGain3);
+    dzSysCreateLimit(zArrayElem(&arr, 3), kMax, kMin);
+    dzSysChain(4, zArrayElem(&arr, 0), zArrayElem(&arr, 1),
+               zArrayElem(&arr, 2), zArrayElem(&arr, 3));
+    dzSysInputPtr(zArrayElem(&arr, 0), 0) = &u;
+    u = 1;
+  }
+  virtual void TearDown() { dzSysArrayDestroy(&arr); }
+
+  dzSysArray arr;
+  double u;
+};
+
+BENCHMARK_F(DzcoChainBenchmark, dzco_array_update, 100, 10000) {
+  dzSysArrayUpdate(&arr, kDt);
+}
+
+// the same chain as a static dataflow graph
+class GraphChainBenchmark : public ::hayai::Fixture {
+  using G = dataflow::Graph<
+      dataflow::Node<dataflow::ConstantBlock<>>,
+      dataflow::Node<dataflow::LagBlock<>, dataflow::In<0>>,
+      dataflow::Node<dataflow::GainBlock<>, dataflow::In<1>>,
+      dataflow::Node<dataflow::LagBlock<>, dataflow::In<2>>,
+      dataflow::Node<dataflow::LimitBlock, dataflow::In<3>>>;
+
+ public:
+  GraphChainBenchmark()
+      : graph(dataflow::ConstantBlock<>(1),
+              dataflow::LagBlock<>(kTc1, kGain1), dataflow::GainBlock<>(kGain2),
+              dataflow::LagBlock<>(kTc2, kGain3),
+              dataflow::LimitBlock(kMin, kMax)) {}
+  virtual void SetUp() {}
+  virtual void TearDown() {}
+
+  G graph;
+};
+
+BENCHMARK_F(GraphChainBenchmark, graph_update, 100, 10000) {
+  graph.update(kDt);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,53 @@
+/* delay_line_benchmark - benchmark of interpolation of delay line
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/delay_line.hpp"
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+class DelayLineBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    line.set_delay(3.5);
+    for (int i = 0; i < 64; ++i) line.push(Vec3D(i, -i, 0.5 * i));
+    a = {1, 2, 3};
+    b = {4, 5, 6};
+    f = 0.3;
+  }
+  virtual void TearDown() {}
+
+  DelayLine<Vec3D, 64> line;
+  Vec3D a, b, y;
+  double f;
+};
+
+// interpolation by the operators of Vec3D and by the loop over elements
+BENCHMARK_F(DelayLineBenchmark, Vec3D_operators, 100, 10000) {
+  y = a + (b - a) * f;
+}
+BENCHMARK_F(DelayLineBenchmark, element_loop, 100, 10000) {
+  delay_line_detail::interpolate(a, b, f, &y);
+}
+BENCHMARK_F(DelayLineBenchmark, update, 100, 10000) { y = line.update(a); }
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,65 @@
+/* dual_benchmark - benchmark test for gradient computation with Dual
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/math/dual.hpp"
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+const double kRolloutTime = 0.1;
+
+template <typename State>
+State rollout(const State& t_stiffness, const State& t_damping) {
+  PdCtrl<State> ctrl;
+  ctrl.refs().position = State{1};
+  ctrl.refs().stiffness = t_stiffness;
+  ctrl.refs().damping = t_damping;
+  while (ctrl.time() < kRolloutTime) ctrl.update();
+  return ctrl.states().position;
+}
+
+class GradientBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    k = 100;
+    c = 10;
+  }
+  virtual void TearDown() {}
+
+  double k, c;
+  double grad[2];
+};
+
+BENCHMARK_F(GradientBenchmark, central_difference, 10, 100) {
+  const double eps = 1e-5;
+  grad[0] = (rollout(k + eps, c) - rollout(k - eps, c)) / (2 * eps);
+  grad[1] = (rollout(k, c + eps) - rollout(k, c - eps)) / (2 * eps);
+}
+
+BENCHMARK_F(GradientBenchmark, dual, 10, 100) {
+  auto x = rollout(make_dual<2>(k, 0), make_dual<2>(c, 1));
+  grad[0] = x.grad(0);
+  grad[1] = x.grad(1);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,104 @@
+/* parareal_benchmark - benchmark of Parareal against serial Runge-Kutta
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/ode_parareal.hpp"
+
+#include <array>
+#include <cmath>
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+using State = std::array<Vec3D, 2>;
+
+// COM rollout of a linear inverted pendulum stabilized around a fixed ZMP
+struct rollout_sys {
+  State operator()(const State& x, const double) const {
+    Vec3D p = zmp + x[0] * 1.5 + x[1] * 0.5;  // feedback to keep it bounded
+    return State{{x[1], (x[0] - p) * 9.8}};
+  }
+  Vec3D zmp;
+};
+
+const double kHorizon = 60;
+const double kStep = 0.001;
+
+class PararealBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    x0 = State{{Vec3D(0.01, -0.02, 0.42), Vec3D(0.1, 0, 0)}};
+    parareal.set_slice_num(64).set_coarse_step_num(20).set_fine_step(kStep);
+    parareal.set_tolerance(1e-9);
+  }
+  virtual void TearDown() {}
+
+  rollout_sys sys;
+  State x0, x;
+  RungeKutta4<State> rk4;
+  Parareal<State> parareal;
+};
+
+// 60 s horizon, serial fine solve vs. Parareal on all hardware threads
+BENCHMARK_F(PararealBenchmark, serial_RK4, 1, 3) {
+  x = x0;
+  for (double t = 0; t < kHorizon - 0.5 * kStep; t += kStep)
+    x = rk4.update(sys, x, t, kStep);
+}
+BENCHMARK_F(PararealBenchmark, parareal, 1, 3) {
+  x = parareal.update(sys, x0, 0.0, kHorizon);
+}
+
+// the same horizon with the system of the COM-ZMP model, whose ZMP regulates
+// the COM to the origin
+class ComZmpModelPararealBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    model.reset(Vec3D(0.01, -0.02, 0.42));
+    model.setZmpPositionCallback(
+        [](const Vec3D& p, const Vec3D& v, const double) {
+          double zeta = std::sqrt(9.8 / 0.42);
+          return Vec3D(2 * p.x() + v.x() / zeta, 2 * p.y() + v.y() / zeta, 0);
+        });
+    x0 = State{{model.states().com_position, Vec3D(0.1, 0, 0)}};
+    parareal.set_slice_num(64).set_coarse_step_num(20).set_fine_step(kStep);
+    parareal.set_tolerance(1e-9);
+  }
+  virtual void TearDown() {}
+
+  ComZmpModel model;
+  State x0, x;
+  RungeKutta4<State> rk4;
+  Parareal<State> parareal;
+};
+
+BENCHMARK_F(ComZmpModelPararealBenchmark, serial_RK4, 1, 3) {
+  x = x0;
+  for (double t = 0; t < kHorizon - 0.5 * kStep; t += kStep)
+    x = rk4.update(model.system(), x, t, kStep);
+}
+BENCHMARK_F(ComZmpModelPararealBenchmark, parareal, 1, 3) {
+  x = parareal.update(model.system(), x0, 0.0, kHorizon);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,59 @@
+/* pd_ctrl_array_benchmark - benchmark test for batched PD controllers
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/pd_ctrl_array.hpp"
+#include <memory>
+#include <vector>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kJoints = 128;
+
+class PdCtrlArrayBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    scalar_ctrls.clear();
+    for (std::size_t i = 0; i < kJoints; ++i) {
+      scalar_ctrls.emplace_back(new PdCtrl<double>);
+      scalar_ctrls.back()->refs().position = 1;
+      scalar_ctrls.back()->refs().stiffness = 100;
+      scalar_ctrls.back()->refs().damping = 10;
+    }
+    array_ctrl.reset(new PdCtrlArray<kJoints>);
+    array_ctrl->refs().position = PdCtrlArrayState<kJoints>{1};
+    array_ctrl->refs().stiffness = PdCtrlArrayState<kJoints>{100};
+    array_ctrl->refs().damping = PdCtrlArrayState<kJoints>{10};
+  }
+  virtual void TearDown() {}
+
+  std::vector<std::unique_ptr<PdCtrl<double>>> scalar_ctrls;
+  std::unique_ptr<PdCtrlArray<kJoints>> array_ctrl;
+};
+
+BENCHMARK_F(PdCtrlArrayBenchmark, scalar_instances, 10, 1000) {
+  for (auto& ctrl : scalar_ctrls) ctrl->update();
+}
+
+BENCHMARK_F(PdCtrlArrayBenchmark, batched, 10, 1000) { array_ctrl->update(); }
+
+}  // namespace
+}  // namespace holon
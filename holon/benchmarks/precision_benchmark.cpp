@@ -0,0 +1,98 @@
+/* precision_benchmark - benchmark test for single and double precision
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/pd_ctrl_array.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
+#include <array>
+#include <cmath>
+#include <memory>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kSize = 256;
+
+template <typename T>
+struct Samples {
+  std::array<T, kSize> p, v, out;
+  void init() {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      p[i] = T(1) + T(i) / T(kSize * 10);
+      v[i] = T(i % 7) / T(10);
+    }
+  }
+};
+
+class PrecisionBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    samples_d.init();
+    samples_f.init();
+    ctrl_d.reset(new PdCtrl<Batch<kSize, double>>);
+    ctrl_d->refs().position = Batch<kSize, double>{1};
+    ctrl_d->refs().stiffness = Batch<kSize, double>{100};
+    ctrl_d->refs().damping = Batch<kSize, double>{10};
+    ctrl_f.reset(new PdCtrl<Batch<kSize, float>>);
+    ctrl_f->refs().position = Batch<kSize, float>{1};
+    ctrl_f->refs().stiffness = Batch<kSize, float>{100};
+    ctrl_f->refs().damping = Batch<kSize, float>{10};
+  }
+  virtual void TearDown() {}
+
+  Samples<double> samples_d;
+  Samples<float> samples_f;
+  std::unique_ptr<PdCtrl<Batch<kSize, double>>> ctrl_d;
+  std::unique_ptr<PdCtrl<Batch<kSize, float>>> ctrl_f;
+};
+
+BENCHMARK_F(PrecisionBenchmark, com_ctrl_formula_double, 10, 1000) {
+  auto& s = samples_d;
+  for (std::size_t i = 0; i < kSize; ++i) {
+    double fz =
+        com_ctrl_z::computeDesReactForce(s.p[i], s.v[i], 1.0, 1.0, 1.0, 1.0);
+    double zeta = std::sqrt(fz / s.p[i]);
+    s.out[i] = com_ctrl_x::computeDesZmpPos(s.p[i] - 1, s.v[i], 0.0, 0.0, 1.0,
+                                            1.0, zeta);
+  }
+}
+
+BENCHMARK_F(PrecisionBenchmark, com_ctrl_formula_float, 10, 1000) {
+  auto& s = samples_f;
+  for (std::size_t i = 0; i < kSize; ++i) {
+    float fz = com_ctrl_z::computeDesReactForce(s.p[i], s.v[i], 1.0f, 1.0f,
+                                                1.0f, 1.0f);
+    float zeta = std::sqrt(fz / s.p[i]);
+    s.out[i] = com_ctrl_x::computeDesZmpPos(s.p[i] - 1, s.v[i], 0.0f, 0.0f,
+                                            1.0f, 1.0f, zeta);
+  }
+}
+
+BENCHMARK_F(PrecisionBenchmark, pd_ctrl_array_double, 10, 1000) {
+  ctrl_d->update();
+}
+
+BENCHMARK_F(PrecisionBenchmark, pd_ctrl_array_float, 10, 1000) {
+  ctrl_f->update();
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,58 @@
+/* state_bus_benchmark - benchmark test for shared-memory state bus
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/state_bus.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+
+#include <unistd.h>
+#include <string>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+class StateBusBenchmark : public ::hayai::Fixture {
+ public:
+  StateBusBenchmark() : publisher(ctrl.data()) {}
+  virtual void SetUp() {
+    name = "/holon_state_bus_benchmark_" + std::to_string(getpid());
+    publisher.open(name);
+    subscriber.open(name);
+  }
+  virtual void TearDown() {
+    subscriber.close();
+    publisher.close();
+  }
+
+  ComCtrl ctrl;
+  std::string name;
+  StateBusPublisher<ComCtrlData> publisher;
+  StateBusSubscriber<ComCtrlData> subscriber;
+};
+
+BENCHMARK_F(StateBusBenchmark, publish, 100, 1000) { publisher.publish(); }
+
+BENCHMARK_F(StateBusBenchmark, publish_and_update, 100, 1000) {
+  publisher.publish();
+  subscriber.update();
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,84 @@
+/* task_scheduler_benchmark - benchmark of resuming scheduled tasks
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/task_scheduler.hpp"
+
+#include <array>
+#include <memory>
+#include "hayai.hpp"
+
+namespace holon {
+namespace {
+
+const int kTaskNum = 64;
+const double kTimeStep = 0.001;
+
+// a phase changes every second
+class Phases : public Task {
+ public:
+  explicit Phases(int* t_phase) : m_phase(t_phase) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    for (;;) {
+      ++*m_phase;
+      HOLON_TASK_AWAIT(until(now() + 1));
+    }
+    HOLON_TASK_END;
+  }
+
+ private:
+  int* m_phase;
+};
+
+class TaskSchedulerBenchmark : public ::hayai::Fixture {
+ public:
+  virtual void SetUp() {
+    for (int i = 0; i < kTaskNum; ++i)
+      scheduler.add(std::make_shared<Phases>(&phase));
+    next.fill(1);
+    tick = 0;
+    phase = 0;
+  }
+  virtual void TearDown() { scheduler.clear(); }
+
+  TaskScheduler scheduler;
+  std::array<double, kTaskNum> next;
+  long tick;
+  int phase;
+};
+
+// the same timeline by scheduled tasks and by checking the time of every
+// phase at every tick
+BENCHMARK_F(TaskSchedulerBenchmark, resume, 100, 10000) {
+  scheduler.resume(++tick * kTimeStep);
+}
+BENCHMARK_F(TaskSchedulerBenchmark, time_checks, 100, 10000) {
+  double t = ++tick * kTimeStep;
+  for (auto& n : next) {
+    if (t < n) continue;
+    ++phase;
+    n += 1;
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Performance regression gate for the closed-loop benchmark.
+
+The benchmark is run pinned to a single CPU with a fixed number of
+repetitions, and the best time per update of every scenario is compared
+against a checked-in baseline. A scenario fails when it becomes slower than
+its baseline by more than its tolerance, or when it needs more right-hand
+side evaluations or heap allocations per step than recorded. Both are
+measured over the run by the benchmark, e.g. evaluations to locate events
+count as well. ComZmpModel::update and PdCtrl::update are timed in
+isolation by the com_zmp_model and pd_ctrl entries, which the baseline
+has to contain. Timings of different build types are not comparable, so
+that the gate refuses to run unless the benchmark is built as the baseline
+was. Only the Python standard library is used so that the gate works
+offline.
+
+Usage:
+  perf_regression_test.py [--executable PATH] [--baseline PATH] [--cpu N]
+                          [--repetitions N] [--update-baseline]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+THIS_BENCHMARK_NAME = "closed_loop_benchmark"
+BASELINE_FILENAME = os.path.join("data", THIS_BENCHMARK_NAME + ".json")
+TEST_EXECUTABLE = os.path.join("..", THIS_BENCHMARK_NAME)
+DEFAULT_TOLERANCE = 0.25
+REQUIRED_SCENARIOS = ("com_zmp_model", "pd_ctrl")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="check closed-loop benchmark against a baseline")
+    parser.add_argument("--executable", default=TEST_EXECUTABLE)
+    parser.add_argument("--baseline", default=BASELINE_FILENAME)
+    parser.add_argument("--cpu", type=int, default=0,
+                        help="CPU the benchmark is pinned to")
+    parser.add_argument("--repetitions", type=int, default=None,
+                        help="repetitions per scenario (default: baseline)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="overwrite the baseline with the current run")
+    return parser.parse_args()
+
+
+def pin_cpu(cpu):
+    # the affinity is inherited by the benchmark process
+    if not hasattr(os, "sched_setaffinity"):
+        print("warning: CPU pinning is not supported on this platform")
+        return
+    try:
+        os.sched_setaffinity(0, {cpu})
+    except OSError as e:
+        print("warning: failed to pin to CPU {}: {}".format(cpu, e))
+
+
+def run_benchmark(executable, repetitions):
+    fd, path = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    try:
+        subprocess.check_call([executable, str(repetitions), path])
+        with open(path) as fobj:
+            return json.load(fobj)
+    finally:
+        os.remove(path)
+
+
+def scenarios_by_name(result):
+    return {s["name"]: s for s in result["scenarios"]}
+
+
+def compare(baseline, current):
+    tolerance = baseline.get("tolerance", DEFAULT_TOLERANCE)
+    cur = scenarios_by_name(current)
+    rows, failures = [], []
+    names = [base["name"] for base in baseline["scenarios"]]
+    for name in REQUIRED_SCENARIOS:
+        if name not in names:
+            failures.append("{}: missing in baseline".format(name))
+    for base in baseline["scenarios"]:
+        name = base["name"]
+        if name not in cur:
+            failures.append("{}: missing in current run".format(name))
+            rows.append((name, base["ns_per_update_min"], None, None, "MISSING"))
+            continue
+        s = cur[name]
+        tol = base.get("tolerance", tolerance)
+        ratio = s["ns_per_update_min"] / base["ns_per_update_min"]
+        status = "ok"
+        if ratio > 1 + tol:
+            status = "SLOWER"
+            failures.append(
+                "{}: {:.1f} ns/update is {:+.1f}% over baseline {:.1f} ns "
+                "(tolerance {:.0f}%)".format(
+                    name, s["ns_per_update_min"], 100 * (ratio - 1),
+                    base["ns_per_update_min"], 100 * tol))
+        for key in ("rhs_evals_per_step", "allocs_per_step"):
+            if s[key] > base[key]:
+                status = "WORSE"
+                failures.append("{}: {} increased from {:g} to {:g}".format(
+                    name, key, base[key], s[key]))
+        rows.append((name, base["ns_per_update_min"], s["ns_per_update_min"],
+                     ratio - 1, status))
+    return rows, failures
+
+
+def print_table(rows):
+    fmt = "{:<40} {:>12} {:>12} {:>9}  {}"
+    print(fmt.format("scenario", "base[ns]", "now[ns]", "change", "status"))
+    for name, base, now, change, status in rows:
+        print(fmt.format(
+            name, "{:.1f}".format(base),
+            "-" if now is None else "{:.1f}".format(now),
+            "-" if change is None else "{:+.1f}%".format(100 * change),
+            status))
+
+
+def update_baseline(path, baseline, current):
+    # keep tolerances of the existing baseline
+    tolerances = {s["name"]: s["tolerance"]
+                  for s in baseline.get("scenarios", []) if "tolerance" in s}
+    out = {
+        "benchmark": current["benchmark"],
+        "build_type": current.get("build_type", ""),
+        "repetitions": current["repetitions"],
+        "tolerance": baseline.get("tolerance", DEFAULT_TOLERANCE),
+        "scenarios": [],
+    }
+    for s in current["scenarios"]:
+        entry = {"name": s["name"],
+                 "ns_per_update_min": s["ns_per_update_min"],
+                 "rhs_evals_per_step": s["rhs_evals_per_step"],
+                 "allocs_per_step": s["allocs_per_step"]}
+        if s["name"] in tolerances:
+            entry["tolerance"] = tolerances[s["name"]]
+        out["scenarios"].append(entry)
+    with open(path, "w") as fobj:
+        json.dump(out, fobj, indent=2)
+        fobj.write("\n")
+    print("baseline written to {}".format(path))
+
+
+def main():
+    args = parse_args()
+    if not os.access(args.executable, os.X_OK):
+        print("error: benchmark executable not found: " + args.executable)
+        return 1
+    baseline = {}
+    if os.path.isfile(args.baseline):
+        with open(args.baseline) as fobj:
+            baseline = json.load(fobj)
+    elif not args.update_baseline:
+        print("error: baseline does not exist: " + args.baseline)
+        return 1
+    repetitions = args.repetitions or baseline.get("repetitions", 10)
+
+    pin_cpu(args.cpu)
+    current = run_benchmark(args.executable, repetitions)
+    if args.update_baseline:
+        update_baseline(args.baseline, baseline, current)
+        return 0
+
+    base_type = baseline.get("build_type")
+    cur_type = current.get("build_type")
+    if base_type != cur_type:
+        print("error: baseline was recorded in a {} build, but the benchmark "
+              "is built as {}".format(base_type or "unknown",
+                                      cur_type or "unknown"))
+        return 1
+
+    rows, failures = compare(baseline, current)
+    print_table(rows)
+    if failures:
+        print("\nperformance regression detected:")
+        for f in failures:
+            print("  " + f)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
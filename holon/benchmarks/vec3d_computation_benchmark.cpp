@@ -19,6 +19,8 @@
  */
 
 #include "holon/corelib/math/vec3d.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
+#include <string>
 #include <utility>
 #include "hayai.hpp"
 
@@ -87,5 +89,34 @@ BENCHMARK_F(ConcatenateBenchmark, zVec3D, 100, 1000) {
 }
 BENCHMARK_F(ConcatenateBenchmark, zvec3d_Vec3D, 100, 1000) { b = b1 + k * b2; }
 
+// formatting a row of log, i.e. three vectors
+class FormatBenchmark : public ::hayai::Fixture {
+ public:
+  FormatBenchmark() : writer(buf, sizeof(buf)) {}
+  virtual void SetUp() {
+    b1 = {0.09995197838849815, -0.09995197838849815, 1};
+    b2 = {-0.00950430938698434, 0.00950430938698434, 0};
+    b3 = {0.1938339359844071, -0.1938339359844071, 0};
+  }
+  virtual void TearDown() {}
+
+  zvec3d::Vec3D b1, b2, b3;
+  std::string s;
+  char buf[256];
+  TextWriter writer;
+};
+
+BENCHMARK_F(FormatBenchmark, data, 100, 1000) {
+  s = b1.data() + " " + b2.data() + " " + b3.data();
+}
+BENCHMARK_F(FormatBenchmark, TextWriter_scientific, 100, 1000) {
+  writer.clear().set_format(TextWriter::Format::scientific, 10);
+  writer << b1 << ' ' << b2 << ' ' << b3;
+}
+BENCHMARK_F(FormatBenchmark, TextWriter_shortest, 100, 1000) {
+  writer.clear().set_format(TextWriter::Format::shortest);
+  writer << b1 << ' ' << b2 << ' ' << b3;
+}
+
 }  // namespace
 }  // namespace holon
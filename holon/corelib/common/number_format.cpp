@@ -0,0 +1,365 @@
+/* number_format - allocation-free formatting of floating-point numbers
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/common/number_format.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace holon {
+namespace number_format {
+
+namespace {
+
+// floating-point number f * 2^e with 64-bit significand
+struct DiyFp {
+  std::uint64_t f;
+  int e;
+};
+
+DiyFp sub(const DiyFp& x, const DiyFp& y) { return DiyFp{x.f - y.f, x.e}; }
+
+// upper 64 bits of the 128-bit product, rounded
+DiyFp mul(const DiyFp& x, const DiyFp& y) {
+  const std::uint64_t mask = 0xFFFFFFFFu;
+  std::uint64_t x_lo = x.f & mask, x_hi = x.f >> 32;
+  std::uint64_t y_lo = y.f & mask, y_hi = y.f >> 32;
+  std::uint64_t p0 = x_lo * y_lo;
+  std::uint64_t p1 = x_lo * y_hi;
+  std::uint64_t p2 = x_hi * y_lo;
+  std::uint64_t p3 = x_hi * y_hi;
+  std::uint64_t q = (p0 >> 32) + (p1 & mask) + (p2 & mask) + (1u << 31);
+  return DiyFp{p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64};
+}
+
+DiyFp normalize(DiyFp x) {
+  while ((x.f >> 63) == 0) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+DiyFp normalizeTo(const DiyFp& x, int t_e) {
+  return DiyFp{x.f << (x.e - t_e), t_e};
+}
+
+// a positive value v and the boundaries m- and m+ of the interval that
+// reads back to v, normalized to the same exponent
+struct Boundaries {
+  DiyFp w, minus, plus;
+};
+
+Boundaries computeBoundaries(double t_value) {
+  const std::uint64_t hidden_bit = std::uint64_t(1) << 52;
+  const int bias = 1075;
+  std::uint64_t bits;
+  std::memcpy(&bits, &t_value, sizeof(bits));
+  std::uint64_t fraction = bits & (hidden_bit - 1);
+  int exponent = static_cast<int>(bits >> 52);
+  DiyFp v = exponent == 0 ? DiyFp{fraction, 1 - bias}
+                          : DiyFp{fraction + hidden_bit, exponent - bias};
+  // the lower boundary is closer if v is a power of two
+  bool lower_is_closer = fraction == 0 && exponent > 1;
+  DiyFp plus = normalize(DiyFp{2 * v.f + 1, v.e - 1});
+  DiyFp minus = lower_is_closer ? DiyFp{4 * v.f - 1, v.e - 2}
+                                : DiyFp{2 * v.f - 1, v.e - 1};
+  return Boundaries{normalize(v), normalizeTo(minus, plus.e), plus};
+}
+
+// normalized 10^k = f * 2^e for k = -300, -292, ..., 340
+struct CachedPower {
+  std::uint64_t f;
+  int e;
+  int k;
+};
+
+const CachedPower kCachedPowers[] = {
+    {0xAB70FE17C79AC6CA, -1060, -300},
+    {0xFF77B1FCBEBCDC4F, -1034, -292},
+    {0xBE5691EF416BD60C, -1007, -284},
+    {0x8DD01FAD907FFC3C, -980, -276},
+    {0xD3515C2831559A83, -954, -268},
+    {0x9D71AC8FADA6C9B5, -927, -260},
+    {0xEA9C227723EE8BCB, -901, -252},
+    {0xAECC49914078536D, -874, -244},
+    {0x823C12795DB6CE57, -847, -236},
+    {0xC21094364DFB5637, -821, -228},
+    {0x9096EA6F3848984F, -794, -220},
+    {0xD77485CB25823AC7, -768, -212},
+    {0xA086CFCD97BF97F4, -741, -204},
+    {0xEF340A98172AACE5, -715, -196},
+    {0xB23867FB2A35B28E, -688, -188},
+    {0x84C8D4DFD2C63F3B, -661, -180},
+    {0xC5DD44271AD3CDBA, -635, -172},
+    {0x936B9FCEBB25C996, -608, -164},
+    {0xDBAC6C247D62A584, -582, -156},
+    {0xA3AB66580D5FDAF6, -555, -148},
+    {0xF3E2F893DEC3F126, -529, -140},
+    {0xB5B5ADA8AAFF80B8, -502, -132},
+    {0x87625F056C7C4A8B, -475, -124},
+    {0xC9BCFF6034C13053, -449, -116},
+    {0x964E858C91BA2655, -422, -108},
+    {0xDFF9772470297EBD, -396, -100},
+    {0xA6DFBD9FB8E5B88F, -369, -92},
+    {0xF8A95FCF88747D94, -343, -84},
+    {0xB94470938FA89BCF, -316, -76},
+    {0x8A08F0F8BF0F156B, -289, -68},
+    {0xCDB02555653131B6, -263, -60},
+    {0x993FE2C6D07B7FAC, -236, -52},
+    {0xE45C10C42A2B3B06, -210, -44},
+    {0xAA242499697392D3, -183, -36},
+    {0xFD87B5F28300CA0E, -157, -28},
+    {0xBCE5086492111AEB, -130, -20},
+    {0x8CBCCC096F5088CC, -103, -12},
+    {0xD1B71758E219652C, -77, -4},
+    {0x9C40000000000000, -50, 4},
+    {0xE8D4A51000000000, -24, 12},
+    {0xAD78EBC5AC620000, 3, 20},
+    {0x813F3978F8940984, 30, 28},
+    {0xC097CE7BC90715B3, 56, 36},
+    {0x8F7E32CE7BEA5C70, 83, 44},
+    {0xD5D238A4ABE98068, 109, 52},
+    {0x9F4F2726179A2245, 136, 60},
+    {0xED63A231D4C4FB27, 162, 68},
+    {0xB0DE65388CC8ADA8, 189, 76},
+    {0x83C7088E1AAB65DB, 216, 84},
+    {0xC45D1DF942711D9A, 242, 92},
+    {0x924D692CA61BE758, 269, 100},
+    {0xDA01EE641A708DEA, 295, 108},
+    {0xA26DA3999AEF774A, 322, 116},
+    {0xF209787BB47D6B85, 348, 124},
+    {0xB454E4A179DD1877, 375, 132},
+    {0x865B86925B9BC5C2, 402, 140},
+    {0xC83553C5C8965D3D, 428, 148},
+    {0x952AB45CFA97A0B3, 455, 156},
+    {0xDE469FBD99A05FE3, 481, 164},
+    {0xA59BC234DB398C25, 508, 172},
+    {0xF6C69A72A3989F5C, 534, 180},
+    {0xB7DCBF5354E9BECE, 561, 188},
+    {0x88FCF317F22241E2, 588, 196},
+    {0xCC20CE9BD35C78A5, 614, 204},
+    {0x98165AF37B2153DF, 641, 212},
+    {0xE2A0B5DC971F303A, 667, 220},
+    {0xA8D9D1535CE3B396, 694, 228},
+    {0xFB9B7CD9A4A7443C, 720, 236},
+    {0xBB764C4CA7A44410, 747, 244},
+    {0x8BAB8EEFB6409C1A, 774, 252},
+    {0xD01FEF10A657842C, 800, 260},
+    {0x9B10A4E5E9913129, 827, 268},
+    {0xE7109BFBA19C0C9D, 853, 276},
+    {0xAC2820D9623BF429, 880, 284},
+    {0x80444B5E7AA7CF85, 907, 292},
+    {0xBF21E44003ACDD2D, 933, 300},
+    {0x8E679C2F5E44FF8F, 960, 308},
+    {0xD433179D9C8CB841, 986, 316},
+    {0x9E19DB92B4E31BA9, 1013, 324},
+    {0xEB96BF6EBADF77D9, 1039, 332},
+    {0xAF87023B9BF0EE6B, 1066, 340},
+};
+const int kCachedPowersMinDecExp = -300;
+const int kCachedPowersDecStep = 8;
+
+// the range of binary exponent of scaled values, for which digits are
+// generated with 64-bit integers
+const int kAlpha = -60;
+const int kGamma = -32;
+
+// cached power c = 10^k such that kAlpha <= e_c + e + 64 <= kGamma
+CachedPower cachedPowerFor(int t_e) {
+  int f = kAlpha - t_e - 1;
+  // k = ceil(f * log10(2)), where 78913 / 2^18 approximates log10(2)
+  int k = (f * 78913) / (1 << 18) + (f > 0);
+  int index = (-kCachedPowersMinDecExp + k + (kCachedPowersDecStep - 1)) /
+              kCachedPowersDecStep;
+  return kCachedPowers[index];
+}
+
+// the largest power of ten not greater than n (< 10^10), and its digits
+int largestPow10(std::uint32_t t_n, std::uint32_t* t_pow10) {
+  std::uint32_t pow10 = 1000000000;
+  int digits = 10;
+  for (; digits > 1 && t_n < pow10; --digits) pow10 /= 10;
+  *t_pow10 = pow10;
+  return digits;
+}
+
+// move the last digit closer to w while it stays in the interval
+void round(char* t_buf, int t_len, std::uint64_t t_dist, std::uint64_t t_delta,
+           std::uint64_t t_rest, std::uint64_t t_ten_k) {
+  while (t_rest < t_dist && t_delta - t_rest >= t_ten_k &&
+         (t_rest + t_ten_k < t_dist ||
+          t_dist - t_rest > t_rest + t_ten_k - t_dist)) {
+    t_buf[t_len - 1]--;
+    t_rest += t_ten_k;
+  }
+}
+
+// generate the shortest digits in (M-, M+) closest to w, where all the
+// values are scaled so that the exponent is in [kAlpha, kGamma]
+int generateDigits(char* t_buf, int* t_dec_exp, const DiyFp& t_minus,
+                   const DiyFp& t_w, const DiyFp& t_plus) {
+  std::uint64_t delta = sub(t_plus, t_minus).f;
+  std::uint64_t dist = sub(t_plus, t_w).f;
+  const DiyFp one{std::uint64_t(1) << -t_plus.e, t_plus.e};
+  std::uint32_t p1 = static_cast<std::uint32_t>(t_plus.f >> -one.e);
+  std::uint64_t p2 = t_plus.f & (one.f - 1);
+  int len = 0;
+
+  // integral part
+  std::uint32_t pow10;
+  for (int n = largestPow10(p1, &pow10); n > 0;) {
+    t_buf[len++] = static_cast<char>('0' + p1 / pow10);
+    p1 %= pow10;
+    --n;
+    std::uint64_t rest = (std::uint64_t(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *t_dec_exp += n;
+      round(t_buf, len, dist, delta, rest, std::uint64_t(pow10) << -one.e);
+      return len;
+    }
+    pow10 /= 10;
+  }
+
+  // fractional part
+  int m = 0;
+  do {
+    p2 *= 10;
+    t_buf[len++] = static_cast<char>('0' + (p2 >> -one.e));
+    p2 &= one.f - 1;
+    ++m;
+    delta *= 10;
+    dist *= 10;
+  } while (p2 > delta);
+  *t_dec_exp -= m;
+  round(t_buf, len, dist, delta, p2, one.f);
+  return len;
+}
+
+// digits of a positive value v = digits * 10^dec_exp
+int grisu2(char* t_buf, int* t_dec_exp, double t_value) {
+  Boundaries b = computeBoundaries(t_value);
+  CachedPower cached = cachedPowerFor(b.plus.e);
+  DiyFp c{cached.f, cached.e};
+  DiyFp w = mul(b.w, c);
+  DiyFp minus = mul(b.minus, c);
+  DiyFp plus = mul(b.plus, c);
+  // shrink the interval by 1 ulp for the errors of the products
+  minus.f++;
+  plus.f--;
+  *t_dec_exp = -cached.k;
+  return generateDigits(t_buf, t_dec_exp, minus, w, plus);
+}
+
+char* writeExponent(char* t_first, int t_exp) {
+  if (t_exp < 0) {
+    *t_first++ = '-';
+    t_exp = -t_exp;
+  } else {
+    *t_first++ = '+';
+  }
+  if (t_exp >= 100) {
+    *t_first++ = static_cast<char>('0' + t_exp / 100);
+    t_exp %= 100;
+  }
+  *t_first++ = static_cast<char>('0' + t_exp / 10);
+  *t_first++ = static_cast<char>('0' + t_exp % 10);
+  return t_first;
+}
+
+// place n digits at the beginning of the buffer with a decimal exponent
+char* formatDigits(char* t_first, int t_n, int t_dec_exp) {
+  // exponent in scientific notation
+  int x = t_n + t_dec_exp - 1;
+  if (x >= 15 || x < -4) {
+    if (t_n > 1) {
+      std::memmove(t_first + 2, t_first + 1, t_n - 1);
+      t_first[1] = '.';
+      ++t_n;
+    }
+    t_first[t_n] = 'e';
+    return writeExponent(t_first + t_n + 1, x);
+  }
+  if (t_dec_exp >= 0) {
+    // integer: ddd000
+    std::memset(t_first + t_n, '0', t_dec_exp);
+    return t_first + t_n + t_dec_exp;
+  }
+  if (x >= 0) {
+    // ddd.ddd
+    std::memmove(t_first + x + 2, t_first + x + 1, t_n - x - 1);
+    t_first[x + 1] = '.';
+    return t_first + t_n + 1;
+  }
+  // 0.000ddd
+  std::memmove(t_first + 1 - x, t_first, t_n);
+  t_first[0] = '0';
+  t_first[1] = '.';
+  std::memset(t_first + 2, '0', -x - 1);
+  return t_first + 1 - x + t_n;
+}
+
+char* writeNonFinite(char* t_first, double t_value) {
+  if (std::isnan(t_value)) {
+    std::memcpy(t_first, "nan", 3);
+    return t_first + 3;
+  }
+  if (t_value < 0) *t_first++ = '-';
+  std::memcpy(t_first, "inf", 3);
+  return t_first + 3;
+}
+
+char* writePrintf(char* t_first, const char* t_format, double t_value,
+                  int t_precision) {
+  if (t_precision < 0) t_precision = 0;
+  if (t_precision > max_precision) t_precision = max_precision;
+  int n = std::snprintf(t_first, max_length, t_format, t_precision, t_value);
+  return t_first + (n < 0 ? 0 : n);
+}
+
+}  // namespace
+
+char* writeShortest(char* t_first, double t_value) {
+  if (!std::isfinite(t_value)) return writeNonFinite(t_first, t_value);
+  if (std::signbit(t_value)) {
+    *t_first++ = '-';
+    t_value = -t_value;
+  }
+  if (t_value == 0) {
+    *t_first = '0';
+    return t_first + 1;
+  }
+  int dec_exp;
+  int n = grisu2(t_first, &dec_exp, t_value);
+  return formatDigits(t_first, n, dec_exp);
+}
+
+char* writeScientific(char* t_first, double t_value, int t_precision) {
+  return writePrintf(t_first, "%.*e", t_value, t_precision);
+}
+
+char* writeGeneral(char* t_first, double t_value, int t_precision) {
+  return writePrintf(t_first, "%.*g", t_value, t_precision);
+}
+
+}  // namespace number_format
+}  // namespace holon
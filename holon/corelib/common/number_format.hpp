@@ -0,0 +1,51 @@
+/* number_format - allocation-free formatting of floating-point numbers
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_COMMON_NUMBER_FORMAT_HPP_
+#define HOLON_COMMON_NUMBER_FORMAT_HPP_
+
+#include <cstddef>
+
+namespace holon {
+namespace number_format {
+
+// maximum number of characters written by the functions below with a
+// precision up to max_precision
+constexpr std::size_t max_length = 32;
+constexpr int max_precision = 17;
+
+// Writes a decimal representation that reads back to the same value, which
+// is usually the shortest one (Grisu2 by F. Loitsch, where about 0.1% of
+// values get a digit more than needed). It is in fixed notation for a decimal
+// exponent in [-4, 15) and in scientific notation otherwise, e.g. 0.1,
+// 1.5e-07, 3e+20. Infinity and NaN are written as inf and nan.
+// The buffer `t_first` needs max_length characters at least, and a pointer
+// to the end of the written characters is returned.
+char* writeShortest(char* t_first, double t_value);
+
+// Writes a value in the same way as printf with "%.*e" and "%.*g",
+// respectively, where the precision is clamped to max_precision.
+char* writeScientific(char* t_first, double t_value, int t_precision);
+char* writeGeneral(char* t_first, double t_value, int t_precision);
+
+}  // namespace number_format
+}  // namespace holon
+
+#endif  // HOLON_COMMON_NUMBER_FORMAT_HPP_
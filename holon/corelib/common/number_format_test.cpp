@@ -0,0 +1,158 @@
+/* number_format - allocation-free formatting of floating-point numbers
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/common/number_format.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include "holon/corelib/math/philox.hpp"
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+std::string shortest(double value) {
+  char buf[number_format::max_length];
+  return std::string(buf, number_format::writeShortest(buf, value));
+}
+
+// the least number of significant digits with which printf round-trips
+int shortestDigits(double value) {
+  char buf[number_format::max_length];
+  for (int p = 1; p < 17; ++p) {
+    std::snprintf(buf, sizeof(buf), "%.*e", p - 1, value);
+    if (std::strtod(buf, nullptr) == value) return p;
+  }
+  return 17;
+}
+
+int significantDigits(const std::string& str) {
+  std::size_t first = str.find_first_of("123456789");
+  std::size_t last = str.find_last_of("0123456789", str.find('e'));
+  int n = 0;
+  for (std::size_t i = first; i <= last; ++i)
+    if (str[i] >= '0' && str[i] <= '9') ++n;
+  // trailing zeros of an integer are not significant
+  for (std::size_t i = last; str.find('.') == std::string::npos &&
+                             str.find('e') == std::string::npos &&
+                             i > first && str[i] == '0';
+       --i)
+    --n;
+  return n;
+}
+
+TEST_CASE("number_format::writeShortest: notation",
+          "[number_format][writeShortest]") {
+  CHECK(shortest(0) == "0");
+  CHECK(shortest(-0.0) == "-0");
+  CHECK(shortest(1) == "1");
+  CHECK(shortest(-2.5) == "-2.5");
+  CHECK(shortest(0.1) == "0.1");
+  CHECK(shortest(0.3) == "0.3");
+  CHECK(shortest(1.0 / 3) == "0.3333333333333333");
+  CHECK(shortest(123456.789) == "123456.789");
+  CHECK(shortest(0.0001) == "0.0001");
+  CHECK(shortest(0.00001) == "1e-05");
+  CHECK(shortest(1.5e-7) == "1.5e-07");
+  CHECK(shortest(1e14) == "100000000000000");
+  CHECK(shortest(1e15) == "1e+15");
+  CHECK(shortest(3e20) == "3e+20");
+  CHECK(shortest(-1.25e-100) == "-1.25e-100");
+  CHECK(shortest(std::numeric_limits<double>::max()) ==
+        "1.7976931348623157e+308");
+  CHECK(shortest(std::numeric_limits<double>::infinity()) == "inf");
+  CHECK(shortest(-std::numeric_limits<double>::infinity()) == "-inf");
+  CHECK(shortest(std::numeric_limits<double>::quiet_NaN()) == "nan");
+}
+
+TEST_CASE("number_format::writeShortest: round trip",
+          "[number_format][writeShortest]") {
+  SECTION("extreme values") {
+    for (double value : {std::numeric_limits<double>::min(),
+                         std::numeric_limits<double>::denorm_min(),
+                         std::numeric_limits<double>::epsilon(),
+                         std::numeric_limits<double>::lowest()}) {
+      std::string str = shortest(value);
+      CHECK(std::strtod(str.c_str(), nullptr) == value);
+    }
+  }
+  SECTION("random bit patterns") {
+    Philox4x32 rng(1);
+    int longer = 0;
+    const int n = 20000;
+    for (int i = 0; i < n; ++i) {
+      std::uint64_t bits = (std::uint64_t(rng()) << 32) | rng();
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      if (!std::isfinite(value)) continue;
+      std::string str = shortest(value);
+      REQUIRE(str.size() < number_format::max_length);
+      REQUIRE(std::strtod(str.c_str(), nullptr) == value);
+      int digits = significantDigits(str);
+      REQUIRE(digits <= 17);
+      if (digits > shortestDigits(value)) ++longer;
+    }
+    // Grisu2 is not the shortest for about 0.1% of values
+    CHECK(longer < n / 500);
+  }
+  SECTION("values with a few digits") {
+    Philox4x32 rng(2);
+    char buf[number_format::max_length];
+    int longer = 0;
+    const int n = 10000;
+    for (int i = 0; i < n; ++i) {
+      int digits = 1 + rng() % 15;
+      int exponent = static_cast<int>(rng() % 61) - 30;
+      double mantissa = 1 + 9 * (rng() / 4294967296.0);
+      std::snprintf(buf, sizeof(buf), "%.*ee%d", digits - 1, mantissa,
+                    exponent);
+      double value = std::strtod(buf, nullptr);
+      std::string str = shortest(value);
+      REQUIRE(std::strtod(str.c_str(), nullptr) == value);
+      if (significantDigits(str) > shortestDigits(value)) ++longer;
+    }
+    CHECK(longer < n / 500);
+  }
+}
+
+TEST_CASE("number_format: same as printf", "[number_format]") {
+  char expected[number_format::max_length];
+  char buf[number_format::max_length];
+  for (double value : {0.0, 1.0, -0.1, 1.0 / 3, 1e-300, 6.02e23}) {
+    std::snprintf(expected, sizeof(expected), "%.10e", value);
+    *number_format::writeScientific(buf, value, 10) = '\0';
+    CHECK(std::string(buf) == expected);
+    std::snprintf(expected, sizeof(expected), "%.6g", value);
+    *number_format::writeGeneral(buf, value, 6) = '\0';
+    CHECK(std::string(buf) == expected);
+  }
+  std::snprintf(expected, sizeof(expected), "%.17e", -1e308);
+  *number_format::writeScientific(buf, -1e308, 40) = '\0';
+  CHECK(std::string(buf) == expected);
+}
+
+}  // namespace
+}  // namespace holon
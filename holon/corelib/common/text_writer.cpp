@@ -0,0 +1,132 @@
+/* text_writer - text formatter into a caller-provided buffer
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/common/text_writer.hpp"
+
+#include <cstring>
+#include <ostream>
+
+namespace holon {
+
+TextWriter::TextWriter(char* t_buffer, std::size_t t_capacity)
+    : m_buffer(t_buffer),
+      m_capacity(t_capacity),
+      m_size(0),
+      m_good(true),
+      m_format(Format::shortest),
+      m_precision(0),
+      m_delimiter(' ') {}
+
+TextWriter& TextWriter::set_format(Format t_format, int t_precision) {
+  m_format = t_format;
+  m_precision = t_precision;
+  return *this;
+}
+
+TextWriter& TextWriter::set_delimiter(char t_delimiter) {
+  m_delimiter = t_delimiter;
+  return *this;
+}
+
+TextWriter& TextWriter::clear() {
+  m_size = 0;
+  m_good = true;
+  return *this;
+}
+
+bool TextWriter::reserve(std::size_t t_len) {
+  if (m_good && m_capacity - m_size < t_len) m_good = false;
+  return m_good;
+}
+
+TextWriter& TextWriter::put(double t_value) {
+  return put(t_value, m_format, m_precision);
+}
+
+TextWriter& TextWriter::put(double t_value, Format t_format,
+                            int t_precision) {
+  if (!m_good) return *this;
+  char tmp[number_format::max_length];
+  bool direct = m_capacity - m_size >= number_format::max_length;
+  char* first = direct ? m_buffer + m_size : tmp;
+  char* last;
+  switch (t_format) {
+    case Format::scientific:
+      last = number_format::writeScientific(first, t_value, t_precision);
+      break;
+    case Format::general:
+      last = number_format::writeGeneral(first, t_value, t_precision);
+      break;
+    default:
+      last = number_format::writeShortest(first, t_value);
+      break;
+  }
+  if (direct) {
+    m_size = last - m_buffer;
+    return *this;
+  }
+  return put(tmp, last - tmp);
+}
+
+TextWriter& TextWriter::put(long long t_value) {
+  if (t_value >= 0) return put(static_cast<unsigned long long>(t_value));
+  put('-');
+  // negate in unsigned so as not to overflow for the minimum
+  return put(0 - static_cast<unsigned long long>(t_value));
+}
+
+TextWriter& TextWriter::put(unsigned long long t_value) {
+  char tmp[20];
+  char* first = tmp + sizeof(tmp);
+  do {
+    *--first = static_cast<char>('0' + t_value % 10);
+    t_value /= 10;
+  } while (t_value > 0);
+  return put(first, tmp + sizeof(tmp) - first);
+}
+
+TextWriter& TextWriter::put(char t_c) {
+  if (reserve(1)) m_buffer[m_size++] = t_c;
+  return *this;
+}
+
+TextWriter& TextWriter::put(const char* t_str, std::size_t t_len) {
+  if (reserve(t_len)) {
+    std::memcpy(m_buffer + m_size, t_str, t_len);
+    m_size += t_len;
+  }
+  return *this;
+}
+
+TextWriter& TextWriter::put(const char* t_str) {
+  return put(t_str, std::strlen(t_str));
+}
+
+TextWriter& TextWriter::flush(std::ostream& t_os) {
+  t_os.write(m_buffer, static_cast<std::streamsize>(m_size));
+  return clear();
+}
+
+TextWriter& TextWriter::flush(std::FILE* t_fp) {
+  std::fwrite(m_buffer, 1, m_size, t_fp);
+  return clear();
+}
+
+}  // namespace holon
@@ -0,0 +1,119 @@
+/* text_writer - text formatter into a caller-provided buffer
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_COMMON_TEXT_WRITER_HPP_
+#define HOLON_COMMON_TEXT_WRITER_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <iosfwd>
+#include <type_traits>
+#include "holon/corelib/common/number_format.hpp"
+
+namespace holon {
+
+// TextWriter formats numbers and strings into a buffer provided by the
+// caller without any allocation, so that it is used to log data every
+// control step. Values are delimited by the caller, whereas a compound
+// value, e.g. a vector, is written with its elements delimited by the
+// delimiter of the writer. Once the buffer runs short, the writer drops
+// what follows and good() turns false until clear() is called.
+class TextWriter {
+  using Self = TextWriter;
+
+ public:
+  enum class Format { shortest, scientific, general };
+
+ public:
+  TextWriter(char* t_buffer, std::size_t t_capacity);
+  template <std::size_t N>
+  explicit TextWriter(char (&t_buffer)[N]) : TextWriter(t_buffer, N) {}
+
+  // accessors
+  inline const char* data() const noexcept { return m_buffer; }
+  inline std::size_t size() const noexcept { return m_size; }
+  inline std::size_t capacity() const noexcept { return m_capacity; }
+  inline bool good() const noexcept { return m_good; }
+  inline Format format() const noexcept { return m_format; }
+  inline int precision() const noexcept { return m_precision; }
+  inline char delimiter() const noexcept { return m_delimiter; }
+
+  // mutators
+  // precision is ignored for Format::shortest
+  Self& set_format(Format t_format, int t_precision = 0);
+  Self& set_delimiter(char t_delimiter);
+  Self& clear();
+
+  // writers
+  Self& put(double t_value);
+  // write a value in a format other than that of the writer, e.g. the time
+  // column of a log, which reads better in a fixed number of digits
+  Self& put(double t_value, Format t_format, int t_precision = 0);
+  Self& put(long long t_value);
+  Self& put(unsigned long long t_value);
+  Self& put(char t_c);
+  Self& put(const char* t_str, std::size_t t_len);
+  Self& put(const char* t_str);
+  inline Self& delimit() { return put(m_delimiter); }
+
+  // write the contents to a stream or a file and clear them
+  Self& flush(std::ostream& t_os);
+  Self& flush(std::FILE* t_fp);
+
+ private:
+  char* m_buffer;
+  std::size_t m_capacity;
+  std::size_t m_size;
+  bool m_good;
+  Format m_format;
+  int m_precision;
+  char m_delimiter;
+
+  bool reserve(std::size_t t_len);
+};
+
+inline TextWriter& operator<<(TextWriter& writer, double value) {
+  return writer.put(value);
+}
+template <typename T,
+          typename std::enable_if<std::is_integral<T>::value &&
+                                      std::is_signed<T>::value,
+                                  std::nullptr_t>::type = nullptr>
+inline TextWriter& operator<<(TextWriter& writer, T value) {
+  return writer.put(static_cast<long long>(value));
+}
+template <typename T,
+          typename std::enable_if<std::is_integral<T>::value &&
+                                      std::is_unsigned<T>::value &&
+                                      !std::is_same<T, bool>::value,
+                                  std::nullptr_t>::type = nullptr>
+inline TextWriter& operator<<(TextWriter& writer, T value) {
+  return writer.put(static_cast<unsigned long long>(value));
+}
+inline TextWriter& operator<<(TextWriter& writer, char c) {
+  return writer.put(c);
+}
+inline TextWriter& operator<<(TextWriter& writer, const char* str) {
+  return writer.put(str);
+}
+
+}  // namespace holon
+
+#endif  // HOLON_COMMON_TEXT_WRITER_HPP_
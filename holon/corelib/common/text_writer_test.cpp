@@ -0,0 +1,120 @@
+/* text_writer - text formatter into a caller-provided buffer
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/common/text_writer.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+std::string str(const TextWriter& writer) {
+  return std::string(writer.data(), writer.size());
+}
+
+TEST_CASE("TextWriter: constructor", "[TextWriter]") {
+  char buf[64];
+  TextWriter writer(buf);
+  CHECK(writer.data() == buf);
+  CHECK(writer.size() == 0);
+  CHECK(writer.capacity() == 64);
+  CHECK(writer.good());
+  CHECK(writer.format() == TextWriter::Format::shortest);
+  CHECK(writer.delimiter() == ' ');
+}
+
+TEST_CASE("TextWriter: write values", "[TextWriter]") {
+  char buf[128];
+  TextWriter writer(buf);
+  SECTION("shortest") {
+    writer << 0.1 << ' ' << -2.0 << ' ' << 1.5e-7 << "\n";
+    CHECK(str(writer) == "0.1 -2 1.5e-07\n");
+  }
+  SECTION("scientific") {
+    writer.set_format(TextWriter::Format::scientific, 10);
+    writer << 0.1;
+    writer.delimit() << 1.0;
+    CHECK(str(writer) == "1.0000000000e-01 1.0000000000e+00");
+  }
+  SECTION("general") {
+    writer.set_format(TextWriter::Format::general, 6);
+    writer.set_delimiter(',');
+    writer << 0.030000000000000002;
+    writer.delimit() << 1234567.0;
+    CHECK(str(writer) == "0.03,1.23457e+06");
+  }
+  SECTION("format of a single value") {
+    writer.put(0.060000000000000005, TextWriter::Format::general, 10) << ' ';
+    writer.put(9.999999999999831, TextWriter::Format::general, 10) << ' ';
+    writer << 0.060000000000000005;
+    CHECK(str(writer) == "0.06 10 0.060000000000000005");
+    CHECK(writer.format() == TextWriter::Format::shortest);
+  }
+  SECTION("integers") {
+    writer << 0 << ' ' << -12 << ' ' << 345u << ' ';
+    writer << static_cast<long long>(-9223372036854775807 - 1);
+    CHECK(str(writer) == "0 -12 345 -9223372036854775808");
+  }
+  SECTION("clear") {
+    writer << "abc";
+    writer.clear();
+    writer << 'd';
+    CHECK(str(writer) == "d");
+  }
+}
+
+TEST_CASE("TextWriter: buffer overflow", "[TextWriter]") {
+  char buf[8];
+  TextWriter writer(buf);
+  writer << 1.5 << ' ';
+  CHECK(writer.good());
+  writer << 0.125;
+  CHECK_FALSE(writer.good());
+  writer << 'x';
+  CHECK(str(writer) == "1.5 ");
+  writer.clear() << 0.125;
+  CHECK(writer.good());
+  CHECK(str(writer) == "0.125");
+  writer << "abc";
+  CHECK(str(writer) == "0.125abc");
+  CHECK(writer.size() == 8);
+  CHECK(writer.good());
+  writer << 'x';
+  CHECK_FALSE(writer.good());
+}
+
+TEST_CASE("TextWriter: flush", "[TextWriter]") {
+  char buf[32];
+  TextWriter writer(buf);
+  std::ostringstream oss;
+  writer << 1.0 << ' ';
+  writer.flush(oss);
+  CHECK(writer.size() == 0);
+  writer << 2.0 << '\n';
+  writer.flush(oss);
+  CHECK(oss.str() == "1 2\n");
+}
+
+}  // namespace
+}  // namespace holon
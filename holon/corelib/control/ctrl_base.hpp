@@ -25,6 +25,7 @@
 #include <type_traits>
 #include "holon/corelib/control/model_base.hpp"
 #include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/data/fields.hpp"
 #include "holon/corelib/math/ode_solver.hpp"
 
 namespace holon {
@@ -121,6 +122,25 @@ class CtrlBase {
     return this->update();
   }
 
+  // checkpoints
+  // (the data include those of the model, so that the clock of the model and
+  // the internal states of the derived controller are added to them)
+  std::size_t checkpoint_size() const {
+    return data_binary_size(m_data) + Model::clock_size() + internals_size();
+  }
+  char* saveCheckpoint(char* t_p) const {
+    return saveInternals(m_model.saveClock(pack_data(t_p, m_data)));
+  }
+  const char* loadCheckpoint(const char* t_p) {
+    return loadInternals(m_model.loadClock(unpack_data(t_p, &m_data)));
+  }
+
+ protected:
+  // internal states of derived controllers which are not in the data
+  virtual std::size_t internals_size() const { return 0; }
+  virtual char* saveInternals(char* t_p) const { return t_p; }
+  virtual const char* loadInternals(const char* t_p) { return t_p; }
+
  private:
   Data m_data;
   Model m_model;
@@ -28,6 +28,7 @@
 #include "holon/corelib/math/ode_euler.hpp"
 
 #include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
 namespace holon {
@@ -152,6 +153,14 @@ TEST_CASE("Check update in CtrlBase", "[CtrlBase][update]") {
   }
 }
 
+TEST_CASE("CtrlBase::update does not allocate memory after warmup",
+          "[CtrlBase][update]") {
+  TestCtrl ctrl;
+  REQUIRE(ctrl.update());
+  REQUIRE_NO_ALLOCATIONS(for (auto i = 0; i < 10; ++i) ctrl.update());
+  REQUIRE_NO_ALLOCATIONS(ctrl.update(0.002));
+}
+
 TEST_CASE("Check reset in CtrlBase", "[CtrlBase][reset]") {
   TestCtrl ctrl;
   REQUIRE(ctrl.update());
@@ -0,0 +1,291 @@
+/* dataflow - static dataflow graph of controller blocks
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_DATAFLOW_HPP_
+#define HOLON_CONTROL_DATAFLOW_HPP_
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace holon {
+namespace dataflow {
+
+// A block is a class which has a type Output and a member function
+//   Output update(double dt, const Input1&, const Input2&, ...)
+// A node of a graph consists of a block and ports connected to its inputs,
+// each of which refers to the output of another node by its index:
+//   In<I>         output of node I at the current tick
+//   In<I, K>      std::get<K>() of output of node I at the current tick
+//   Delayed<I>    output of node I at the previous tick
+//   Delayed<I, K> std::get<K>() of output of node I at the previous tick
+// A loop of nodes has to be broken by Delayed<>.
+constexpr std::size_t whole = static_cast<std::size_t>(-1);
+
+template <std::size_t I, std::size_t K = whole>
+struct In {};
+template <std::size_t I, std::size_t K = whole>
+struct Delayed {};
+
+template <typename Block, typename... Ports>
+struct Node {
+  using block_type = Block;
+  using ports = std::tuple<Ports...>;
+};
+
+namespace detail {
+
+constexpr std::size_t cmax(std::size_t a, std::size_t b) {
+  return a > b ? a : b;
+}
+
+// rank of a node is the length of the longest path of In<> to it, which
+// is computed at compile time; nodes are updated in order of ranks
+// (node_rank is parameterized only by the node, so that the rank of each
+// node is instantiated once and shared by all the paths through it; a loop
+// of In<> therefore ends up in an incomplete type of node_rank)
+template <typename Nodes, std::size_t I>
+struct node_rank;
+
+template <typename Nodes, typename Port>
+struct port_rank;
+
+template <typename Nodes, std::size_t J, std::size_t K>
+struct port_rank<Nodes, In<J, K>>
+    : std::integral_constant<std::size_t, node_rank<Nodes, J>::value + 1> {
+  static_assert(J < std::tuple_size<Nodes>::value, "In<> out of range.");
+};
+
+template <typename Nodes, std::size_t J, std::size_t K>
+struct port_rank<Nodes, Delayed<J, K>>
+    : std::integral_constant<std::size_t, 0> {
+  static_assert(J < std::tuple_size<Nodes>::value, "Delayed<> out of range.");
+};
+
+template <typename Nodes, typename Ports>
+struct ports_rank;
+
+template <typename Nodes>
+struct ports_rank<Nodes, std::tuple<>>
+    : std::integral_constant<std::size_t, 0> {};
+
+template <typename Nodes, typename Port, typename... Ports>
+struct ports_rank<Nodes, std::tuple<Port, Ports...>>
+    : std::integral_constant<
+          std::size_t, cmax(port_rank<Nodes, Port>::value,
+                            ports_rank<Nodes, std::tuple<Ports...>>::value)> {
+};
+
+template <typename Nodes, std::size_t I>
+struct node_rank
+    : ports_rank<Nodes, typename std::tuple_element<I, Nodes>::type::ports> {
+};
+
+template <typename Nodes, std::size_t I, std::size_t N>
+struct max_rank
+    : std::integral_constant<std::size_t,
+                             cmax(node_rank<Nodes, I>::value,
+                                  max_rank<Nodes, I + 1, N>::value)> {};
+
+template <typename Nodes, std::size_t N>
+struct max_rank<Nodes, N, N> : std::integral_constant<std::size_t, 0> {};
+
+// check if the output of node J is referred to by Delayed<>
+template <std::size_t J, typename Ports>
+struct refers_delayed;
+
+template <std::size_t J>
+struct refers_delayed<J, std::tuple<>> : std::false_type {};
+
+template <std::size_t J, typename Port, typename... Ports>
+struct refers_delayed<J, std::tuple<Port, Ports...>>
+    : refers_delayed<J, std::tuple<Ports...>> {};
+
+template <std::size_t J, std::size_t K, typename... Ports>
+struct refers_delayed<J, std::tuple<Delayed<J, K>, Ports...>>
+    : std::true_type {};
+
+template <typename Nodes, std::size_t J, std::size_t I, std::size_t N>
+struct is_delayed
+    : std::integral_constant<
+          bool,
+          refers_delayed<J, typename std::tuple_element<
+                                I, Nodes>::type::ports>::value ||
+              is_delayed<Nodes, J, I + 1, N>::value> {};
+
+template <typename Nodes, std::size_t J, std::size_t N>
+struct is_delayed<Nodes, J, N, N> : std::false_type {};
+
+// access to the value of a port
+template <std::size_t K>
+struct select {
+  template <typename T>
+  static auto get(const T& t_value) -> decltype(std::get<K>(t_value)) {
+    return std::get<K>(t_value);
+  }
+};
+
+template <>
+struct select<whole> {
+  template <typename T>
+  static const T& get(const T& t_value) {
+    return t_value;
+  }
+};
+
+template <typename Port>
+struct port;
+
+template <std::size_t J, std::size_t K>
+struct port<In<J, K>> {
+  template <typename Outputs>
+  static auto get(const Outputs& t_current, const Outputs&)
+      -> decltype(select<K>::get(std::get<J>(t_current))) {
+    return select<K>::get(std::get<J>(t_current));
+  }
+};
+
+template <std::size_t J, std::size_t K>
+struct port<Delayed<J, K>> {
+  template <typename Outputs>
+  static auto get(const Outputs&, const Outputs& t_previous)
+      -> decltype(select<K>::get(std::get<J>(t_previous))) {
+    return select<K>::get(std::get<J>(t_previous));
+  }
+};
+
+}  // namespace detail
+
+// Graph holds blocks and their outputs in tuples, so that all the buffers
+// between blocks reside in the graph object itself. The order of updates is
+// fixed at compile time and update() expands into plain calls of the
+// blocks without any virtual call or allocation.
+template <typename... Nodes>
+class Graph {
+  using NodeTuple = std::tuple<Nodes...>;
+
+ public:
+  static constexpr std::size_t size = sizeof...(Nodes);
+  static constexpr std::size_t rank_num =
+      detail::max_rank<NodeTuple, 0, size>::value + 1;
+
+  using Blocks = std::tuple<typename Nodes::block_type...>;
+  using Outputs = std::tuple<typename Nodes::block_type::Output...>;
+  template <std::size_t I>
+  using BlockI = typename std::tuple_element<I, Blocks>::type;
+  template <std::size_t I>
+  using OutputI = typename std::tuple_element<I, Outputs>::type;
+
+ public:
+  Graph() : m_blocks(), m_outputs(), m_delayed() {}
+  explicit Graph(const typename Nodes::block_type&... t_blocks)
+      : m_blocks(t_blocks...), m_outputs(), m_delayed() {}
+
+  template <std::size_t I>
+  static constexpr std::size_t rank() {
+    return detail::node_rank<NodeTuple, I>::value;
+  }
+
+  // accessors
+  template <std::size_t I>
+  BlockI<I>& block() {
+    return std::get<I>(m_blocks);
+  }
+  template <std::size_t I>
+  const BlockI<I>& block() const {
+    return std::get<I>(m_blocks);
+  }
+  template <std::size_t I>
+  const OutputI<I>& output() const {
+    return std::get<I>(m_outputs);
+  }
+
+  // set an initial output, which is also the previous one
+  template <std::size_t I>
+  Graph& set_output(const OutputI<I>& t_output) {
+    std::get<I>(m_outputs) = std::get<I>(m_delayed) = t_output;
+    return *this;
+  }
+
+  // update all the blocks for one tick
+  void update(double t_dt) {
+    updateRank<0>(t_dt);
+    saveDelayed<0>();
+  }
+
+ private:
+  Blocks m_blocks;
+  Outputs m_outputs;
+  Outputs m_delayed;
+
+  template <std::size_t R>
+  typename std::enable_if<(R == rank_num)>::type updateRank(double) {}
+  template <std::size_t R>
+  typename std::enable_if<(R < rank_num)>::type updateRank(double t_dt) {
+    updateNodes<R, 0>(t_dt);
+    updateRank<R + 1>(t_dt);
+  }
+
+  template <std::size_t R, std::size_t I>
+  typename std::enable_if<(I == size)>::type updateNodes(double) {}
+  template <std::size_t R, std::size_t I>
+  typename std::enable_if<(I < size)>::type updateNodes(double t_dt) {
+    updateNode<I>(t_dt, std::integral_constant<bool, rank<I>() == R>());
+    updateNodes<R, I + 1>(t_dt);
+  }
+
+  template <std::size_t I>
+  void updateNode(double, std::false_type) {}
+  template <std::size_t I>
+  void updateNode(double t_dt, std::true_type) {
+    using Ports = typename std::tuple_element<I, NodeTuple>::type::ports;
+    callBlock<I>(t_dt, Ports());
+  }
+  template <std::size_t I, typename... Ports>
+  void callBlock(double t_dt, std::tuple<Ports...>) {
+    std::get<I>(m_outputs) = std::get<I>(m_blocks).update(
+        t_dt, detail::port<Ports>::get(m_outputs, m_delayed)...);
+  }
+
+  template <std::size_t I>
+  typename std::enable_if<(I == size)>::type saveDelayed() {}
+  template <std::size_t I>
+  typename std::enable_if<(I < size)>::type saveDelayed() {
+    saveDelayed<I>(std::integral_constant<
+                   bool, detail::is_delayed<NodeTuple, I, 0, size>::value>());
+    saveDelayed<I + 1>();
+  }
+  template <std::size_t I>
+  void saveDelayed(std::false_type) {}
+  template <std::size_t I>
+  void saveDelayed(std::true_type) {
+    std::get<I>(m_delayed) = std::get<I>(m_outputs);
+  }
+};
+
+template <typename... Nodes>
+constexpr std::size_t Graph<Nodes...>::size;
+template <typename... Nodes>
+constexpr std::size_t Graph<Nodes...>::rank_num;
+
+}  // namespace dataflow
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_DATAFLOW_HPP_
@@ -0,0 +1,198 @@
+/* dataflow_blocks - basic blocks of static dataflow graph
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_DATAFLOW_BLOCKS_HPP_
+#define HOLON_CONTROL_DATAFLOW_BLOCKS_HPP_
+
+#include <array>
+#include "holon/corelib/control/dataflow.hpp"
+#include "holon/corelib/control/pd_ctrl/pd_ctrl_formula.hpp"
+#include "holon/corelib/control/point_mass_model.hpp"
+
+namespace holon {
+namespace dataflow {
+
+// source of a value given from outside
+template <typename T = double>
+class ConstantBlock {
+ public:
+  using Output = T;
+
+  explicit ConstantBlock(const T& t_value = T()) : m_value(t_value) {}
+  inline const T& value() const noexcept { return m_value; }
+  ConstantBlock& set_value(const T& t_value) {
+    m_value = t_value;
+    return *this;
+  }
+  const T& update(double) const { return m_value; }
+
+ private:
+  T m_value;
+};
+
+template <typename T = double>
+class GainBlock {
+ public:
+  using Output = T;
+
+  explicit GainBlock(double t_gain = 1) : m_gain(t_gain) {}
+  inline double gain() const noexcept { return m_gain; }
+  T update(double, const T& t_u) const { return t_u * m_gain; }
+
+ private:
+  double m_gain;
+};
+
+// weighted sum of two inputs, e.g. (1, -1) for subtraction
+template <typename T = double>
+class SumBlock {
+ public:
+  using Output = T;
+
+  explicit SumBlock(double t_w1 = 1, double t_w2 = 1)
+      : m_w1(t_w1), m_w2(t_w2) {}
+  T update(double, const T& t_u1, const T& t_u2) const {
+    return t_u1 * m_w1 + t_u2 * m_w2;
+  }
+
+ private:
+  double m_w1, m_w2;
+};
+
+class LimitBlock {
+ public:
+  using Output = double;
+
+  LimitBlock(double t_min, double t_max) : m_min(t_min), m_max(t_max) {}
+  double update(double, double t_u) const {
+    return t_u < m_min ? m_min : (t_u > m_max ? m_max : t_u);
+  }
+
+ private:
+  double m_min, m_max;
+};
+
+// first-order lag T dy/dt + y = K u discretized by backward Euler method
+template <typename T = double>
+class LagBlock {
+ public:
+  using Output = T;
+
+  explicit LagBlock(double t_time_constant, double t_gain = 1,
+                    const T& t_initial = T())
+      : m_time_constant(t_time_constant), m_gain(t_gain), m_y(t_initial) {}
+  inline const T& value() const noexcept { return m_y; }
+  const T& update(double t_dt, const T& t_u) {
+    double r = t_dt / m_time_constant;
+    m_y = (m_y + t_u * m_gain * r) / (1 + r);
+    return m_y;
+  }
+
+ private:
+  double m_time_constant;
+  double m_gain;
+  T m_y;
+};
+
+template <typename T = double>
+class IntegratorBlock {
+ public:
+  using Output = T;
+
+  explicit IntegratorBlock(const T& t_initial = T()) : m_y(t_initial) {}
+  const T& update(double t_dt, const T& t_u) {
+    m_y = m_y + t_u * t_dt;
+    return m_y;
+  }
+
+ private:
+  T m_y;
+};
+
+// PD control of a point mass to track a reference given as an input;
+// inputs are (position, velocity) of the mass and the reference position
+template <typename State = double>
+class PdBlock {
+ public:
+  using Output = State;
+  using Input = std::array<State, 2>;
+
+  PdBlock(const State& t_stiffness, const State& t_damping)
+      : m_stiffness(t_stiffness), m_damping(t_damping) {}
+  State update(double, const Input& t_x, const State& t_ref) const {
+    return pd_ctrl_formula::computeDesForce(t_x[0], t_x[1], t_ref, State(0),
+                                            m_stiffness, m_damping);
+  }
+
+ private:
+  State m_stiffness;
+  State m_damping;
+};
+
+// point mass driven by a force held over a tick, which is integrated by
+// the Runge-Kutta method of PointMassModel; the output is (position,
+// velocity)
+template <typename State = double>
+class PointMassBlock {
+ public:
+  using Output = std::array<State, 2>;
+  using Model = PointMassModel<State>;
+
+  explicit PointMassBlock(double t_mass = 1,
+                          const Output& t_initial = Output())
+      : m_model(t_initial[0], t_mass), m_x(t_initial) {
+    m_model.states().velocity = t_initial[1];
+    bindForce();
+  }
+  // a copy owns its model data, to which the force callback is bound
+  PointMassBlock(const PointMassBlock& t_block)
+      : PointMassBlock(t_block.mass(), t_block.m_x) {}
+  PointMassBlock& operator=(const PointMassBlock& t_block) {
+    m_model.states() = t_block.m_model.states();
+    m_x = t_block.m_x;
+    return *this;
+  }
+
+  inline double mass() const noexcept { return m_model.mass(); }
+  inline const Model& model() const noexcept { return m_model; }
+  const Output& update(double t_dt, const State& t_force) {
+    m_model.states().force = t_force;
+    m_model.update(t_dt);
+    m_x[0] = m_model.states().position;
+    m_x[1] = m_model.states().velocity;
+    return m_x;
+  }
+
+ private:
+  Model m_model;
+  Output m_x;
+
+  void bindForce() {
+    auto data = m_model.data();
+    m_model.setForceCallback([data](const State&, const State&, double) {
+      return data.template get<0>().force;
+    });
+  }
+};
+
+}  // namespace dataflow
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_DATAFLOW_BLOCKS_HPP_
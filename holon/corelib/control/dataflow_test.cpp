@@ -0,0 +1,129 @@
+/* dataflow - static dataflow graph of controller blocks
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/dataflow.hpp"
+
+#include <cmath>
+#include "holon/corelib/control/dataflow_blocks.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace dataflow {
+namespace {
+
+TEST_CASE("dataflow::Graph: order of updates", "[dataflow][Graph]") {
+  Fuzzer fuzz;
+  double u = fuzz();
+  // y = 2 u + 0.5 u, declared in reverse order
+  using G = Graph<Node<SumBlock<>, In<1>, In<2>>, Node<GainBlock<>, In<2>>,
+                  Node<ConstantBlock<>>>;
+  static_assert(G::rank<2>() == 0, "");
+  static_assert(G::rank<1>() == 1, "");
+  static_assert(G::rank<0>() == 2, "");
+  static_assert(G::rank_num == 3, "");
+  G graph(SumBlock<>(1, 0.5), GainBlock<>(2), ConstantBlock<>(u));
+  graph.update(0.001);
+  CHECK(graph.output<2>() == u);
+  CHECK(graph.output<1>() == 2 * u);
+  CHECK(graph.output<0>() == 2 * u + 0.5 * u);
+
+  graph.block<2>().set_value(1);
+  graph.update(0.001);
+  CHECK(graph.output<0>() == 2.5);
+}
+
+TEST_CASE("dataflow::Graph: ranks of diamonds", "[dataflow][Graph]") {
+  // each diamond doubles the paths to the last node, whose rank is still
+  // computed once per node
+  using G = Graph<Node<ConstantBlock<>>, Node<GainBlock<>, In<0>>,
+                  Node<GainBlock<>, In<0>>, Node<SumBlock<>, In<1>, In<2>>,
+                  Node<GainBlock<>, In<3>>, Node<GainBlock<>, In<3>>,
+                  Node<SumBlock<>, In<4>, In<5>>>;
+  static_assert(G::rank<3>() == 2, "");
+  static_assert(G::rank<6>() == 4, "");
+  static_assert(G::rank_num == 5, "");
+  G graph(ConstantBlock<>(1), GainBlock<>(2), GainBlock<>(3), SumBlock<>(),
+          GainBlock<>(0.5), GainBlock<>(-1), SumBlock<>());
+  graph.update(0.001);
+  CHECK(graph.output<6>() == Approx(-2.5));
+}
+
+TEST_CASE("dataflow::Graph: step response of chain of lags",
+          "[dataflow][Graph]") {
+  const double dt = 0.001, tc = 0.05, k = 2;
+  Graph<Node<ConstantBlock<Vec3D>>, Node<LagBlock<Vec3D>, In<0>>,
+        Node<GainBlock<Vec3D>, In<1>>>
+      graph(ConstantBlock<Vec3D>({1, -1, 0.5}), LagBlock<Vec3D>(tc, k),
+            GainBlock<Vec3D>(0.5));
+  const int n = 100;
+  for (int i = 0; i < n; ++i) graph.update(dt);
+  double y = k * (1 - std::pow(1 / (1 + dt / tc), n));
+  CHECK(graph.output<1>()[0] == Approx(y));
+  CHECK(graph.output<1>()[1] == Approx(-y));
+  CHECK(graph.output<2>()[2] == Approx(0.25 * y));
+}
+
+TEST_CASE("dataflow::Graph: loop broken by delayed port",
+          "[dataflow][Graph]") {
+  SECTION("counter") {
+    Graph<Node<SumBlock<>, Delayed<0>, In<1>>, Node<ConstantBlock<>>> graph(
+        SumBlock<>(), ConstantBlock<>(1));
+    graph.set_output<0>(10);
+    for (int i = 1; i <= 5; ++i) {
+      graph.update(0.01);
+      CHECK(graph.output<0>() == 10 + i);
+    }
+  }
+  SECTION("PD control of point mass") {
+    const double dt = 0.001, m = 2, k = 100, c = 20, ref = 0.3;
+    Graph<Node<ConstantBlock<>>, Node<PdBlock<>, Delayed<2>, In<0>>,
+          Node<PointMassBlock<>, In<1>>>
+        graph(ConstantBlock<>(ref), PdBlock<>(k, c), PointMassBlock<>(m));
+    double x = 0, v = 0;
+    for (int i = 0; i < 3000; ++i) {
+      graph.update(dt);
+      double f = k * (ref - x) - c * v;
+      // RK4 is exact for a force held over a tick
+      x += (v + 0.5 * f * dt / m) * dt;
+      v += f * dt / m;
+      REQUIRE(graph.output<2>()[0] == Approx(x));
+      REQUIRE(graph.output<1>() == Approx(f));
+    }
+    CHECK(graph.output<2>()[0] == Approx(ref).epsilon(1e-3));
+    CHECK(graph.output<2>()[1] == Approx(0).margin(1e-3));
+  }
+}
+
+TEST_CASE("dataflow::Graph: select element of output", "[dataflow][Graph]") {
+  Graph<Node<PointMassBlock<>, In<1>>, Node<ConstantBlock<>>,
+        Node<GainBlock<>, In<0, 1>>, Node<LimitBlock, In<0, 0>>>
+      graph(PointMassBlock<>(1, {{0, 1}}), ConstantBlock<>(0), GainBlock<>(3),
+            LimitBlock(-1, 0.05));
+  graph.update(0.1);
+  CHECK(graph.output<2>() == Approx(3));
+  CHECK(graph.output<3>() == Approx(0.05));
+}
+
+}  // namespace
+}  // namespace dataflow
+}  // namespace holon
@@ -0,0 +1,203 @@
+/* delay_line - fixed-capacity delay line with fractional delay
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_DELAY_LINE_HPP_
+#define HOLON_CONTROL_DELAY_LINE_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/data/fields.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+namespace delay_line_detail {
+
+// interpolation between a newer sample t_a and an older one t_b at the
+// fraction t_f of the way, which is exact for t_f = 0
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type interpolate(
+    const T& t_a, const T& t_b, double t_f, T* t_out) {
+  *t_out = t_a + (t_b - t_a) * t_f;
+}
+
+// integers are not interpolated but the nearer one is taken
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type interpolate(
+    const T& t_a, const T& t_b, double t_f, T* t_out) {
+  *t_out = t_f < 0.5 ? t_a : t_b;
+}
+
+// elements are interpolated in a plain loop over the raw array instead of
+// the out-of-line operators of Vec3D, so that the compiler packs them into
+// SIMD registers
+inline void interpolate(const Vec3D& t_a, const Vec3D& t_b, double t_f,
+                        Vec3D* t_out) {
+  const double* a = t_a.get_ptr()->e;
+  const double* b = t_b.get_ptr()->e;
+  double* out = t_out->get_ptr()->e;
+  for (std::size_t i = 0; i < 3; ++i) out[i] = a[i] + (b[i] - a[i]) * t_f;
+}
+
+// an optional value is interpolated only if both are given
+template <typename T>
+void interpolate(const optional<T>& t_a, const optional<T>& t_b, double t_f,
+                 optional<T>* t_out) {
+  if (!t_a || !t_b) {
+    *t_out = t_a;
+    return;
+  }
+  T v;
+  interpolate(*t_a, *t_b, t_f, &v);
+  *t_out = v;
+}
+
+template <typename T>
+typename std::enable_if<has_fields<T>::value>::type interpolate(
+    const T& t_a, const T& t_b, double t_f, T* t_out);
+
+struct Interpolator {
+  double f;
+  template <typename M>
+  void operator()(const char*, M& t_out, const M& t_a, const M& t_b) {
+    interpolate(t_a, t_b, f, &t_out);
+  }
+};
+
+// a registered struct is interpolated field by field
+template <typename T>
+typename std::enable_if<has_fields<T>::value>::type interpolate(
+    const T& t_a, const T& t_b, double t_f, T* t_out) {
+  T::for_each_field(Interpolator{t_f}, *t_out, t_a, t_b);
+}
+
+}  // namespace delay_line_detail
+
+// DelayLine delays a signal sampled every time step by a fractional number
+// of samples, which is interpolated linearly between the two neighbouring
+// samples so as not to overshoot. The samples are kept in a ring buffer of
+// a fixed capacity, so that no memory is allocated while running. Until as
+// many samples as the delay are pushed, the oldest one is held. It is put
+// in the feedback path between a model and a controller, e.g.
+//
+//   sensor.push(model.states().com_position);
+//   ctrl.feedback(sensor.output(), ...);
+//
+// or in the command path the other way round. T is a floating-point number,
+// Vec3D or a raw data struct registered with HOLON_DEFINE_FIELDS.
+template <typename T, std::size_t Capacity>
+class DelayLine {
+  static_assert(Capacity > 1, "DelayLine must have at least two samples.");
+
+  using Self = DelayLine<T, Capacity>;
+
+ public:
+  static constexpr std::size_t capacity = Capacity;
+  static constexpr double max_delay() { return Capacity - 1; }
+
+ public:
+  explicit DelayLine(double t_delay = 0)
+      : m_samples(), m_head(0), m_size(0), m_delay(0) {
+    set_delay(t_delay);
+  }
+
+  // accessors
+  // (the delay is in samples, i.e. delay time divided by the time step)
+  inline double delay() const noexcept { return m_delay; }
+  inline std::size_t size() const noexcept { return m_size; }
+  inline bool empty() const noexcept { return m_size == 0; }
+
+  // mutators
+  // (the delay is limited within [0, max_delay()])
+  Self& set_delay(double t_delay) {
+    m_delay = t_delay > 0 ? std::fmin(t_delay, max_delay()) : 0;
+    return *this;
+  }
+  Self& set_delay(double t_delay_time, double t_time_step) {
+    return set_delay(t_delay_time / t_time_step);
+  }
+  Self& clear() {
+    m_head = 0;
+    m_size = 0;
+    return *this;
+  }
+
+  // push the latest sample
+  Self& push(const T& t_sample) {
+    m_head = m_head + 1 < Capacity ? m_head + 1 : 0;
+    m_samples[m_head] = t_sample;
+    if (m_size < Capacity) ++m_size;
+    return *this;
+  }
+  // sample delayed by t_delay from the latest one
+  T at(double t_delay) const {
+    if (empty()) return T();
+    t_delay = t_delay > 0 ? std::fmin(t_delay, max_delay()) : 0;
+    std::size_t k = static_cast<std::size_t>(t_delay);
+    double f = t_delay - k;
+    if (k + 1 >= m_size) return sample(m_size - 1);
+    if (f == 0) return sample(k);
+    T out = sample(k);
+    delay_line_detail::interpolate(sample(k), sample(k + 1), f, &out);
+    return out;
+  }
+  inline T output() const { return at(m_delay); }
+  inline T update(const T& t_sample) { return push(t_sample).output(); }
+
+  // binary image of the samples for checkpoints
+  static constexpr std::size_t binary_size() {
+    return Capacity * field_binary_size<T>::value +
+           2 * field_binary_size<std::size_t>::value +
+           field_binary_size<double>::value;
+  }
+  char* pack(char* t_p) const {
+    for (const auto& s : m_samples) t_p = pack_fields(t_p, s);
+    t_p = pack_fields(t_p, m_head);
+    t_p = pack_fields(t_p, m_size);
+    return pack_fields(t_p, m_delay);
+  }
+  const char* unpack(const char* t_p) {
+    for (auto& s : m_samples) t_p = unpack_fields(t_p, &s);
+    t_p = unpack_fields(t_p, &m_head);
+    t_p = unpack_fields(t_p, &m_size);
+    return unpack_fields(t_p, &m_delay);
+  }
+
+ private:
+  std::array<T, Capacity> m_samples;
+  std::size_t m_head;
+  std::size_t m_size;
+  double m_delay;
+
+  // sample pushed t_k steps before the latest one
+  inline const T& sample(std::size_t t_k) const {
+    return m_samples[m_head >= t_k ? m_head - t_k : m_head + Capacity - t_k];
+  }
+};
+
+template <typename T, std::size_t Capacity>
+constexpr std::size_t DelayLine<T, Capacity>::capacity;
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_DELAY_LINE_HPP_
@@ -0,0 +1,170 @@
+/* delay_line - fixed-capacity delay line with fractional delay
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/delay_line.hpp"
+
+#include <vector>
+#include "holon/corelib/control/point_mass_model/point_mass_model_data.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+struct DelayLineSample {
+  double value;
+  optional<double> command;
+  int count;
+
+  HOLON_DEFINE_FIELDS(DelayLineSample, value, command, count)
+};
+
+TEST_CASE("DelayLine: constructor", "[DelayLine]") {
+  SECTION("default") {
+    DelayLine<double, 8> line;
+    CHECK(line.capacity == 8);
+    CHECK(line.max_delay() == 7);
+    CHECK(line.delay() == 0);
+    CHECK(line.empty());
+    CHECK(line.output() == 0);
+  }
+  SECTION("with delay") {
+    DelayLine<double, 8> line(2.5);
+    CHECK(line.delay() == 2.5);
+  }
+}
+
+TEST_CASE("DelayLine: set delay", "[DelayLine]") {
+  DelayLine<double, 8> line;
+  CHECK(line.set_delay(3).delay() == 3);
+  CHECK(line.set_delay(0.003, 0.001).delay() == Approx(3));
+  CHECK(line.set_delay(-1).delay() == 0);
+  CHECK(line.set_delay(10).delay() == 7);
+}
+
+TEST_CASE("DelayLine: delay by integer samples", "[DelayLine]") {
+  DelayLine<double, 8> line(3);
+  SECTION("the oldest sample is held until filled") {
+    CHECK(line.update(1) == 1);
+    CHECK(line.update(2) == 1);
+    CHECK(line.update(3) == 1);
+    CHECK(line.update(4) == 1);
+    CHECK(line.update(5) == 2);
+    CHECK(line.size() == 5);
+  }
+  SECTION("wrap around the buffer") {
+    for (int i = 0; i < 20; ++i) {
+      double y = line.update(i);
+      CHECK(y == (i < 3 ? 0 : i - 3));
+    }
+    CHECK(line.size() == 8);
+    CHECK(line.at(7) == 12);
+    CHECK(line.at(100) == 12);
+  }
+  SECTION("no delay") {
+    line.set_delay(0);
+    CHECK(line.update(1) == 1);
+    CHECK(line.update(-0.0) == 0);
+    CHECK(std::signbit(line.output()));
+  }
+  SECTION("clear") {
+    line.update(1);
+    line.clear();
+    CHECK(line.empty());
+    CHECK(line.update(2) == 2);
+  }
+}
+
+TEST_CASE("DelayLine: delay by fractional samples", "[DelayLine]") {
+  Fuzzer fuzz(0, 6);
+  double delay = fuzz();
+  SECTION("scalar") {
+    DelayLine<double, 8> line(delay);
+    for (int i = 0; i < 20; ++i) line.push(0.5 * i);
+    CHECK(line.output() == Approx(0.5 * (19 - delay)));
+  }
+  SECTION("Vec3D") {
+    DelayLine<Vec3D, 8> line(delay);
+    Vec3D v(1, -2, 0.5);
+    for (int i = 0; i < 20; ++i) line.push(v * i);
+    Vec3D expected = v * (19 - delay);
+    for (std::size_t i = 0; i < 3; ++i)
+      CHECK(line.output()[i] == Approx(expected[i]));
+  }
+}
+
+TEST_CASE("DelayLine: delay raw data field by field", "[DelayLine]") {
+  SECTION("point mass") {
+    DelayLine<PointMassModelRawData<Vec3D>, 4> line(1.25);
+    PointMassModelRawData<Vec3D> data{1, Vec3D(0, 0, 0), Vec3D(1, 2, 3),
+                                      kVec3DZero, kVec3DZero};
+    line.push(data);
+    data.position = Vec3D(1, 2, 3);
+    data.mass = 2;
+    line.push(data);
+    data.position = Vec3D(2, 4, 6);
+    line.push(data);
+    auto out = line.output();
+    CHECK(out.mass == 1.75);
+    CHECK(out.position == Vec3D(0.75, 1.5, 2.25));
+    CHECK(out.velocity == Vec3D(1, 2, 3));
+  }
+  SECTION("optional and integer") {
+    DelayLine<DelayLineSample, 4> line(0.75);
+    line.push(DelayLineSample{0, 1.0, 0});
+    line.push(DelayLineSample{1, 2.0, 1});
+    auto out = line.output();
+    CHECK(out.value == 0.25);
+    CHECK(out.command.value() == 1.25);
+    CHECK(out.count == 0);
+    line.push(DelayLineSample{2, nullopt, 2});
+    out = line.output();
+    CHECK(out.value == 1.25);
+    CHECK_FALSE(out.command);
+    CHECK(out.count == 1);
+  }
+}
+
+TEST_CASE("DelayLine: pack and unpack samples", "[DelayLine]") {
+  DelayLine<Vec3D, 8> line(2.5);
+  Fuzzer fuzz;
+  for (int i = 0; i < 10; ++i) line.push(fuzz.get<Vec3D>());
+  std::vector<char> image(line.binary_size());
+  CHECK(line.pack(image.data()) == image.data() + image.size());
+
+  DelayLine<Vec3D, 8> other;
+  CHECK(other.unpack(image.data()) == image.data() + image.size());
+  CHECK(other.delay() == 2.5);
+  CHECK(other.size() == 8);
+  Vec3D v = fuzz.get<Vec3D>();
+  CHECK(other.update(v) == line.update(v));
+}
+
+TEST_CASE("DelayLine: no allocation while running", "[DelayLine]") {
+  DelayLine<PointMassModelRawData<Vec3D>, 16> line(3.5);
+  PointMassModelRawData<Vec3D> data{};
+  line.update(data);
+  CHECK_NO_ALLOCATIONS(for (int i = 0; i < 100; ++i) line.update(data));
+}
+
+}  // namespace
+}  // namespace holon
@@ -25,8 +25,12 @@
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/control/model_event.hpp"
 #include "holon/corelib/control/system_base.hpp"
 #include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/data/fields.hpp"
 #include "holon/corelib/math/misc.hpp"
 #include "holon/corelib/math/ode_solver.hpp"
 
@@ -60,9 +64,12 @@ class ModelBase {
  public:
   static constexpr bool is_model_type = true;
   static constexpr double default_time_step = 0.001;
+  static constexpr double default_event_tolerance = 1e-10;
   using DataType = Data;
   template <std::size_t I>
   using RawDataType = typename Data::template RawDataI<I>;
+  using StateArray = typename SystemBase<State, Data>::StateArray;
+  using Event = ModelEvent<StateArray, System>;
 
  public:
   explicit ModelBase(Data t_data)
@@ -70,7 +77,13 @@ class ModelBase {
         m_time_step(default_time_step),
         m_data(t_data),
         m_system(t_data),
-        m_solver() {}
+        m_solver(),
+        m_events(),
+        m_event_times(),
+        m_event_tolerance(default_event_tolerance),
+        m_stopped_event(),
+        m_stopped_step(),
+        m_evaluation_count(0) {}
   virtual ~ModelBase() = default;
 
   // accessors
@@ -95,6 +108,18 @@ class ModelBase {
   const Solver& solver() const noexcept { return m_solver; }
   Solver& solver() noexcept { return m_solver; }
 
+  // evaluations of the system by the solver since the model was made,
+  // including those to locate events, which are not part of checkpoints
+  std::size_t evaluation_count() const noexcept { return m_evaluation_count; }
+
+  std::size_t event_num() const noexcept { return m_events.size(); }
+  const Event& event(std::size_t t_i) const { return m_events[t_i]; }
+  double event_tolerance() const noexcept { return m_event_tolerance; }
+  // index of the terminal event which stopped the last step
+  optional<std::size_t> stopped_event() const noexcept {
+    return m_stopped_event;
+  }
+
   // mutators
   Self& set_time_step(double t_time_step) {
     m_time_step = is_positive(t_time_step) ? t_time_step : default_time_step;
@@ -104,18 +129,87 @@ class ModelBase {
     m_data = t_data;
     return *this;
   }
+  Self& set_event_tolerance(double t_event_tolerance) {
+    m_event_tolerance = is_positive(t_event_tolerance)
+                            ? t_event_tolerance
+                            : default_event_tolerance;
+    return *this;
+  }
   virtual Self& reset() {
     m_time = 0;
+    m_stopped_event = nullopt;
+    m_stopped_step = nullopt;
+    return *this;
+  }
+
+  // events
+  std::size_t addEvent(typename Event::Function t_function,
+                       typename Event::Callback t_callback = nullptr,
+                       EventDirection t_direction = EventDirection::both,
+                       bool t_is_terminal = false) {
+    m_events.push_back(
+        Event{t_function, t_callback, t_direction, t_is_terminal, nullptr});
+    m_event_times.push_back(0);
+    return m_events.size() - 1;
+  }
+  std::size_t addSystemEvent(typename Event::SystemFunction t_function,
+                             typename Event::Callback t_callback = nullptr,
+                             EventDirection t_direction = EventDirection::both,
+                             bool t_is_terminal = false) {
+    m_events.push_back(
+        Event{nullptr, t_callback, t_direction, t_is_terminal, t_function});
+    m_event_times.push_back(0);
+    return m_events.size() - 1;
+  }
+  Self& clearEvents() {
+    m_events.clear();
+    m_event_times.clear();
     return *this;
   }
 
+  // checkpoints
+  // A checkpoint is a binary image of the data and the clock, i.e. the time,
+  // the time step and the state of a step stopped by an event, from which
+  // the model resumes bit-identically. The system, the solver and the events
+  // are configuration and not included; the stage buffers of the solver are
+  // always overwritten before they are read.
+  std::size_t checkpoint_size() const {
+    return data_binary_size(m_data) + clock_size();
+  }
+  char* saveCheckpoint(char* t_p) const {
+    return saveClock(pack_data(t_p, m_data));
+  }
+  const char* loadCheckpoint(const char* t_p) {
+    return loadClock(unpack_data(t_p, &m_data));
+  }
+  // the clock only, for owners which save the data by themselves
+  static constexpr std::size_t clock_size() {
+    return 2 * field_binary_size<double>::value +
+           field_binary_size<optional<std::size_t>>::value +
+           field_binary_size<optional<double>>::value;
+  }
+  char* saveClock(char* t_p) const {
+    t_p = pack_fields(t_p, m_time);
+    t_p = pack_fields(t_p, m_time_step);
+    t_p = pack_fields(t_p, m_stopped_event);
+    return pack_fields(t_p, m_stopped_step);
+  }
+  const char* loadClock(const char* t_p) {
+    t_p = unpack_fields(t_p, &m_time);
+    t_p = unpack_fields(t_p, &m_time_step);
+    t_p = unpack_fields(t_p, &m_stopped_event);
+    return unpack_fields(t_p, &m_stopped_step);
+  }
+
   // copy data
   Self& copy_data(const Data& t_data) { m_data.copy(t_data); }
   Self& copy_data(const Self& t_model) { this->copy_data(t_model.data()); }
 
   // update
+  // (the time advances only up to a terminal event if it stopped the step)
   virtual bool update() {
-    m_time += m_time_step;
+    m_time += m_stopped_step.value_or(m_time_step);
+    m_stopped_step = nullopt;
     return true;
   }
   virtual bool update(double t_time_step) {
@@ -123,16 +217,91 @@ class ModelBase {
     return update();
   }
 
+ protected:
+  // Integrate the state over the time step. If events are registered, the
+  // times when they occur within the step are located by re-integrating
+  // the state from the beginning of the step, which serves as the dense
+  // output of one-step solvers. The callbacks of the earliest events are
+  // dispatched there, and the integration resumes after them, so that they
+  // are able to switch the system. A terminal event ends the step at the
+  // located time instead.
+  StateArray integrate(const StateArray& t_state) {
+    m_stopped_event = nullopt;
+    m_stopped_step = nullopt;
+    double t0 = m_time;
+    double t1 = m_time + m_time_step;
+    StateArray x0 = t_state;
+    StateArray x1 = solve(x0, t0, m_time_step);
+    while (!m_events.empty()) {
+      auto n = m_events.size();
+      auto first = n;
+      for (std::size_t i = 0; i < n; ++i) {
+        const auto& e = m_events[i];
+        double g0 = e.evaluate(m_system, x0, t0);
+        double g1 = e.evaluate(m_system, x1, t1);
+        m_event_times[i] = std::numeric_limits<double>::infinity();
+        if (!e.isCrossed(g0, g1)) continue;
+        auto f = [&](double t) {
+          return e.evaluate(m_system, solve(x0, t0, t - t0), t);
+        };
+        m_event_times[i] = findEventTime(f, t0, t1, g0, g1, m_event_tolerance);
+        if (first == n || m_event_times[i] < m_event_times[first])
+          first = i;
+      }
+      if (first == n) break;
+      double te = m_event_times[first];
+      StateArray xe = solve(x0, t0, te - t0);
+      for (std::size_t i = 0; i < n; ++i) {
+        if (m_event_times[i] > te + m_event_tolerance) continue;
+        if (m_events[i].callback) m_events[i].callback(xe, te);
+        if (m_events[i].is_terminal && !m_stopped_event) m_stopped_event = i;
+      }
+      if (m_stopped_event) {
+        m_stopped_step = te - m_time;
+        return xe;
+      }
+      t0 = te;
+      x0 = xe;
+      if (t1 - t0 <= m_event_tolerance) return x0;
+      x1 = solve(x0, t0, t1 - t0);
+    }
+    return x1;
+  }
+
  private:
+  // system handed to the solver, which counts its evaluations
+  struct CountedSystem {
+    const System& system;
+    std::size_t& count;
+    StateArray operator()(const StateArray& t_x, double t_t) const {
+      ++count;
+      return system(t_x, t_t);
+    }
+  };
+
+  StateArray solve(const StateArray& t_x, double t_t, double t_dt) {
+    return m_solver.update(CountedSystem{m_system, m_evaluation_count}, t_x,
+                           t_t, t_dt);
+  }
+
   double m_time;
   double m_time_step;
   Data m_data;
   System m_system;
   Solver m_solver;
+  std::vector<Event> m_events;
+  std::vector<double> m_event_times;
+  double m_event_tolerance;
+  optional<std::size_t> m_stopped_event;
+  optional<double> m_stopped_step;
+  std::size_t m_evaluation_count;
 };
 
 template <typename State, typename Solver, typename Data, typename System>
 constexpr double ModelBase<State, Solver, Data, System>::default_time_step;
+template <typename State, typename Solver, typename Data, typename System>
+constexpr double
+    ModelBase<State, Solver, Data, System>::default_event_tolerance;
 
 template <typename T, typename = int>
 struct is_model_type : std::false_type {};
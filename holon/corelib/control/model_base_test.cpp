@@ -21,6 +21,7 @@
 #include "holon/corelib/control/model_base.hpp"
 
 #include <array>
+#include <vector>
 #include "holon/corelib/control/system_base.hpp"
 #include "holon/corelib/data/data_set_base.hpp"
 #include "holon/corelib/math/ode_euler.hpp"
@@ -166,5 +167,105 @@ TEST_CASE("Check copy_data in ModelBase", "[ModelBase][copy_data]") {
   SECTION("Overloaded function 2") { CheckCopyData_2(); }
 }
 
+// dp/dt = v, dv/dt = 1
+struct EventTestSystem : SystemBase<double, TestData> {
+  explicit EventTestSystem(TestData t_data) : SystemBase(t_data) {}
+  SystemBase::StateArray operator()(const StateArray& x,
+                                    const double) const final {
+    return StateArray{x[1], 1};
+  };
+};
+
+struct EventTestModel : ModelBase<double, Euler<std::array<double, 2>>,
+                                  TestData, EventTestSystem> {
+  EventTestModel() : ModelBase(make_data<TestData>()) {}
+  virtual bool update() override {
+    auto x = integrate(StateArray{states().p, states().v});
+    states().p = x[0];
+    states().v = x[1];
+    return ModelBase::update();
+  }
+};
+
+TEST_CASE("ModelBase locates events within a step", "[ModelBase][event]") {
+  const double te = 0.00035;
+  EventTestModel model;
+  std::vector<double> times;
+  std::vector<double> velocities;
+  auto callback = [&](const EventTestModel::StateArray& x, const double t) {
+    times.push_back(t);
+    velocities.push_back(x[1]);
+  };
+  auto g = [te](const EventTestModel::StateArray& x, const double) {
+    return x[1] - te;
+  };
+
+  SECTION("non-terminal event dispatches callback and completes step") {
+    REQUIRE(model.addEvent(g, callback) == 0);
+    REQUIRE(model.event_num() == 1);
+    model.update();
+    REQUIRE(times.size() == 1);
+    CHECK(times[0] == Approx(te).margin(1e-9));
+    CHECK(velocities[0] == Approx(te).margin(1e-9));
+    CHECK(model.time() == Approx(model.time_step()));
+    CHECK(model.states().v == Approx(model.time_step()));
+    CHECK_FALSE(model.stopped_event());
+    model.update();
+    CHECK(times.size() == 1);
+  }
+  SECTION("terminal event stops step") {
+    model.addEvent(g);
+    model.clearEvents();
+    REQUIRE(model.event_num() == 0);
+    model.addEvent([](const EventTestModel::StateArray&, const double) {
+      return 1.0;
+    });
+    REQUIRE(model.addEvent(g, callback, EventDirection::rising, true) == 1);
+    model.update();
+    REQUIRE(model.stopped_event());
+    CHECK(*model.stopped_event() == 1);
+    CHECK(model.time() == Approx(te).margin(1e-9));
+    CHECK(model.states().v == Approx(te).margin(1e-9));
+    model.update();
+    CHECK_FALSE(model.stopped_event());
+    CHECK(model.time() == Approx(te + model.time_step()).margin(1e-9));
+    CHECK(times.size() == 1);
+  }
+  SECTION("direction is respected") {
+    model.addEvent(g, callback, EventDirection::falling);
+    model.update();
+    CHECK(times.empty());
+  }
+  SECTION("events are dispatched in order of time") {
+    auto g2 = [](const EventTestModel::StateArray& x, const double) {
+      return x[1] - 0.0002;
+    };
+    model.addEvent(g, callback);
+    model.addEvent(g2, callback);
+    model.update();
+    REQUIRE(times.size() == 2);
+    CHECK(times[0] == Approx(0.0002).margin(1e-9));
+    CHECK(times[1] == Approx(te).margin(1e-9));
+  }
+}
+
+TEST_CASE("ModelBase counts evaluations of the system",
+          "[ModelBase][event]") {
+  EventTestModel model;
+  CHECK(model.evaluation_count() == 0);
+  model.update();
+  CHECK(model.evaluation_count() == 1);
+  model.update();
+  CHECK(model.evaluation_count() == 2);
+
+  SECTION("an event re-integrates the step to locate itself") {
+    model.addEvent([](const EventTestModel::StateArray& x, const double) {
+      return x[1] - 0.0025;
+    });
+    model.update();
+    CHECK(model.evaluation_count() > 3);
+  }
+}
+
 }  // namespace
 }  // namespace holon
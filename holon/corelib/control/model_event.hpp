@@ -0,0 +1,105 @@
+/* model_event - event detection within a step of model
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_MODEL_EVENT_HPP_
+#define HOLON_CONTROL_MODEL_EVENT_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+namespace holon {
+
+enum class EventDirection { rising, falling, both };
+
+// Event on the state of a model, which occurs when the event function
+// crosses zero in the given direction. The callback is dispatched at the
+// located time with the state there, and a terminal event stops the step.
+// An event function of the system is given the system of the model which
+// evaluates it, so that it remains valid in copies of the model.
+template <typename StateArray, typename System = std::nullptr_t>
+struct ModelEvent {
+  using Function = std::function<double(const StateArray&, const double)>;
+  using SystemFunction =
+      std::function<double(const System&, const StateArray&, const double)>;
+  using Callback = std::function<void(const StateArray&, const double)>;
+
+  Function function;
+  Callback callback;
+  EventDirection direction;
+  bool is_terminal;
+  SystemFunction system_function;
+
+  double evaluate(const System& t_system, const StateArray& t_state,
+                  const double t_time) const {
+    return system_function ? system_function(t_system, t_state, t_time)
+                           : function(t_state, t_time);
+  }
+
+  // A crossing is counted only when the value departs from non-zero, so
+  // that an event located exactly at the beginning of a step does not
+  // occur again.
+  bool isCrossed(double t_g0, double t_g1) const {
+    if (t_g0 == 0) return false;
+    bool rising = t_g0 < 0 && t_g1 >= 0;
+    bool falling = t_g0 > 0 && t_g1 <= 0;
+    switch (direction) {
+      case EventDirection::rising:
+        return rising;
+      case EventDirection::falling:
+        return falling;
+      default:
+        return rising || falling;
+    }
+  }
+};
+
+// Illinois variant of the regula falsi to find a root of f between t_a and
+// t_b, where f(t_a) and f(t_b) have opposite signs or f(t_b) is zero. The
+// returned time lies on the side of t_b within t_tol, i.e. just after the
+// crossing, so that the sign has already changed there.
+template <typename F>
+double findEventTime(F&& f, double t_a, double t_b, double t_fa, double t_fb,
+                     double t_tol, int t_max_iter = 100) {
+  int side = 0;
+  for (int i = 0; i < t_max_iter && t_b - t_a > t_tol && t_fb != 0; ++i) {
+    double c = (t_fa * t_b - t_fb * t_a) / (t_fa - t_fb);
+    // fall back to bisection if rounding pushes it out of the bracket
+    if (!(c > t_a && c < t_b)) c = 0.5 * (t_a + t_b);
+    double fc = f(c);
+    if (fc == 0) return c;
+    if (std::signbit(fc) == std::signbit(t_fb)) {
+      t_b = c;
+      t_fb = fc;
+      if (side == -1) t_fa *= 0.5;
+      side = -1;
+    } else {
+      t_a = c;
+      t_fa = fc;
+      if (side == 1) t_fb *= 0.5;
+      side = 1;
+    }
+  }
+  return t_b;
+}
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_MODEL_EVENT_HPP_
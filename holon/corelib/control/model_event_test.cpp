@@ -0,0 +1,90 @@
+/* model_event - event detection within a step of model
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/model_event.hpp"
+
+#include <array>
+#include <cmath>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Event = ModelEvent<std::array<double, 2>>;
+
+TEST_CASE("ModelEvent::isCrossed", "[ModelEvent]") {
+  Event rising{nullptr, nullptr, EventDirection::rising, false, nullptr};
+  Event falling{nullptr, nullptr, EventDirection::falling, false, nullptr};
+  Event both{nullptr, nullptr, EventDirection::both, false, nullptr};
+  SECTION("rising") {
+    CHECK(rising.isCrossed(-1, 1));
+    CHECK(rising.isCrossed(-1, 0));
+    CHECK_FALSE(rising.isCrossed(1, -1));
+    CHECK_FALSE(rising.isCrossed(-1, -0.5));
+  }
+  SECTION("falling") {
+    CHECK(falling.isCrossed(1, -1));
+    CHECK(falling.isCrossed(1, 0));
+    CHECK_FALSE(falling.isCrossed(-1, 1));
+    CHECK_FALSE(falling.isCrossed(1, 0.5));
+  }
+  SECTION("both") {
+    CHECK(both.isCrossed(-1, 1));
+    CHECK(both.isCrossed(1, -1));
+    CHECK_FALSE(both.isCrossed(1, 2));
+  }
+  SECTION("departing from zero is not a crossing") {
+    CHECK_FALSE(rising.isCrossed(0, 1));
+    CHECK_FALSE(falling.isCrossed(0, -1));
+    CHECK_FALSE(both.isCrossed(0, 1));
+  }
+}
+
+TEST_CASE("findEventTime", "[ModelEvent]") {
+  const double tol = 1e-12;
+  SECTION("root of nonlinear function") {
+    int count = 0;
+    auto f = [&count](double t) {
+      ++count;
+      return t * t - 2;
+    };
+    double t = findEventTime(f, 1, 2, f(1), f(2), tol);
+    CHECK(t == Approx(std::sqrt(2)).epsilon(1e-12));
+    CHECK(t >= std::sqrt(2));
+    CHECK(count < 20);
+  }
+  SECTION("returned time lies after the crossing") {
+    Fuzzer fuzz(0.1, 0.9);
+    double root = fuzz();
+    auto f = [root](double t) { return std::exp(-(t - root)) - 1; };
+    double t = findEventTime(f, 0, 1, f(0), f(1), tol);
+    CHECK(t == Approx(root));
+    CHECK(f(t) <= 0);
+  }
+  SECTION("root at the end of the interval") {
+    auto f = [](double t) { return t - 1; };
+    CHECK(findEventTime(f, 0, 1, f(0), f(1), tol) == 1);
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,194 @@
+/* multi_rate_ctrl - composition of controllers running at different rates
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/multi_rate_ctrl.hpp"
+
+#include <zm/zm_misc.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace holon {
+
+struct MultiRateCtrl::Tier {
+  std::function<bool(double)> update;
+  std::size_t ratio;
+  bool offload;
+  std::vector<std::function<void()>> reads;
+  std::vector<std::function<void()>> writes;
+  std::atomic<std::size_t> update_count;
+  std::atomic<std::size_t> overrun_count;
+
+  // worker thread of an offloaded tier
+  std::thread worker;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::atomic<bool> running;
+  std::atomic<bool> busy;
+  std::atomic<bool> failed;
+
+  Tier(std::function<bool(double)> t_update, std::size_t t_ratio,
+       bool t_offload)
+      : update(std::move(t_update)),
+        ratio(t_ratio),
+        offload(t_offload),
+        update_count(0),
+        overrun_count(0),
+        running(false),
+        busy(false),
+        failed(false) {}
+
+  bool run(double t_time_step) {
+    for (auto& read : reads) read();
+    bool result = update(t_time_step);
+    for (auto& write : writes) write();
+    ++update_count;
+    return result;
+  }
+
+  void start(double t_time_step) {
+    if (!offload || running) return;
+    running = true;
+    worker = std::thread([this, t_time_step] { work(t_time_step); });
+  }
+
+  void stop() {
+    if (!running) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running = false;
+    }
+    cv.notify_one();
+    worker.join();
+  }
+
+  // returns false if the worker is still busy
+  bool kick() {
+    if (busy.load(std::memory_order_acquire)) return false;
+    {
+      // the worker holds the lock only while it checks busy, and setting
+      // busy under the lock makes sure that it sees either the flag or the
+      // notification
+      std::lock_guard<std::mutex> lock(mutex);
+      busy.store(true, std::memory_order_release);
+    }
+    cv.notify_one();
+    return true;
+  }
+
+  void work(double t_time_step) {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return busy || !running; });
+        // finish the last kick before quitting
+        if (!busy) {
+          if (!running) return;
+          continue;
+        }
+      }
+      if (!run(t_time_step)) failed = true;
+      busy.store(false, std::memory_order_release);
+    }
+  }
+};
+
+constexpr double MultiRateCtrl::default_time_step;
+
+MultiRateCtrl::MultiRateCtrl(double t_time_step)
+    : m_time_step(t_time_step), m_tick(0), m_tiers(), m_started(false) {}
+
+MultiRateCtrl::~MultiRateCtrl() { stop(); }
+
+std::size_t MultiRateCtrl::ratio(std::size_t t_tier) const {
+  return isValidTier(t_tier) ? m_tiers[t_tier]->ratio : 0;
+}
+
+bool MultiRateCtrl::is_offloaded(std::size_t t_tier) const {
+  return isValidTier(t_tier) && m_tiers[t_tier]->offload;
+}
+
+bool MultiRateCtrl::is_busy(std::size_t t_tier) const {
+  return isValidTier(t_tier) && m_tiers[t_tier]->busy;
+}
+
+std::size_t MultiRateCtrl::update_count(std::size_t t_tier) const {
+  return isValidTier(t_tier) ? m_tiers[t_tier]->update_count.load() : 0;
+}
+
+std::size_t MultiRateCtrl::overrun_count(std::size_t t_tier) const {
+  return isValidTier(t_tier) ? m_tiers[t_tier]->overrun_count.load() : 0;
+}
+
+void MultiRateCtrl::start() {
+  for (auto& tier : m_tiers) tier->start(tier->ratio * m_time_step);
+  m_started = true;
+}
+
+void MultiRateCtrl::stop() {
+  for (auto& tier : m_tiers) tier->stop();
+  m_started = false;
+}
+
+bool MultiRateCtrl::update() {
+  bool result = true;
+  if (!m_started) start();
+  for (auto& tier : m_tiers) {
+    if (m_tick % tier->ratio == 0) {
+      if (!tier->offload)
+        result = tier->run(tier->ratio * m_time_step) && result;
+      else if (!tier->kick())
+        ++tier->overrun_count;
+    }
+    if (tier->offload && tier->failed.exchange(false)) result = false;
+  }
+  ++m_tick;
+  return result;
+}
+
+std::size_t MultiRateCtrl::addTier(std::function<bool(double)> t_update,
+                                   std::size_t t_ratio, bool t_offload) {
+  // workers are restarted on the next update
+  stop();
+  m_tiers.emplace_back(
+      new Tier(std::move(t_update), t_ratio > 0 ? t_ratio : 1, t_offload));
+  return m_tiers.size() - 1;
+}
+
+MultiRateCtrl& MultiRateCtrl::addLink(std::size_t t_from,
+                                      std::function<void()> t_write,
+                                      std::size_t t_to,
+                                      std::function<void()> t_read) {
+  if (!isValidTier(t_from) || !isValidTier(t_to)) return *this;
+  stop();
+  m_tiers[t_from]->writes.push_back(std::move(t_write));
+  m_tiers[t_to]->reads.push_back(std::move(t_read));
+  return *this;
+}
+
+bool MultiRateCtrl::isValidTier(std::size_t t_tier) const {
+  if (t_tier < m_tiers.size()) return true;
+  ZRUNERROR("tier %zu does not exist (number of tiers: %zu)", t_tier,
+            m_tiers.size());
+  return false;
+}
+
+}  // namespace holon
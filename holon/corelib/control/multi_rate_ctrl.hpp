@@ -0,0 +1,166 @@
+/* multi_rate_ctrl - composition of controllers running at different rates
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_MULTI_RATE_CTRL_HPP_
+#define HOLON_CONTROL_MULTI_RATE_CTRL_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace holon {
+
+// Mailbox passes a value from one thread to another through three
+// preallocated slots (triple buffering). The writer fills back() and posts
+// it, and the reader fetches the latest posted value into front(). Neither
+// of them ever waits for the other; values posted in between are lost.
+template <typename T>
+class Mailbox {
+  static constexpr unsigned kIndex = 3;
+  static constexpr unsigned kFresh = 4;
+
+ public:
+  explicit Mailbox(const T& t_value = T())
+      : m_slots{{t_value, t_value, t_value}},
+        m_middle(0),
+        m_back(1),
+        m_front(2) {}
+
+  // writer side
+  inline T& back() noexcept { return m_slots[m_back]; }
+  void post() {
+    m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) &
+             kIndex;
+  }
+
+  // reader side; returns true if a new value has come
+  bool fetch() {
+    if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) return false;
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+    return true;
+  }
+  inline const T& front() const noexcept { return m_slots[m_front]; }
+
+ private:
+  std::array<T, 3> m_slots;
+  std::atomic<unsigned> m_middle;
+  unsigned m_back;
+  unsigned m_front;
+};
+
+template <typename T>
+constexpr unsigned Mailbox<T>::kIndex;
+template <typename T>
+constexpr unsigned Mailbox<T>::kFresh;
+
+// MultiRateCtrl updates controllers, namely tiers, at integer ratios of the
+// base time step, e.g. a planner every 10 ticks, a balancer every tick of
+// 1 ms and so on. On a tick, tiers due run in order of addition with the
+// time step multiplied by their ratios, so that a tier added earlier passes
+// its outputs to those added later within the same tick. Data are passed
+// between tiers through mailboxes by links, which copy data out of a tier
+// after its update and into another tier before its update.
+//
+// A tier can be offloaded to a worker thread. On its tick the worker is
+// only kicked, and the tick is skipped and counted as an overrun if the
+// worker is still busy, so that a slow tier never blocks faster ones. All
+// the links into and out of an offloaded tier are processed in the worker.
+class MultiRateCtrl {
+  using Self = MultiRateCtrl;
+
+ public:
+  static constexpr double default_time_step = 0.001;
+
+ public:
+  explicit MultiRateCtrl(double t_time_step = default_time_step);
+  ~MultiRateCtrl();
+  MultiRateCtrl(const Self&) = delete;
+  Self& operator=(const Self&) = delete;
+
+  // accessors
+  inline double time_step() const noexcept { return m_time_step; }
+  inline double time() const noexcept { return m_tick * m_time_step; }
+  inline std::size_t tick_count() const noexcept { return m_tick; }
+  inline std::size_t tier_num() const noexcept { return m_tiers.size(); }
+  std::size_t ratio(std::size_t t_tier) const;
+  bool is_offloaded(std::size_t t_tier) const;
+  // whether the worker of an offloaded tier is updating it
+  bool is_busy(std::size_t t_tier) const;
+  std::size_t update_count(std::size_t t_tier) const;
+  std::size_t overrun_count(std::size_t t_tier) const;
+
+  // add a controller updated every t_ratio ticks and return its index;
+  // the controller is referred to and must outlive this object
+  template <typename Ctrl>
+  std::size_t add(Ctrl& t_ctrl, std::size_t t_ratio = 1,
+                  bool t_offload = false) {
+    return addTier(
+        [&t_ctrl](double t_time_step) { return t_ctrl.update(t_time_step); },
+        t_ratio, t_offload);
+  }
+
+  // connect t_from to t_to with a mailbox of T; t_write copies data out of
+  // t_from into the mailbox, and t_read copies it into t_to
+  template <typename T>
+  Self& connect(std::size_t t_from, std::function<void(T*)> t_write,
+                std::size_t t_to, std::function<void(const T&)> t_read,
+                const T& t_initial_value = T()) {
+    auto mailbox = std::make_shared<Mailbox<T>>(t_initial_value);
+    return addLink(
+        t_from,
+        [mailbox, t_write] {
+          t_write(&mailbox->back());
+          mailbox->post();
+        },
+        t_to,
+        [mailbox, t_read] {
+          if (mailbox->fetch()) t_read(mailbox->front());
+        });
+  }
+
+  // start / stop worker threads of offloaded tiers; update() starts them
+  // if not yet
+  void start();
+  void stop();
+
+  // proceed one tick; returns false if any tier has failed to update
+  bool update();
+
+ private:
+  struct Tier;
+
+  double m_time_step;
+  std::size_t m_tick;
+  std::vector<std::unique_ptr<Tier>> m_tiers;
+  bool m_started;
+
+  std::size_t addTier(std::function<bool(double)> t_update,
+                      std::size_t t_ratio, bool t_offload);
+  Self& addLink(std::size_t t_from, std::function<void()> t_write,
+                std::size_t t_to, std::function<void()> t_read);
+  bool isValidTier(std::size_t t_tier) const;
+};
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_MULTI_RATE_CTRL_HPP_
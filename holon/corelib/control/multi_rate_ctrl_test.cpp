@@ -0,0 +1,193 @@
+/* multi_rate_ctrl - composition of controllers running at different rates
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/multi_rate_ctrl.hpp"
+
+#include <atomic>
+#include <thread>
+#include "holon/corelib/control/pd_ctrl.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Ctrl = PdCtrl<double>;
+using Outputs = PdCtrlOutputsRawData<double>;
+
+// a planner which does not finish its update until it is released
+class GatedCtrl : public Ctrl {
+ public:
+  GatedCtrl() : m_released(false) {}
+  virtual bool update(double dt) override {
+    while (!m_released) std::this_thread::yield();
+    return Ctrl::update(dt);
+  }
+  void release() { m_released = true; }
+
+ private:
+  std::atomic<bool> m_released;
+};
+
+void connect(MultiRateCtrl* composite, std::size_t from, Ctrl* planner,
+             std::size_t to, Ctrl* servo) {
+  composite->connect<Outputs>(
+      from, [planner](Outputs* out) { *out = planner->outputs(); }, to,
+      [servo](const Outputs& in) {
+        servo->refs().position = in.position;
+        servo->refs().velocity = in.velocity;
+      });
+}
+
+TEST_CASE("Mailbox: pass the latest value", "[Mailbox]") {
+  Mailbox<int> mailbox(-1);
+  CHECK_FALSE(mailbox.fetch());
+  CHECK(mailbox.front() == -1);
+  mailbox.back() = 1;
+  mailbox.post();
+  mailbox.back() = 2;
+  mailbox.post();
+  REQUIRE(mailbox.fetch());
+  CHECK(mailbox.front() == 2);
+  CHECK_FALSE(mailbox.fetch());
+  CHECK(mailbox.front() == 2);
+  mailbox.back() = 3;
+  mailbox.post();
+  REQUIRE(mailbox.fetch());
+  CHECK(mailbox.front() == 3);
+}
+
+TEST_CASE("Mailbox: values are not torn across threads", "[Mailbox]") {
+  const int n = 100000;
+  Mailbox<std::array<int, 16>> mailbox;
+  std::thread writer([&mailbox] {
+    for (int i = 1; i <= n; ++i) {
+      mailbox.back().fill(i);
+      mailbox.post();
+    }
+  });
+  bool consistent = true;
+  int last = 0;
+  while (last < n) {
+    if (!mailbox.fetch()) continue;
+    const auto& v = mailbox.front();
+    for (auto e : v) consistent = consistent && e == v[0];
+    consistent = consistent && v[0] > last;
+    last = v[0];
+  }
+  writer.join();
+  CHECK(consistent);
+}
+
+TEST_CASE("MultiRateCtrl: update tiers at integer ratios",
+          "[MultiRateCtrl]") {
+  Fuzzer fuzz(0.5, 1.5);
+  Ctrl planner, servo;
+  planner.refs().position = fuzz();
+  planner.refs().stiffness = 10;
+  planner.refs().damping = 6;
+  servo.refs().stiffness = 400;
+  servo.refs().damping = 40;
+
+  MultiRateCtrl composite(0.001);
+  auto i_planner = composite.add(planner, 10);
+  auto i_servo = composite.add(servo);
+  connect(&composite, i_planner, &planner, i_servo, &servo);
+  REQUIRE(composite.tier_num() == 2);
+  CHECK(composite.ratio(i_planner) == 10);
+  CHECK_FALSE(composite.is_offloaded(i_planner));
+
+  for (int i = 0; i < 25; ++i) {
+    double ref = servo.refs().position;
+    REQUIRE(composite.update());
+    if (i % 10 == 0)
+      CHECK(servo.refs().position == planner.outputs().position);
+    else
+      CHECK(servo.refs().position == ref);
+  }
+  CHECK(composite.tick_count() == 25);
+  CHECK(composite.time() == Approx(0.025));
+  CHECK(composite.update_count(i_planner) == 3);
+  CHECK(composite.update_count(i_servo) == 25);
+  CHECK(planner.time() == Approx(0.03));
+  CHECK(servo.time() == Approx(0.025));
+
+  for (int i = 0; i < 10000; ++i) composite.update();
+  CHECK(servo.states().position ==
+        Approx(planner.refs().position).epsilon(1e-3));
+}
+
+TEST_CASE("MultiRateCtrl: slow tier offloaded to worker thread",
+          "[MultiRateCtrl]") {
+  GatedCtrl planner;
+  Ctrl servo;
+  planner.refs().position = 1;
+  servo.refs().stiffness = 400;
+  servo.refs().damping = 40;
+
+  MultiRateCtrl composite(0.001);
+  auto i_planner = composite.add(planner, 2, true);
+  auto i_servo = composite.add(servo);
+  connect(&composite, i_planner, &planner, i_servo, &servo);
+  CHECK(composite.is_offloaded(i_planner));
+
+  // the servo goes on while the planner is stuck in its first update, and
+  // the other 49 ticks of the planner are skipped
+  for (int i = 0; i < 100; ++i) REQUIRE(composite.update());
+  CHECK(composite.update_count(i_servo) == 100);
+  CHECK(composite.update_count(i_planner) == 0);
+  CHECK(composite.overrun_count(i_planner) == 49);
+
+  planner.release();
+  composite.stop();
+  CHECK(composite.update_count(i_planner) == 1);
+  CHECK(planner.time() == Approx(0.002));
+
+  // the worker is kicked again once it has finished
+  planner.refs().position = 2;
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(composite.update());
+    while (composite.is_busy(i_planner)) std::this_thread::yield();
+  }
+  composite.stop();
+  CHECK(composite.update_count(i_planner) == 51);
+  CHECK(composite.overrun_count(i_planner) == 49);
+  CHECK(servo.refs().position == planner.outputs().position);
+}
+
+TEST_CASE("MultiRateCtrl: reject tiers that do not exist",
+          "[MultiRateCtrl]") {
+  Ctrl planner, servo;
+  MultiRateCtrl composite;
+  auto i_planner = composite.add(planner, 10);
+  zEchoOff();
+  CHECK(composite.ratio(1) == 0);
+  CHECK_FALSE(composite.is_offloaded(1));
+  CHECK(composite.update_count(1) == 0);
+  CHECK(composite.overrun_count(1) == 0);
+  connect(&composite, i_planner, &planner, 1, &servo);
+  zEchoOn();
+  CHECK(composite.update());
+  CHECK(composite.ratio(i_planner) == 10);
+}
+
+}  // namespace
+}  // namespace holon
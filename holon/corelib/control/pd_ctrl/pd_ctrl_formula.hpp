@@ -26,9 +26,9 @@
 namespace holon {
 namespace pd_ctrl_formula {
 
-inline double computeDesForce(const double& t_x, const double& t_v,
-                              const double& t_xd, const double& t_vd,
-                              const double& t_k, const double& t_c) {
+template <typename T>
+inline T computeDesForce(const T& t_x, const T& t_v, const T& t_xd,
+                         const T& t_vd, const T& t_k, const T& t_c) {
   return t_k * (t_xd - t_x) + t_c * (t_vd - t_v);
 }
 
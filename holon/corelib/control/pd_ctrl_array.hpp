@@ -0,0 +1,43 @@
+/* pd_ctrl_array - batched PD controllers over independent point masses
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_PD_CTRL_ARRAY_HPP_
+#define HOLON_CONTROL_PD_CTRL_ARRAY_HPP_
+
+#include <cstddef>
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/math/batch.hpp"
+
+namespace holon {
+
+// PdCtrlArray runs N independent PD-controlled point masses as a single
+// system whose state lanes are stored contiguously (structure of arrays).
+// One tick performs one Runge-Kutta step and one force evaluation for all
+// the lanes, and each lane follows exactly the same arithmetic as
+// PdCtrl<double>. Note that the mass is shared among the lanes.
+template <std::size_t N>
+using PdCtrlArrayState = Batch<N, double>;
+
+template <std::size_t N>
+using PdCtrlArray = PdCtrl<PdCtrlArrayState<N>>;
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_PD_CTRL_ARRAY_HPP_
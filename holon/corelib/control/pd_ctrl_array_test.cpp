@@ -0,0 +1,95 @@
+/* pd_ctrl_array - batched PD controllers over independent point masses
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/pd_ctrl_array.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kLanes = 8;
+using State = PdCtrlArrayState<kLanes>;
+
+TEST_CASE("PdCtrlArray matches independent scalar PdCtrl instances",
+          "[PdCtrlArray][update]") {
+  Fuzzer fuzz;
+  Fuzzer fuzz_gain(0, 100);
+  double mass = Fuzzer(0.1, 10).get<double>();
+
+  PointMassModel<State> model(State{0}, mass);
+  std::array<PointMassModel<double>, kLanes> scalar_models;
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    model.states().position[i] = fuzz();
+    model.states().velocity[i] = fuzz();
+    scalar_models[i].states().mass = mass;
+    scalar_models[i].states().position = model.states().position[i];
+    scalar_models[i].states().velocity = model.states().velocity[i];
+  }
+  PdCtrlArray<kLanes> ctrl(model);
+  std::vector<std::unique_ptr<PdCtrl<double>>> scalar_ctrls;
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    scalar_ctrls.emplace_back(new PdCtrl<double>(scalar_models[i]));
+    auto& c = *scalar_ctrls.back();
+    ctrl.refs().position[i] = c.refs().position = fuzz();
+    ctrl.refs().velocity[i] = c.refs().velocity = fuzz();
+    ctrl.refs().stiffness[i] = c.refs().stiffness = fuzz_gain();
+    ctrl.refs().damping[i] = c.refs().damping = fuzz_gain();
+  }
+
+  for (auto step = 0; step < 100; ++step) {
+    ctrl.update();
+    for (auto& c : scalar_ctrls) c->update();
+  }
+  for (std::size_t i = 0; i < kLanes; ++i) {
+    INFO("lane " << i);
+    const auto& c = *scalar_ctrls[i];
+    CHECK(ctrl.time() == c.time());
+    CHECK(ctrl.outputs().position[i] == c.outputs().position);
+    CHECK(ctrl.outputs().velocity[i] == c.outputs().velocity);
+    CHECK(ctrl.outputs().acceleration[i] == c.outputs().acceleration);
+    CHECK(ctrl.outputs().force[i] == c.outputs().force);
+  }
+}
+
+TEST_CASE("PdCtrlArray is reset to the initial positions",
+          "[PdCtrlArray][reset]") {
+  Fuzzer fuzz;
+  State p0;
+  for (auto& p : p0) p = fuzz();
+  PdCtrlArray<kLanes> ctrl(PointMassModel<State>{p0});
+  ctrl.refs().position = State{1};
+  ctrl.refs().stiffness = State{10};
+  ctrl.update();
+  REQUIRE(ctrl.states().position != p0);
+  ctrl.reset();
+  CHECK(ctrl.time() == 0.0);
+  CHECK(ctrl.states().position == p0);
+  CHECK(ctrl.states().velocity == State{0});
+  CHECK(ctrl.refs().position == p0);
+}
+
+}  // namespace
+}  // namespace holon
@@ -21,9 +21,11 @@
 #include "holon/corelib/control/pd_ctrl.hpp"
 
 #include <memory>
+#include "holon/corelib/math/dual.hpp"
 #include "holon/corelib/math/vec3d.hpp"
 
 #include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
 namespace holon {
@@ -147,6 +149,23 @@ TEST_CASE("Outputs should be updated after calling update of PdCtrl",
   CheckOutputsAfterUpdate<Vec3D>();
 }
 
+template <typename T>
+void CheckNoAllocationsInUpdate() {
+  Fuzzer fuzz;
+  PdCtrl<T> ctrl;
+  ctrl.refs().position = fuzz.get<T>();
+  ctrl.refs().stiffness = T{100};
+  ctrl.refs().damping = T{10};
+  REQUIRE(ctrl.update());
+  REQUIRE_NO_ALLOCATIONS(for (auto i = 0; i < 10; ++i) ctrl.update());
+}
+
+TEST_CASE("PdCtrl::update does not allocate memory after warmup",
+          "[PdCtrl][update]") {
+  CheckNoAllocationsInUpdate<double>();
+  CheckNoAllocationsInUpdate<Vec3D>();
+}
+
 SCENARIO("Point mass is converged at the desired position with PD contrl",
          "[PdCtrl][update]") {
   GIVEN("Point mass is currently at 0, desired position is 1") {
@@ -185,5 +204,35 @@ SCENARIO("Point mass is converged at the desired position with PD contrl",
   }
 }
 
+double positionAfterRollout(double t_stiffness, double t_damping) {
+  PdCtrl<double> ctrl;
+  ctrl.refs().position = 1;
+  ctrl.refs().stiffness = t_stiffness;
+  ctrl.refs().damping = t_damping;
+  while (ctrl.time() < 0.5) ctrl.update();
+  return ctrl.states().position;
+}
+
+TEST_CASE("Gradients of PdCtrl rollout with respect to gains",
+          "[PdCtrl][update][Dual]") {
+  const double k = 100, c = 10, eps = 1e-5;
+  PdCtrl<Dual<2>> ctrl;
+  ctrl.refs().position = 1;
+  ctrl.refs().stiffness = make_dual<2>(k, 0);
+  ctrl.refs().damping = make_dual<2>(c, 1);
+  while (ctrl.time() < 0.5) ctrl.update();
+
+  double dxdk = (positionAfterRollout(k + eps, c) -
+                 positionAfterRollout(k - eps, c)) /
+                (2 * eps);
+  double dxdc = (positionAfterRollout(k, c + eps) -
+                 positionAfterRollout(k, c - eps)) /
+                (2 * eps);
+  CHECK(ctrl.states().position.value() ==
+        Approx(positionAfterRollout(k, c)));
+  CHECK(ctrl.states().position.grad(0) == Approx(dxdk).epsilon(1e-4));
+  CHECK(ctrl.states().position.grad(1) == Approx(dxdc).epsilon(1e-4));
+}
+
 }  // namespace
 }  // namespace holon
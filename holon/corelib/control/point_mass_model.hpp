@@ -83,8 +83,7 @@ class PointMassModel : public ModelBase<State, Solver, Data, System> {
   // update
   virtual bool update() override {
     StateArray state{{this->states().position, this->states().velocity}};
-    state = this->solver().update(this->system(), state, this->time(),
-                                  this->time_step());
+    state = this->integrate(state);
     this->states().force = this->system().force(
         this->states().position, this->states().velocity, this->time());
     this->states().acceleration = this->system().acceleration(
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/data/fields.hpp"
 
 namespace holon {
 
@@ -33,6 +34,9 @@ struct PointMassModelRawData {
   State velocity;
   State acceleration;
   State force;
+
+  HOLON_DEFINE_FIELDS(PointMassModelRawData, mass, position, velocity,
+                      acceleration, force)
 };
 
 template <typename State>
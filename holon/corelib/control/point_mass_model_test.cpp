@@ -20,6 +20,9 @@
 
 #include "holon/corelib/control/point_mass_model.hpp"
 
+#include <array>
+#include <cmath>
+
 #include "catch.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
@@ -301,5 +304,24 @@ TEST_CASE("Check if data is updated after update of PointMassModel",
   CheckDataAfterUpdate<Vec3D>();
 }
 
+TEST_CASE("PointMassModel stops at terminal event", "[PointMassModel][event]") {
+  // falling from height h touches the ground at sqrt(2 h / g)
+  const double h = 0.3, g = 9.8;
+  Model<double> model(h);
+  model.setAccelerationCallback([g](const double&, const double&,
+                                    const double) { return -g; });
+  std::size_t touchdown = model.addEvent(
+      [](const std::array<double, 2>& x, const double) { return x[0]; },
+      nullptr, EventDirection::falling, true);
+  model.set_time_step(0.01);
+  int count = 0;
+  while (!model.stopped_event() && count++ < 1000) model.update();
+  REQUIRE(model.stopped_event());
+  CHECK(*model.stopped_event() == touchdown);
+  CHECK(model.time() == Approx(std::sqrt(2 * h / g)));
+  CHECK(model.states().position == Approx(0).margin(1e-9));
+  CHECK(model.states().velocity == Approx(-std::sqrt(2 * g * h)));
+}
+
 }  // namespace
 }  // namespace holon
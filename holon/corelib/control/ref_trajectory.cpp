@@ -0,0 +1,180 @@
+/* ref_trajectory - precomputed reference trajectory
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/ref_trajectory.hpp"
+
+#include <zm/zm_ip.h>
+#include <zm/zm_misc.h>
+#include <algorithm>
+
+namespace holon {
+
+constexpr std::size_t RefTrajectory::coefficient_num;
+
+const RefTrajectory::Segment* RefTrajectory::Cursor::seek(double t_time) {
+  const auto& segments = m_trajectory->m_segments;
+  if (segments.empty()) return nullptr;
+  if (m_segment >= segments.size() || t_time < segments[m_segment].start)
+    m_segment = 0;
+  while (m_segment + 1 < segments.size() &&
+         !(t_time < segments[m_segment + 1].start))
+    ++m_segment;
+  return &segments[m_segment];
+}
+
+double RefTrajectory::Cursor::value(double t_time) {
+  const Segment* seg = seek(t_time);
+  if (!seg) return 0;
+  double s = std::max(t_time - seg->start, 0.0);
+  const double* c = seg->c;
+  return c[0] + s * (c[1] + s * (c[2] + s * (c[3] + s * (c[4] + s * c[5]))));
+}
+
+double RefTrajectory::Cursor::velocity(double t_time) {
+  const Segment* seg = seek(t_time);
+  if (!seg || t_time < seg->start) return 0;
+  double s = t_time - seg->start;
+  const double* c = seg->c;
+  return c[1] +
+         s * (2 * c[2] + s * (3 * c[3] + s * (4 * c[4] + s * 5 * c[5])));
+}
+
+double RefTrajectory::Cursor::acceleration(double t_time) {
+  const Segment* seg = seek(t_time);
+  if (!seg || t_time < seg->start) return 0;
+  double s = t_time - seg->start;
+  const double* c = seg->c;
+  return 2 * c[2] + s * (6 * c[3] + s * (12 * c[4] + s * 20 * c[5]));
+}
+
+double RefTrajectory::start_time() const {
+  return m_segments.empty() ? 0 : m_segments.front().start;
+}
+
+double RefTrajectory::end_time() const {
+  return m_segments.empty() ? 0 : m_segments.back().start;
+}
+
+bool RefTrajectory::isValid(const std::vector<Knot>& t_knots) const {
+  if (t_knots.empty()) {
+    ZRUNERROR("At least one knot is required.");
+    return false;
+  }
+  for (std::size_t i = 1; i < t_knots.size(); ++i) {
+    if (!(t_knots[i - 1].time < t_knots[i].time)) {
+      ZRUNERROR("Knots must be in increasing order of time. (given: %f, %f)",
+                t_knots[i - 1].time, t_knots[i].time);
+      return false;
+    }
+  }
+  return true;
+}
+
+void RefTrajectory::appendHold(const Knot& t_knot) {
+  m_segments.push_back(Segment{t_knot.time, {t_knot.value, 0, 0, 0, 0, 0}});
+}
+
+// x(s) = x0 + d (10 r^3 - 15 r^4 + 6 r^5), r = s / T
+bool RefTrajectory::buildMinJerk(const std::vector<Knot>& t_knots) {
+  if (!isValid(t_knots)) return false;
+  m_segments.clear();
+  m_segments.reserve(t_knots.size());
+  for (std::size_t i = 0; i + 1 < t_knots.size(); ++i) {
+    double T = t_knots[i + 1].time - t_knots[i].time;
+    double d = t_knots[i + 1].value - t_knots[i].value;
+    double T3 = T * T * T;
+    m_segments.push_back(Segment{t_knots[i].time,
+                                 {t_knots[i].value, 0, 0, 10 * d / T3,
+                                  -15 * d / (T3 * T), 6 * d / (T3 * T * T)}});
+  }
+  appendHold(t_knots.back());
+  return true;
+}
+
+// A step at t_i is smoothed over [t_i, t_i + r_i], where r_i is t_ramp
+// clipped by the next knot, and the value is held until the next step.
+bool RefTrajectory::buildSmoothSteps(const std::vector<Knot>& t_knots,
+                                     double t_ramp) {
+  if (!isValid(t_knots)) return false;
+  if (t_ramp <= 0) {
+    ZRUNERROR("Ramp duration must be positive. (given: %f)", t_ramp);
+    return false;
+  }
+  std::vector<Knot> knots{t_knots.front()};
+  for (std::size_t i = 1; i < t_knots.size(); ++i) {
+    if (knots.back().time < t_knots[i].time)
+      knots.push_back(Knot{t_knots[i].time, knots.back().value});
+    double end = t_knots[i].time + t_ramp;
+    if (i + 1 < t_knots.size()) end = std::min(end, t_knots[i + 1].time);
+    knots.push_back(Knot{end, t_knots[i].value});
+  }
+  return buildMinJerk(knots);
+}
+
+// The velocities at knots are solved by zm, and each segment is the cubic
+// Hermite polynomial determined by the values and velocities at its ends.
+bool RefTrajectory::buildCubicSpline(const std::vector<Knot>& t_knots,
+                                     double t_start_velocity,
+                                     double t_end_velocity) {
+  if (!isValid(t_knots)) return false;
+  m_segments.clear();
+  if (t_knots.size() == 1) {
+    appendHold(t_knots.front());
+    return true;
+  }
+  zSeq seq;
+  zSeqInit(&seq);
+  for (std::size_t i = 0; i < t_knots.size(); ++i) {
+    double dt = i == 0 ? 0 : t_knots[i].time - t_knots[i - 1].time;
+    if (!zSeqEnqueue(&seq, zVecCreateList(1, t_knots[i].value), dt)) {
+      zSeqFree(&seq);
+      return false;
+    }
+  }
+  zVec v0 = zVecCreateList(1, t_start_velocity);
+  zVec v1 = zVecCreateList(1, t_end_velocity);
+  zVec vel = zVecAlloc(1);
+  zIP ip;
+  bool result =
+      zIPCreateSpline(&ip, &seq, ZSPLINE_FIX_EDGE, v0, ZSPLINE_FIX_EDGE, v1);
+  if (result) {
+    m_segments.reserve(t_knots.size());
+    double prev_velocity = zVecElem(zIPSecVel(&ip, 0, vel), 0);
+    for (std::size_t i = 0; i + 1 < t_knots.size(); ++i) {
+      double h = t_knots[i + 1].time - t_knots[i].time;
+      double p0 = t_knots[i].value;
+      double p1 = t_knots[i + 1].value;
+      double u0 = prev_velocity;
+      double u1 = zVecElem(zIPSecVel(&ip, static_cast<int>(i + 1), vel), 0);
+      m_segments.push_back(
+          Segment{t_knots[i].time,
+                  {p0, u0, (3 * (p1 - p0) / h - 2 * u0 - u1) / h,
+                   (2 * (p0 - p1) / h + u0 + u1) / (h * h), 0, 0}});
+      prev_velocity = u1;
+    }
+    appendHold(t_knots.back());
+    zIPDestroy(&ip);
+  }
+  zVecFreeAO(3, v0, v1, vel);
+  zSeqFree(&seq);
+  return result;
+}
+
+}  // namespace holon
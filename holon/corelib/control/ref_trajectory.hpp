@@ -0,0 +1,103 @@
+/* ref_trajectory - precomputed reference trajectory
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_REF_TRAJECTORY_HPP_
+#define HOLON_CONTROL_REF_TRAJECTORY_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace holon {
+
+// Reference trajectory of a scalar precomputed into a table of polynomial
+// segments, where the k-th coefficient of a segment multiplies the k-th
+// power of the time since its start. The value is held at the first knot
+// before it and at the last knot after it. A Cursor evaluates the table in
+// O(1) per tick without search or allocation, as long as the time moves
+// forward.
+class RefTrajectory {
+  using Self = RefTrajectory;
+
+ public:
+  static constexpr std::size_t coefficient_num = 6;
+
+  struct Knot {
+    double time;
+    double value;
+  };
+  struct Segment {
+    double start;
+    double c[coefficient_num];
+  };
+
+  // segment cursor, which remembers the segment evaluated last
+  class Cursor {
+   public:
+    explicit Cursor(const RefTrajectory& t_trajectory)
+        : m_trajectory(&t_trajectory), m_segment(0) {}
+
+    inline std::size_t segment() const noexcept { return m_segment; }
+    inline void rewind() noexcept { m_segment = 0; }
+
+    double value(double t_time);
+    double velocity(double t_time);
+    double acceleration(double t_time);
+
+   private:
+    const RefTrajectory* m_trajectory;
+    std::size_t m_segment;
+
+    const Segment* seek(double t_time);
+  };
+
+ public:
+  RefTrajectory() = default;
+
+  // accessors
+  inline const std::vector<Segment>& segments() const noexcept {
+    return m_segments;
+  }
+  inline std::size_t segment_num() const noexcept { return m_segments.size(); }
+  inline bool empty() const noexcept { return m_segments.empty(); }
+  double start_time() const;
+  double end_time() const;
+
+  // builders, which take knots in strictly increasing order of time
+  // rest-to-rest minimum-jerk motion between consecutive knots
+  bool buildMinJerk(const std::vector<Knot>& t_knots);
+  // steps to the values of knots smoothed by minimum-jerk motion which
+  // starts at each knot and lasts for t_ramp at most
+  bool buildSmoothSteps(const std::vector<Knot>& t_knots, double t_ramp);
+  // cubic spline through knots with the velocities at both ends
+  bool buildCubicSpline(const std::vector<Knot>& t_knots,
+                        double t_start_velocity = 0,
+                        double t_end_velocity = 0);
+  void clear() { m_segments.clear(); }
+
+ private:
+  std::vector<Segment> m_segments;
+
+  bool isValid(const std::vector<Knot>& t_knots) const;
+  void appendHold(const Knot& t_knot);
+};
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_REF_TRAJECTORY_HPP_
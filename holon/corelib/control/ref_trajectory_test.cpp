@@ -0,0 +1,157 @@
+/* ref_trajectory - precomputed reference trajectory
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/ref_trajectory.hpp"
+
+#include <zm/zm_misc.h>
+#include <cmath>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Knot = RefTrajectory::Knot;
+
+TEST_CASE("RefTrajectory: empty trajectory", "[RefTrajectory]") {
+  RefTrajectory trajectory;
+  RefTrajectory::Cursor cursor(trajectory);
+  CHECK(trajectory.empty());
+  CHECK(cursor.value(1) == 0);
+  CHECK(cursor.velocity(1) == 0);
+  CHECK(cursor.acceleration(1) == 0);
+}
+
+TEST_CASE("RefTrajectory: minimum-jerk motion", "[RefTrajectory]") {
+  Fuzzer fuzz;
+  double x0 = fuzz(), x1 = fuzz(), x2 = fuzz();
+  RefTrajectory trajectory;
+  REQUIRE(trajectory.buildMinJerk({{1, x0}, {3, x1}, {3.5, x2}}));
+  REQUIRE(trajectory.segment_num() == 3);
+  CHECK(trajectory.start_time() == 1);
+  CHECK(trajectory.end_time() == 3.5);
+
+  RefTrajectory::Cursor cursor(trajectory);
+  SECTION("held before the first knot") {
+    CHECK(cursor.value(0) == x0);
+    CHECK(cursor.velocity(0) == 0);
+  }
+  SECTION("rest at knots") {
+    CHECK(cursor.value(1) == x0);
+    CHECK(cursor.value(3) == Approx(x1));
+    CHECK(cursor.velocity(3) == Approx(0).margin(1e-12));
+    CHECK(cursor.acceleration(3) == Approx(0).margin(1e-9));
+    CHECK(cursor.value(3.5) == x2);
+    CHECK(cursor.value(10) == x2);
+  }
+  SECTION("symmetric profile") {
+    CHECK(cursor.value(2) == Approx(0.5 * (x0 + x1)));
+    CHECK(cursor.velocity(2) == Approx(1.875 * (x1 - x0) / 2));
+    CHECK(cursor.acceleration(2) == Approx(0).margin(1e-9));
+  }
+}
+
+TEST_CASE("RefTrajectory: smooth steps", "[RefTrajectory]") {
+  RefTrajectory trajectory;
+  // the second ramp is clipped by the third step
+  REQUIRE(trajectory.buildSmoothSteps({{0, 0}, {1, 1}, {3, -1}, {3.2, 2}},
+                                      0.5));
+  RefTrajectory::Cursor cursor(trajectory);
+  CHECK(cursor.value(0.99) == 0);
+  CHECK(cursor.value(1.25) == Approx(0.5));
+  CHECK(cursor.value(1.5) == Approx(1));
+  CHECK(cursor.value(2.9) == 1);
+  CHECK(cursor.value(3.1) == Approx(0).margin(1e-12));
+  CHECK(cursor.value(3.2) == Approx(-1));
+  CHECK(cursor.value(3.45) == Approx(0.5));
+  CHECK(cursor.value(3.7) == 2);
+  CHECK(trajectory.end_time() == Approx(3.7));
+
+  SECTION("continuity") {
+    const double eps = 1e-9;
+    RefTrajectory::Cursor c(trajectory);
+    for (auto t : {1.0, 1.5, 3.0, 3.2, 3.7}) {
+      CHECK(c.value(t - eps) == Approx(c.value(t)).margin(1e-6));
+      CHECK(c.velocity(t - eps) == Approx(c.velocity(t)).margin(1e-6));
+    }
+  }
+}
+
+TEST_CASE("RefTrajectory: cubic spline", "[RefTrajectory]") {
+  // a cubic spline reproduces a cubic polynomial with the end velocities
+  auto f = [](double t) { return ((t - 2) * t + 0.5) * t + 1; };
+  auto df = [](double t) { return (3 * t - 4) * t + 0.5; };
+  std::vector<Knot> knots;
+  for (auto t : {0.0, 0.3, 1.0, 1.2, 2.5}) knots.push_back(Knot{t, f(t)});
+  RefTrajectory trajectory;
+  REQUIRE(trajectory.buildCubicSpline(knots, df(0), df(2.5)));
+  REQUIRE(trajectory.segment_num() == knots.size());
+
+  RefTrajectory::Cursor cursor(trajectory);
+  for (double t = 0; t <= 2.5; t += 0.01) {
+    CHECK(cursor.value(t) == Approx(f(t)));
+    CHECK(cursor.velocity(t) == Approx(df(t)).margin(1e-9));
+    CHECK(cursor.acceleration(t) == Approx(6 * t - 4).margin(1e-9));
+  }
+  CHECK(cursor.value(3) == Approx(f(2.5)));
+  CHECK(cursor.velocity(3) == 0);
+
+  SECTION("single knot") {
+    REQUIRE(trajectory.buildCubicSpline({{1, 2}}));
+    RefTrajectory::Cursor c(trajectory);
+    CHECK(c.value(0) == 2);
+    CHECK(c.value(2) == 2);
+  }
+}
+
+TEST_CASE("RefTrajectory::Cursor follows time", "[RefTrajectory]") {
+  RefTrajectory trajectory;
+  REQUIRE(trajectory.buildMinJerk({{0, 0}, {1, 1}, {2, 0}, {3, 1}}));
+  RefTrajectory::Cursor cursor(trajectory);
+  std::size_t prev = 0;
+  for (double t = 0; t < 4; t += 0.01) {
+    cursor.value(t);
+    CHECK(cursor.segment() >= prev);
+    CHECK(cursor.segment() <= prev + 1);
+    prev = cursor.segment();
+  }
+  CHECK(cursor.segment() == 3);
+  // moving back in time restarts from the first segment
+  CHECK(cursor.value(1.5) == Approx(0.5));
+  CHECK(cursor.segment() == 1);
+  cursor.rewind();
+  CHECK(cursor.segment() == 0);
+}
+
+TEST_CASE("RefTrajectory: invalid knots", "[RefTrajectory]") {
+  RefTrajectory trajectory;
+  REQUIRE(trajectory.buildMinJerk({{0, 1}}));
+  zEchoOff();
+  CHECK_FALSE(trajectory.buildMinJerk({}));
+  CHECK_FALSE(trajectory.buildMinJerk({{0, 1}, {0, 2}}));
+  CHECK_FALSE(trajectory.buildCubicSpline({{1, 1}, {0, 2}}));
+  CHECK_FALSE(trajectory.buildSmoothSteps({{0, 1}, {1, 2}}, 0));
+  zEchoOn();
+  CHECK(trajectory.segment_num() == 1);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,108 @@
+/* task_scheduler - stackless tasks resumed on time and condition
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/task_scheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace holon {
+
+namespace {
+
+// the heap of timed tasks has the earliest one on top
+struct Later {
+  template <typename Timed>
+  bool operator()(const Timed& t_a, const Timed& t_b) const {
+    return t_a.time > t_b.time ||
+           (t_a.time == t_b.time && t_a.order > t_b.order);
+  }
+};
+
+}  // namespace
+
+TaskScheduler::TaskScheduler() : m_time(0), m_order(0) {}
+
+TaskScheduler& TaskScheduler::add(std::shared_ptr<Task> t_task) {
+  if (t_task)
+    pushTimed(-std::numeric_limits<double>::infinity(), std::move(t_task));
+  return *this;
+}
+
+TaskScheduler& TaskScheduler::clear() {
+  m_timed.clear();
+  m_waiting.clear();
+  m_next.clear();
+  return *this;
+}
+
+TaskScheduler& TaskScheduler::resume(double t_time) {
+  m_time = t_time;
+  // tasks awaiting the next resumption run first; those suspending again
+  // with Await::next() wait for the one after
+  m_next_buffer.swap(m_next);
+  for (auto& task : m_next_buffer) run(std::move(task));
+  m_next_buffer.clear();
+  while (!m_timed.empty() && m_timed.front().time <= t_time) {
+    std::pop_heap(m_timed.begin(), m_timed.end(), Later());
+    auto task = std::move(m_timed.back().task);
+    m_timed.pop_back();
+    run(std::move(task));
+  }
+  m_waiting_buffer.swap(m_waiting);
+  for (auto& waiting : m_waiting_buffer) {
+    if (waiting.condition())
+      run(std::move(waiting.task));
+    else
+      m_waiting.push_back(std::move(waiting));
+  }
+  m_waiting_buffer.clear();
+  return *this;
+}
+
+void TaskScheduler::pushTimed(double t_time, std::shared_ptr<Task> t_task) {
+  m_timed.push_back(Timed{t_time, m_order++, std::move(t_task)});
+  std::push_heap(m_timed.begin(), m_timed.end(), Later());
+}
+
+void TaskScheduler::run(std::shared_ptr<Task> t_task) {
+  for (;;) {
+    Await await = t_task->resume(m_time);
+    switch (await.kind()) {
+      case Await::Kind::done:
+        return;
+      case Await::Kind::time:
+        if (await.time() <= m_time) continue;
+        pushTimed(await.time(), std::move(t_task));
+        return;
+      case Await::Kind::condition:
+        if (await.condition()()) continue;
+        m_waiting.push_back(Waiting{std::move(await.condition()),
+                                    std::move(t_task)});
+        return;
+      case Await::Kind::next:
+        m_next.push_back(std::move(t_task));
+        return;
+    }
+  }
+}
+
+}  // namespace holon
@@ -0,0 +1,226 @@
+/* task_scheduler - stackless tasks resumed on time and condition
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_CONTROL_TASK_SCHEDULER_HPP_
+#define HOLON_CONTROL_TASK_SCHEDULER_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#include <exception>
+#include <utility>
+#define HOLON_HAS_COROUTINES 1
+#endif
+
+namespace holon {
+
+// Await tells a scheduler when to resume a task that has suspended itself:
+// when the time reaches a moment, when a condition holds, or at the next
+// resumption of the scheduler. A task resumes at once without suspending if
+// the time or the condition has already been reached.
+class Await {
+ public:
+  using Condition = std::function<bool()>;
+  enum class Kind { done, time, condition, next };
+
+  static Await done() { return Await(Kind::done, 0, nullptr); }
+  static Await until(double t_time) {
+    return Await(Kind::time, t_time, nullptr);
+  }
+  static Await when(Condition t_condition) {
+    return Await(Kind::condition, 0, std::move(t_condition));
+  }
+  static Await next() { return Await(Kind::next, 0, nullptr); }
+
+  inline Kind kind() const noexcept { return m_kind; }
+  inline double time() const noexcept { return m_time; }
+  inline Condition& condition() noexcept { return m_condition; }
+
+ private:
+  Kind m_kind;
+  double m_time;
+  Condition m_condition;
+
+  Await(Kind t_kind, double t_time, Condition t_condition)
+      : m_kind(t_kind), m_time(t_time), m_condition(std::move(t_condition)) {}
+};
+
+inline Await until(double t_time) { return Await::until(t_time); }
+inline Await when(Await::Condition t_condition) {
+  return Await::when(std::move(t_condition));
+}
+
+// Task is a stackless coroutine. Its body, run(), is written between
+// HOLON_TASK_BEGIN and HOLON_TASK_END, and suspends at HOLON_TASK_AWAIT,
+// from where it continues when resumed again. Since the body returns at
+// every suspension, local variables do not survive it; keep the state of a
+// task in its members. HOLON_TASK_AWAIT must neither be placed inside a
+// switch statement of the body nor twice on a line.
+//
+//   class Walk : public Task {
+//     Await run() override {
+//       HOLON_TASK_BEGIN;
+//       cmd->vxd = 0.1;
+//       HOLON_TASK_AWAIT(until(5));
+//       cmd->vxd = 0;
+//       HOLON_TASK_END;
+//     }
+//   };
+class Task {
+ public:
+  Task() : m_resume_point(0), m_time(0) {}
+  virtual ~Task() = default;
+
+  inline bool finished() const noexcept { return m_resume_point < 0; }
+  // time at which the task is resumed
+  inline double now() const noexcept { return m_time; }
+
+  // run the task from where it suspended until it suspends again
+  Await resume(double t_time) {
+    m_time = t_time;
+    return finished() ? Await::done() : run();
+  }
+
+ protected:
+  virtual Await run() = 0;
+
+  // resume point of the body, where zero means its beginning and negative
+  // values its end
+  int m_resume_point;
+
+ private:
+  double m_time;
+};
+
+#define HOLON_TASK_BEGIN             \
+  switch (this->m_resume_point) {    \
+    case 0:
+#define HOLON_TASK_AWAIT(await)      \
+  do {                               \
+    this->m_resume_point = __LINE__; \
+    return (await);                  \
+    case __LINE__:;                  \
+  } while (false)
+#define HOLON_TASK_END               \
+  }                                  \
+  this->m_resume_point = -1;         \
+  return ::holon::Await::done()
+
+#ifdef HOLON_HAS_COROUTINES
+// Script is a task written as a C++20 coroutine, which suspends at
+// co_await with an Await, e.g. `co_await until(5);`.
+class Script : public Task {
+ public:
+  struct promise_type {
+    Await await = Await::done();
+
+    Script get_return_object() {
+      return Script(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() { std::terminate(); }
+    std::suspend_always await_transform(Await t_await) {
+      await = std::move(t_await);
+      return {};
+    }
+  };
+
+  Script(Script&& t_script) noexcept
+      : m_handle(std::exchange(t_script.m_handle, nullptr)) {}
+  Script(const Script&) = delete;
+  Script& operator=(const Script&) = delete;
+  virtual ~Script() {
+    if (m_handle) m_handle.destroy();
+  }
+
+ protected:
+  virtual Await run() override {
+    m_handle.resume();
+    if (!m_handle.done()) return std::move(m_handle.promise().await);
+    m_resume_point = -1;
+    return Await::done();
+  }
+
+ private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  explicit Script(std::coroutine_handle<promise_type> t_handle)
+      : m_handle(t_handle) {}
+};
+#endif
+
+// TaskScheduler resumes tasks only when what they await fires. Tasks
+// awaiting a time are kept in a heap ordered by the time, so that a
+// resumption costs a single comparison while none of them is due. Tasks
+// awaiting a condition have it evaluated at every resumption. Tasks due at
+// the same resumption run in the order of their times and then of their
+// suspension.
+class TaskScheduler {
+  using Self = TaskScheduler;
+
+ public:
+  TaskScheduler();
+
+  inline double time() const noexcept { return m_time; }
+  inline std::size_t size() const noexcept {
+    return m_timed.size() + m_waiting.size() + m_next.size();
+  }
+  inline bool empty() const noexcept { return size() == 0; }
+
+  // add a task, which starts at the next resumption
+  Self& add(std::shared_ptr<Task> t_task);
+  Self& clear();
+
+  // resume the tasks that are due at t_time, to be called at every step of
+  // an executor loop
+  Self& resume(double t_time);
+
+ private:
+  struct Timed {
+    double time;
+    std::size_t order;
+    std::shared_ptr<Task> task;
+  };
+  struct Waiting {
+    Await::Condition condition;
+    std::shared_ptr<Task> task;
+  };
+
+  double m_time;
+  std::size_t m_order;
+  std::vector<Timed> m_timed;
+  std::vector<Waiting> m_waiting;
+  std::vector<Waiting> m_waiting_buffer;
+  std::vector<std::shared_ptr<Task>> m_next;
+  std::vector<std::shared_ptr<Task>> m_next_buffer;
+
+  void pushTimed(double t_time, std::shared_ptr<Task> t_task);
+  void run(std::shared_ptr<Task> t_task);
+};
+
+}  // namespace holon
+
+#endif  // HOLON_CONTROL_TASK_SCHEDULER_HPP_
@@ -0,0 +1,225 @@
+/* task_scheduler - stackless tasks resumed on time and condition
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/task_scheduler.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
+
+namespace holon {
+namespace {
+
+using Log = std::vector<std::pair<double, std::string>>;
+
+const double kTimeStep = 0.01;
+
+// resume t_scheduler every time step over [0, t_end)
+void runUntil(TaskScheduler* t_scheduler, double t_end) {
+  for (int i = 0; i * kTimeStep < t_end; ++i)
+    t_scheduler->resume(i * kTimeStep);
+}
+
+class Timeline : public Task {
+ public:
+  explicit Timeline(Log* t_log) : m_log(t_log) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    m_log->emplace_back(now(), "start");
+    HOLON_TASK_AWAIT(until(0.5));
+    m_log->emplace_back(now(), "phase 1");
+    HOLON_TASK_AWAIT(until(0.2));  // already passed
+    m_log->emplace_back(now(), "phase 2");
+    for (m_count = 0; m_count < 3; ++m_count) {
+      HOLON_TASK_AWAIT(until(now() + 0.1));
+      m_log->emplace_back(now(), "loop");
+    }
+    HOLON_TASK_END;
+  }
+
+ private:
+  Log* m_log;
+  int m_count;
+};
+
+TEST_CASE("TaskScheduler: resume a task at awaited times",
+          "[TaskScheduler]") {
+  Log log;
+  TaskScheduler scheduler;
+  auto task = std::make_shared<Timeline>(&log);
+  scheduler.add(task);
+  CHECK(scheduler.size() == 1);
+  CHECK(log.empty());
+
+  runUntil(&scheduler, 2);
+  REQUIRE(log.size() == 6);
+  CHECK(log[0] == std::make_pair(0.0, std::string("start")));
+  CHECK(log[1].first == Approx(0.5));
+  CHECK(log[1].second == "phase 1");
+  CHECK(log[2].first == log[1].first);
+  CHECK(log[2].second == "phase 2");
+  CHECK(log[3].first == Approx(0.6));
+  CHECK(log[4].first == Approx(0.7));
+  CHECK(log[5].first == Approx(0.8));
+  CHECK(task->finished());
+  CHECK(scheduler.empty());
+}
+
+class Watcher : public Task {
+ public:
+  Watcher(const double* t_x, Log* t_log) : m_x(t_x), m_log(t_log) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    HOLON_TASK_AWAIT(when([this] { return *m_x >= 1; }));
+    m_log->emplace_back(now(), "reached");
+    HOLON_TASK_AWAIT(Await::next());
+    m_log->emplace_back(now(), "next");
+    HOLON_TASK_END;
+  }
+
+ private:
+  const double* m_x;
+  Log* m_log;
+};
+
+TEST_CASE("TaskScheduler: resume a task when a condition holds",
+          "[TaskScheduler]") {
+  Log log;
+  double x = 0;
+  TaskScheduler scheduler;
+  scheduler.add(std::make_shared<Watcher>(&x, &log));
+  for (int i = 0; i < 10; ++i) {
+    x = 0.25 * i;
+    scheduler.resume(i);
+  }
+  REQUIRE(log.size() == 2);
+  CHECK(log[0] == std::make_pair(4.0, std::string("reached")));
+  CHECK(log[1] == std::make_pair(5.0, std::string("next")));
+  CHECK(scheduler.empty());
+}
+
+class Marker : public Task {
+ public:
+  Marker(double t_time, std::string t_name, Log* t_log)
+      : m_time(t_time), m_name(std::move(t_name)), m_log(t_log) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    HOLON_TASK_AWAIT(until(m_time));
+    m_log->emplace_back(now(), m_name);
+    HOLON_TASK_END;
+  }
+
+ private:
+  double m_time;
+  std::string m_name;
+  Log* m_log;
+};
+
+TEST_CASE("TaskScheduler: order of tasks due at once", "[TaskScheduler]") {
+  Log log;
+  TaskScheduler scheduler;
+  scheduler.add(std::make_shared<Marker>(0.3, "c", &log))
+      .add(std::make_shared<Marker>(0.1, "a", &log))
+      .add(std::make_shared<Marker>(0.3, "d", &log))
+      .add(std::make_shared<Marker>(0.2, "b", &log));
+  scheduler.resume(0);
+  scheduler.resume(1);
+  REQUIRE(log.size() == 4);
+  CHECK(log[0].second == "a");
+  CHECK(log[1].second == "b");
+  CHECK(log[2].second == "c");
+  CHECK(log[3].second == "d");
+
+  SECTION("clear") {
+    scheduler.add(std::make_shared<Marker>(2, "e", &log));
+    scheduler.resume(1.5);
+    CHECK(scheduler.size() == 1);
+    scheduler.clear();
+    scheduler.resume(3);
+    CHECK(log.size() == 4);
+  }
+}
+
+class Ticker : public Task {
+ public:
+  explicit Ticker(int* t_count) : m_count(t_count) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    for (;;) {
+      HOLON_TASK_AWAIT(until(now() + 1));
+      ++*m_count;
+    }
+    HOLON_TASK_END;
+  }
+
+ private:
+  int* m_count;
+};
+
+TEST_CASE("TaskScheduler: no allocations while resuming",
+          "[TaskScheduler]") {
+  int count = 0;
+  TaskScheduler scheduler;
+  for (int i = 0; i < 8; ++i) scheduler.add(std::make_shared<Ticker>(&count));
+  runUntil(&scheduler, 1.5);
+  CHECK(count == 8);
+  CHECK_NO_ALLOCATIONS(runUntil(&scheduler, 10));
+  CHECK(count == 8 * 9);  // ticks at t = 1, ..., 9
+}
+
+#ifdef HOLON_HAS_COROUTINES
+Script timeline(const TaskScheduler& t_scheduler, Log* t_log) {
+  t_log->emplace_back(t_scheduler.time(), "start");
+  co_await until(0.5);
+  t_log->emplace_back(t_scheduler.time(), "phase 1");
+  for (int i = 0; i < 3; ++i) {
+    co_await until(t_scheduler.time() + 0.1);
+    t_log->emplace_back(t_scheduler.time(), "loop");
+  }
+}
+
+TEST_CASE("TaskScheduler: resume a coroutine", "[TaskScheduler]") {
+  Log log;
+  TaskScheduler scheduler;
+  auto script = std::make_shared<Script>(timeline(scheduler, &log));
+  scheduler.add(script);
+  runUntil(&scheduler, 2);
+  REQUIRE(log.size() == 5);
+  CHECK(log[0].first == 0);
+  CHECK(log[1].first == Approx(0.5));
+  CHECK(log[4].first == Approx(0.8));
+  CHECK(script->finished());
+  CHECK(scheduler.empty());
+}
+#endif
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,145 @@
+/* checkpoint_store - sequence of binary checkpoints with delta compression
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/checkpoint_store.hpp"
+
+#include <zm/zm_misc.h>
+#include <algorithm>
+#include <cstring>
+
+namespace holon {
+
+constexpr std::size_t CheckpointStore::default_keyframe_interval;
+
+CheckpointStore::CheckpointStore(std::size_t t_image_size,
+                                 std::size_t t_keyframe_interval)
+    : m_image_size(t_image_size),
+      m_keyframe_interval(t_keyframe_interval > 0 ? t_keyframe_interval
+                                                  : default_keyframe_interval),
+      m_entries(),
+      m_bytes(),
+      m_last(t_image_size) {}
+
+CheckpointStore& CheckpointStore::set_image_size(std::size_t t_image_size) {
+  m_image_size = t_image_size;
+  m_last.assign(t_image_size, 0);
+  return clear();
+}
+
+CheckpointStore& CheckpointStore::set_keyframe_interval(
+    std::size_t t_keyframe_interval) {
+  m_keyframe_interval = t_keyframe_interval > 0 ? t_keyframe_interval
+                                                : default_keyframe_interval;
+  return clear();
+}
+
+CheckpointStore& CheckpointStore::clear() {
+  m_entries.clear();
+  m_bytes.clear();
+  return *this;
+}
+
+CheckpointStore& CheckpointStore::truncate(std::size_t t_n) {
+  if (t_n >= m_entries.size()) return *this;
+  m_bytes.resize(m_entries[t_n].offset);
+  m_entries.resize(t_n);
+  if (t_n > 0) restore(t_n - 1, m_last.data());
+  return *this;
+}
+
+bool CheckpointStore::push(double t_time, const char* t_image) {
+  if (!m_entries.empty() && t_time < m_entries.back().time) {
+    ZRUNERROR("checkpoints must be pushed in order of time. (given: %f)",
+              t_time);
+    return false;
+  }
+  m_entries.push_back(Entry{t_time, m_bytes.size()});
+  if (is_keyframe(m_entries.size() - 1)) {
+    m_bytes.insert(m_bytes.end(), t_image, t_image + m_image_size);
+  } else {
+    appendDelta(t_image);
+  }
+  std::memcpy(m_last.data(), t_image, m_image_size);
+  return true;
+}
+
+bool CheckpointStore::restore(std::size_t t_i, char* t_image) const {
+  if (t_i >= m_entries.size()) {
+    ZRUNERROR("checkpoint %zu does not exist. (size: %zu)", t_i,
+              m_entries.size());
+    return false;
+  }
+  std::size_t key = t_i - t_i % m_keyframe_interval;
+  std::memcpy(t_image, m_bytes.data() + m_entries[key].offset, m_image_size);
+  for (std::size_t i = key + 1; i <= t_i; ++i) applyDelta(i, t_image);
+  return true;
+}
+
+optional<std::size_t> CheckpointStore::find(double t_time) const {
+  auto it = std::upper_bound(
+      m_entries.begin(), m_entries.end(), t_time,
+      [](double t, const Entry& entry) { return t < entry.time; });
+  if (it == m_entries.begin()) return nullopt;
+  return static_cast<std::size_t>(it - m_entries.begin() - 1);
+}
+
+std::size_t CheckpointStore::end_of(std::size_t t_i) const {
+  return t_i + 1 < m_entries.size() ? m_entries[t_i + 1].offset
+                                    : m_bytes.size();
+}
+
+// A delta is a series of runs, each of which is the offset and the length of
+// changed bytes followed by the bytes. Unchanged gaps shorter than a pair of
+// headers are merged into a run since they are cheaper to copy.
+void CheckpointStore::appendDelta(const char* t_image) {
+  const std::size_t header_size = 2 * sizeof(RunHeader);
+  const char* last = m_last.data();
+  std::size_t i = 0;
+  while (i < m_image_size) {
+    if (t_image[i] == last[i]) {
+      ++i;
+      continue;
+    }
+    std::size_t begin = i;
+    std::size_t end = i + 1;
+    for (std::size_t j = end; j < m_image_size && j < end + header_size; ++j)
+      if (t_image[j] != last[j]) end = j + 1;
+    RunHeader header[2] = {static_cast<RunHeader>(begin),
+                           static_cast<RunHeader>(end - begin)};
+    const char* p = reinterpret_cast<const char*>(header);
+    m_bytes.insert(m_bytes.end(), p, p + header_size);
+    m_bytes.insert(m_bytes.end(), t_image + begin, t_image + end);
+    i = end;
+  }
+}
+
+void CheckpointStore::applyDelta(std::size_t t_i, char* t_image) const {
+  const char* p = m_bytes.data() + m_entries[t_i].offset;
+  const char* end = m_bytes.data() + end_of(t_i);
+  while (p < end) {
+    RunHeader header[2];
+    std::memcpy(header, p, sizeof(header));
+    p += sizeof(header);
+    std::memcpy(t_image + header[0], p, header[1]);
+    p += header[1];
+  }
+}
+
+}  // namespace holon
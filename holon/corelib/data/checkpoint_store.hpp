@@ -0,0 +1,97 @@
+/* checkpoint_store - sequence of binary checkpoints with delta compression
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_DATA_CHECKPOINT_STORE_HPP_
+#define HOLON_DATA_CHECKPOINT_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "holon/corelib/common/optional.hpp"
+
+namespace holon {
+
+// CheckpointStore keeps a sequence of binary images of the same size taken
+// at increasing times, e.g. by pack_data(). Every keyframe_interval-th image
+// is stored as it is, and the others as deltas from their predecessors,
+// which consist of runs of changed bytes, so that a long run costs little
+// more memory than the parts of the state that actually change. An image is
+// restored from the latest keyframe followed by the deltas after it.
+class CheckpointStore {
+  using Self = CheckpointStore;
+
+ public:
+  static constexpr std::size_t default_keyframe_interval = 16;
+
+ public:
+  explicit CheckpointStore(
+      std::size_t t_image_size = 0,
+      std::size_t t_keyframe_interval = default_keyframe_interval);
+
+  // accessors
+  inline std::size_t image_size() const noexcept { return m_image_size; }
+  inline std::size_t keyframe_interval() const noexcept {
+    return m_keyframe_interval;
+  }
+  inline std::size_t size() const noexcept { return m_entries.size(); }
+  inline bool empty() const noexcept { return m_entries.empty(); }
+  inline double time(std::size_t t_i) const { return m_entries[t_i].time; }
+  // number of bytes in which the images are stored
+  inline std::size_t byte_size() const noexcept { return m_bytes.size(); }
+
+  // mutators
+  // (changing the image size or the keyframe interval clears the images)
+  Self& set_image_size(std::size_t t_image_size);
+  Self& set_keyframe_interval(std::size_t t_keyframe_interval);
+  Self& clear();
+  // keep the first t_n images only
+  Self& truncate(std::size_t t_n);
+
+  // append an image of image_size() bytes taken at t_time
+  bool push(double t_time, const char* t_image);
+  // copy the t_i-th image into a buffer of image_size() bytes
+  bool restore(std::size_t t_i, char* t_image) const;
+  // index of the latest image taken at or before t_time
+  optional<std::size_t> find(double t_time) const;
+
+ private:
+  struct Entry {
+    double time;
+    std::size_t offset;
+  };
+  using RunHeader = std::uint32_t;
+
+  std::size_t m_image_size;
+  std::size_t m_keyframe_interval;
+  std::vector<Entry> m_entries;
+  std::vector<char> m_bytes;
+  std::vector<char> m_last;
+
+  inline bool is_keyframe(std::size_t t_i) const noexcept {
+    return t_i % m_keyframe_interval == 0;
+  }
+  std::size_t end_of(std::size_t t_i) const;
+  void appendDelta(const char* t_image);
+  void applyDelta(std::size_t t_i, char* t_image) const;
+};
+
+}  // namespace holon
+
+#endif  // HOLON_DATA_CHECKPOINT_STORE_HPP_
@@ -0,0 +1,143 @@
+/* checkpoint_store - sequence of binary checkpoints with delta compression
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/checkpoint_store.hpp"
+
+#include <vector>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kImageSize = 256;
+
+// images in which a few doubles change at every step
+std::vector<std::vector<char>> makeImages(std::size_t t_n) {
+  Fuzzer fuzz(-1, 1);
+  std::vector<std::vector<char>> images;
+  std::vector<double> v(kImageSize / sizeof(double));
+  for (auto& e : v) e = fuzz();
+  for (std::size_t i = 0; i < t_n; ++i) {
+    v[i % v.size()] = fuzz();
+    v[(3 * i + 1) % v.size()] = fuzz();
+    const char* p = reinterpret_cast<const char*>(v.data());
+    images.emplace_back(p, p + kImageSize);
+  }
+  return images;
+}
+
+TEST_CASE("CheckpointStore: constructor", "[data][CheckpointStore]") {
+  SECTION("default") {
+    CheckpointStore store;
+    CHECK(store.image_size() == 0);
+    CHECK(store.keyframe_interval() ==
+          CheckpointStore::default_keyframe_interval);
+    CHECK(store.empty());
+    CHECK(store.byte_size() == 0);
+  }
+  SECTION("with arguments") {
+    CheckpointStore store(kImageSize, 4);
+    CHECK(store.image_size() == kImageSize);
+    CHECK(store.keyframe_interval() == 4);
+  }
+  SECTION("zero keyframe interval is replaced with default") {
+    CheckpointStore store(kImageSize, 0);
+    CHECK(store.keyframe_interval() ==
+          CheckpointStore::default_keyframe_interval);
+  }
+}
+
+TEST_CASE("CheckpointStore: restore images", "[data][CheckpointStore]") {
+  auto images = makeImages(50);
+  CheckpointStore store(kImageSize, 8);
+  for (std::size_t i = 0; i < images.size(); ++i)
+    REQUIRE(store.push(0.1 * i, images[i].data()));
+  REQUIRE(store.size() == images.size());
+
+  std::vector<char> image(kImageSize);
+  for (std::size_t i = 0; i < images.size(); ++i) {
+    REQUIRE(store.restore(i, image.data()));
+    CHECK(image == images[i]);
+    CHECK(store.time(i) == 0.1 * i);
+  }
+  // deltas hold only the changed doubles
+  CHECK(store.byte_size() < images.size() * kImageSize / 4);
+
+  zEchoOff();
+  CHECK_FALSE(store.restore(images.size(), image.data()));
+  zEchoOn();
+}
+
+TEST_CASE("CheckpointStore: unchanged images", "[data][CheckpointStore]") {
+  std::vector<char> image(kImageSize, 1);
+  CheckpointStore store(kImageSize, 4);
+  for (std::size_t i = 0; i < 8; ++i) store.push(i, image.data());
+  CHECK(store.byte_size() == 2 * kImageSize);
+}
+
+TEST_CASE("CheckpointStore: find the latest image before a time",
+          "[data][CheckpointStore]") {
+  auto images = makeImages(5);
+  CheckpointStore store(kImageSize);
+  CHECK_FALSE(store.find(0));
+  for (std::size_t i = 0; i < images.size(); ++i)
+    store.push(1.0 + i, images[i].data());
+  CHECK_FALSE(store.find(0.5));
+  CHECK(store.find(1.0).value() == 0);
+  CHECK(store.find(2.5).value() == 1);
+  CHECK(store.find(5.0).value() == 4);
+  CHECK(store.find(100).value() == 4);
+
+  zEchoOff();
+  CHECK_FALSE(store.push(4.5, images[0].data()));
+  zEchoOn();
+  CHECK(store.size() == images.size());
+}
+
+TEST_CASE("CheckpointStore: truncate and push again",
+          "[data][CheckpointStore]") {
+  auto images = makeImages(20);
+  auto others = makeImages(20);
+  CheckpointStore store(kImageSize, 4);
+  for (std::size_t i = 0; i < images.size(); ++i)
+    store.push(i, images[i].data());
+
+  std::size_t n = 0;
+  SECTION("in the middle of deltas") { n = 10; }
+  SECTION("at a keyframe") { n = 8; }
+  store.truncate(n);
+  REQUIRE(store.size() == n);
+  for (std::size_t i = n; i < others.size(); ++i)
+    store.push(i, others[i].data());
+
+  std::vector<char> image(kImageSize);
+  for (std::size_t i = 0; i < store.size(); ++i) {
+    store.restore(i, image.data());
+    CHECK(image == (i < n ? images[i] : others[i]));
+  }
+  store.truncate(0);
+  CHECK(store.empty());
+  CHECK(store.byte_size() == 0);
+}
+
+}  // namespace
+}  // namespace holon
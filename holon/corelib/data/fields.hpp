@@ -0,0 +1,581 @@
+/* fields - compile-time field registry of raw data structs
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_DATA_FIELDS_HPP_
+#define HOLON_DATA_FIELDS_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/common/text_writer.hpp"
+#include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
+
+// HOLON_DEFINE_FIELDS registers the fields of a raw data struct in order of
+// declaration. It is put at the end of the struct body, e.g.
+//
+//   struct RawData {
+//     double mass;
+//     Vec3D position;
+//     HOLON_DEFINE_FIELDS(RawData, mass, position)
+//   };
+//
+// and defines only types and static member functions, so that the struct
+// stays an aggregate with the same layout. The registry consists of
+//   field_types      : std::tuple of the field types
+//   field_name(i)    : name of the i-th field
+//   for_each_field   : calls f("name", obj.name...) for each field
+//   for_each_member  : calls f("name", &Type::name) for each field
+// which are expanded at compile time, so that generic code below visits the
+// fields without any lookup at runtime. It works for class templates as well
+// since Type is the injected class name there.
+#define HOLON_DEFINE_FIELDS(Type, ...)                                       \
+  using field_types = typename ::holon::fields_detail::drop_first<           \
+      void HOLON_FIELDS_FOR_EACH(HOLON_FIELDS_TYPE, __VA_ARGS__)>::type;     \
+  static const char* field_name(std::size_t t_i) {                          \
+    static const char* const names[] = {                                    \
+        HOLON_FIELDS_FOR_EACH(HOLON_FIELDS_NAME, __VA_ARGS__)};             \
+    return names[t_i];                                                      \
+  }                                                                         \
+  template <typename F, typename... Objs>                                   \
+  static void for_each_field(F&& t_f, Objs&&... t_objs) {                   \
+    HOLON_FIELDS_FOR_EACH(HOLON_FIELDS_VISIT, __VA_ARGS__)                  \
+  }                                                                         \
+  template <typename F>                                                     \
+  static void for_each_member(F&& t_f) {                                    \
+    using holon_fields_self = Type;                                         \
+    HOLON_FIELDS_FOR_EACH(HOLON_FIELDS_MEMBER, __VA_ARGS__)                 \
+  }
+
+#define HOLON_FIELDS_TYPE(x) , decltype(x)
+#define HOLON_FIELDS_NAME(x) #x,
+#define HOLON_FIELDS_VISIT(x) t_f(#x, t_objs.x...);
+#define HOLON_FIELDS_MEMBER(x) t_f(#x, &holon_fields_self::x);
+
+// apply a macro to each of up to 24 arguments
+#define HOLON_FIELDS_EXPAND(x) x
+#define HOLON_FIELDS_CAT(a, b) HOLON_FIELDS_CAT_(a, b)
+#define HOLON_FIELDS_CAT_(a, b) a##b
+#define HOLON_FIELDS_NARG(...)                                               \
+  HOLON_FIELDS_EXPAND(HOLON_FIELDS_NARG_(__VA_ARGS__, 24, 23, 22, 21, 20,   \
+                                         19, 18, 17, 16, 15, 14, 13, 12, 11, \
+                                         10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define HOLON_FIELDS_NARG_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, \
+                           _13, _14, _15, _16, _17, _18, _19, _20, _21, _22,  \
+                           _23, _24, N, ...)                                  \
+  N
+#define HOLON_FIELDS_FOR_EACH(m, ...)                                        \
+  HOLON_FIELDS_EXPAND(HOLON_FIELDS_CAT(HOLON_FIELDS_FOR_EACH_,               \
+                                       HOLON_FIELDS_NARG(__VA_ARGS__))(     \
+      m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_1(m, x) m(x)
+#define HOLON_FIELDS_FOR_EACH_2(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_1(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_3(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_2(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_4(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_3(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_5(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_4(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_6(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_5(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_7(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_6(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_8(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_7(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_9(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_8(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_10(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_9(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_11(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_10(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_12(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_11(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_13(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_12(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_14(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_13(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_15(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_14(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_16(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_15(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_17(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_16(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_18(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_17(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_19(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_18(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_20(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_19(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_21(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_20(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_22(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_21(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_23(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_22(m, __VA_ARGS__))
+#define HOLON_FIELDS_FOR_EACH_24(m, x, ...) \
+  m(x) HOLON_FIELDS_EXPAND(HOLON_FIELDS_FOR_EACH_23(m, __VA_ARGS__))
+
+namespace holon {
+
+namespace fields_detail {
+
+template <typename T, typename... Ts>
+struct drop_first {
+  using type = std::tuple<Ts...>;
+};
+
+template <typename... Ts>
+struct make_void {
+  using type = void;
+};
+
+}  // namespace fields_detail
+
+// check if fields of a struct are registered with HOLON_DEFINE_FIELDS
+template <typename T, typename = void>
+struct has_fields : std::false_type {};
+template <typename T>
+struct has_fields<
+    T, typename fields_detail::make_void<typename T::field_types>::type>
+    : std::true_type {};
+
+template <typename T>
+struct field_num : std::tuple_size<typename T::field_types> {};
+
+// path to a field, e.g. com_position.x, chained on the stack of visitors
+struct FieldPath {
+  const char* name;
+  const FieldPath* parent;
+};
+
+inline TextWriter& operator<<(TextWriter& writer, const FieldPath& path) {
+  if (path.parent) writer << *path.parent << '.';
+  return writer << path.name;
+}
+
+// I/O of a field of type T; a field consists of one or more columns each of
+// which holds a scalar value
+template <typename T, typename = void>
+struct field_io;
+
+template <typename T>
+struct field_io<T,
+                typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static constexpr std::size_t column_num() { return 1; }
+  static constexpr std::size_t binary_size() { return sizeof(T); }
+  static void write_names(TextWriter& t_writer, const FieldPath& t_path) {
+    t_writer << t_path;
+  }
+  static void write(TextWriter& t_writer, const T& t_value) {
+    put(t_writer, t_value, std::is_integral<T>());
+  }
+  static char* pack(char* t_p, const T& t_value) {
+    std::memcpy(t_p, &t_value, sizeof(T));
+    return t_p + sizeof(T);
+  }
+  static const char* unpack(const char* t_p, T* t_value) {
+    std::memcpy(t_value, t_p, sizeof(T));
+    return t_p + sizeof(T);
+  }
+  // NaNs are regarded as identical
+  static bool equal(const T& t_a, const T& t_b) {
+    return t_a == t_b || (t_a != t_a && t_b != t_b);
+  }
+  template <typename F>
+  static std::size_t diff(const FieldPath& t_path, const T& t_a, const T& t_b,
+                          F& t_f) {
+    if (equal(t_a, t_b)) return 0;
+    t_f(t_path, static_cast<double>(t_a), static_cast<double>(t_b));
+    return 1;
+  }
+
+ private:
+  static void put(TextWriter& t_writer, const T& t_value, std::true_type) {
+    t_writer.put(static_cast<long long>(t_value));
+  }
+  static void put(TextWriter& t_writer, const T& t_value, std::false_type) {
+    t_writer.put(static_cast<double>(t_value));
+  }
+};
+
+template <>
+struct field_io<Vec3D> {
+  using Elem = field_io<double>;
+
+  static constexpr std::size_t column_num() { return 3; }
+  static constexpr std::size_t binary_size() { return 3 * sizeof(double); }
+  static void write_names(TextWriter& t_writer, const FieldPath& t_path) {
+    t_writer << FieldPath{"x", &t_path};
+    t_writer.delimit() << FieldPath{"y", &t_path};
+    t_writer.delimit() << FieldPath{"z", &t_path};
+  }
+  static void write(TextWriter& t_writer, const Vec3D& t_value) {
+    t_writer << t_value;
+  }
+  static char* pack(char* t_p, const Vec3D& t_value) {
+    std::memcpy(t_p, t_value.get_ptr()->e, binary_size());
+    return t_p + binary_size();
+  }
+  static const char* unpack(const char* t_p, Vec3D* t_value) {
+    std::memcpy(t_value->get_ptr()->e, t_p, binary_size());
+    return t_p + binary_size();
+  }
+  static bool equal(const Vec3D& t_a, const Vec3D& t_b) {
+    return Elem::equal(t_a[0], t_b[0]) && Elem::equal(t_a[1], t_b[1]) &&
+           Elem::equal(t_a[2], t_b[2]);
+  }
+  template <typename F>
+  static std::size_t diff(const FieldPath& t_path, const Vec3D& t_a,
+                          const Vec3D& t_b, F& t_f) {
+    return Elem::diff(FieldPath{"x", &t_path}, t_a[0], t_b[0], t_f) +
+           Elem::diff(FieldPath{"y", &t_path}, t_a[1], t_b[1], t_f) +
+           Elem::diff(FieldPath{"z", &t_path}, t_a[2], t_b[2], t_f);
+  }
+};
+
+// an empty optional is written as NaN and packed with a flag byte
+template <typename T>
+struct field_io<optional<T>,
+                typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  using Elem = field_io<T>;
+
+  static constexpr std::size_t column_num() { return 1; }
+  static constexpr std::size_t binary_size() { return 1 + sizeof(T); }
+  static void write_names(TextWriter& t_writer, const FieldPath& t_path) {
+    t_writer << t_path;
+  }
+  static void write(TextWriter& t_writer, const optional<T>& t_value) {
+    if (t_value)
+      Elem::write(t_writer, *t_value);
+    else
+      t_writer.put(std::numeric_limits<double>::quiet_NaN());
+  }
+  static char* pack(char* t_p, const optional<T>& t_value) {
+    *t_p = t_value ? 1 : 0;
+    T v = t_value ? *t_value : T();
+    return Elem::pack(t_p + 1, v);
+  }
+  static const char* unpack(const char* t_p, optional<T>* t_value) {
+    T v;
+    const char* p = Elem::unpack(t_p + 1, &v);
+    if (*t_p)
+      *t_value = v;
+    else
+      *t_value = nullopt;
+    return p;
+  }
+  static bool equal(const optional<T>& t_a, const optional<T>& t_b) {
+    if (!t_a || !t_b) return !t_a == !t_b;
+    return Elem::equal(*t_a, *t_b);
+  }
+  template <typename F>
+  static std::size_t diff(const FieldPath& t_path, const optional<T>& t_a,
+                          const optional<T>& t_b, F& t_f) {
+    if (equal(t_a, t_b)) return 0;
+    t_f(t_path, value(t_a), value(t_b));
+    return 1;
+  }
+
+ private:
+  static double value(const optional<T>& t_value) {
+    return t_value ? static_cast<double>(*t_value)
+                   : std::numeric_limits<double>::quiet_NaN();
+  }
+};
+
+namespace fields_detail {
+
+template <typename Tuple>
+struct sum;
+
+template <>
+struct sum<std::tuple<>> {
+  static constexpr std::size_t column_num() { return 0; }
+  static constexpr std::size_t binary_size() { return 0; }
+};
+
+template <typename T, typename... Ts>
+struct sum<std::tuple<T, Ts...>> {
+  static constexpr std::size_t column_num() {
+    return field_io<T>::column_num() + sum<std::tuple<Ts...>>::column_num();
+  }
+  static constexpr std::size_t binary_size() {
+    return field_io<T>::binary_size() + sum<std::tuple<Ts...>>::binary_size();
+  }
+};
+
+struct NameWriter {
+  TextWriter& writer;
+  const FieldPath* parent;
+  bool first;
+  template <typename S, typename M>
+  void operator()(const char* t_name, M S::*) {
+    if (!first) writer.delimit();
+    first = false;
+    field_io<M>::write_names(writer, FieldPath{t_name, parent});
+  }
+};
+
+struct ValueWriter {
+  TextWriter& writer;
+  bool first;
+  template <typename M>
+  void operator()(const char*, const M& t_value) {
+    if (!first) writer.delimit();
+    first = false;
+    field_io<M>::write(writer, t_value);
+  }
+};
+
+struct Packer {
+  char* p;
+  template <typename M>
+  void operator()(const char*, const M& t_value) {
+    p = field_io<M>::pack(p, t_value);
+  }
+};
+
+struct Unpacker {
+  const char* p;
+  template <typename M>
+  void operator()(const char*, M& t_value) {
+    p = field_io<M>::unpack(p, &t_value);
+  }
+};
+
+struct Comparator {
+  bool equal;
+  template <typename M>
+  void operator()(const char*, const M& t_a, const M& t_b) {
+    equal = equal && field_io<M>::equal(t_a, t_b);
+  }
+};
+
+template <typename F>
+struct Differ {
+  const FieldPath* parent;
+  F& f;
+  std::size_t count;
+  template <typename M>
+  void operator()(const char* t_name, const M& t_a, const M& t_b) {
+    count += field_io<M>::diff(FieldPath{t_name, parent}, t_a, t_b, f);
+  }
+};
+
+template <typename T, typename M>
+struct MemberFinder {
+  const std::string& name;
+  M T::**found;
+  void operator()(const char* t_name, M T::*t_member) {
+    if (name == t_name) *found = t_member;
+  }
+  template <typename Other>
+  void operator()(const char*, Other T::*) {}
+};
+
+struct NullDiffHandler {
+  void operator()(const FieldPath&, double, double) {}
+};
+
+}  // namespace fields_detail
+
+// a registered struct is a field whose columns are those of its fields
+template <typename T>
+struct field_io<T, typename std::enable_if<has_fields<T>::value>::type> {
+  using Sum = fields_detail::sum<typename T::field_types>;
+
+  static constexpr std::size_t column_num() { return Sum::column_num(); }
+  static constexpr std::size_t binary_size() { return Sum::binary_size(); }
+  static void write_names(TextWriter& t_writer, const FieldPath* t_parent) {
+    T::for_each_member(fields_detail::NameWriter{t_writer, t_parent, true});
+  }
+  static void write_names(TextWriter& t_writer, const FieldPath& t_path) {
+    write_names(t_writer, &t_path);
+  }
+  static void write(TextWriter& t_writer, const T& t_value) {
+    T::for_each_field(fields_detail::ValueWriter{t_writer, true}, t_value);
+  }
+  static char* pack(char* t_p, const T& t_value) {
+    fields_detail::Packer packer{t_p};
+    T::for_each_field(packer, t_value);
+    return packer.p;
+  }
+  static const char* unpack(const char* t_p, T* t_value) {
+    fields_detail::Unpacker unpacker{t_p};
+    T::for_each_field(unpacker, *t_value);
+    return unpacker.p;
+  }
+  static bool equal(const T& t_a, const T& t_b) {
+    fields_detail::Comparator comparator{true};
+    T::for_each_field(comparator, t_a, t_b);
+    return comparator.equal;
+  }
+  template <typename F>
+  static std::size_t diff(const FieldPath* t_parent, const T& t_a,
+                          const T& t_b, F& t_f) {
+    fields_detail::Differ<F> differ{t_parent, t_f, 0};
+    T::for_each_field(differ, t_a, t_b);
+    return differ.count;
+  }
+  template <typename F>
+  static std::size_t diff(const FieldPath& t_path, const T& t_a, const T& t_b,
+                          F& t_f) {
+    return diff(&t_path, t_a, t_b, t_f);
+  }
+};
+
+// number of columns and size of binary image of a registered struct
+template <typename T>
+struct field_column_num
+    : std::integral_constant<std::size_t, field_io<T>::column_num()> {};
+template <typename T>
+struct field_binary_size
+    : std::integral_constant<std::size_t, field_io<T>::binary_size()> {};
+
+// write names of all the columns, e.g. mass com_position.x ...
+template <typename T>
+TextWriter& write_field_names(TextWriter& t_writer) {
+  field_io<T>::write_names(t_writer, nullptr);
+  return t_writer;
+}
+
+// write values of all the columns in order of declaration
+template <typename T>
+TextWriter& write_fields(TextWriter& t_writer, const T& t_value) {
+  field_io<T>::write(t_writer, t_value);
+  return t_writer;
+}
+
+template <typename T, typename std::enable_if<has_fields<T>::value,
+                                              std::nullptr_t>::type = nullptr>
+TextWriter& operator<<(TextWriter& t_writer, const T& t_value) {
+  return write_fields(t_writer, t_value);
+}
+
+// copy values into / from a buffer of field_binary_size<T>::value bytes
+template <typename T>
+char* pack_fields(char* t_p, const T& t_value) {
+  return field_io<T>::pack(t_p, t_value);
+}
+template <typename T>
+const char* unpack_fields(const char* t_p, T* t_value) {
+  return field_io<T>::unpack(t_p, t_value);
+}
+
+// check if all the columns are identical
+template <typename T>
+bool equal_fields(const T& t_a, const T& t_b) {
+  return field_io<T>::equal(t_a, t_b);
+}
+
+// call t_f(path, a, b) for each column that differs and return the number of
+// them; an empty optional is passed as NaN
+template <typename T, typename F>
+std::size_t diff_fields(const T& t_a, const T& t_b, F t_f) {
+  return field_io<T>::diff(nullptr, t_a, t_b, t_f);
+}
+template <typename T>
+std::size_t diff_fields(const T& t_a, const T& t_b) {
+  return diff_fields(t_a, t_b, fields_detail::NullDiffHandler());
+}
+
+// find a field of type M by name; returns nullptr if not found
+template <typename T, typename M>
+M T::*find_field(const std::string& t_name) {
+  M T::*found = nullptr;
+  T::for_each_member(fields_detail::MemberFinder<T, M>{t_name, &found});
+  return found;
+}
+
+// all the raw data of a data set one after another
+template <typename Data, typename... RawData>
+constexpr std::size_t data_binary_size(
+    const DataSetBase<Data, RawData...>& /* data */) {
+  return fields_detail::sum<std::tuple<RawData...>>::binary_size();
+}
+
+namespace fields_detail {
+
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I == sizeof...(RawData)), char*>::type pack_data_impl(
+    char* t_p, const DataSetBase<Data, RawData...>&) {
+  return t_p;
+}
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I < sizeof...(RawData)), char*>::type pack_data_impl(
+    char* t_p, const DataSetBase<Data, RawData...>& t_data) {
+  return pack_data_impl<I + 1>(pack_fields(t_p, t_data.template get<I>()),
+                               t_data);
+}
+
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I == sizeof...(RawData)), const char*>::type
+unpack_data_impl(const char* t_p, DataSetBase<Data, RawData...>*) {
+  return t_p;
+}
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I < sizeof...(RawData)), const char*>::type
+unpack_data_impl(const char* t_p, DataSetBase<Data, RawData...>* t_data) {
+  return unpack_data_impl<I + 1>(
+      unpack_fields(t_p, &t_data->template get<I>()), t_data);
+}
+
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I == sizeof...(RawData)), void>::type write_data_impl(
+    TextWriter&, const DataSetBase<Data, RawData...>&) {}
+template <std::size_t I, typename Data, typename... RawData>
+typename std::enable_if<(I < sizeof...(RawData)), void>::type write_data_impl(
+    TextWriter& t_writer, const DataSetBase<Data, RawData...>& t_data) {
+  if (I > 0) t_writer.delimit();
+  write_fields(t_writer, t_data.template get<I>());
+  write_data_impl<I + 1>(t_writer, t_data);
+}
+
+}  // namespace fields_detail
+
+// take a binary snapshot of a data set into a buffer of data_binary_size()
+// bytes and restore it; the end of the written / read region is returned
+template <typename Data, typename... RawData>
+char* pack_data(char* t_p, const DataSetBase<Data, RawData...>& t_data) {
+  return fields_detail::pack_data_impl<0>(t_p, t_data);
+}
+template <typename Data, typename... RawData>
+const char* unpack_data(const char* t_p,
+                        DataSetBase<Data, RawData...>* t_data) {
+  return fields_detail::unpack_data_impl<0>(t_p, t_data);
+}
+
+// write values of all the raw data of a data set in a row
+template <typename Data, typename... RawData>
+TextWriter& write_data(TextWriter& t_writer,
+                       const DataSetBase<Data, RawData...>& t_data) {
+  fields_detail::write_data_impl<0>(t_writer, t_data);
+  return t_writer;
+}
+
+}  // namespace holon
+
+#endif  // HOLON_DATA_FIELDS_HPP_
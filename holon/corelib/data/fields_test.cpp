@@ -0,0 +1,186 @@
+/* fields - compile-time field registry of raw data structs
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/fields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+struct FieldsSample1 {
+  double mass;
+  Vec3D position;
+  optional<double> command;
+  int count;
+
+  HOLON_DEFINE_FIELDS(FieldsSample1, mass, position, command, count)
+};
+
+template <typename State>
+struct FieldsSample2 {
+  State value;
+  FieldsSample1 nested;
+
+  HOLON_DEFINE_FIELDS(FieldsSample2, value, nested)
+};
+
+class FieldsDataSet
+    : public DataSetBase<FieldsDataSet, FieldsSample1, FieldsSample2<double>> {
+ public:
+  FieldsSample1& data1() { return get<0>(); }
+  FieldsSample2<double>& data2() { return get<1>(); }
+};
+
+std::string written(const TextWriter& writer) {
+  return std::string(writer.data(), writer.size());
+}
+
+FieldsSample1 random_sample1() {
+  Fuzzer fuzz;
+  return FieldsSample1{fuzz(), {fuzz(), fuzz(), fuzz()}, fuzz(), 3};
+}
+
+TEST_CASE("fields: registry of field names and types", "[data][fields]") {
+  CHECK(has_fields<FieldsSample1>::value);
+  CHECK_FALSE(has_fields<Vec3D>::value);
+  CHECK(field_num<FieldsSample1>::value == 4);
+  CHECK(field_num<FieldsSample2<Vec3D>>::value == 2);
+  CHECK(std::string(FieldsSample1::field_name(0)) == "mass");
+  CHECK(std::string(FieldsSample1::field_name(3)) == "count");
+  CHECK((std::is_same<std::tuple_element<1, FieldsSample1::field_types>::type,
+                      Vec3D>::value));
+  CHECK((std::is_same<
+         std::tuple_element<0, FieldsSample2<Vec3D>::field_types>::type,
+         Vec3D>::value));
+  CHECK(field_column_num<FieldsSample1>::value == 6);
+  CHECK(field_column_num<FieldsSample2<Vec3D>>::value == 9);
+  CHECK(field_binary_size<FieldsSample1>::value ==
+        sizeof(double) * 4 + 1 + sizeof(double) + sizeof(int));
+}
+
+TEST_CASE("fields: find a field by name", "[data][fields]") {
+  CHECK((find_field<FieldsSample1, Vec3D>("position") ==
+         &FieldsSample1::position));
+  CHECK((find_field<FieldsSample1, double>("mass") == &FieldsSample1::mass));
+  CHECK((find_field<FieldsSample1, double>("position") == nullptr));
+  CHECK((find_field<FieldsSample1, double>("unknown") == nullptr));
+}
+
+TEST_CASE("fields: write names and values of columns", "[data][fields]") {
+  char buf[256];
+  TextWriter writer(buf);
+
+  SECTION("names") {
+    write_field_names<FieldsSample2<Vec3D>>(writer);
+    CHECK(written(writer) ==
+          "value.x value.y value.z nested.mass nested.position.x "
+          "nested.position.y nested.position.z nested.command nested.count");
+  }
+  SECTION("values") {
+    FieldsSample1 data{1.5, {0.1, -0.2, 1}, 2, 3};
+    writer << data;
+    CHECK(written(writer) == "1.5 0.1 -0.2 1 2 3");
+  }
+  SECTION("empty optional is written as nan") {
+    FieldsSample2<double> data{0.5, {1, {0, 0, 0}, nullopt, -1}};
+    writer.set_delimiter(',');
+    writer << data;
+    CHECK(written(writer) == "0.5,1,0,0,0,nan,-1");
+  }
+}
+
+TEST_CASE("fields: compute differences", "[data][fields]") {
+  FieldsSample1 a = random_sample1();
+  FieldsSample1 b = a;
+  CHECK(equal_fields(a, b));
+  CHECK(diff_fields(a, b) == 0);
+
+  b.position[1] += 1;
+  b.command = nullopt;
+  std::vector<std::string> names;
+  std::vector<double> values;
+  auto n = diff_fields(a, b, [&](const FieldPath& path, double va, double vb) {
+    char buf[64];
+    TextWriter writer(buf);
+    writer << path;
+    names.emplace_back(writer.data(), writer.size());
+    values.push_back(va);
+    values.push_back(vb);
+  });
+  CHECK_FALSE(equal_fields(a, b));
+  REQUIRE(n == 2);
+  CHECK(names[0] == "position.y");
+  CHECK(names[1] == "command");
+  CHECK(values[0] == a.position[1]);
+  CHECK(values[1] == b.position[1]);
+  CHECK(values[2] == *a.command);
+  CHECK(std::isnan(values[3]));
+
+  SECTION("NaNs are regarded as identical") {
+    a.mass = b.mass = std::nan("");
+    CHECK(diff_fields(a, b) == 2);
+  }
+}
+
+TEST_CASE("fields: pack and unpack binary image", "[data][fields]") {
+  FieldsSample2<Vec3D> a{{1, 2, 3}, random_sample1()}, b;
+  char buf[field_binary_size<FieldsSample2<Vec3D>>::value];
+  CHECK(pack_fields(buf, a) == buf + sizeof(buf));
+  CHECK(unpack_fields(buf, &b) == buf + sizeof(buf));
+  CHECK(equal_fields(a, b));
+
+  a.nested.command = nullopt;
+  pack_fields(buf, a);
+  unpack_fields(buf, &b);
+  CHECK_FALSE(b.nested.command);
+}
+
+TEST_CASE("fields: snapshot of data set", "[data][fields]") {
+  FieldsDataSet data;
+  data.data1() = random_sample1();
+  data.data2() = FieldsSample2<double>{0.5, random_sample1()};
+  std::vector<char> buf(data_binary_size(data));
+  CHECK(buf.size() == field_binary_size<FieldsSample1>::value +
+                          field_binary_size<FieldsSample2<double>>::value);
+  CHECK(pack_data(buf.data(), data) == buf.data() + buf.size());
+
+  FieldsDataSet restored;
+  CHECK(unpack_data(buf.data(), &restored) == buf.data() + buf.size());
+  CHECK(equal_fields(restored.data1(), data.data1()));
+  CHECK(equal_fields(restored.data2(), data.data2()));
+
+  char text[256];
+  TextWriter writer(text);
+  write_data(writer, data);
+  std::string str = written(writer);
+  CHECK(std::count(str.begin(), str.end(), ' ') + 1 ==
+        field_column_num<FieldsSample1>::value +
+            field_column_num<FieldsSample2<double>>::value);
+}
+
+}  // namespace
+}  // namespace holon
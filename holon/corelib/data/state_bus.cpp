@@ -0,0 +1,176 @@
+/* state_bus - shared-memory bus to publish data sets across processes
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/state_bus.hpp"
+
+#include <zm/zm_misc.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <new>
+
+namespace holon {
+
+struct StateBusSegment::Header {
+  std::uint32_t magic;
+  std::uint32_t size;
+  std::atomic<std::uint64_t> sequence;
+};
+
+namespace {
+
+const std::uint32_t kMagic = 0x686c6e62;
+// keep the payload off the cache line of the sequence
+const std::size_t kHeaderSize = 64;
+
+std::string segmentName(const std::string& t_name) {
+  return t_name.empty() || t_name[0] != '/' ? "/" + t_name : t_name;
+}
+
+// inode of a segment, or zero if it does not exist
+std::uint64_t segmentInode(const std::string& t_name) {
+  int fd = shm_open(t_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return 0;
+  struct stat st;
+  std::uint64_t inode = fstat(fd, &st) == 0 ? st.st_ino : 0;
+  ::close(fd);
+  return inode;
+}
+
+}  // namespace
+
+StateBusSegment::StateBusSegment()
+    : m_name(),
+      m_size(0),
+      m_map_size(0),
+      m_owner(false),
+      m_inode(0),
+      m_header(nullptr),
+      m_payload(nullptr) {
+  static_assert(sizeof(Header) <= kHeaderSize, "header is too large.");
+}
+
+StateBusSegment::~StateBusSegment() { close(); }
+
+bool StateBusSegment::create(const std::string& t_name, std::size_t t_size,
+                             bool t_take_over) {
+  if (t_take_over) shm_unlink(segmentName(t_name).c_str());
+  return map(segmentName(t_name), t_size, true);
+}
+
+bool StateBusSegment::open(const std::string& t_name, std::size_t t_size) {
+  return map(segmentName(t_name), t_size, false);
+}
+
+void StateBusSegment::close() {
+  if (!is_open()) return;
+  munmap(m_header, m_map_size);
+  // the segment may have been taken over by another publisher
+  if (m_owner && segmentInode(m_name) == m_inode) shm_unlink(m_name.c_str());
+  m_name.clear();
+  m_size = m_map_size = 0;
+  m_owner = false;
+  m_inode = 0;
+  m_header = nullptr;
+  m_payload = nullptr;
+}
+
+char* StateBusSegment::begin_write() {
+  std::uint64_t seq = m_header->sequence.load(std::memory_order_relaxed);
+  m_header->sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return m_payload;
+}
+
+void StateBusSegment::end_write() {
+  std::uint64_t seq = m_header->sequence.load(std::memory_order_relaxed);
+  m_header->sequence.store(seq + 1, std::memory_order_release);
+}
+
+std::uint64_t StateBusSegment::sequence() const {
+  return m_header ? m_header->sequence.load(std::memory_order_acquire) : 0;
+}
+
+const char* StateBusSegment::payload() const { return m_payload; }
+
+bool StateBusSegment::validate(std::uint64_t t_sequence) const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return m_header->sequence.load(std::memory_order_relaxed) == t_sequence;
+}
+
+bool StateBusSegment::map(const std::string& t_name, std::size_t t_size,
+                          bool t_owner) {
+  close();
+  std::size_t map_size = kHeaderSize + t_size;
+  int fd = t_owner
+               ? shm_open(t_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)
+               : shm_open(t_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (t_owner && errno == EEXIST)
+      ZRUNERROR("state bus %s is already published", t_name.c_str());
+    else
+      ZOPENERROR(t_name.c_str());
+    return false;
+  }
+  struct stat st;
+  if (t_owner ? ftruncate(fd, static_cast<off_t>(map_size)) != 0 ||
+                    fstat(fd, &st) != 0
+              : fstat(fd, &st) != 0 ||
+                    static_cast<std::size_t>(st.st_size) < map_size) {
+    ZRUNERROR("state bus %s is not of size %zu", t_name.c_str(), map_size);
+    ::close(fd);
+    if (t_owner) shm_unlink(t_name.c_str());
+    return false;
+  }
+  int prot = t_owner ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* p = mmap(nullptr, map_size, prot, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    ZRUNERROR("cannot map state bus %s (errno: %d)", t_name.c_str(), errno);
+    if (t_owner) shm_unlink(t_name.c_str());
+    return false;
+  }
+  Header* header = static_cast<Header*>(p);
+  if (t_owner) {
+    header = new (p) Header;
+    header->size = static_cast<std::uint32_t>(t_size);
+    header->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kMagic;
+  } else if (header->magic != kMagic || header->size != t_size) {
+    ZRUNERROR("state bus %s carries another type of data (size: %u)",
+              t_name.c_str(), header->magic == kMagic ? header->size : 0);
+    munmap(p, map_size);
+    return false;
+  }
+  m_name = t_name;
+  m_size = t_size;
+  m_map_size = map_size;
+  m_owner = t_owner;
+  m_inode = st.st_ino;
+  m_header = header;
+  m_payload = static_cast<char*>(p) + kHeaderSize;
+  return true;
+}
+
+}  // namespace holon
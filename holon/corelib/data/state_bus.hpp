@@ -0,0 +1,173 @@
+/* state_bus - shared-memory bus to publish data sets across processes
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_DATA_STATE_BUS_HPP_
+#define HOLON_DATA_STATE_BUS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "holon/corelib/data/fields.hpp"
+
+namespace holon {
+
+// StateBusSegment maps a named POSIX shared-memory segment which holds a
+// payload of a fixed size guarded by a sequence lock. The owner creates the
+// segment and is the only writer; it makes the sequence odd while writing
+// and even when done. Others map it read-only and retry reading until they
+// see the same even sequence before and after copying the payload, so that
+// neither side ever blocks.
+class StateBusSegment {
+  using Self = StateBusSegment;
+
+ public:
+  StateBusSegment();
+  ~StateBusSegment();
+  StateBusSegment(const Self&) = delete;
+  Self& operator=(const Self&) = delete;
+
+  // create a segment to write, which is removed when closed; it fails if
+  // the segment exists unless t_take_over is set, which removes the
+  // existing one first, e.g. that left by a crashed publisher
+  bool create(const std::string& t_name, std::size_t t_size,
+              bool t_take_over = false);
+  // open an existing segment to read
+  bool open(const std::string& t_name, std::size_t t_size);
+  void close();
+
+  // accessors
+  inline bool is_open() const noexcept { return m_header != nullptr; }
+  inline bool is_owner() const noexcept { return m_owner; }
+  inline const std::string& name() const noexcept { return m_name; }
+  inline std::size_t size() const noexcept { return m_size; }
+
+  // writer side; the payload returned by begin_write() is to be filled up
+  // before end_write() is called
+  char* begin_write();
+  void end_write();
+
+  // reader side
+  std::uint64_t sequence() const;
+  const char* payload() const;
+  // check if the sequence has not changed since t_sequence was read
+  bool validate(std::uint64_t t_sequence) const;
+
+ private:
+  struct Header;
+
+  std::string m_name;
+  std::size_t m_size;
+  std::size_t m_map_size;
+  bool m_owner;
+  std::uint64_t m_inode;
+  Header* m_header;
+  char* m_payload;
+
+  bool map(const std::string& t_name, std::size_t t_size, bool t_owner);
+};
+
+// StateBusPublisher publishes all the raw data of a data set into a segment.
+// The data set shares the raw data with that given, e.g. data of a
+// controller, so that publish() copies the latest values directly into the
+// segment.
+template <typename Data>
+class StateBusPublisher {
+ public:
+  explicit StateBusPublisher(const Data& t_data) : m_data(t_data) {}
+
+  bool open(const std::string& t_name, bool t_take_over = false) {
+    return m_segment.create(t_name, data_binary_size(m_data), t_take_over);
+  }
+  void close() { m_segment.close(); }
+  inline bool is_open() const noexcept { return m_segment.is_open(); }
+
+  bool publish() {
+    if (!m_segment.is_open()) return false;
+    pack_data(m_segment.begin_write(), m_data);
+    m_segment.end_write();
+    return true;
+  }
+  inline std::uint64_t published_count() const {
+    return m_segment.sequence() / 2;
+  }
+
+ private:
+  Data m_data;
+  StateBusSegment m_segment;
+};
+
+// StateBusSubscriber reads a data set published by StateBusPublisher into
+// its own data set.
+template <typename Data>
+class StateBusSubscriber {
+ public:
+  static constexpr int default_max_retry = 100;
+
+ public:
+  explicit StateBusSubscriber(const Data& t_data = Data())
+      : m_data(t_data), m_sequence(0) {}
+
+  bool open(const std::string& t_name) {
+    m_sequence = 0;
+    if (!m_segment.open(t_name, data_binary_size(m_data))) return false;
+    m_buffer.resize(m_segment.size());
+    return true;
+  }
+  void close() { m_segment.close(); }
+  inline bool is_open() const noexcept { return m_segment.is_open(); }
+
+  inline const Data& data() const noexcept { return m_data; }
+  inline Data& data() noexcept { return m_data; }
+  inline std::uint64_t received_count() const noexcept {
+    return m_sequence / 2;
+  }
+
+  // read the data if published since the last update; returns false when
+  // nothing new has come or the writer has kept overwriting the data
+  bool update(int t_max_retry = default_max_retry) {
+    if (!m_segment.is_open()) return false;
+    for (int i = 0; i < t_max_retry; ++i) {
+      std::uint64_t seq = m_segment.sequence();
+      if (seq & 1) continue;
+      if (seq == m_sequence) return false;
+      std::memcpy(m_buffer.data(), m_segment.payload(), m_buffer.size());
+      if (!m_segment.validate(seq)) continue;
+      unpack_data(m_buffer.data(), &m_data);
+      m_sequence = seq;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  Data m_data;
+  StateBusSegment m_segment;
+  std::vector<char> m_buffer;
+  std::uint64_t m_sequence;
+};
+
+template <typename Data>
+constexpr int StateBusSubscriber<Data>::default_max_retry;
+
+}  // namespace holon
+
+#endif  // HOLON_DATA_STATE_BUS_HPP_
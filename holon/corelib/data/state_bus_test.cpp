@@ -0,0 +1,188 @@
+/* state_bus - shared-memory bus to publish data sets across processes
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/data/state_bus.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+struct StateBusRawData1 {
+  double time;
+  Vec3D position;
+  optional<double> command;
+
+  HOLON_DEFINE_FIELDS(StateBusRawData1, time, position, command)
+};
+
+struct StateBusRawData2 {
+  double mass;
+  double twice;
+
+  HOLON_DEFINE_FIELDS(StateBusRawData2, mass, twice)
+};
+
+class StateBusData : public DataSetBase<StateBusData, StateBusRawData1,
+                                        StateBusRawData2> {
+ public:
+  StateBusRawData1& data1() { return get<0>(); }
+  StateBusRawData2& data2() { return get<1>(); }
+};
+
+class OtherData : public DataSetBase<OtherData, StateBusRawData2> {};
+
+std::string segment_name() {
+  return "/holon_state_bus_test_" + std::to_string(getpid());
+}
+
+void set_random(StateBusData* data) {
+  Fuzzer fuzz;
+  data->data1() = StateBusRawData1{fuzz(), {fuzz(), fuzz(), fuzz()}, fuzz()};
+  data->data2().mass = fuzz();
+  data->data2().twice = 2 * data->data2().mass;
+}
+
+TEST_CASE("StateBus: publish and subscribe data set", "[data][StateBus]") {
+  StateBusData data;
+  StateBusPublisher<StateBusData> publisher(data);
+  StateBusSubscriber<StateBusData> subscriber;
+  REQUIRE(publisher.open(segment_name()));
+  REQUIRE(subscriber.open(segment_name()));
+  CHECK_FALSE(subscriber.update());
+
+  set_random(&data);
+  CHECK(publisher.publish());
+  CHECK(publisher.published_count() == 1);
+  REQUIRE(subscriber.update());
+  CHECK(subscriber.received_count() == 1);
+  CHECK(equal_fields(subscriber.data().data1(), data.data1()));
+  CHECK(equal_fields(subscriber.data().data2(), data.data2()));
+  CHECK_FALSE(subscriber.update());
+
+  SECTION("latest data is read") {
+    data.data1().command = nullopt;
+    publisher.publish();
+    data.data1().time += 1;
+    publisher.publish();
+    REQUIRE(subscriber.update());
+    CHECK(subscriber.received_count() == 3);
+    CHECK(subscriber.data().data1().time == data.data1().time);
+    CHECK_FALSE(subscriber.data().data1().command);
+  }
+}
+
+TEST_CASE("StateBus: read is retried while writing", "[data][StateBus]") {
+  StateBusSegment writer, reader;
+  REQUIRE(writer.create(segment_name(), 8));
+  REQUIRE(reader.open(segment_name(), 8));
+  CHECK_FALSE(reader.is_owner());
+
+  char* payload = writer.begin_write();
+  CHECK(reader.sequence() % 2 == 1);
+  std::uint64_t seq = reader.sequence();
+  payload[0] = 'a';
+  writer.end_write();
+  CHECK_FALSE(reader.validate(seq));
+  seq = reader.sequence();
+  CHECK(seq == 2);
+  CHECK(reader.payload()[0] == 'a');
+  CHECK(reader.validate(seq));
+}
+
+TEST_CASE("StateBus: fail to open segment", "[data][StateBus]") {
+  StateBusSubscriber<StateBusData> subscriber;
+  zEchoOff();
+  SECTION("not exist") { CHECK_FALSE(subscriber.open(segment_name())); }
+  SECTION("another type of data") {
+    OtherData other;
+    StateBusPublisher<OtherData> publisher(other);
+    REQUIRE(publisher.open(segment_name()));
+    CHECK_FALSE(subscriber.open(segment_name()));
+  }
+  zEchoOn();
+  CHECK_FALSE(subscriber.is_open());
+  CHECK_FALSE(subscriber.update());
+}
+
+TEST_CASE("StateBus: a second publisher does not clobber the first",
+          "[data][StateBus]") {
+  StateBusData data;
+  set_random(&data);
+  StateBusPublisher<StateBusData> publisher(data), another(data);
+  REQUIRE(publisher.open(segment_name()));
+  REQUIRE(publisher.publish());
+  zEchoOff();
+  CHECK_FALSE(another.open(segment_name()));
+  zEchoOn();
+  CHECK(publisher.published_count() == 1);
+
+  SECTION("take over") {
+    REQUIRE(another.open(segment_name(), true));
+    CHECK(another.published_count() == 0);
+    // closing the former publisher leaves the segment taken over
+    publisher.close();
+    StateBusSubscriber<StateBusData> subscriber;
+    REQUIRE(subscriber.open(segment_name()));
+    REQUIRE(another.publish());
+    CHECK(subscriber.update());
+  }
+}
+
+TEST_CASE("StateBus: subscribe in another process", "[data][StateBus]") {
+  const int n = 20000;
+  const std::string name = segment_name();
+  StateBusData data;
+  StateBusPublisher<StateBusData> publisher(data);
+  REQUIRE(publisher.open(name));
+  publisher.publish();
+
+  pid_t pid = fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    // every data read should be consistent until the last one comes
+    StateBusSubscriber<StateBusData> subscriber;
+    if (!subscriber.open(name)) _exit(2);
+    for (long i = 0; i < 100000000; ++i) {
+      if (!subscriber.update()) continue;
+      auto& raw = subscriber.data().data2();
+      if (raw.twice != 2 * raw.mass) _exit(1);
+      if (raw.mass == n) _exit(0);
+    }
+    _exit(3);
+  }
+  for (int i = 1; i <= n; ++i) {
+    data.data2().mass = i;
+    data.data2().twice = 2 * i;
+    publisher.publish();
+  }
+  int status;
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  CHECK(WEXITSTATUS(status) == 0);
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,214 @@
+/* batch_rollout - parallel rollouts of batches of models into flat arrays
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/batch_rollout.hpp"
+
+#include <zm/zm_misc.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+
+namespace holon {
+
+constexpr std::size_t ComZmpModelRollout::initial_size;
+constexpr std::size_t ComZmpModelRollout::input_size;
+constexpr std::size_t ComZmpModelRollout::output_size;
+constexpr std::size_t ComCtrlRollout::initial_size;
+constexpr std::size_t ComCtrlRollout::input_size;
+constexpr std::size_t ComCtrlRollout::output_size;
+constexpr std::size_t PdCtrlRollout::initial_size;
+constexpr std::size_t PdCtrlRollout::input_size;
+constexpr std::size_t PdCtrlRollout::output_size;
+
+namespace {
+
+bool overlaps(const double* t_a, std::size_t t_a_num, const double* t_b,
+              std::size_t t_b_num) {
+  auto a = reinterpret_cast<std::uintptr_t>(t_a);
+  auto b = reinterpret_cast<std::uintptr_t>(t_b);
+  return t_a_num > 0 && t_b_num > 0 && a < b + t_b_num * sizeof(double) &&
+         b < a + t_a_num * sizeof(double);
+}
+
+// t_*_num are the numbers of elements of the whole arrays
+bool isValid(const BatchRollout& t_rollout, const double* t_initial,
+             std::size_t t_initial_num, const double* t_input,
+             std::size_t t_input_num, const double* t_out,
+             std::size_t t_out_num) {
+  if (t_rollout.time_step <= 0) {
+    ZRUNERROR("time step of a rollout must be positive (given: %g)",
+              t_rollout.time_step);
+    return false;
+  }
+  if (t_rollout.batch_num > 0 && (!t_initial || !t_input)) {
+    ZRUNERROR("initial states and inputs of a rollout must be given");
+    return false;
+  }
+  if (t_rollout.batch_num > 0 && t_rollout.step_num > 0 && !t_out) {
+    ZRUNERROR("output of a rollout must be given");
+    return false;
+  }
+  if (overlaps(t_out, t_out_num, t_initial, t_initial_num) ||
+      overlaps(t_out, t_out_num, t_input, t_input_num)) {
+    ZRUNERROR("output of a rollout must not overlap the inputs");
+    return false;
+  }
+  return true;
+}
+
+bool isValidMass(double t_mass) {
+  if (t_mass > 0) return true;
+  ZRUNERROR("mass of a model must be positive (given: %g)", t_mass);
+  return false;
+}
+
+// calls t_f(i) for each element i of a batch on worker threads, which take
+// the next element from a shared counter
+template <typename F>
+bool forEachElement(const BatchRollout& t_rollout, F t_f) {
+  std::size_t thread_num = t_rollout.thread_num;
+  if (thread_num == 0) thread_num = std::thread::hardware_concurrency();
+  thread_num = std::max<std::size_t>(
+      1, std::min<std::size_t>(thread_num, t_rollout.batch_num));
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> succeeded(true);
+  auto work = [&] {
+    for (std::size_t i; (i = next++) < t_rollout.batch_num;)
+      if (!t_f(i)) succeeded = false;
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t k = 1; k < thread_num; ++k) workers.emplace_back(work);
+  work();
+  for (auto& worker : workers) worker.join();
+  return succeeded;
+}
+
+inline Vec3D read(const double* t_p) { return Vec3D(t_p[0], t_p[1], t_p[2]); }
+
+inline double* write(const Vec3D& t_v, double* t_p) {
+  *t_p++ = t_v.x();
+  *t_p++ = t_v.y();
+  *t_p++ = t_v.z();
+  return t_p;
+}
+
+}  // namespace
+
+bool rolloutComZmpModel(const BatchRollout& t_rollout, double t_mass,
+                        const double* t_initial, const double* t_zmp,
+                        double* t_out) {
+  using Layout = ComZmpModelRollout;
+  const std::size_t b = t_rollout.batch_num, n = t_rollout.step_num;
+  if (!isValid(t_rollout, t_initial, b * Layout::initial_size, t_zmp,
+               b * n * Layout::input_size, t_out,
+               b * n * Layout::output_size) ||
+      !isValidMass(t_mass))
+    return false;
+  return forEachElement(t_rollout, [&](std::size_t i) {
+    const double* x0 = t_initial + i * Layout::initial_size;
+    const double* zmp = t_zmp + i * n * Layout::input_size;
+    double* out = t_out + i * n * Layout::output_size;
+    ComZmpModel model(read(x0), t_mass);
+    model.states().com_velocity = read(x0 + 3);
+    for (std::size_t k = 0; k < n; ++k, zmp += Layout::input_size) {
+      model.setZmpPosition(read(zmp));
+      if (!model.update(t_rollout.time_step)) return false;
+      out = write(model.states().com_position, out);
+      out = write(model.states().com_velocity, out);
+    }
+    return true;
+  });
+}
+
+bool rolloutComCtrl(const BatchRollout& t_rollout, double t_mass,
+                    double t_plant_mass, const double* t_initial,
+                    const double* t_commands, double* t_out) {
+  using Layout = ComCtrlRollout;
+  const std::size_t b = t_rollout.batch_num, n = t_rollout.step_num;
+  if (!isValid(t_rollout, t_initial, b * Layout::initial_size, t_commands,
+               b * n * Layout::input_size, t_out,
+               b * n * Layout::output_size) ||
+      !isValidMass(t_mass) || !isValidMass(t_plant_mass))
+    return false;
+  return forEachElement(t_rollout, [&](std::size_t i) {
+    const double* x0 = t_initial + i * Layout::initial_size;
+    const double* c = t_commands + i * n * Layout::input_size;
+    double* out = t_out + i * n * Layout::output_size;
+    ComZmpModel plant(read(x0), t_plant_mass);
+    plant.states().com_velocity = read(x0 + 3);
+    ComCtrl ctrl(ComZmpModel(read(x0), t_mass));
+    ctrl.reset(read(x0));
+    auto cmd = ctrl.getCommands();
+    for (std::size_t k = 0; k < n; ++k, c += Layout::input_size) {
+      ctrl.feedback(plant);
+      cmd->set_com_position(read(c));
+      cmd->set_com_velocity(c[3], c[4]);
+      cmd->qx1 = c[5];
+      cmd->qx2 = c[6];
+      cmd->qy1 = c[7];
+      cmd->qy2 = c[8];
+      cmd->qz1 = c[9];
+      cmd->qz2 = c[10];
+      if (!ctrl.update(t_rollout.time_step)) return false;
+      plant.setZmpPosition(ctrl.outputs().zmp_position,
+                           ctrl.outputs().reaction_force.z());
+      if (!plant.update(t_rollout.time_step)) return false;
+      out = write(plant.states().com_position, out);
+      out = write(plant.states().com_velocity, out);
+      out = write(plant.states().zmp_position, out);
+    }
+    return true;
+  });
+}
+
+bool rolloutPdCtrl(const BatchRollout& t_rollout, const double* t_initial,
+                   const double* t_refs, double* t_out) {
+  using Layout = PdCtrlRollout;
+  const std::size_t b = t_rollout.batch_num, n = t_rollout.step_num;
+  if (!isValid(t_rollout, t_initial, b * Layout::initial_size, t_refs,
+               b * Layout::input_size, t_out, b * n * Layout::output_size))
+    return false;
+  return forEachElement(t_rollout, [&](std::size_t i) {
+    const double* x0 = t_initial + i * Layout::initial_size;
+    const double* r = t_refs + i * Layout::input_size;
+    double* out = t_out + i * n * Layout::output_size;
+    if (!isValidMass(r[4])) return false;
+    PdCtrl<double> ctrl(PointMassModel<double>(x0[0], r[4]));
+    ctrl.model().states().velocity = x0[1];
+    ctrl.refs().position = r[0];
+    ctrl.refs().velocity = r[1];
+    ctrl.refs().stiffness = r[2];
+    ctrl.refs().damping = r[3];
+    for (std::size_t k = 0; k < n; ++k) {
+      if (!ctrl.update(t_rollout.time_step)) return false;
+      *out++ = ctrl.states().position;
+      *out++ = ctrl.states().velocity;
+      *out++ = ctrl.outputs().force;
+    }
+    return true;
+  });
+}
+
+}  // namespace holon
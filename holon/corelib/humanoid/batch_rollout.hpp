@@ -0,0 +1,87 @@
+/* batch_rollout - parallel rollouts of batches of models into flat arrays
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_BATCH_ROLLOUT_HPP_
+#define HOLON_HUMANOID_BATCH_ROLLOUT_HPP_
+
+#include <cstddef>
+
+namespace holon {
+
+// Batch rollouts simulate a batch of independent models for a number of
+// steps and write every step into caller-owned, row-major double arrays, so
+// that a caller such as the Python module passes its arrays without copies.
+// The elements of a batch are distributed over threads; a thread number of
+// zero uses the hardware concurrency. Each function returns false when the
+// arguments are invalid, e.g. the output overlaps the inputs, or an update
+// of any element fails.
+struct BatchRollout {
+  std::size_t batch_num;
+  std::size_t step_num;
+  double time_step;
+  std::size_t thread_num;
+};
+
+// ComZmpModel driven by ZMP positions
+//   initial : [batch_num][6] COM position, COM velocity
+//   zmp     : [batch_num][step_num][3] ZMP position at each step
+//   out     : [batch_num][step_num][6] COM position, COM velocity
+struct ComZmpModelRollout {
+  static constexpr std::size_t initial_size = 6;
+  static constexpr std::size_t input_size = 3;
+  static constexpr std::size_t output_size = 6;
+};
+bool rolloutComZmpModel(const BatchRollout& t_rollout, double t_mass,
+                        const double* t_initial, const double* t_zmp,
+                        double* t_out);
+
+// ComCtrl regulating a separate ComZmpModel plant in a closed loop; the
+// controller is fed back the COM state of the plant and drives it by the
+// desired ZMP position, and the commands are given at each step. The plant
+// mass differs from the mass of the controller to model the mismatch.
+//   initial  : [batch_num][6] COM position, COM velocity of the plant
+//   commands : [batch_num][step_num][11] xd, yd, zd, vxd, vyd, qx1, qx2,
+//              qy1, qy2, qz1, qz2
+//   out      : [batch_num][step_num][9] COM position, COM velocity of the
+//              plant, ZMP position
+struct ComCtrlRollout {
+  static constexpr std::size_t initial_size = 6;
+  static constexpr std::size_t input_size = 11;
+  static constexpr std::size_t output_size = 9;
+};
+bool rolloutComCtrl(const BatchRollout& t_rollout, double t_mass,
+                    double t_plant_mass, const double* t_initial,
+                    const double* t_commands, double* t_out);
+
+// PdCtrl of a scalar point mass
+//   initial : [batch_num][2] position, velocity
+//   refs    : [batch_num][5] position, velocity, stiffness, damping, mass
+//   out     : [batch_num][step_num][3] position, velocity, force
+struct PdCtrlRollout {
+  static constexpr std::size_t initial_size = 2;
+  static constexpr std::size_t input_size = 5;
+  static constexpr std::size_t output_size = 3;
+};
+bool rolloutPdCtrl(const BatchRollout& t_rollout, const double* t_initial,
+                   const double* t_refs, double* t_out);
+
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_BATCH_ROLLOUT_HPP_
@@ -0,0 +1,194 @@
+/* batch_rollout - parallel rollouts of batches of models into flat arrays
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/batch_rollout.hpp"
+
+#include <zm/zm_misc.h>
+#include <vector>
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kBatchNum = 5;
+const std::size_t kStepNum = 50;
+const double kTimeStep = 0.01;
+const double kMass = 1.5;
+
+Vec3D read(const double* t_p) { return Vec3D(t_p[0], t_p[1], t_p[2]); }
+
+TEST_CASE("rolloutComZmpModel: roll out models driven by ZMP",
+          "[BatchRollout][ComZmpModel]") {
+  using Layout = ComZmpModelRollout;
+  Fuzzer fuzz(-0.1, 0.1);
+  std::vector<double> initial(kBatchNum * Layout::initial_size);
+  std::vector<double> zmp(kBatchNum * kStepNum * Layout::input_size);
+  std::vector<double> out(kBatchNum * kStepNum * Layout::output_size);
+  for (auto& v : initial) v = fuzz();
+  for (std::size_t i = 0; i < kBatchNum; ++i) initial[i * 6 + 2] = 1;
+  for (auto& v : zmp) v = fuzz();
+
+  BatchRollout rollout{kBatchNum, kStepNum, kTimeStep, 1};
+  SECTION("single thread") {}
+  SECTION("multiple threads") { rollout.thread_num = 3; }
+  SECTION("hardware concurrency") { rollout.thread_num = 0; }
+  REQUIRE(rolloutComZmpModel(rollout, kMass, initial.data(), zmp.data(),
+                             out.data()));
+  for (std::size_t i = 0; i < kBatchNum; ++i) {
+    ComZmpModel model(read(&initial[i * 6]), kMass);
+    model.states().com_velocity = read(&initial[i * 6 + 3]);
+    for (std::size_t k = 0; k < kStepNum; ++k) {
+      model.setZmpPosition(read(&zmp[(i * kStepNum + k) * 3]));
+      model.update(kTimeStep);
+      const double* o = &out[(i * kStepNum + k) * 6];
+      CHECK(read(o) == model.states().com_position);
+      CHECK(read(o + 3) == model.states().com_velocity);
+    }
+  }
+}
+
+TEST_CASE("rolloutComCtrl: roll out controllers of plants with commands",
+          "[BatchRollout][ComCtrl]") {
+  using Layout = ComCtrlRollout;
+  const double plant_mass = 1.2 * kMass;
+  Fuzzer fuzz(-0.1, 0.1);
+  Fuzzer gain(0.5, 2);
+  std::vector<double> initial(kBatchNum * Layout::initial_size);
+  std::vector<double> commands(kBatchNum * kStepNum * Layout::input_size);
+  std::vector<double> out(kBatchNum * kStepNum * Layout::output_size);
+  for (auto& v : initial) v = fuzz();
+  for (std::size_t i = 0; i < kBatchNum; ++i) initial[i * 6 + 2] = 1;
+  for (std::size_t i = 0; i < kBatchNum * kStepNum; ++i) {
+    double* c = &commands[i * 11];
+    c[0] = fuzz(), c[1] = fuzz(), c[2] = 1 + fuzz();
+    c[3] = fuzz(), c[4] = 0;
+    for (std::size_t j = 5; j < 11; ++j) c[j] = gain();
+  }
+
+  BatchRollout rollout{kBatchNum, kStepNum, kTimeStep, 2};
+  REQUIRE(rolloutComCtrl(rollout, kMass, plant_mass, initial.data(),
+                         commands.data(), out.data()));
+  for (std::size_t i = 0; i < kBatchNum; ++i) {
+    ComZmpModel plant(read(&initial[i * 6]), plant_mass);
+    plant.states().com_velocity = read(&initial[i * 6 + 3]);
+    ComCtrl ctrl(ComZmpModel(read(&initial[i * 6]), kMass));
+    ctrl.reset(read(&initial[i * 6]));
+    auto cmd = ctrl.getCommands();
+    for (std::size_t k = 0; k < kStepNum; ++k) {
+      const double* c = &commands[(i * kStepNum + k) * 11];
+      ctrl.feedback(plant);
+      cmd->set_com_position(read(c));
+      cmd->set_com_velocity(c[3], c[4]);
+      cmd->qx1 = c[5], cmd->qx2 = c[6];
+      cmd->qy1 = c[7], cmd->qy2 = c[8];
+      cmd->qz1 = c[9], cmd->qz2 = c[10];
+      ctrl.update(kTimeStep);
+      plant.setZmpPosition(ctrl.outputs().zmp_position,
+                           ctrl.outputs().reaction_force.z());
+      plant.update(kTimeStep);
+      const double* o = &out[(i * kStepNum + k) * 9];
+      CHECK(read(o) == plant.states().com_position);
+      CHECK(read(o + 3) == plant.states().com_velocity);
+      CHECK(read(o + 6) == plant.states().zmp_position);
+    }
+  }
+}
+
+TEST_CASE("rolloutPdCtrl: roll out PD controllers with gains",
+          "[BatchRollout][PdCtrl]") {
+  using Layout = PdCtrlRollout;
+  Fuzzer fuzz(-1, 1);
+  Fuzzer positive(1, 10);
+  std::vector<double> initial(kBatchNum * Layout::initial_size);
+  std::vector<double> refs(kBatchNum * Layout::input_size);
+  std::vector<double> out(kBatchNum * kStepNum * Layout::output_size);
+  for (auto& v : initial) v = fuzz();
+  for (std::size_t i = 0; i < kBatchNum; ++i) {
+    double* r = &refs[i * 5];
+    r[0] = fuzz(), r[1] = 0, r[2] = positive(), r[3] = positive();
+    r[4] = positive();
+  }
+
+  BatchRollout rollout{kBatchNum, kStepNum, kTimeStep, 4};
+  REQUIRE(rolloutPdCtrl(rollout, initial.data(), refs.data(), out.data()));
+  for (std::size_t i = 0; i < kBatchNum; ++i) {
+    const double* r = &refs[i * 5];
+    PdCtrl<double> ctrl(PointMassModel<double>(initial[i * 2], r[4]));
+    ctrl.model().states().velocity = initial[i * 2 + 1];
+    ctrl.refs().position = r[0];
+    ctrl.refs().velocity = r[1];
+    ctrl.refs().stiffness = r[2];
+    ctrl.refs().damping = r[3];
+    for (std::size_t k = 0; k < kStepNum; ++k) {
+      ctrl.update(kTimeStep);
+      const double* o = &out[(i * kStepNum + k) * 3];
+      CHECK(o[0] == ctrl.states().position);
+      CHECK(o[1] == ctrl.states().velocity);
+      CHECK(o[2] == ctrl.outputs().force);
+    }
+  }
+}
+
+TEST_CASE("BatchRollout: reject invalid arguments", "[BatchRollout]") {
+  std::vector<double> initial(6, 1), input(11, 1), out(9, 0);
+  BatchRollout rollout{1, 1, kTimeStep, 1};
+  zEchoOff();
+  SECTION("time step") {
+    rollout.time_step = 0;
+    CHECK_FALSE(rolloutComZmpModel(rollout, kMass, initial.data(),
+                                   input.data(), out.data()));
+  }
+  SECTION("mass") {
+    CHECK_FALSE(rolloutComCtrl(rollout, 0, kMass, initial.data(),
+                               input.data(), out.data()));
+    CHECK_FALSE(rolloutComCtrl(rollout, kMass, 0, initial.data(),
+                               input.data(), out.data()));
+    input[4] = -1;
+    CHECK_FALSE(rolloutPdCtrl(rollout, initial.data(), input.data(),
+                              out.data()));
+  }
+  SECTION("arrays") {
+    CHECK_FALSE(rolloutComCtrl(rollout, kMass, kMass, nullptr, input.data(),
+                               out.data()));
+    CHECK_FALSE(rolloutPdCtrl(rollout, initial.data(), input.data(),
+                              nullptr));
+  }
+  SECTION("overlapping arrays") {
+    CHECK_FALSE(rolloutComZmpModel(rollout, kMass, initial.data(),
+                                   out.data() + 3, out.data()));
+    CHECK_FALSE(rolloutComZmpModel(rollout, kMass, out.data() + 3,
+                                   input.data(), out.data()));
+    CHECK_FALSE(rolloutPdCtrl(rollout, initial.data(), out.data() + 2,
+                              out.data()));
+  }
+  zEchoOn();
+  SECTION("empty batch") {
+    rollout.batch_num = 0;
+    CHECK(rolloutPdCtrl(rollout, nullptr, nullptr, nullptr));
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -26,6 +26,7 @@
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
 #include "holon/corelib/humanoid/com_ctrl/phase_y.hpp"
+#include "holon/corelib/humanoid/com_zmp_estimator.hpp"
 #include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
 #include "holon/corelib/math/misc.hpp"
 
@@ -141,6 +142,10 @@ void ComCtrl::feedback(const Vec3D& t_com_position,
   states().com_velocity = t_com_velocity;
 }
 
+void ComCtrl::feedback(const ComZmpEstimator& t_estimator) {
+  feedback(t_estimator.com_position(), t_estimator.com_velocity());
+}
+
 Vec3D ComCtrl::computeDesReactForce(const Vec3D& t_com_position,
                                     const Vec3D& t_com_velocity,
                                     const double /* t */) {
@@ -202,6 +207,24 @@ double ComCtrl::phaseRF() const {
   return phase_y::computePhase(pz, pRin);
 }
 
+std::size_t ComCtrl::internals_size() const {
+  return field_binary_size<Vec3D>::value + 3 * field_binary_size<double>::value;
+}
+
+char* ComCtrl::saveInternals(char* t_p) const {
+  t_p = pack_fields(t_p, m_default_com_position);
+  t_p = pack_fields(t_p, m_canonical_foot_dist);
+  t_p = pack_fields(t_p, m_max_foot_dist);
+  return pack_fields(t_p, m_current_foot_dist);
+}
+
+const char* ComCtrl::loadInternals(const char* t_p) {
+  t_p = unpack_fields(t_p, &m_default_com_position);
+  t_p = unpack_fields(t_p, &m_canonical_foot_dist);
+  t_p = unpack_fields(t_p, &m_max_foot_dist);
+  return unpack_fields(t_p, &m_current_foot_dist);
+}
+
 void ComCtrl::updateSideward() {
   auto zeta = formula::computeZeta(states().com_position, states().zmp_position,
                                    states().com_acceleration);
@@ -25,11 +25,14 @@
 #include "holon/corelib/common/optional.hpp"
 #include "holon/corelib/control/ctrl_base.hpp"
 #include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/data/fields.hpp"
 #include "holon/corelib/humanoid/com_zmp_model.hpp"
 #include "holon/corelib/math/vec3d.hpp"
 
 namespace holon {
 
+class ComZmpEstimator;
+
 struct ComCtrlCommandsRawData {
   using opt_double = optional<double>;
 
@@ -45,6 +48,9 @@ struct ComCtrlCommandsRawData {
   void set_com_position(const Vec3D& t_com_position);
   void set_com_position(opt_double t_xd, opt_double t_yd, opt_double t_zd);
   void set_com_velocity(opt_double t_vxd, opt_double t_vyd);
+
+  HOLON_DEFINE_FIELDS(ComCtrlCommandsRawData, xd, yd, zd, vxd, vyd, qx1, qx2,
+                      qy1, qy2, qz1, qz2, rho, dist, kr, vhp)
 };
 
 struct ComCtrlRefsRawData {
@@ -55,6 +61,9 @@ struct ComCtrlRefsRawData {
   double qz1, qz2;
   double rho, dist, kr;
   double vhp;
+
+  HOLON_DEFINE_FIELDS(ComCtrlRefsRawData, com_position, com_velocity, qx1, qx2,
+                      qy1, qy2, qz1, qz2, rho, dist, kr, vhp)
 };
 
 struct ComCtrlOutputsRawData {
@@ -63,6 +72,9 @@ struct ComCtrlOutputsRawData {
   Vec3D com_acceleration;
   Vec3D zmp_position;
   Vec3D reaction_force;
+
+  HOLON_DEFINE_FIELDS(ComCtrlOutputsRawData, com_position, com_velocity,
+                      com_acceleration, zmp_position, reaction_force)
 };
 
 class ComCtrlData
@@ -131,6 +143,7 @@ class ComCtrl : public CtrlBase<Vec3D, RungeKutta4<std::array<Vec3D, 2>>,
   void feedback(const Model& t_model);
   void feedback(ComZmpModelData t_model_data);
   void feedback(const Vec3D& t_com_position, const Vec3D& t_com_velocity);
+  void feedback(const ComZmpEstimator& t_estimator);
   virtual bool update() override;
   virtual bool update(double t_time_step) override;
 
@@ -145,6 +158,11 @@ class ComCtrl : public CtrlBase<Vec3D, RungeKutta4<std::array<Vec3D, 2>>,
   double phaseLF() const;
   double phaseRF() const;
 
+ protected:
+  virtual std::size_t internals_size() const override;
+  virtual char* saveInternals(char* t_p) const override;
+  virtual const char* loadInternals(const char* t_p) override;
+
  private:
   Vec3D m_default_com_position;
   double m_canonical_foot_dist;
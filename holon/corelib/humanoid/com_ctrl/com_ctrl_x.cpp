@@ -25,17 +25,22 @@
 namespace holon {
 namespace com_ctrl_x {
 
-double computeDesZmpPos(double t_x, double t_v, double t_xd, double t_vd,
-                        double t_q1, double t_q2, double t_zeta) {
+template <typename T>
+T computeDesZmpPos(T t_x, T t_v, T t_xd, T t_vd, T t_q1, T t_q2, T t_zeta) {
   if (zIsTiny(t_zeta) || t_zeta < 0) {
-    ZRUNERROR("ZETA should be positive. (given: %f)", t_zeta);
+    ZRUNERROR("ZETA should be positive. (given: %f)", double(t_zeta));
     return 0;
   }
-  double x = t_x - t_xd;
-  double v = t_v - t_vd;
+  T x = t_x - t_xd;
+  T v = t_v - t_vd;
   return t_x + (t_q1 * t_q2) * x + (t_q1 + t_q2) * v / t_zeta;
 }
 
+template double computeDesZmpPos<double>(double, double, double, double,
+                                         double, double, double);
+template float computeDesZmpPos<float>(float, float, float, float, float,
+                                       float, float);
+
 double computeDesZmpPos(const Vec3D& t_com_position,
                         const Vec3D& t_com_velocity,
                         const Vec3D& t_ref_com_position,
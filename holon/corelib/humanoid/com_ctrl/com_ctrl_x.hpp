@@ -36,8 +36,9 @@ struct Parameters {
 static const double default_q1 = 1;
 static const double default_q2 = 1;
 
-double computeDesZmpPos(double t_x, double t_v, double t_xd, double t_vd,
-                        double t_q1, double t_q2, double t_zeta);
+// The scalar function is instantiated for float and double.
+template <typename T>
+T computeDesZmpPos(T t_x, T t_v, T t_xd, T t_vd, T t_q1, T t_q2, T t_zeta);
 double computeDesZmpPos(const Vec3D& t_com_position,
                         const Vec3D& t_com_velocity,
                         const Vec3D& t_ref_com_position,
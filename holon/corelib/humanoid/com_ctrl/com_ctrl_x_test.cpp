@@ -23,6 +23,7 @@
 #include <cure/cure_misc.h>
 
 #include "catch.hpp"
+#include "holon/test/util/differential/differential.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
 namespace holon {
@@ -330,5 +331,56 @@ TEST_CASE("Case 9: desired ZMP for logitudinal moving alog x-axis",
   }
 }
 
+TEST_CASE("Desired ZMP along x-axis in single precision",
+          "[ComCtrlX][float]") {
+  Fuzzer fuzz(-1, 1);
+  Fuzzer fuzz_positive(0.1, 2);
+  for (auto i = 0; i < 10; ++i) {
+    double x = fuzz(), v = fuzz(), xd = fuzz(), vd = fuzz();
+    double q1 = fuzz_positive(), q2 = fuzz_positive(), zeta = fuzz_positive();
+    auto expected_xz = computeDesZmpPos(x, v, xd, vd, q1, q2, zeta);
+    auto xz = computeDesZmpPos<float>(x, v, xd, vd, q1, q2, zeta);
+    CHECK(xz == Approx(expected_xz).margin(1e-5));
+  }
+}
+
+TEST_CASE("Desired ZMP along x-axis in single precision against double",
+          "[ComCtrlX][float][differential]") {
+  // inputs are rounded to float in advance so that only errors in
+  // arithmetic are measured
+  auto reference = [](const std::array<double, 7>& x) {
+    return computeDesZmpPos<double>(float(x[0]), float(x[1]), float(x[2]),
+                                    float(x[3]), float(x[4]), float(x[5]),
+                                    float(x[6]));
+  };
+  auto candidate = [](const std::array<double, 7>& x) {
+    return computeDesZmpPos<float>(x[0], x[1], x[2], x[3], x[4], x[5], x[6]);
+  };
+  EdgeCaseFuzzer fuzz(0.1, 2);
+  zEchoOff();
+  auto res = compareUlp<7>(fuzz, fuzz_sample_count(100000), reference,
+                           candidate);
+  zEchoOn();
+  INFO(res.ulp << "worst input: " << to_string(res.worst_input));
+  CHECK(res.ulp.nan_mismatch_count() == 0);
+  CHECK(res.ulp.percentile(0.9) <= 3);
+}
+
+TEST_CASE("Desired ZMP along x-axis of Vec3D agrees with scalar one",
+          "[ComCtrlX][differential]") {
+  EdgeCaseFuzzer fuzz(-2, 2);
+  zEchoOff();
+  checkProperty<5>(fuzz, fuzz_sample_count(10000),
+                   [](const std::array<double, 5>& x) {
+                     Vec3D p(x[0], 0, 1), v(x[1], 0, 0);
+                     Parameters params = {x[2], 0, x[3], 1, x[4]};
+                     return ulp_distance(
+                                computeDesZmpPos(p, v, params),
+                                computeDesZmpPos<double>(x[0], x[1], x[2], 0,
+                                                         x[3], 1, x[4])) == 0;
+                   });
+  zEchoOn();
+}
+
 }  // namespace
 }  // namespace holon
@@ -21,36 +21,44 @@
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
 
 #include <zm/zm_misc.h>
+#include <cmath>
+#include "holon/corelib/math/misc.hpp"
 
 namespace holon {
 namespace com_ctrl_y {
 
 namespace {
 
-double computeNonlinearDumping(double t_y, double t_v, double t_yd, double t_q1,
-                               double t_q2, double t_rho, double t_dist,
-                               double t_kr, double t_zeta) {
-  if (zIsTiny(t_rho) || t_rho < 0.0) return 1.0;
-  if (zIsTiny(t_dist) || t_dist < 0.0) return 1.0;
-  double r2 = zSqr(t_y - t_yd) + zSqr(t_v / t_zeta) / (t_q1 * t_q2);
-  double rz = 0.5 * t_dist;
-  return 1.0 - t_rho * exp(t_kr * (1.0 - zSqr((t_q1 * t_q2 + 1.0) / rz) * r2));
+template <typename T>
+T computeNonlinearDumping(T t_y, T t_v, T t_yd, T t_q1, T t_q2, T t_rho,
+                          T t_dist, T t_kr, T t_zeta) {
+  if (zIsTiny(t_rho) || t_rho < 0) return 1;
+  if (zIsTiny(t_dist) || t_dist < 0) return 1;
+  T r2 = square(t_y - t_yd) + square(t_v / t_zeta) / (t_q1 * t_q2);
+  T rz = T(0.5) * t_dist;
+  return 1 - t_rho * std::exp(t_kr * (1 - square((t_q1 * t_q2 + 1) / rz) * r2));
 }
 
 }  // namespace
 
-double computeDesZmpPos(double t_y, double t_v, double t_yd, double t_q1,
-                        double t_q2, double t_rho, double t_dist, double t_kr,
-                        double t_zeta) {
+template <typename T>
+T computeDesZmpPos(T t_y, T t_v, T t_yd, T t_q1, T t_q2, T t_rho, T t_dist,
+                   T t_kr, T t_zeta) {
   if (zIsTiny(t_zeta) || t_zeta < 0) {
-    ZRUNERROR("ZETA should be positive. (given: %f)", t_zeta);
+    ZRUNERROR("ZETA should be positive. (given: %f)", double(t_zeta));
     return 0;
   }
-  double nd = computeNonlinearDumping(t_y, t_v, t_yd, t_q1, t_q2, t_rho, t_dist,
-                                      t_kr, t_zeta);
+  T nd = computeNonlinearDumping(t_y, t_v, t_yd, t_q1, t_q2, t_rho, t_dist,
+                                 t_kr, t_zeta);
   return t_y + (t_q1 * t_q2) * (t_y - t_yd) + (t_q1 + t_q2) * nd * t_v / t_zeta;
 }
 
+template double computeDesZmpPos<double>(double, double, double, double,
+                                         double, double, double, double,
+                                         double);
+template float computeDesZmpPos<float>(float, float, float, float, float,
+                                       float, float, float, float);
+
 double computeDesZmpPos(const Vec3D& t_com_position,
                         const Vec3D& t_com_velocity,
                         const Vec3D& t_ref_com_position, double t_q1,
@@ -39,9 +39,10 @@ static const double default_rho = 0;
 static const double default_dist = 0;
 static const double default_kr = 1;
 
-double computeDesZmpPos(double t_y, double t_v, double t_yd, double t_q1,
-                        double t_q2, double t_rho, double t_dist, double t_kr,
-                        double t_zeta);
+// The scalar function is instantiated for float and double.
+template <typename T>
+T computeDesZmpPos(T t_y, T t_v, T t_yd, T t_q1, T t_q2, T t_rho, T t_dist,
+                   T t_kr, T t_zeta);
 double computeDesZmpPos(const Vec3D& t_com_position,
                         const Vec3D& t_com_velocity,
                         const Vec3D& t_ref_com_position, double t_q1,
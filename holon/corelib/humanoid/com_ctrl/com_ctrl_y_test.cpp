@@ -326,5 +326,20 @@ TEST_CASE("Case 8: dumping term should 1 when dist = 0, even if rho =1",
   }
 }
 
+TEST_CASE("Desired ZMP along y-axis in single precision",
+          "[ComCtrlY][float]") {
+  Fuzzer fuzz(-0.1, 0.1);
+  Fuzzer fuzz_positive(0.1, 2);
+  for (auto i = 0; i < 10; ++i) {
+    double y = fuzz(), v = fuzz(), yd = fuzz();
+    double q1 = fuzz_positive(), q2 = fuzz_positive(), zeta = fuzz_positive();
+    double rho = 1, dist = 0.2, kr = 1;
+    auto expected_yz =
+        computeDesZmpPos(y, v, yd, q1, q2, rho, dist, kr, zeta);
+    auto yz = computeDesZmpPos<float>(y, v, yd, q1, q2, rho, dist, kr, zeta);
+    CHECK(yz == Approx(expected_yz).margin(1e-5));
+  }
+}
+
 }  // namespace
 }  // namespace holon
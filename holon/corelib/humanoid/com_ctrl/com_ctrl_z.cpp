@@ -22,32 +22,39 @@
 
 #include <roki/rk_g.h>
 #include <algorithm>
+#include <cmath>
 
 namespace holon {
 namespace com_ctrl_z {
 
 namespace {
 
-double computeSqrXi(double t_zd) {
+template <typename T>
+T computeSqrXi(T t_zd) {
   if (zIsTiny(t_zd) || t_zd < 0) {
-    ZRUNERROR("Desired COM height should be positive. (given: %f)", t_zd);
+    ZRUNERROR("Desired COM height should be positive. (given: %f)",
+              double(t_zd));
     return 0;
   }
-  return RK_G / t_zd;
+  return T(RK_G) / t_zd;
 }
 
 }  // namespace
 
-double computeDesReactForce(double t_z, double t_v, double t_zd, double t_q1,
-                            double t_q2, double t_mass) {
-  double xi2 = computeSqrXi(t_zd);
-  double xi = sqrt(xi2);
-  double fz =
-      -xi2 * t_q1 * t_q2 * (t_z - t_zd) - xi * (t_q1 + t_q2) * t_v + RK_G;
+template <typename T>
+T computeDesReactForce(T t_z, T t_v, T t_zd, T t_q1, T t_q2, T t_mass) {
+  T xi2 = computeSqrXi(t_zd);
+  T xi = std::sqrt(xi2);
+  T fz = -xi2 * t_q1 * t_q2 * (t_z - t_zd) - xi * (t_q1 + t_q2) * t_v + T(RK_G);
   fz *= t_mass;
-  return std::max<double>(fz, 0);
+  return std::max<T>(fz, 0);
 }
 
+template double computeDesReactForce<double>(double, double, double, double,
+                                             double, double);
+template float computeDesReactForce<float>(float, float, float, float, float,
+                                           float);
+
 double computeDesReactForce(const Vec3D& t_com_position,
                             const Vec3D& t_com_velocity,
                             const Vec3D& t_ref_com_position, double t_q1,
@@ -35,8 +35,9 @@ struct Parameters {
 static const double default_q1 = 1;
 static const double default_q2 = 1;
 
-double computeDesReactForce(double t_z, double t_v, double t_zd, double t_q1,
-                            double t_q2, double t_mass);
+// The scalar function is instantiated for float and double.
+template <typename T>
+T computeDesReactForce(T t_z, T t_v, T t_zd, T t_q1, T t_q2, T t_mass);
 double computeDesReactForce(const Vec3D& t_com_position,
                             const Vec3D& t_com_velocity,
                             const Vec3D& t_ref_com_position, double t_q1,
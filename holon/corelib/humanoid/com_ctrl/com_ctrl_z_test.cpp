@@ -203,5 +203,18 @@ TEST_CASE("Case 4: compute desired reaction force along z-axis",
   zEchoOn();
 }
 
+TEST_CASE("Desired reaction force in single precision",
+          "[ComCtrlZ][float]") {
+  Fuzzer fuzz(-0.1, 0.1);
+  Fuzzer fuzz_positive(0.5, 2);
+  for (auto i = 0; i < 10; ++i) {
+    double zd = fuzz_positive(), z = zd + fuzz(), v = fuzz();
+    double q1 = fuzz_positive(), q2 = fuzz_positive(), mass = fuzz_positive();
+    auto expected_fz = computeDesReactForce(z, v, zd, q1, q2, mass);
+    auto fz = computeDesReactForce<float>(z, v, zd, q1, q2, mass);
+    CHECK(fz == Approx(expected_fz).epsilon(1e-5));
+  }
+}
+
 }  // namespace
 }  // namespace holon
@@ -28,19 +28,21 @@
 namespace holon {
 namespace phase_y {
 
-double computeFrequency(double t_q1, double t_q2, double t_zeta) {
+template <typename T>
+T computeFrequency(T t_q1, T t_q2, T t_zeta) {
   if (t_zeta < 0 || (t_q1 * t_q2) < 0) {
-    ZRUNERROR("ZETA, Q1 and Q2 must be positive. (given: %f, %f, %f)", t_zeta,
-              t_q1, t_q2);
+    ZRUNERROR("ZETA, Q1 and Q2 must be positive. (given: %f, %f, %f)",
+              double(t_zeta), double(t_q1), double(t_q2));
     return 0;
   }
   return t_zeta * std::sqrt(t_q1 * t_q2);
 }
 
-Complex computeComplexZmp(double t_yz, double t_vy, double t_yd, double t_q1,
-                          double t_q2, double t_zeta) {
-  double omega = computeFrequency(t_q1, t_q2, t_zeta);
-  return Complex(t_yz - t_yd, -(t_q1 * t_q2 + 1.0) * t_vy / omega);
+template <typename T>
+std::complex<T> computeComplexZmp(T t_yz, T t_vy, T t_yd, T t_q1, T t_q2,
+                                  T t_zeta) {
+  T omega = computeFrequency(t_q1, t_q2, t_zeta);
+  return std::complex<T>(t_yz - t_yd, -(t_q1 * t_q2 + 1) * t_vy / omega);
 }
 
 Complex computeComplexZmp(const Vec3D& t_zmp_position,
@@ -51,10 +53,13 @@ Complex computeComplexZmp(const Vec3D& t_zmp_position,
                            t_ref_com_position.y(), t_q1, t_q2, t_zeta);
 }
 
-Complex computeComplexInnerEdge(double t_yin, double t_yd, const Complex& t_pz,
-                                int t_is_left) {
-  double y = t_yin - t_yd;
-  return Complex(y, -std::sqrt(std::norm(t_pz) - y * y) * sgn(t_is_left));
+template <typename T>
+std::complex<T> computeComplexInnerEdge(T t_yin, T t_yd,
+                                        const std::complex<T>& t_pz,
+                                        int t_is_left) {
+  T y = t_yin - t_yd;
+  return std::complex<T>(
+      y, -std::sqrt(std::norm(t_pz) - y * y) * T(sgn(t_is_left)));
 }
 
 Complex computeComplexInnerEdge(const Vec3D& t_inner_edge,
@@ -64,8 +69,9 @@ Complex computeComplexInnerEdge(const Vec3D& t_inner_edge,
                                  t_is_left);
 }
 
-double computePhase(double t_yz, double t_vy, double t_yd, double t_yin,
-                    double t_q1, double t_q2, double t_zeta, int t_is_left) {
+template <typename T>
+T computePhase(T t_yz, T t_vy, T t_yd, T t_yin, T t_q1, T t_q2, T t_zeta,
+               int t_is_left) {
   auto pz = computeComplexZmp(t_yz, t_vy, t_yd, t_q1, t_q2, t_zeta);
   return computePhase(pz, computeComplexInnerEdge(t_yin, t_yd, pz, t_is_left));
 }
@@ -78,58 +84,81 @@ double computePhase(const Vec3D& t_zmp_position, const Vec3D& t_com_velocity,
                               t_inner_edge, t_ref_com_position, pz, t_is_left));
 }
 
-double computePhase(const Complex& t_pz, const Complex& t_p0) {
+template <typename T>
+T computePhase(const std::complex<T>& t_pz, const std::complex<T>& t_p0) {
   auto t_p1 = std::conj(t_p0);
   auto denom = std::arg(t_p1 / t_p0);
-  if (denom < 0) denom += 2.0 * M_PI;
+  if (denom < 0) denom += T(2.0 * M_PI);
   auto numer = std::arg(t_pz / t_p0);
-  if (zIsTiny(denom - std::fabs(numer))) return 1.0;
-  return limit(numer / denom, 0.0, 1.0);
+  if (zIsTiny(denom - std::fabs(numer))) return 1;
+  return limit<T>(numer / denom, 0, 1);
 }
 
 namespace internal {
 
-bool isOmegaValid(const double t_omega) {
+template <typename T>
+bool isOmegaValid(const T t_omega) {
   if (zIsTiny(t_omega)) {
     ZRUNERROR("Frequency of oscillation must be positive. (given: %f)",
-              t_omega);
+              double(t_omega));
     return false;
   }
   return true;
 }
 
-bool isOmegaValid(const double t_q1, const double t_q2, const double t_zeta) {
+template <typename T>
+bool isOmegaValid(const T t_q1, const T t_q2, const T t_zeta) {
   return isOmegaValid(computeFrequency(t_q1, t_q2, t_zeta));
 }
 
 }  // namespace internal
 
-double computePeriod(double t_q1, double t_q2, double t_zeta) {
+template <typename T>
+T computePeriod(T t_q1, T t_q2, T t_zeta) {
   auto omega = computeFrequency(t_q1, t_q2, t_zeta);
   if (!internal::isOmegaValid(omega)) return 0;
-  return zPIx2 / omega;
+  return T(zPIx2) / omega;
 }
 
-double computeTimeSpan(const Complex& t_p0, double t_q1, double t_q2,
-                       double t_zeta) {
+template <typename T>
+T computeTimeSpan(const std::complex<T>& t_p0, T t_q1, T t_q2, T t_zeta) {
   auto omega = computeFrequency(t_q1, t_q2, t_zeta);
   if (!internal::isOmegaValid(omega)) return 0;
   return std::arg(std::conj(t_p0) / t_p0) / omega;
 }
 
-double computeElapsedTime(const Complex& t_pz, const Complex& t_p0, double t_q1,
-                          double t_q2, double t_zeta) {
+template <typename T>
+T computeElapsedTime(const std::complex<T>& t_pz, const std::complex<T>& t_p0,
+                     T t_q1, T t_q2, T t_zeta) {
   auto omega = computeFrequency(t_q1, t_q2, t_zeta);
   if (!internal::isOmegaValid(omega)) return 0;
   return std::arg(t_pz / t_p0) / omega;
 }
 
-double computeRemainingTime(const Complex& t_pz, const Complex& t_p0,
-                            double t_q1, double t_q2, double t_zeta) {
+template <typename T>
+T computeRemainingTime(const std::complex<T>& t_pz,
+                       const std::complex<T>& t_p0, T t_q1, T t_q2, T t_zeta) {
   auto omega = computeFrequency(t_q1, t_q2, t_zeta);
   if (!internal::isOmegaValid(omega)) return 0;
   return std::arg(std::conj(t_p0) / t_pz) / omega;
 }
 
+#define HOLON_PHASE_Y_INSTANTIATE(T)                                         \
+  template T computeFrequency<T>(T, T, T);                                   \
+  template std::complex<T> computeComplexZmp<T>(T, T, T, T, T, T);           \
+  template std::complex<T> computeComplexInnerEdge<T>(                       \
+      T, T, const std::complex<T>&, int);                                    \
+  template T computePhase<T>(T, T, T, T, T, T, T, int);                      \
+  template T computePhase<T>(const std::complex<T>&, const std::complex<T>&); \
+  template T computePeriod<T>(T, T, T);                                      \
+  template T computeTimeSpan<T>(const std::complex<T>&, T, T, T);            \
+  template T computeElapsedTime<T>(const std::complex<T>&,                   \
+                                   const std::complex<T>&, T, T, T);         \
+  template T computeRemainingTime<T>(const std::complex<T>&,                 \
+                                     const std::complex<T>&, T, T, T);
+HOLON_PHASE_Y_INSTANTIATE(double)
+HOLON_PHASE_Y_INSTANTIATE(float)
+#undef HOLON_PHASE_Y_INSTANTIATE
+
 }  // namespace phase_y
 }  // namespace holon
@@ -29,36 +29,46 @@ namespace phase_y {
 
 using Complex = std::complex<double>;
 
-double computeFrequency(double t_q1, double t_q2, double t_zeta);
+// The scalar functions are instantiated for float and double.
+template <typename T>
+T computeFrequency(T t_q1, T t_q2, T t_zeta);
 
-Complex computeComplexZmp(double t_yz, double t_vy, double t_yd, double t_q1,
-                          double t_q2, double t_zeta);
+template <typename T>
+std::complex<T> computeComplexZmp(T t_yz, T t_vy, T t_yd, T t_q1, T t_q2,
+                                  T t_zeta);
 Complex computeComplexZmp(const Vec3D& t_zmp_position,
                           const Vec3D& t_com_velocity,
                           const Vec3D& t_ref_com_position, double t_q1,
                           double t_q2, double t_zeta);
 
-Complex computeComplexInnerEdge(double t_yin, double t_yd, const Complex& t_pz,
-                                int t_is_left);
+template <typename T>
+std::complex<T> computeComplexInnerEdge(T t_yin, T t_yd,
+                                        const std::complex<T>& t_pz,
+                                        int t_is_left);
 Complex computeComplexInnerEdge(const Vec3D& t_inner_edge,
                                 const Vec3D& t_ref_com_position,
                                 const Complex& t_pz, int t_is_left);
 
-double computePhase(double t_yz, double t_vy, double t_yd, double t_yin,
-                    double t_q1, double t_q2, double t_zeta, int t_is_left);
+template <typename T>
+T computePhase(T t_yz, T t_vy, T t_yd, T t_yin, T t_q1, T t_q2, T t_zeta,
+               int t_is_left);
 double computePhase(const Vec3D& t_zmp_position, const Vec3D& t_com_velocity,
                     const Vec3D& t_ref_com_position, const Vec3D& t_inner_edge,
                     double t_q1, double t_q2, double t_zeta, int t_is_left);
-double computePhase(const Complex& t_pz, const Complex& t_p0);
+template <typename T>
+T computePhase(const std::complex<T>& t_pz, const std::complex<T>& t_p0);
 
-double computePeriod(double t_q1, double t_q2, double t_zeta);
+template <typename T>
+T computePeriod(T t_q1, T t_q2, T t_zeta);
 
-double computeTimeSpan(const Complex& t_p0, double t_q1, double t_q2,
-                       double t_zeta);
-double computeElapsedTime(const Complex& t_pz, const Complex& t_p0, double t_q1,
-                          double t_q2, double t_zeta);
-double computeRemainingTime(const Complex& t_pz, const Complex& t_p0,
-                            double t_q1, double t_q2, double t_zeta);
+template <typename T>
+T computeTimeSpan(const std::complex<T>& t_p0, T t_q1, T t_q2, T t_zeta);
+template <typename T>
+T computeElapsedTime(const std::complex<T>& t_pz, const std::complex<T>& t_p0,
+                     T t_q1, T t_q2, T t_zeta);
+template <typename T>
+T computeRemainingTime(const std::complex<T>& t_pz,
+                       const std::complex<T>& t_p0, T t_q1, T t_q2, T t_zeta);
 
 }  // namespace phase_y
 }  // namespace holon
@@ -20,9 +20,12 @@
 
 #include "holon/corelib/humanoid/com_ctrl/phase_y.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "catch.hpp"
+#include "holon/test/util/differential/differential.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
 namespace holon {
@@ -329,6 +332,89 @@ TEST_CASE("The case where frequency equals to zero should be handled",
   zEchoOn();
 }
 
+TEST_CASE("Phase of ZMP in single precision",
+          "[phase_y][float]") {
+  Fuzzer fuzz(-0.1, 0.1);
+  Fuzzer fuzz_positive(0.5, 2);
+  for (auto i = 0; i < 10; ++i) {
+    double yz = fuzz(), vy = fuzz(), yd = fuzz();
+    double q1 = fuzz_positive(), q2 = fuzz_positive(), zeta = fuzz_positive();
+    auto expected_pz = computeComplexZmp(yz, vy, yd, q1, q2, zeta);
+    auto pz = computeComplexZmp<float>(yz, vy, yd, q1, q2, zeta);
+    CHECK(pz.real() == Approx(expected_pz.real()).margin(1e-6));
+    CHECK(pz.imag() == Approx(expected_pz.imag()).margin(1e-6));
+    CHECK(computePeriod<float>(q1, q2, zeta) ==
+          Approx(computePeriod(q1, q2, zeta)).epsilon(1e-5));
+    double yin = yd + 0.5 * expected_pz.real();
+    auto expected_phase = computePhase(
+        expected_pz, computeComplexInnerEdge(yin, yd, expected_pz, 1));
+    auto phase = computePhase(
+        pz, computeComplexInnerEdge<float>(yin, yd, pz, 1));
+    CHECK(phase == Approx(expected_phase).margin(1e-5));
+  }
+}
+
+TEST_CASE("Phase along y-axis in single precision against double",
+          "[phase_y][float][differential]") {
+  // arguments: yz, vy, yd, yin, q1, q2, zeta
+  // (edge cases are checked separately below since huge values overflow
+  // in float)
+  auto reference = [](const std::array<double, 7>& x) {
+    return computePhase<double>(float(x[0]), float(x[1]), float(x[2]),
+                                float(x[3]), float(x[4]), float(x[5]),
+                                float(x[6]), 1);
+  };
+  auto candidate = [](const std::array<double, 7>& x) {
+    return computePhase<float>(x[0], x[1], x[2], x[3], x[4], x[5], x[6], 1);
+  };
+  EdgeCaseFuzzer fuzz(0.1, 2, 0);
+  zEchoOff();
+  auto res = compareUlp<7>(fuzz, fuzz_sample_count(100000), reference,
+                           candidate);
+  zEchoOn();
+  INFO(res.ulp << "worst input: " << to_string(res.worst_input));
+  CHECK(res.ulp.nan_mismatch_count() == 0);
+  CHECK(res.ulp.percentile(0.9) <= 3);
+}
+
+TEST_CASE("Phase along y-axis in single precision with edge cases",
+          "[phase_y][float][differential]") {
+  // arguments: yz, vy, yd, yin, q1, q2, zeta
+  // The phase is in [0, 1] or NaN for any arguments. It is NaN in float if
+  // and only if it is in double within the domain, i.e. unless the
+  // frequency is not positive, the squared magnitude of the complex ZMP
+  // overflows in float or the inner edge is on the circle of the complex
+  // ZMP within rounding errors of float.
+  auto is_edge_case = [](double v) { return !(v >= 0.1 && v <= 2); };
+  EdgeCaseFuzzer fuzz(0.1, 2);
+  std::size_t n_edge_case = 0;
+  zEchoOff();
+  checkProperty<7>(
+      fuzz, fuzz_sample_count(100000), [&](const std::array<double, 7>& x) {
+        std::array<float, 7> f;
+        for (std::size_t i = 0; i < 7; ++i) f[i] = x[i];
+        float phase =
+            computePhase<float>(f[0], f[1], f[2], f[3], f[4], f[5], f[6], 1);
+        if (!std::isnan(phase) && (phase < 0 || phase > 1)) return false;
+        float omega = computeFrequency(f[4], f[5], f[6]);
+        auto pz = computeComplexZmp(f[0], f[1], f[2], f[4], f[5], f[6]);
+        if (zIsTiny(omega) || !(omega > 0) || !std::isfinite(std::norm(pz)))
+          return true;
+        double y = double(f[3]) - f[2];
+        double r2 = std::norm(
+            computeComplexZmp<double>(f[0], f[1], f[2], f[4], f[5], f[6]));
+        if (std::fabs(r2 - y * y) <=
+            4 * std::numeric_limits<float>::epsilon() * r2)
+          return true;
+        if (std::any_of(x.begin(), x.end(), is_edge_case)) ++n_edge_case;
+        double expected =
+            computePhase<double>(f[0], f[1], f[2], f[3], f[4], f[5], f[6], 1);
+        return std::isnan(phase) == std::isnan(expected);
+      });
+  zEchoOn();
+  CHECK(n_edge_case > 0);
+}
+
 }  // namespace
 }  // namespace phase_y
 }  // namespace holon
@@ -0,0 +1,106 @@
+/* com_ctrl_blocks - blocks of COM controller for static dataflow graph
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_COM_CTRL_BLOCKS_HPP_
+#define HOLON_HUMANOID_COM_CTRL_BLOCKS_HPP_
+
+#include <array>
+#include "holon/corelib/control/dataflow.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
+#include "holon/corelib/humanoid/com_zmp_estimator.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+namespace dataflow {
+
+// COM controller in the same formulas as ComCtrl::computeDesZmpPos;
+// inputs are (position, velocity) of the COM and the referential COM
+// position, and the output is (ZMP position, reaction force). The other
+// references are held in the block and given by refs().
+class ComCtrlBlock {
+ public:
+  using Output = std::array<Vec3D, 2>;
+  using Input = std::array<Vec3D, 2>;
+  using Refs = ComCtrlRefsRawData;
+
+  explicit ComCtrlBlock(const Refs& t_refs,
+                        double t_mass = ComCtrlData::default_mass)
+      : m_refs(t_refs), m_mass(t_mass) {}
+
+  inline const Refs& refs() const noexcept { return m_refs; }
+  inline Refs& refs() noexcept { return m_refs; }
+  inline double mass() const noexcept { return m_mass; }
+  Output update(double, const Input& t_x, const Vec3D& t_ref) const {
+    double fz = com_ctrl_z::computeDesReactForce(
+        t_x[0], t_x[1], t_ref, m_refs.qz1, m_refs.qz2, m_mass);
+    double zeta = com_zmp_model_formula::computeZeta(t_x[0].z(), m_refs.vhp,
+                                                     fz, m_mass);
+    double xz = com_ctrl_x::computeDesZmpPos(t_x[0], t_x[1], t_ref,
+                                             m_refs.com_velocity, m_refs.qx1,
+                                             m_refs.qx2, zeta);
+    double yz = com_ctrl_y::computeDesZmpPos(
+        t_x[0], t_x[1], t_ref, m_refs.qy1, m_refs.qy2, m_refs.rho,
+        m_refs.dist, m_refs.kr, zeta);
+    return Output{{Vec3D(xz, yz, m_refs.vhp), Vec3D(0, 0, fz)}};
+  }
+
+ private:
+  Refs m_refs;
+  double m_mass;
+};
+
+// estimator of the COM state by ComZmpEstimator; inputs are the measured
+// COM position and ZMP position, and the output is the estimated (position,
+// velocity) of the COM, which is fed to ComCtrlBlock. The time step of the
+// estimator is fixed by its setup().
+class ComZmpEstimatorBlock {
+ public:
+  using Output = std::array<Vec3D, 2>;
+
+  ComZmpEstimatorBlock() : m_estimator(), m_x() {}
+  explicit ComZmpEstimatorBlock(const ComZmpEstimator& t_estimator)
+      : m_estimator(t_estimator),
+        m_x{{t_estimator.com_position(), t_estimator.com_velocity()}} {}
+
+  inline const ComZmpEstimator& estimator() const noexcept {
+    return m_estimator;
+  }
+  inline ComZmpEstimator& estimator() noexcept { return m_estimator; }
+  const Output& update(double, const Vec3D& t_com_position,
+                       const Vec3D& t_zmp_position) {
+    m_estimator.update(t_com_position, t_zmp_position);
+    m_x[0] = m_estimator.com_position();
+    m_x[1] = m_estimator.com_velocity();
+    return m_x;
+  }
+
+ private:
+  ComZmpEstimator m_estimator;
+  Output m_x;
+};
+
+}  // namespace dataflow
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_COM_CTRL_BLOCKS_HPP_
@@ -0,0 +1,103 @@
+/* com_ctrl_blocks - blocks of COM controller for static dataflow graph
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_blocks.hpp"
+
+#include "holon/corelib/control/dataflow_blocks.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace dataflow {
+namespace {
+
+const double kDt = 0.001;
+
+TEST_CASE("dataflow::ComCtrlBlock: same as ComCtrl",
+          "[dataflow][ComCtrlBlock]") {
+  Fuzzer fuzz;
+  ComCtrl ctrl;
+  ctrl.update(kDt);
+  ctrl.refs().com_velocity = fuzz.get<Vec3D>();
+  ComCtrlBlock block(ctrl.refs(), ctrl.model().mass());
+  for (int i = 0; i < 10; ++i) {
+    Vec3D p = ctrl.refs().com_position + fuzz.get<Vec3D>() * 0.1;
+    Vec3D v = fuzz.get<Vec3D>() * 0.1;
+    auto y = block.update(kDt, {{p, v}}, ctrl.refs().com_position);
+    CHECK(y[0] == ctrl.computeDesZmpPos(p, v, 0));
+    CHECK(y[1] == ctrl.computeDesReactForce(p, v, 0));
+  }
+}
+
+TEST_CASE("dataflow::ComZmpEstimatorBlock: same as ComZmpEstimator",
+          "[dataflow][ComZmpEstimatorBlock]") {
+  Fuzzer fuzz;
+  Vec3D p(0, 0, 0.42), v = fuzz.get<Vec3D>();
+  ComZmpEstimator estimator;
+  estimator.setup(p, Vec3D(0, 0, 0), kDt).reset(p, v);
+  ComZmpEstimatorBlock block(estimator);
+  CHECK(block.estimator().com_position() == p);
+  for (int i = 0; i < 10; ++i) {
+    Vec3D pm = p + fuzz.get<Vec3D>() * 0.01;
+    Vec3D zm = fuzz.get<Vec3D>() * 0.01;
+    estimator.update(pm, zm);
+    auto y = block.update(kDt, pm, zm);
+    CHECK(y[0] == estimator.com_position());
+    CHECK(y[1] == estimator.com_velocity());
+    CHECK(block.estimator().zmp_position() == estimator.zmp_position());
+  }
+}
+
+TEST_CASE("dataflow::Graph: COM control on estimates",
+          "[dataflow][ComCtrlBlock][ComZmpEstimatorBlock]") {
+  Fuzzer fuzz;
+  ComCtrl ctrl;
+  ctrl.update(kDt);
+  Vec3D p = ctrl.refs().com_position;
+  ComZmpEstimator estimator;
+  estimator.setup(p, Vec3D(p.x(), p.y(), 0), kDt).reset(p);
+  // measured COM position, measured ZMP position, estimator, reference,
+  // controller
+  Graph<Node<ConstantBlock<Vec3D>>, Node<ConstantBlock<Vec3D>>,
+        Node<ComZmpEstimatorBlock, In<0>, In<1>>, Node<ConstantBlock<Vec3D>>,
+        Node<ComCtrlBlock, In<2>, In<3>>>
+      graph(ConstantBlock<Vec3D>(p), ConstantBlock<Vec3D>(),
+            ComZmpEstimatorBlock(estimator),
+            ConstantBlock<Vec3D>(ctrl.refs().com_position),
+            ComCtrlBlock(ctrl.refs(), ctrl.model().mass()));
+  for (int i = 0; i < 10; ++i) {
+    Vec3D pm = p + fuzz.get<Vec3D>() * 1e-4;
+    Vec3D zm = Vec3D(p.x(), p.y(), 0) + fuzz.get<Vec3D>() * 1e-3;
+    graph.block<0>().set_value(pm);
+    graph.block<1>().set_value(zm);
+    graph.update(kDt);
+    estimator.update(pm, zm);
+    ctrl.feedback(estimator);
+    CHECK(graph.output<2>()[0] == estimator.com_position());
+    CHECK(graph.output<4>()[0] ==
+          ctrl.computeDesZmpPos(estimator.com_position(),
+                                estimator.com_velocity(), 0));
+  }
+}
+
+}  // namespace
+}  // namespace dataflow
+}  // namespace holon
@@ -0,0 +1,343 @@
+/* com_ctrl_command_socket - remote commands to COM controller over socket
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_command_socket.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <zm/zm_misc.h>
+#include <cerrno>
+#include <cstring>
+
+namespace holon {
+
+namespace {
+
+using Field = ComCtrlCommandMessage::Field;
+
+constexpr std::size_t kFieldNum = field_num<ComCtrlCommandsRawData>::value;
+static_assert(kFieldNum <= 32, "too many commands to be masked.");
+
+inline std::uint32_t bit(std::size_t t_index) {
+  return std::uint32_t(1) << t_index;
+}
+
+struct FieldIndex {
+  Field field;
+  std::size_t index;
+  std::size_t count;
+  void operator()(const char*, Field t_field) {
+    if (t_field == field) index = count;
+    ++count;
+  }
+};
+
+struct ValueMask {
+  std::uint32_t mask;
+  std::size_t count;
+  void operator()(const char*, const optional<double>& t_value) {
+    if (t_value) mask |= bit(count);
+    ++count;
+  }
+};
+
+std::uint32_t valueMask(const ComCtrlCommandsRawData& t_values) {
+  ValueMask value_mask{0, 0};
+  ComCtrlCommandsRawData::for_each_field(value_mask, t_values);
+  return value_mask.mask;
+}
+
+struct Encoder {
+  char* p;
+  std::uint32_t mask;
+  std::size_t count;
+  void operator()(const char*, const optional<double>& t_value) {
+    if (t_value) {
+      std::memcpy(p, &*t_value, sizeof(double));
+      p += sizeof(double);
+      mask |= bit(count);
+    }
+    ++count;
+  }
+};
+
+struct Decoder {
+  const char* p;
+  std::uint32_t mask;
+  std::size_t count;
+  void operator()(const char*, optional<double>& t_value) {
+    if (mask & bit(count++)) {
+      double v;
+      std::memcpy(&v, p, sizeof(double));
+      p += sizeof(double);
+      t_value = v;
+    } else {
+      t_value = nullopt;
+    }
+  }
+};
+
+struct Applier {
+  std::uint32_t reset_mask;
+  std::size_t count;
+  void operator()(const char*, optional<double>& t_value,
+                  const optional<double>& t_newer) {
+    if (t_newer)
+      t_value = t_newer;
+    else if (reset_mask & bit(count))
+      t_value = nullopt;
+    ++count;
+  }
+};
+
+std::size_t popcount(std::uint32_t t_mask) {
+  std::size_t n = 0;
+  for (; t_mask; t_mask &= t_mask - 1) ++n;
+  return n;
+}
+
+bool makeAddress(const std::string& t_path, sockaddr_un* t_addr) {
+  std::memset(t_addr, 0, sizeof(sockaddr_un));
+  t_addr->sun_family = AF_UNIX;
+  if (t_path.empty() || t_path.size() >= sizeof(t_addr->sun_path)) {
+    ZRUNERROR("invalid socket path: %s", t_path.c_str());
+    return false;
+  }
+  std::memcpy(t_addr->sun_path, t_path.c_str(), t_path.size());
+  return true;
+}
+
+int openSocket() {
+  int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    ZRUNERROR("cannot open socket (errno: %d)", errno);
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+}  // namespace
+
+const std::uint32_t ComCtrlCommandMessage::magic = 0x43434c48;  // HLCC
+const std::size_t ComCtrlCommandMessage::header_size =
+    4 * sizeof(std::uint32_t);
+const std::size_t ComCtrlCommandMessage::max_size =
+    header_size + kFieldNum * sizeof(double);
+
+ComCtrlCommandMessage& ComCtrlCommandMessage::reset(Field t_field) {
+  FieldIndex finder{t_field, kFieldNum, 0};
+  ComCtrlCommandsRawData::for_each_member(finder);
+  if (finder.index < kFieldNum) {
+    reset_mask |= bit(finder.index);
+    values.*t_field = nullopt;
+  }
+  return *this;
+}
+
+bool ComCtrlCommandMessage::is_empty() const {
+  return valueMask(values) == 0 && reset_mask == 0;
+}
+
+std::size_t ComCtrlCommandMessage::encode(char* t_buf,
+                                          std::size_t t_size) const {
+  if (t_size < max_size) return 0;
+  Encoder encoder{t_buf + header_size, 0, 0};
+  ComCtrlCommandsRawData::for_each_field(encoder, values);
+  std::uint32_t header[4] = {magic, sequence, encoder.mask,
+                             reset_mask & ~encoder.mask};
+  std::memcpy(t_buf, header, header_size);
+  return static_cast<std::size_t>(encoder.p - t_buf);
+}
+
+bool ComCtrlCommandMessage::decode(const char* t_buf, std::size_t t_size) {
+  std::uint32_t header[4];
+  if (t_size < header_size) return false;
+  std::memcpy(header, t_buf, header_size);
+  if (header[0] != magic) return false;
+  if ((header[2] | header[3]) >> kFieldNum) return false;
+  if (t_size != header_size + popcount(header[2]) * sizeof(double))
+    return false;
+  sequence = header[1];
+  reset_mask = header[3];
+  ComCtrlCommandsRawData::for_each_field(
+      Decoder{t_buf + header_size, header[2], 0}, values);
+  return true;
+}
+
+void ComCtrlCommandMessage::merge(const ComCtrlCommandMessage& t_newer) {
+  ComCtrlCommandsRawData::for_each_field(Applier{t_newer.reset_mask, 0},
+                                         values, t_newer.values);
+  sequence = t_newer.sequence;
+  reset_mask = (reset_mask | t_newer.reset_mask) & ~valueMask(values);
+}
+
+void ComCtrlCommandMessage::applyTo(ComCtrlCommandsRawData* t_commands) const {
+  ComCtrlCommandsRawData::for_each_field(Applier{reset_mask, 0}, *t_commands,
+                                         values);
+}
+
+ComCtrlCommandSender::ComCtrlCommandSender() : m_fd(-1), m_sequence(0) {}
+
+ComCtrlCommandSender::~ComCtrlCommandSender() { close(); }
+
+bool ComCtrlCommandSender::open(const std::string& t_path) {
+  close();
+  sockaddr_un addr;
+  if (!makeAddress(t_path, &addr)) return false;
+  if ((m_fd = openSocket()) < 0) return false;
+  if (connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ZRUNERROR("cannot connect to %s (errno: %d)", t_path.c_str(), errno);
+    close();
+    return false;
+  }
+  return true;
+}
+
+void ComCtrlCommandSender::close() {
+  if (m_fd < 0) return;
+  ::close(m_fd);
+  m_fd = -1;
+}
+
+bool ComCtrlCommandSender::send(ComCtrlCommandMessage t_message) {
+  char buf[ComCtrlCommandMessage::header_size + kFieldNum * sizeof(double)];
+  if (!is_open()) return false;
+  t_message.sequence = ++m_sequence;
+  std::size_t size = t_message.encode(buf, sizeof(buf));
+  return ::send(m_fd, buf, size, 0) == static_cast<ssize_t>(size);
+}
+
+bool ComCtrlCommandSender::send(const ComCtrlCommandsRawData& t_values) {
+  ComCtrlCommandMessage message;
+  message.values = t_values;
+  return send(message);
+}
+
+constexpr int ComCtrlCommandReceiver::default_poll_timeout;
+
+ComCtrlCommandReceiver::ComCtrlCommandReceiver()
+    : m_fd(-1),
+      m_path(),
+      m_thread(),
+      m_running(false),
+      m_mutex(),
+      m_pending(),
+      m_has_pending(false),
+      m_last_sequence(0),
+      m_received_count(0),
+      m_rejected_count(0) {}
+
+ComCtrlCommandReceiver::~ComCtrlCommandReceiver() { close(); }
+
+bool ComCtrlCommandReceiver::open(const std::string& t_path) {
+  close();
+  sockaddr_un addr;
+  if (!makeAddress(t_path, &addr)) return false;
+  // remove the socket file left by a former receiver, but nothing else
+  struct stat st;
+  if (lstat(t_path.c_str(), &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      ZRUNERROR("%s exists and is not a socket", t_path.c_str());
+      return false;
+    }
+    unlink(t_path.c_str());
+  }
+  if ((m_fd = openSocket()) < 0) return false;
+  if (bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ZRUNERROR("cannot bind %s (errno: %d)", t_path.c_str(), errno);
+    ::close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  m_path = t_path;
+  return true;
+}
+
+void ComCtrlCommandReceiver::close() {
+  stop();
+  if (m_fd < 0) return;
+  ::close(m_fd);
+  unlink(m_path.c_str());
+  m_fd = -1;
+  m_path.clear();
+}
+
+bool ComCtrlCommandReceiver::start(int t_poll_timeout) {
+  if (!is_open() || m_running) return false;
+  m_running = true;
+  m_thread = std::thread([this, t_poll_timeout] {
+    pollfd pfd{m_fd, POLLIN, 0};
+    while (m_running) {
+      if (poll(&pfd, 1, t_poll_timeout) > 0) receive();
+    }
+  });
+  return true;
+}
+
+void ComCtrlCommandReceiver::stop() {
+  if (!m_running) return;
+  m_running = false;
+  m_thread.join();
+}
+
+std::size_t ComCtrlCommandReceiver::receive() {
+  char buf[ComCtrlCommandMessage::header_size + kFieldNum * sizeof(double) +
+           1];
+  ComCtrlCommandMessage message;
+  std::size_t n = 0;
+  if (!is_open()) return 0;
+  for (;;) {
+    ssize_t size = recv(m_fd, buf, sizeof(buf), 0);
+    if (size < 0) break;
+    if (!message.decode(buf, static_cast<std::size_t>(size))) {
+      ++m_rejected_count;
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_has_pending)
+      m_pending.merge(message);
+    else
+      m_pending = message;
+    m_has_pending = true;
+    ++m_received_count;
+    ++n;
+  }
+  return n;
+}
+
+bool ComCtrlCommandReceiver::apply(ComCtrlCommandsRawData* t_commands) {
+  std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+  if (!lock.owns_lock() || !m_has_pending) return false;
+  m_pending.applyTo(t_commands);
+  m_last_sequence = m_pending.sequence;
+  m_has_pending = false;
+  return true;
+}
+
+bool ComCtrlCommandReceiver::apply(ComCtrl* t_ctrl) {
+  return apply(t_ctrl->getCommands().get());
+}
+
+}  // namespace holon
@@ -0,0 +1,151 @@
+/* com_ctrl_command_socket - remote commands to COM controller over socket
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_COM_CTRL_COMMAND_SOCKET_HPP_
+#define HOLON_HUMANOID_COM_CTRL_COMMAND_SOCKET_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+
+namespace holon {
+
+// A message to update commands to ComCtrl. On the wire, it consists of a
+// header of four 32-bit words, namely the magic number, the sequence number,
+// the mask of fields to set and that to reset, followed by the values of the
+// fields to set in order of declaration, all in native byte order. Fields
+// neither set nor reset are left as they are.
+struct ComCtrlCommandMessage {
+  using Field = optional<double> ComCtrlCommandsRawData::*;
+
+  static const std::uint32_t magic;
+  static const std::size_t header_size;
+  static const std::size_t max_size;
+
+  std::uint32_t sequence = 0;
+  std::uint32_t reset_mask = 0;
+  ComCtrlCommandsRawData values = ComCtrlCommandsRawData();
+
+  ComCtrlCommandMessage& reset(Field t_field);
+  bool is_empty() const;
+
+  // returns the size of encoded message, or zero if the buffer is short
+  std::size_t encode(char* t_buf, std::size_t t_size) const;
+  bool decode(const char* t_buf, std::size_t t_size);
+
+  // merge a newer message so that applying the result is equivalent to
+  // applying this and the newer one in order
+  void merge(const ComCtrlCommandMessage& t_newer);
+  void applyTo(ComCtrlCommandsRawData* t_commands) const;
+};
+
+// ComCtrlCommandSender sends messages to a receiver bound to a path of a
+// Unix domain datagram socket. Sending never blocks; a message is dropped
+// when the receiver is not ready.
+class ComCtrlCommandSender {
+  using Self = ComCtrlCommandSender;
+
+ public:
+  ComCtrlCommandSender();
+  ~ComCtrlCommandSender();
+  ComCtrlCommandSender(const Self&) = delete;
+  Self& operator=(const Self&) = delete;
+
+  bool open(const std::string& t_path);
+  void close();
+  inline bool is_open() const noexcept { return m_fd >= 0; }
+  inline std::uint32_t sequence() const noexcept { return m_sequence; }
+
+  // the sequence number is given by the sender
+  bool send(ComCtrlCommandMessage t_message);
+  bool send(const ComCtrlCommandsRawData& t_values);
+
+ private:
+  int m_fd;
+  std::uint32_t m_sequence;
+};
+
+// ComCtrlCommandReceiver binds a Unix domain datagram socket and ingests
+// messages either by receive() or in a side thread launched by start().
+// Ingested messages are merged into one pending message, which is applied
+// to commands of a controller by apply() at the boundary of control steps.
+// apply() only tries to lock the pending message, so that the control
+// thread never waits for the side thread.
+class ComCtrlCommandReceiver {
+  using Self = ComCtrlCommandReceiver;
+
+ public:
+  static constexpr int default_poll_timeout = 10;  // [ms]
+
+ public:
+  ComCtrlCommandReceiver();
+  ~ComCtrlCommandReceiver();
+  ComCtrlCommandReceiver(const Self&) = delete;
+  Self& operator=(const Self&) = delete;
+
+  bool open(const std::string& t_path);
+  void close();
+  inline bool is_open() const noexcept { return m_fd >= 0; }
+  inline const std::string& path() const noexcept { return m_path; }
+
+  // side thread
+  bool start(int t_poll_timeout = default_poll_timeout);
+  void stop();
+  inline bool is_running() const noexcept { return m_running; }
+
+  // ingest all the messages arrived without blocking; returns the number
+  // of messages accepted
+  std::size_t receive();
+
+  // returns true if any message has been applied
+  bool apply(ComCtrlCommandsRawData* t_commands);
+  bool apply(ComCtrl* t_ctrl);
+
+  // statistics
+  inline std::uint32_t last_sequence() const noexcept {
+    return m_last_sequence;
+  }
+  inline std::size_t received_count() const noexcept {
+    return m_received_count;
+  }
+  inline std::size_t rejected_count() const noexcept {
+    return m_rejected_count;
+  }
+
+ private:
+  int m_fd;
+  std::string m_path;
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+  std::mutex m_mutex;
+  ComCtrlCommandMessage m_pending;
+  bool m_has_pending;
+  std::uint32_t m_last_sequence;
+  std::atomic<std::size_t> m_received_count;
+  std::atomic<std::size_t> m_rejected_count;
+};
+
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_COM_CTRL_COMMAND_SOCKET_HPP_
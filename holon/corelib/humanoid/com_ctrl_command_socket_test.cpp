@@ -0,0 +1,211 @@
+/* com_ctrl_command_socket - remote commands to COM controller over socket
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_command_socket.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Message = ComCtrlCommandMessage;
+
+std::string socket_path() {
+  return "/tmp/holon_com_ctrl_command_test_" + std::to_string(getpid());
+}
+
+TEST_CASE("ComCtrlCommandMessage: encode and decode",
+          "[ComCtrlCommandMessage]") {
+  Fuzzer fuzz;
+  Message msg;
+  char buf[256];
+  CHECK(msg.is_empty());
+
+  msg.sequence = 7;
+  msg.values.vxd = fuzz();
+  msg.values.zd = fuzz();
+  msg.reset(&ComCtrlCommandsRawData::dist);
+  CHECK_FALSE(msg.is_empty());
+  std::size_t size = msg.encode(buf, sizeof(buf));
+  REQUIRE(size == Message::header_size + 2 * sizeof(double));
+  CHECK(msg.encode(buf, Message::max_size - 1) == 0);
+
+  Message decoded;
+  decoded.values.xd = 1;
+  REQUIRE(decoded.decode(buf, size));
+  CHECK(decoded.sequence == 7);
+  CHECK(decoded.reset_mask == msg.reset_mask);
+  CHECK(equal_fields(decoded.values, msg.values));
+
+  SECTION("broken message") {
+    CHECK_FALSE(decoded.decode(buf, size - 1));
+    CHECK_FALSE(decoded.decode(buf, Message::header_size - 1));
+    buf[0] ^= 1;
+    CHECK_FALSE(decoded.decode(buf, size));
+  }
+}
+
+TEST_CASE("ComCtrlCommandMessage: merge and apply messages",
+          "[ComCtrlCommandMessage]") {
+  ComCtrlCommandsRawData commands;
+  commands.xd = 0.1;
+  commands.dist = 0.2;
+  commands.rho = 1;
+
+  Message older, newer;
+  older.sequence = 1;
+  older.values.xd = 0.3;
+  older.values.vxd = 0.4;
+  older.reset(&ComCtrlCommandsRawData::rho);
+  newer.sequence = 2;
+  newer.values.rho = 0.5;
+  newer.reset(&ComCtrlCommandsRawData::dist)
+      .reset(&ComCtrlCommandsRawData::vxd);
+
+  ComCtrlCommandsRawData expected = commands;
+  older.applyTo(&expected);
+  newer.applyTo(&expected);
+  CHECK(expected.xd == 0.3);
+  CHECK_FALSE(expected.vxd);
+  CHECK_FALSE(expected.dist);
+  CHECK(expected.rho == 0.5);
+
+  older.merge(newer);
+  CHECK(older.sequence == 2);
+  older.applyTo(&commands);
+  CHECK(equal_fields(commands, expected));
+}
+
+TEST_CASE("ComCtrlCommandReceiver: receive commands",
+          "[ComCtrlCommandReceiver]") {
+  ComCtrl ctrl;
+  ComCtrlCommandReceiver receiver;
+  ComCtrlCommandSender sender;
+  REQUIRE(receiver.open(socket_path()));
+  REQUIRE(sender.open(socket_path()));
+  CHECK(receiver.receive() == 0);
+  CHECK_FALSE(receiver.apply(&ctrl));
+
+  ComCtrlCommandsRawData values;
+  values.vxd = 0.1;
+  values.zd = 0.9;
+  CHECK(sender.send(values));
+  Message msg;
+  msg.values.vxd = 0.2;
+  msg.reset(&ComCtrlCommandsRawData::zd);
+  CHECK(sender.send(msg));
+  CHECK(receiver.receive() == 2);
+  REQUIRE(receiver.apply(&ctrl));
+  CHECK(receiver.last_sequence() == 2);
+  CHECK(ctrl.commands().vxd == 0.2);
+  CHECK_FALSE(ctrl.commands().zd);
+  CHECK_FALSE(receiver.apply(&ctrl));
+
+  SECTION("reject broken message") {
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, socket_path().c_str());
+    char buf[20] = "broken message";
+    sendto(fd, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&addr),
+           sizeof(addr));
+    ::close(fd);
+    CHECK(receiver.receive() == 0);
+    CHECK(receiver.rejected_count() == 1);
+    CHECK(receiver.received_count() == 2);
+  }
+  SECTION("fail to send after receiver is closed") {
+    receiver.close();
+    zEchoOff();
+    CHECK_FALSE(sender.send(values));
+    CHECK_FALSE(sender.open(socket_path()));
+    zEchoOn();
+  }
+}
+
+TEST_CASE("ComCtrlCommandReceiver: keep files other than sockets",
+          "[ComCtrlCommandReceiver]") {
+  std::string path = socket_path();
+  {
+    std::ofstream ofs(path);
+    ofs << "user data";
+  }
+  ComCtrlCommandReceiver receiver;
+  zEchoOff();
+  CHECK_FALSE(receiver.open(path));
+  zEchoOn();
+  std::ifstream ifs(path);
+  std::string line;
+  std::getline(ifs, line);
+  CHECK(line == "user data");
+  unlink(path.c_str());
+
+  // a socket file left by a former receiver is replaced
+  REQUIRE(receiver.open(path));
+  receiver.close();
+  ComCtrlCommandReceiver former;
+  REQUIRE(former.open(path));
+  CHECK(receiver.open(path));
+}
+
+TEST_CASE("ComCtrlCommandReceiver: ingest commands in side thread",
+          "[ComCtrlCommandReceiver]") {
+  ComCtrl ctrl;
+  ComCtrlCommandReceiver receiver;
+  ComCtrlCommandSender sender;
+  REQUIRE(receiver.open(socket_path()));
+  REQUIRE(sender.open(socket_path()));
+  REQUIRE(receiver.start(1));
+  CHECK(receiver.is_running());
+
+  // a message is dropped while the queue of the socket is full
+  const int n = 100;
+  for (int i = 1; i <= n; ++i) {
+    ComCtrlCommandsRawData values;
+    values.vxd = i;
+    while (!sender.send(values))
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  // sequence numbers of dropped messages are skipped
+  for (int i = 0; i < 1000 && receiver.last_sequence() < sender.sequence();
+       ++i) {
+    receiver.apply(&ctrl);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(receiver.last_sequence() == sender.sequence());
+  CHECK(receiver.received_count() == n);
+  CHECK(ctrl.commands().vxd == n);
+  receiver.stop();
+  CHECK_FALSE(receiver.is_running());
+}
+
+}  // namespace
+}  // namespace holon
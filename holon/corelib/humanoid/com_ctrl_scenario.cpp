@@ -0,0 +1,661 @@
+/* com_ctrl_scenario - scenario description to run COM controller
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_scenario.hpp"
+
+#include <zm/zm_misc.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+
+namespace holon {
+
+constexpr std::size_t ComCtrlScenario::max_delay_steps;
+
+namespace {
+
+using Command = ComCtrlScenario::Command;
+using CommandField = ComCtrlScenario::CommandField;
+using LogColumn = ComCtrlScenario::LogColumn;
+
+const char* const kRefFields[] = {"ref_com_x", "ref_com_y", "ref_com_z"};
+
+const char* const kDefaultLog = "time com_position com_velocity zmp_position";
+
+std::string trim(const std::string& t_str) {
+  const char* ws = " \t\r\n";
+  std::size_t first = t_str.find_first_not_of(ws);
+  if (first == std::string::npos) return std::string();
+  return t_str.substr(first, t_str.find_last_not_of(ws) - first + 1);
+}
+
+bool readNumbers(const std::string& t_key, const std::string& t_value,
+                 std::size_t t_n, double* t_v) {
+  const char* p = t_value.c_str();
+  char* end;
+  for (std::size_t i = 0; i < t_n; ++i, p = end) {
+    t_v[i] = std::strtod(p, &end);
+    if (end == p) break;
+    if (i + 1 == t_n && trim(end).empty()) return true;
+  }
+  ZRUNERROR("%s requires %zu number(s). (given: %s)", t_key.c_str(), t_n,
+            t_value.c_str());
+  return false;
+}
+
+bool readNumber(const std::string& t_key, const std::string& t_value,
+                double* t_v) {
+  return readNumbers(t_key, t_value, 1, t_v);
+}
+
+bool readVec3D(const std::string& t_key, const std::string& t_value,
+               Vec3D* t_v) {
+  double v[3];
+  if (!readNumbers(t_key, t_value, 3, v)) return false;
+  *t_v = Vec3D(v[0], v[1], v[2]);
+  return true;
+}
+
+bool readCommandField(const std::string& t_key, const std::string& t_value,
+                      Command* t_command) {
+  double v[3];
+  if (t_key == "at") return readNumber(t_key, t_value, &t_command->time);
+  if (t_key == "com_position") {
+    if (!readNumbers(t_key, t_value, 3, v)) return false;
+    t_command->values.emplace_back(&ComCtrlCommandsRawData::xd, v[0]);
+    t_command->values.emplace_back(&ComCtrlCommandsRawData::yd, v[1]);
+    t_command->values.emplace_back(&ComCtrlCommandsRawData::zd, v[2]);
+    return true;
+  }
+  if (t_key == "com_velocity") {
+    if (!readNumbers(t_key, t_value, 2, v)) return false;
+    t_command->values.emplace_back(&ComCtrlCommandsRawData::vxd, v[0]);
+    t_command->values.emplace_back(&ComCtrlCommandsRawData::vyd, v[1]);
+    return true;
+  }
+  if (CommandField field =
+          find_field<ComCtrlCommandsRawData, optional<double>>(t_key)) {
+    if (!readNumber(t_key, t_value, v)) return false;
+    t_command->values.emplace_back(field, v[0]);
+    return true;
+  }
+  ZRUNERROR("unknown command: %s", t_key.c_str());
+  return false;
+}
+
+bool readLogColumn(const std::string& t_name, LogColumn* t_column) {
+  *t_column = LogColumn{LogColumn::Kind::time, nullptr, 0, nullptr};
+  if (t_name == "time") return true;
+  if ((t_column->command =
+           find_field<ComCtrlCommandsRawData, optional<double>>(t_name))) {
+    t_column->kind = LogColumn::Kind::command;
+    return true;
+  }
+  for (std::size_t i = 0; i < 3; ++i) {
+    if (t_name != kRefFields[i]) continue;
+    t_column->kind = LogColumn::Kind::ref;
+    t_column->axis = i;
+    return true;
+  }
+  if ((t_column->state = find_field<ComZmpModelRawData, Vec3D>(t_name))) {
+    t_column->kind = LogColumn::Kind::state;
+    return true;
+  }
+  ZRUNERROR("unknown log column: %s", t_name.c_str());
+  return false;
+}
+
+bool readLog(const std::string& t_value, std::vector<LogColumn>* t_log) {
+  std::istringstream iss(t_value);
+  std::string name;
+  t_log->clear();
+  while (iss >> name) {
+    LogColumn column;
+    if (!readLogColumn(name, &column)) return false;
+    t_log->push_back(column);
+  }
+  return true;
+}
+
+bool readScenarioField(const std::string& t_key, const std::string& t_value,
+                       ComCtrlScenario* t_scenario) {
+  if (t_key == "name") {
+    t_scenario->name = t_value;
+    return true;
+  }
+  if (t_key == "time") return readNumber(t_key, t_value, &t_scenario->time);
+  if (t_key == "dt") return readNumber(t_key, t_value, &t_scenario->dt);
+  if (t_key == "log") return readLog(t_value, &t_scenario->log);
+  if (t_key == "ramp") return readNumber(t_key, t_value, &t_scenario->ramp);
+  if (t_key == "sensor_delay")
+    return readNumber(t_key, t_value, &t_scenario->sensor_delay);
+  if (t_key == "actuator_delay")
+    return readNumber(t_key, t_value, &t_scenario->actuator_delay);
+  if (t_key == "profile") {
+    if (t_value == "step") {
+      t_scenario->profile = ComCtrlScenario::Profile::step;
+    } else if (t_value == "min_jerk") {
+      t_scenario->profile = ComCtrlScenario::Profile::min_jerk;
+    } else if (t_value == "spline") {
+      t_scenario->profile = ComCtrlScenario::Profile::spline;
+    } else {
+      ZRUNERROR("unknown profile: %s", t_value.c_str());
+      return false;
+    }
+    return true;
+  }
+  if (t_key == "loop") {
+    if (t_value == "open") {
+      t_scenario->loop = ComCtrlScenario::Loop::open;
+    } else if (t_value == "zmp_position") {
+      t_scenario->loop = ComCtrlScenario::Loop::zmp_position;
+    } else if (t_value == "reaction_force") {
+      t_scenario->loop = ComCtrlScenario::Loop::reaction_force;
+    } else {
+      ZRUNERROR("unknown loop: %s", t_value.c_str());
+      return false;
+    }
+    return true;
+  }
+  ZRUNERROR("unknown field in [scenario]: %s", t_key.c_str());
+  return false;
+}
+
+bool readInitialField(const std::string& t_key, const std::string& t_value,
+                      ComCtrlScenario* t_scenario) {
+  double v;
+  if (t_key == "com_position") {
+    return readVec3D(t_key, t_value, &t_scenario->com_position);
+  }
+  if (t_key == "com_velocity") {
+    Vec3D com_velocity;
+    if (!readVec3D(t_key, t_value, &com_velocity)) return false;
+    t_scenario->com_velocity = com_velocity;
+    return true;
+  }
+  if (t_key == "foot_dist") {
+    if (!readNumber(t_key, t_value, &v)) return false;
+    t_scenario->foot_dist = v;
+    return true;
+  }
+  ZRUNERROR("unknown field in [initial]: %s", t_key.c_str());
+  return false;
+}
+
+bool readPushField(const std::string& t_key, const std::string& t_value,
+                   ComCtrlScenario::Push* t_push) {
+  if (t_key == "start") return readNumber(t_key, t_value, &t_push->start);
+  if (t_key == "end") return readNumber(t_key, t_value, &t_push->end);
+  if (t_key == "force") return readVec3D(t_key, t_value, &t_push->force);
+  ZRUNERROR("unknown field in [push]: %s", t_key.c_str());
+  return false;
+}
+
+bool readRandomPush(const ComCtrlScenarioReader::Section& t_section,
+                    RandomPushDisturbance* t_push) {
+  // interval is applied before duration, which is clamped by interval
+  double v[5] = {0, t_push->start_time(), t_push->interval(),
+                 t_push->duration(), t_push->max_force()};
+  const char* const keys[] = {"seed", "start_time", "interval", "duration",
+                              "max_force"};
+  for (const auto& field : t_section.fields) {
+    const std::size_t n = sizeof(keys) / sizeof(keys[0]);
+    std::size_t i = std::find(keys, keys + n, field.first) - keys;
+    if (i == n) {
+      ZRUNERROR("unknown field in [random_push]: %s", field.first.c_str());
+      return false;
+    }
+    if (i == 0) {
+      char* end;
+      std::uint64_t seed = std::strtoull(field.second.c_str(), &end, 10);
+      if (end == field.second.c_str() || !trim(end).empty()) {
+        ZRUNERROR("seed requires an integer. (given: %s)",
+                  field.second.c_str());
+        return false;
+      }
+      t_push->set_seed(seed);
+    } else if (!readNumber(field.first, field.second, &v[i])) {
+      return false;
+    }
+  }
+  t_push->set_start_time(v[1]).set_interval(v[2]).set_duration(v[3]);
+  t_push->set_max_force(v[4]);
+  return true;
+}
+
+}  // namespace
+
+std::size_t ComCtrlScenario::log_width() const {
+  std::size_t width = 0;
+  for (const auto& column : log)
+    width += column.kind == LogColumn::Kind::state ? 3 : 1;
+  return width;
+}
+
+bool ComCtrlScenarioReader::read(std::istream& t_is) {
+  std::string line;
+  for (int lineno = 1; std::getline(t_is, line); ++lineno) {
+    line = trim(line.substr(0, line.find('%')));
+    if (line.empty()) continue;
+    if (line.front() == '[' && line.back() == ']') {
+      m_sections.push_back(Section{trim(line.substr(1, line.size() - 2)), {}});
+      continue;
+    }
+    std::size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      ZRUNERROR("line %d: field should be `key: value` (given: %s)", lineno,
+                line.c_str());
+      return false;
+    }
+    if (m_sections.empty()) {
+      ZRUNERROR("line %d: field outside of section", lineno);
+      return false;
+    }
+    m_sections.back().fields.emplace_back(trim(line.substr(0, colon)),
+                                          trim(line.substr(colon + 1)));
+  }
+  return true;
+}
+
+bool ComCtrlScenarioReader::readFile(const std::string& t_path) {
+  std::ifstream ifs(t_path);
+  if (!ifs) {
+    ZOPENERROR(t_path.c_str());
+    return false;
+  }
+  return read(ifs);
+}
+
+bool ComCtrlScenarioReader::set(const std::string& t_tag_key,
+                                const std::string& t_value) {
+  std::size_t dot = t_tag_key.find('.');
+  if (dot == std::string::npos) {
+    ZRUNERROR("field should be given as `tag.key` (given: %s)",
+              t_tag_key.c_str());
+    return false;
+  }
+  std::string tag = t_tag_key.substr(0, dot);
+  std::string key = t_tag_key.substr(dot + 1);
+  auto section =
+      std::find_if(m_sections.begin(), m_sections.end(),
+                   [&tag](const Section& s) { return s.tag == tag; });
+  if (section == m_sections.end()) {
+    m_sections.push_back(Section{tag, {}});
+    section = m_sections.end() - 1;
+  }
+  for (auto& field : section->fields) {
+    if (field.first == key) {
+      field.second = t_value;
+      return true;
+    }
+  }
+  section->fields.emplace_back(key, t_value);
+  return true;
+}
+
+bool ComCtrlScenarioReader::build(ComCtrlScenario* t_scenario) const {
+  ComCtrlScenario scenario;
+  readLog(kDefaultLog, &scenario.log);
+  for (const auto& section : m_sections) {
+    if (section.tag == "scenario" || section.tag == "initial") {
+      auto read_field = section.tag == "scenario" ? readScenarioField
+                                                  : readInitialField;
+      for (const auto& field : section.fields)
+        if (!read_field(field.first, field.second, &scenario)) return false;
+    } else if (section.tag == "command") {
+      Command command{0, {}};
+      for (const auto& field : section.fields)
+        if (!readCommandField(field.first, field.second, &command))
+          return false;
+      scenario.commands.push_back(command);
+    } else if (section.tag == "push") {
+      ComCtrlScenario::Push push{0, 0, kVec3DZero};
+      for (const auto& field : section.fields)
+        if (!readPushField(field.first, field.second, &push)) return false;
+      if (push.end <= push.start) {
+        ZRUNERROR("push should end after it starts. (given: %f - %f)",
+                  push.start, push.end);
+        return false;
+      }
+      scenario.pushes.push_back(push);
+    } else if (section.tag == "random_push") {
+      RandomPushDisturbance push;
+      if (!readRandomPush(section, &push)) return false;
+      scenario.random_push = push;
+    } else {
+      ZRUNERROR("unknown section: [%s]", section.tag.c_str());
+      return false;
+    }
+  }
+  if (scenario.dt <= 0) {
+    ZRUNERROR("dt should be positive. (given: %f)", scenario.dt);
+    return false;
+  }
+  if (scenario.ramp <= 0) {
+    ZRUNERROR("ramp should be positive. (given: %f)", scenario.ramp);
+    return false;
+  }
+  if (scenario.loop == ComCtrlScenario::Loop::open &&
+      (!scenario.pushes.empty() || scenario.random_push)) {
+    ZRUNERROR("disturbances require a closed loop");
+    return false;
+  }
+  for (double delay : {scenario.sensor_delay, scenario.actuator_delay}) {
+    if (delay < 0 || delay > ComCtrlScenario::max_delay_steps * scenario.dt) {
+      ZRUNERROR("delay should be within [0, %f]. (given: %f)",
+                ComCtrlScenario::max_delay_steps * scenario.dt, delay);
+      return false;
+    }
+  }
+  if (scenario.loop == ComCtrlScenario::Loop::open &&
+      (scenario.sensor_delay > 0 || scenario.actuator_delay > 0)) {
+    ZRUNERROR("delays require a closed loop");
+    return false;
+  }
+  std::stable_sort(scenario.commands.begin(), scenario.commands.end(),
+                   [](const Command& a, const Command& b) {
+                     return a.time < b.time;
+                   });
+  *t_scenario = scenario;
+  return true;
+}
+
+ComCtrlScenarioRunner::ComCtrlScenarioRunner(const ComCtrlScenario& t_scenario)
+    : m_scenario(t_scenario),
+      m_os(nullptr),
+      m_format(LogFormat::text),
+      m_row(t_scenario.log_width()),
+      m_text(t_scenario.log_width() * (number_format::max_length + 1) + 1),
+      m_states(),
+      m_step_count(0),
+      m_evaluation_count(0),
+      m_max_com_error(0),
+      m_next_command(0),
+      m_profiles(),
+      m_cursors(),
+      m_checkpoint_interval(0),
+      m_checkpoints(),
+      m_image(),
+      m_sensed_position(),
+      m_sensed_velocity(),
+      m_actuation() {}
+
+ComCtrlScenarioRunner& ComCtrlScenarioRunner::set_log(std::ostream* t_os,
+                                                      LogFormat t_format) {
+  m_os = t_os;
+  m_format = t_format;
+  return *this;
+}
+
+ComCtrlScenarioRunner& ComCtrlScenarioRunner::set_checkpoint_interval(
+    std::size_t t_steps, std::size_t t_keyframe_interval) {
+  m_checkpoint_interval = t_steps;
+  m_checkpoints.set_keyframe_interval(t_keyframe_interval);
+  return *this;
+}
+
+bool ComCtrlScenarioRunner::run() {
+  m_step_count = 0;
+  m_evaluation_count = 0;
+  m_max_com_error = 0;
+  m_next_command = 0;
+  m_checkpoints.clear();
+  if (!buildProfiles()) return false;
+  return m_scenario.loop == ComCtrlScenario::Loop::open ? runOpenLoop(false)
+                                                        : runClosedLoop(false);
+}
+
+bool ComCtrlScenarioRunner::replay(double t_time) {
+  auto i = m_checkpoints.find(t_time);
+  if (!i) {
+    ZRUNERROR("no checkpoint at or before %f", t_time);
+    return false;
+  }
+  m_image.resize(m_checkpoints.image_size());
+  m_checkpoints.restore(i.value(), m_image.data());
+  // the checkpoints after that are taken again
+  m_checkpoints.truncate(i.value());
+  return m_scenario.loop == ComCtrlScenario::Loop::open ? runOpenLoop(true)
+                                                        : runClosedLoop(true);
+}
+
+// Each commanded field gets a trajectory through its commanded values, so
+// that it is evaluated by a cursor every step without any search.
+bool ComCtrlScenarioRunner::buildProfiles() {
+  m_profiles.clear();
+  m_cursors.clear();
+  if (m_scenario.profile == ComCtrlScenario::Profile::step) return true;
+  std::vector<CommandField> fields;
+  for (const auto& command : m_scenario.commands)
+    for (const auto& value : command.values)
+      if (std::find(fields.begin(), fields.end(), value.first) == fields.end())
+        fields.push_back(value.first);
+  for (auto field : fields) {
+    std::vector<RefTrajectory::Knot> knots;
+    for (const auto& command : m_scenario.commands) {
+      for (const auto& value : command.values) {
+        if (value.first != field) continue;
+        // a later value at the same time overwrites the former
+        if (!knots.empty() && knots.back().time == command.time) {
+          knots.back().value = value.second;
+        } else {
+          knots.push_back(RefTrajectory::Knot{command.time, value.second});
+        }
+      }
+    }
+    RefTrajectory trajectory;
+    bool result = m_scenario.profile == ComCtrlScenario::Profile::min_jerk
+                      ? trajectory.buildSmoothSteps(knots, m_scenario.ramp)
+                      : trajectory.buildCubicSpline(knots);
+    if (!result) return false;
+    m_profiles.emplace_back(field, trajectory);
+  }
+  for (const auto& profile : m_profiles) m_cursors.emplace_back(profile.second);
+  return true;
+}
+
+void ComCtrlScenarioRunner::giveCommands(double t_time, ComCtrl* t_ctrl) {
+  const auto& commands = m_scenario.commands;
+  for (; m_next_command < commands.size() &&
+         !(t_time < commands[m_next_command].time);
+       ++m_next_command) {
+    auto cmd = t_ctrl->getCommands();
+    for (const auto& value : commands[m_next_command].values)
+      (*cmd).*value.first = value.second;
+  }
+  // profiles take over once the first value of the field is given
+  for (std::size_t i = 0; i < m_profiles.size(); ++i) {
+    if (t_time < m_profiles[i].second.start_time()) continue;
+    (*t_ctrl->getCommands()).*m_profiles[i].first = m_cursors[i].value(t_time);
+  }
+}
+
+bool ComCtrlScenarioRunner::runOpenLoop(bool t_resume) {
+  const ComCtrlScenario& s = m_scenario;
+  ComCtrl ctrl;
+  if (s.foot_dist) {
+    ctrl.reset(s.com_position, s.foot_dist.value());
+  } else {
+    ctrl.reset(s.com_position);
+  }
+  if (s.com_velocity) ctrl.states().com_velocity = s.com_velocity.value();
+  if (t_resume) loadCheckpoint(&ctrl, nullptr);
+
+  while (ctrl.time() < s.time) {
+    saveCheckpoint(ctrl.time(), ctrl, nullptr);
+    giveCommands(ctrl.time(), &ctrl);
+    if (!ctrl.update(s.dt)) return false;
+    writeLog(ctrl.time(), ctrl, ctrl.states());
+  }
+  m_states = ctrl.states();
+  m_evaluation_count = ctrl.model().evaluation_count();
+  return true;
+}
+
+bool ComCtrlScenarioRunner::runClosedLoop(bool t_resume) {
+  const ComCtrlScenario& s = m_scenario;
+  ComZmpModel model;
+  model.reset(s.com_position);
+  if (s.com_velocity) model.states().com_velocity = s.com_velocity.value();
+  if (!s.pushes.empty() || s.random_push) {
+    model.setExternalForceCallback(
+        [&s](const Vec3D&, const Vec3D&, const double t) {
+          Vec3D f = s.random_push ? s.random_push->force(t) : kVec3DZero;
+          for (const auto& push : s.pushes)
+            if (t > push.start && t < push.end) f = f + push.force;
+          return f;
+        });
+  }
+  ComCtrl ctrl(model);
+  if (s.foot_dist) ctrl.reset(s.com_position, s.foot_dist.value());
+  m_sensed_position.clear().set_delay(s.sensor_delay, s.dt);
+  m_sensed_velocity.clear().set_delay(s.sensor_delay, s.dt);
+  m_actuation.clear().set_delay(s.actuator_delay, s.dt);
+  if (t_resume) loadCheckpoint(&ctrl, &model);
+
+  while (model.time() < s.time) {
+    saveCheckpoint(model.time(), ctrl, &model);
+
+    // feedback
+    m_sensed_position.push(model.states().com_position);
+    m_sensed_velocity.push(model.states().com_velocity);
+    ctrl.feedback(m_sensed_position.output(), m_sensed_velocity.output());
+
+    // update controller
+    giveCommands(model.time(), &ctrl);
+    if (!ctrl.update(s.dt)) return false;
+
+    // update simulator
+    if (s.loop == ComCtrlScenario::Loop::zmp_position) {
+      model.setZmpPosition(m_actuation.update(ctrl.outputs().zmp_position));
+    } else {
+      model.setReactionForce(m_actuation.update(ctrl.outputs().reaction_force));
+    }
+    if (!model.update(s.dt)) return false;
+
+    writeLog(model.time(), ctrl, model.states());
+  }
+  m_states = model.states();
+  m_evaluation_count =
+      ctrl.model().evaluation_count() + model.evaluation_count();
+  return true;
+}
+
+// A checkpoint consists of the progress of the runner, the controller and
+// the simulator and the delay lines of a closed loop, if any. The
+// disturbances are functions of time, and the command profiles are
+// evaluated from any time, so that they have no states to be saved.
+void ComCtrlScenarioRunner::saveCheckpoint(double t_time,
+                                           const ComCtrl& t_ctrl,
+                                           const ComZmpModel* t_model) {
+  if (m_checkpoint_interval == 0 || m_step_count % m_checkpoint_interval != 0)
+    return;
+  std::size_t size = field_binary_size<std::size_t>::value * 2 +
+                     field_binary_size<double>::value +
+                     t_ctrl.checkpoint_size() +
+                     (t_model ? t_model->checkpoint_size() +
+                                    3 * Delay::binary_size()
+                              : 0);
+  if (m_checkpoints.image_size() != size) m_checkpoints.set_image_size(size);
+  m_image.resize(size);
+  char* p = pack_fields(m_image.data(), m_step_count);
+  p = pack_fields(p, m_max_com_error);
+  p = pack_fields(p, m_next_command);
+  p = t_ctrl.saveCheckpoint(p);
+  if (t_model) {
+    p = t_model->saveCheckpoint(p);
+    p = m_sensed_position.pack(p);
+    p = m_sensed_velocity.pack(p);
+    m_actuation.pack(p);
+  }
+  m_checkpoints.push(t_time, m_image.data());
+}
+
+void ComCtrlScenarioRunner::loadCheckpoint(ComCtrl* t_ctrl,
+                                           ComZmpModel* t_model) {
+  const char* p = unpack_fields(m_image.data(), &m_step_count);
+  p = unpack_fields(p, &m_max_com_error);
+  p = unpack_fields(p, &m_next_command);
+  p = t_ctrl->loadCheckpoint(p);
+  if (t_model) {
+    p = t_model->loadCheckpoint(p);
+    p = m_sensed_position.unpack(p);
+    p = m_sensed_velocity.unpack(p);
+    m_actuation.unpack(p);
+  }
+}
+
+void ComCtrlScenarioRunner::writeLog(double t_time, const ComCtrl& t_ctrl,
+                                     const ComZmpModelRawData& t_states) {
+  ++m_step_count;
+  double dx = t_states.com_position[0] - t_ctrl.refs().com_position[0];
+  double dy = t_states.com_position[1] - t_ctrl.refs().com_position[1];
+  m_max_com_error = std::max(m_max_com_error, std::sqrt(dx * dx + dy * dy));
+  if (!m_os) return;
+
+  if (m_format == LogFormat::text) {
+    TextWriter writer(m_text.data(), m_text.size());
+    for (const auto& column : m_scenario.log) {
+      if (writer.size() > 0) writer.delimit();
+      switch (column.kind) {
+        case LogColumn::Kind::time:
+          writer.put(t_time, TextWriter::Format::general, 10);
+          break;
+        case LogColumn::Kind::command:
+          writer << (t_ctrl.commands().*column.command).value_or(0);
+          break;
+        case LogColumn::Kind::ref:
+          writer << t_ctrl.refs().com_position[column.axis];
+          break;
+        case LogColumn::Kind::state:
+          writer << t_states.*column.state;
+          break;
+      }
+    }
+    writer.put('\n').flush(*m_os);
+    return;
+  }
+
+  double* v = m_row.data();
+  for (const auto& column : m_scenario.log) {
+    switch (column.kind) {
+      case LogColumn::Kind::time:
+        *v++ = t_time;
+        break;
+      case LogColumn::Kind::command:
+        *v++ = (t_ctrl.commands().*column.command).value_or(0);
+        break;
+      case LogColumn::Kind::ref:
+        *v++ = t_ctrl.refs().com_position[column.axis];
+        break;
+      case LogColumn::Kind::state:
+        for (std::size_t i = 0; i < 3; ++i) *v++ = (t_states.*column.state)[i];
+        break;
+    }
+  }
+  m_os->write(reinterpret_cast<const char*>(m_row.data()),
+              static_cast<std::streamsize>(m_row.size() * sizeof(double)));
+}
+
+}  // namespace holon
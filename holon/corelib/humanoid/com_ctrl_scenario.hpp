@@ -0,0 +1,235 @@
+/* com_ctrl_scenario - scenario description to run COM controller
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_COM_CTRL_SCENARIO_HPP_
+#define HOLON_HUMANOID_COM_CTRL_SCENARIO_HPP_
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/common/text_writer.hpp"
+#include "holon/corelib/control/delay_line.hpp"
+#include "holon/corelib/control/ref_trajectory.hpp"
+#include "holon/corelib/data/checkpoint_store.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/random_push_disturbance.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
+
+namespace holon {
+
+// Description of a simulation of COM controller, i.e. initial states,
+// a timeline of commands, a schedule of disturbances and what to log.
+struct ComCtrlScenario {
+  using CommandField = optional<double> ComCtrlCommandsRawData::*;
+
+  // open: the controller runs on its own internal model
+  // zmp_position / reaction_force: a separate model is driven by the
+  // designated output of the controller, which is fed back every step
+  enum class Loop { open, zmp_position, reaction_force };
+
+  // step: commands change at once
+  // min_jerk: commands move by minimum-jerk motion lasting for `ramp`
+  // spline: commands follow a cubic spline through the commanded values
+  enum class Profile { step, min_jerk, spline };
+
+  // commands are given when the time reaches `time`, and are kept until
+  // they are overwritten by a later one
+  struct Command {
+    double time;
+    std::vector<std::pair<CommandField, double>> values;
+  };
+
+  // external force given during start < t < end
+  struct Push {
+    double start;
+    double end;
+    Vec3D force;
+  };
+
+  struct LogColumn {
+    enum class Kind { time, command, ref, state };
+    Kind kind;
+    CommandField command;
+    std::size_t axis;
+    Vec3D ComZmpModelRawData::*state;
+  };
+
+  // maximum transport delay in steps
+  static constexpr std::size_t max_delay_steps = 127;
+
+  std::string name;
+  double time = 10;
+  double dt = 0.01;
+  Loop loop = Loop::open;
+  Profile profile = Profile::step;
+  double ramp = 0.5;
+  // transport delays of the feedback and of the output in a closed loop
+  double sensor_delay = 0;
+  double actuator_delay = 0;
+  Vec3D com_position = {0, 0, 1};
+  optional<Vec3D> com_velocity;
+  optional<double> foot_dist;
+  std::vector<Command> commands;
+  std::vector<Push> pushes;
+  optional<RandomPushDisturbance> random_push;
+  std::vector<LogColumn> log;
+
+  // number of values in a row of the log
+  std::size_t log_width() const;
+};
+
+// Reader of a scenario written in tagged text, e.g.
+//   % comment
+//   [scenario]
+//   name: com_regulation
+//   time: 10
+//   dt: 0.01
+//   loop: open                % open, zmp_position or reaction_force
+//   profile: min_jerk         % step, min_jerk or spline
+//   ramp: 0.5
+//   sensor_delay: 0.005       % seconds, in a closed loop
+//   actuator_delay: 0.002
+//   log: time com_position com_velocity zmp_position
+//   [initial]
+//   com_position: 0.1 -0.1 1
+//   [command]
+//   at: 0
+//   com_position: 0 0 1
+//   [push]
+//   start: 4
+//   end: 4.1
+//   force: 1 -1 0
+// Fields are kept as text until build() is called, so that any of them can
+// be overwritten by set() in order to sweep parameters of a scenario.
+class ComCtrlScenarioReader {
+  using Self = ComCtrlScenarioReader;
+
+ public:
+  struct Section {
+    std::string tag;
+    std::vector<std::pair<std::string, std::string>> fields;
+  };
+
+ public:
+  ComCtrlScenarioReader() = default;
+
+  bool read(std::istream& t_is);
+  bool readFile(const std::string& t_path);
+
+  // overwrite a field given as `tag.key` in the first section of the tag
+  // (a section is appended if the tag does not appear)
+  bool set(const std::string& t_tag_key, const std::string& t_value);
+
+  bool build(ComCtrlScenario* t_scenario) const;
+
+  inline const std::vector<Section>& sections() const noexcept {
+    return m_sections;
+  }
+
+ private:
+  std::vector<Section> m_sections;
+};
+
+// Runner of a scenario at full speed, which writes a row of the log every
+// step either as text or as raw native doubles. The text has the time in 10
+// significant digits and the other values in a round-trip form.
+class ComCtrlScenarioRunner {
+  using Self = ComCtrlScenarioRunner;
+
+ public:
+  enum class LogFormat { text, binary };
+
+ public:
+  explicit ComCtrlScenarioRunner(const ComCtrlScenario& t_scenario);
+
+  Self& set_log(std::ostream* t_os, LogFormat t_format = LogFormat::text);
+  // take a checkpoint every t_steps steps while running (0 disables them),
+  // every t_keyframe_interval-th of which is stored in full
+  Self& set_checkpoint_interval(
+      std::size_t t_steps,
+      std::size_t t_keyframe_interval =
+          CheckpointStore::default_keyframe_interval);
+
+  bool run();
+  // rewind to the latest checkpoint at or before t_time of the last run and
+  // run the rest of the scenario again, which writes the log from there on
+  // and reproduces the results of the original run bit by bit
+  bool replay(double t_time);
+
+  // results of the last run, where the COM error is the maximum horizontal
+  // distance of the COM from its reference
+  inline const ComZmpModelRawData& states() const noexcept { return m_states; }
+  inline std::size_t step_count() const noexcept { return m_step_count; }
+  // evaluations of the system equations by the controller and the simulator
+  // in the last run or replay
+  inline std::size_t evaluation_count() const noexcept {
+    return m_evaluation_count;
+  }
+  inline double max_com_error() const noexcept {
+    return m_max_com_error;
+  }
+  inline std::size_t checkpoint_interval() const noexcept {
+    return m_checkpoint_interval;
+  }
+  inline const CheckpointStore& checkpoints() const noexcept {
+    return m_checkpoints;
+  }
+
+ private:
+  const ComCtrlScenario& m_scenario;
+  std::ostream* m_os;
+  LogFormat m_format;
+  std::vector<double> m_row;
+  std::vector<char> m_text;
+  ComZmpModelRawData m_states;
+  std::size_t m_step_count;
+  std::size_t m_evaluation_count;
+  double m_max_com_error;
+  std::size_t m_next_command;
+  std::vector<std::pair<ComCtrlScenario::CommandField, RefTrajectory>>
+      m_profiles;
+  std::vector<RefTrajectory::Cursor> m_cursors;
+  std::size_t m_checkpoint_interval;
+  CheckpointStore m_checkpoints;
+  std::vector<char> m_image;
+  // delay lines in the feedback and the output paths of a closed loop
+  using Delay = DelayLine<Vec3D, ComCtrlScenario::max_delay_steps + 1>;
+  Delay m_sensed_position;
+  Delay m_sensed_velocity;
+  Delay m_actuation;
+
+  bool buildProfiles();
+  bool runOpenLoop(bool t_resume);
+  bool runClosedLoop(bool t_resume);
+  void saveCheckpoint(double t_time, const ComCtrl& t_ctrl,
+                      const ComZmpModel* t_model);
+  void loadCheckpoint(ComCtrl* t_ctrl, ComZmpModel* t_model);
+  void giveCommands(double t_time, ComCtrl* t_ctrl);
+  void writeLog(double t_time, const ComCtrl& t_ctrl,
+                const ComZmpModelRawData& t_states);
+};
+
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_COM_CTRL_SCENARIO_HPP_
@@ -0,0 +1,362 @@
+/* com_ctrl_scenario - scenario description to run COM controller
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_ctrl_scenario.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+const char* const kScenarioText = R"(% regulation with pushes
+[scenario]
+name: test
+time: 2   % seconds
+dt: 0.01
+loop: zmp_position
+log: time vxd ref_com_y com_position
+[initial]
+com_position: 0.1 -0.1 1
+com_velocity: 0 0.01 0
+[command]
+at: 1
+com_velocity: 0.1 0
+[command]
+at: 0
+com_position: 0 0 1
+qx1: 2
+[push]
+start: 0.5
+end: 0.6
+force: 1 -1 0
+[random_push]
+seed: 3
+interval: 1
+duration: 0.2
+)";
+
+bool buildScenario(const std::string& t_text, ComCtrlScenario* t_scenario) {
+  std::istringstream iss(t_text);
+  ComCtrlScenarioReader reader;
+  return reader.read(iss) && reader.build(t_scenario);
+}
+
+TEST_CASE("ComCtrlScenarioReader: read a scenario", "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  REQUIRE(buildScenario(kScenarioText, &s));
+  CHECK(s.name == "test");
+  CHECK(s.time == 2);
+  CHECK(s.dt == 0.01);
+  CHECK(s.loop == ComCtrlScenario::Loop::zmp_position);
+  CHECK(s.com_position == Vec3D(0.1, -0.1, 1));
+  REQUIRE(s.com_velocity);
+  CHECK(s.com_velocity.value() == Vec3D(0, 0.01, 0));
+  CHECK_FALSE(s.foot_dist);
+
+  SECTION("commands are sorted in time") {
+    REQUIRE(s.commands.size() == 2);
+    CHECK(s.commands[0].time == 0);
+    REQUIRE(s.commands[0].values.size() == 4);
+    CHECK(s.commands[0].values[0].first == &ComCtrlCommandsRawData::xd);
+    CHECK(s.commands[0].values[2].first == &ComCtrlCommandsRawData::zd);
+    CHECK(s.commands[0].values[2].second == 1);
+    CHECK(s.commands[0].values[3].first == &ComCtrlCommandsRawData::qx1);
+    CHECK(s.commands[1].time == 1);
+    REQUIRE(s.commands[1].values.size() == 2);
+    CHECK(s.commands[1].values[0].first == &ComCtrlCommandsRawData::vxd);
+    CHECK(s.commands[1].values[0].second == 0.1);
+  }
+  SECTION("disturbances") {
+    REQUIRE(s.pushes.size() == 1);
+    CHECK(s.pushes[0].start == 0.5);
+    CHECK(s.pushes[0].end == 0.6);
+    CHECK(s.pushes[0].force == Vec3D(1, -1, 0));
+    REQUIRE(s.random_push);
+    CHECK(s.random_push->seed() == 3);
+    CHECK(s.random_push->interval() == 1);
+    CHECK(s.random_push->duration() == 0.2);
+    CHECK(s.random_push->max_force() ==
+          RandomPushDisturbance::default_max_force);
+  }
+  SECTION("log columns") {
+    REQUIRE(s.log.size() == 4);
+    CHECK(s.log[0].kind == ComCtrlScenario::LogColumn::Kind::time);
+    CHECK(s.log[1].kind == ComCtrlScenario::LogColumn::Kind::command);
+    CHECK(s.log[2].kind == ComCtrlScenario::LogColumn::Kind::ref);
+    CHECK(s.log[2].axis == 1);
+    CHECK(s.log[3].kind == ComCtrlScenario::LogColumn::Kind::state);
+    CHECK(s.log_width() == 6);
+  }
+}
+
+TEST_CASE("ComCtrlScenarioReader: default scenario", "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  REQUIRE(buildScenario("[scenario]\n", &s));
+  CHECK(s.loop == ComCtrlScenario::Loop::open);
+  CHECK(s.profile == ComCtrlScenario::Profile::step);
+  CHECK(s.commands.empty());
+  CHECK(s.log.size() == 4);
+  CHECK(s.log_width() == 10);
+}
+
+TEST_CASE("ComCtrlScenarioReader: overwrite fields", "[ComCtrlScenario]") {
+  std::istringstream iss(kScenarioText);
+  ComCtrlScenarioReader reader;
+  REQUIRE(reader.read(iss));
+  REQUIRE(reader.set("scenario.dt", "0.001"));
+  REQUIRE(reader.set("initial.foot_dist", "0.2"));
+  REQUIRE(reader.set("random_push.seed", "5"));
+  ComCtrlScenario s;
+  REQUIRE(reader.build(&s));
+  CHECK(s.dt == 0.001);
+  REQUIRE(s.foot_dist);
+  CHECK(s.foot_dist.value() == 0.2);
+  CHECK(s.random_push->seed() == 5);
+
+  zEchoOff();
+  CHECK_FALSE(reader.set("dt", "0.001"));
+  zEchoOn();
+}
+
+TEST_CASE("ComCtrlScenarioReader: reject invalid scenarios",
+          "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  zEchoOff();
+  CHECK_FALSE(buildScenario("time: 1\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\ntime 1\n", &s));
+  CHECK_FALSE(buildScenario("[unknown]\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nunknown: 1\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\ntime: a\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\ndt: 0\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nloop: half\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nprofile: linear\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nramp: 0\n", &s));
+  CHECK_FALSE(buildScenario(
+      "[scenario]\nloop: zmp_position\nsensor_delay: -0.01\n", &s));
+  CHECK_FALSE(buildScenario(
+      "[scenario]\nloop: zmp_position\nactuator_delay: 2\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nsensor_delay: 0.01\n", &s));
+  CHECK_FALSE(buildScenario("[scenario]\nlog: time com_jerk\n", &s));
+  CHECK_FALSE(buildScenario("[initial]\ncom_position: 0 0\n", &s));
+  CHECK_FALSE(buildScenario("[command]\nxd: 1 2\n", &s));
+  CHECK_FALSE(buildScenario("[command]\nwd: 1\n", &s));
+  CHECK_FALSE(buildScenario("[random_push]\nseed: -\n", &s));
+  CHECK_FALSE(buildScenario("[push]\nforce: 1 0 0\n", &s));
+  zEchoOn();
+}
+
+TEST_CASE("ComCtrlScenarioRunner: open loop", "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  REQUIRE(buildScenario(
+      "[scenario]\ntime: 1\n"
+      "[initial]\ncom_position: 0.1 -0.1 1\n"
+      "[command]\ncom_position: 0 0 1\n[command]\nat: 0.5\nvxd: 0.1\n",
+      &s));
+  std::ostringstream oss;
+  ComCtrlScenarioRunner runner(s);
+  runner.set_log(&oss);
+  REQUIRE(runner.run());
+
+  ComCtrl ctrl;
+  auto cmd = ctrl.getCommands();
+  std::ostringstream expected;
+  char buf[256];
+  TextWriter writer(buf);
+  ctrl.reset(Vec3D(0.1, -0.1, 1));
+  cmd->set_com_position(Vec3D(0, 0, 1));
+  while (ctrl.time() < 1) {
+    if (ctrl.time() >= 0.5) cmd->vxd = 0.1;
+    ctrl.update(0.01);
+    writer.put(ctrl.time(), TextWriter::Format::general, 10) << ' ';
+    writer << ctrl.states().com_position << ' ';
+    writer << ctrl.states().com_velocity << ' ';
+    writer << ctrl.states().zmp_position << '\n';
+    writer.flush(expected);
+  }
+  CHECK(oss.str() == expected.str());
+  CHECK(runner.step_count() == 100);
+  CHECK(runner.evaluation_count() == ctrl.model().evaluation_count());
+  CHECK(runner.states().com_position == ctrl.states().com_position);
+  CHECK(runner.max_com_error() > 0.1);
+}
+
+TEST_CASE("ComCtrlScenarioRunner: smooth command profiles",
+          "[ComCtrlScenario]") {
+  const std::string text =
+      "[scenario]\ntime: 2\nlog: time vxd\n"
+      "[command]\nvxd: 0\n[command]\nat: 1\nvxd: 0.1\n";
+
+  SECTION("read profiles") {
+    ComCtrlScenario s;
+    REQUIRE(buildScenario(text + "[scenario]\nprofile: spline\n", &s));
+    CHECK(s.profile == ComCtrlScenario::Profile::spline);
+    REQUIRE(buildScenario(
+        text + "[scenario]\nprofile: min_jerk\nramp: 0.2\n", &s));
+    CHECK(s.profile == ComCtrlScenario::Profile::min_jerk);
+    CHECK(s.ramp == 0.2);
+  }
+  SECTION("minimum-jerk profile") {
+    ComCtrlScenario s;
+    REQUIRE(buildScenario(
+        text + "[scenario]\nprofile: min_jerk\nramp: 0.5\n", &s));
+    std::ostringstream oss;
+    ComCtrlScenarioRunner runner(s);
+    runner.set_log(&oss);
+    REQUIRE(runner.run());
+
+    std::istringstream iss(oss.str());
+    double t, vxd, prev = 0, max_jump = 0;
+    while (iss >> t >> vxd) {
+      // commands are given before the update, i.e. at t - dt
+      if (t < 1 + 0.5 * s.dt) CHECK(vxd == Approx(0).margin(1e-12));
+      if (t > 1.5 + 1.5 * s.dt) CHECK(vxd == Approx(0.1));
+      max_jump = std::max(max_jump, std::fabs(vxd - prev));
+      prev = vxd;
+    }
+    CHECK(prev == Approx(0.1));
+    // the peak rate of a minimum-jerk motion is 1.875 times the mean rate
+    CHECK(max_jump < 1.875 * 0.1 / 0.5 * s.dt + 1e-9);
+  }
+}
+
+TEST_CASE("ComCtrlScenarioRunner: closed loop with disturbances",
+          "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  REQUIRE(buildScenario(kScenarioText, &s));
+  std::ostringstream oss;
+  ComCtrlScenarioRunner runner(s);
+  runner.set_log(&oss, ComCtrlScenarioRunner::LogFormat::binary);
+  REQUIRE(runner.run());
+  CHECK(runner.step_count() == 200);
+  // RK4 of the controller and of the simulator
+  CHECK(runner.evaluation_count() == 200 * 8);
+  CHECK(oss.str().size() == 200 * s.log_width() * sizeof(double));
+
+  ComZmpModel model;
+  model.reset(Vec3D(0.1, -0.1, 1));
+  model.states().com_velocity = Vec3D(0, 0.01, 0);
+  model.setExternalForceCallback(
+      [&s](const Vec3D&, const Vec3D&, const double t) {
+        Vec3D f = s.random_push->force(t);
+        return t > 0.5 && t < 0.6 ? f + Vec3D(1, -1, 0) : f;
+      });
+  ComCtrl ctrl(model);
+  auto cmd = ctrl.getCommands();
+  cmd->set_com_position(Vec3D(0, 0, 1));
+  cmd->qx1 = 2;
+  while (model.time() < 2) {
+    ctrl.feedback(model);
+    if (model.time() >= 1) cmd->set_com_velocity(0.1, 0);
+    ctrl.update(0.01);
+    model.setZmpPosition(ctrl.outputs().zmp_position);
+    model.update(0.01);
+  }
+  CHECK(runner.states().com_position == model.states().com_position);
+  CHECK(runner.states().com_velocity == model.states().com_velocity);
+
+  const double* last = reinterpret_cast<const double*>(oss.str().data()) +
+                       199 * s.log_width();
+  CHECK(last[0] == model.time());
+  CHECK(last[1] == 0.1);
+  CHECK(last[2] == ctrl.refs().com_position[1]);
+  CHECK(last[3] == model.states().com_position[0]);
+  CHECK(last[5] == model.states().com_position[2]);
+}
+
+TEST_CASE("ComCtrlScenarioRunner: closed loop with transport delays",
+          "[ComCtrlScenario]") {
+  ComCtrlScenario s;
+  REQUIRE(buildScenario(
+      "[scenario]\ntime: 1\nloop: zmp_position\n"
+      "sensor_delay: 0.02\nactuator_delay: 0.015\n"
+      "[initial]\ncom_position: 0.1 -0.1 1\n"
+      "[command]\ncom_position: 0 0 1\n",
+      &s));
+  CHECK(s.sensor_delay == 0.02);
+  CHECK(s.actuator_delay == 0.015);
+  ComCtrlScenarioRunner runner(s);
+  REQUIRE(runner.run());
+
+  ComZmpModel model;
+  model.reset(Vec3D(0.1, -0.1, 1));
+  ComCtrl ctrl(model);
+  ctrl.getCommands()->set_com_position(Vec3D(0, 0, 1));
+  DelayLine<Vec3D, 8> position(2), velocity(2), zmp(1.5);
+  while (model.time() < 1) {
+    ctrl.feedback(position.update(model.states().com_position),
+                  velocity.update(model.states().com_velocity));
+    ctrl.update(0.01);
+    model.setZmpPosition(zmp.update(ctrl.outputs().zmp_position));
+    model.update(0.01);
+  }
+  CHECK(runner.states().com_position == model.states().com_position);
+  CHECK(runner.states().com_velocity == model.states().com_velocity);
+}
+
+TEST_CASE("ComCtrlScenarioRunner: replay from checkpoints",
+          "[ComCtrlScenario][checkpoint]") {
+  std::string text = kScenarioText;
+  SECTION("closed loop") {}
+  SECTION("closed loop with delays") {
+    text += "[scenario]\nsensor_delay: 0.025\nactuator_delay: 0.01\n";
+  }
+  SECTION("open loop without disturbances") {
+    text = text.substr(0, text.find("[push]")) + "[scenario]\nloop: open\n";
+  }
+  ComCtrlScenario s;
+  REQUIRE(buildScenario(text + "[scenario]\nprofile: min_jerk\n", &s));
+  std::ostringstream oss;
+  ComCtrlScenarioRunner runner(s);
+  runner.set_log(&oss, ComCtrlScenarioRunner::LogFormat::binary);
+  runner.set_checkpoint_interval(30, 4);
+  REQUIRE(runner.run());
+  REQUIRE(runner.checkpoints().size() == 7);
+  CHECK(runner.checkpoints().time(1) == Approx(0.3));
+  auto states = runner.states();
+  auto max_com_error = runner.max_com_error();
+  auto byte_size = runner.checkpoints().byte_size();
+  CHECK(byte_size <
+        runner.checkpoints().size() * runner.checkpoints().image_size());
+
+  // the log is written again from the checkpoint at 0.9
+  std::ostringstream replayed;
+  runner.set_log(&replayed, ComCtrlScenarioRunner::LogFormat::binary);
+  REQUIRE(runner.replay(1.0));
+  std::size_t row_size = s.log_width() * sizeof(double);
+  CHECK(replayed.str() == oss.str().substr(90 * row_size));
+  CHECK(runner.step_count() == 200);
+  CHECK(runner.states().com_position == states.com_position);
+  CHECK(runner.states().com_velocity == states.com_velocity);
+  CHECK(runner.max_com_error() == max_com_error);
+  CHECK(runner.checkpoints().size() == 7);
+  CHECK(runner.checkpoints().byte_size() == byte_size);
+
+  zEchoOff();
+  CHECK_FALSE(runner.replay(-1));
+  zEchoOn();
+}
+
+}  // namespace
+}  // namespace holon
@@ -21,11 +21,13 @@
 #include "holon/corelib/humanoid/com_ctrl.hpp"
 
 #include <roki/rk_g.h>
+#include <vector>
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
 #include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
 
 #include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
 #include "holon/test/util/catch/custom_matchers.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
@@ -332,6 +334,23 @@ TEST_CASE("check if desired ZMP position is modified after update",
   }
 }
 
+TEST_CASE("ComCtrl::update() does not allocate memory after warmup",
+          "[ComCtrl][update]") {
+  ComCtrl ctrl;
+  ctrl.reset(Vec3D(0.1, -0.1, 1));
+  auto cmd = ctrl.getCommands();
+  REQUIRE(ctrl.update());
+  REQUIRE_NO_ALLOCATIONS(for (auto i = 0; i < 10; ++i) ctrl.update());
+
+  cmd->set_com_position({0, 0.1, 1});
+  REQUIRE(ctrl.update());
+  REQUIRE_NO_ALLOCATIONS(for (auto i = 0; i < 10; ++i) {
+    cmd->set_com_position({0, 0.1 * i, 1});
+    ctrl.feedback(ctrl.model());
+    ctrl.update();
+  });
+}
+
 TEST_CASE("ComCtrl::update() updates control paramters", "[ComCtrl]") {
   ComCtrl ctrl;
   Vec3D p0 = {0.1, -0.1, 1.5};
@@ -876,5 +895,33 @@ SCENARIO("Check relations among rho, yd, dist and vyd", "[ComCtrl]") {
   }
 }
 
+TEST_CASE("ComCtrl: resume from a checkpoint", "[ComCtrl][checkpoint]") {
+  ComCtrl ctrl;
+  auto cmd = ctrl.getCommands();
+  cmd->vxd = 0.1;
+  cmd->vyd = 0.1;
+  while (ctrl.time() < 0.5) ctrl.update();
+
+  std::vector<char> image(ctrl.checkpoint_size());
+  CHECK(ctrl.saveCheckpoint(image.data()) == image.data() + image.size());
+  while (ctrl.time() < 1) ctrl.update();
+
+  SECTION("rewind itself") {
+    CHECK(ctrl.loadCheckpoint(image.data()) == image.data() + image.size());
+    CHECK(ctrl.time() == Approx(0.5));
+  }
+  ComCtrl other;
+  other.set_canonical_foot_dist(0.3);
+  SECTION("load into another controller") {
+    CHECK(other.loadCheckpoint(image.data()) == image.data() + image.size());
+    CHECK(other.canonical_foot_dist() == ctrl.canonical_foot_dist());
+    CHECK(other.commands().vyd.value() == 0.1);
+    while (other.time() < 1) other.update();
+    CHECK(other.states().com_position == ctrl.states().com_position);
+    CHECK(other.refs().com_position == ctrl.refs().com_position);
+    CHECK(other.refs().dist == ctrl.refs().dist);
+  }
+}
+
 }  // namespace
 }  // namespace holon
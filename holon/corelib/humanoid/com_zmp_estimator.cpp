@@ -0,0 +1,255 @@
+/* com_zmp_estimator - Kalman filter to estimate COM states and ZMP
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_zmp_estimator.hpp"
+
+#include <roki/rk_g.h>
+#include <zm/zm_misc.h>
+#include <algorithm>
+#include <cmath>
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+
+namespace holon {
+
+constexpr double ComZmpAxisEstimator::default_zeta;
+constexpr double ComZmpAxisEstimator::default_time_step;
+constexpr double ComZmpAxisEstimator::default_acc_variance;
+constexpr double ComZmpAxisEstimator::default_zmp_variance;
+constexpr double ComZmpAxisEstimator::default_com_position_noise;
+constexpr double ComZmpAxisEstimator::default_zmp_position_noise;
+constexpr double ComZmpAxisEstimator::default_initial_variance;
+
+namespace {
+
+// measurement matrix picks up the COM position and the ZMP
+const Matrix<2, 3> kH{1, 0, 0, 0, 0, 1};
+
+}  // namespace
+
+ComZmpAxisEstimator::ComZmpAxisEstimator()
+    : m_zeta(default_zeta),
+      m_time_step(default_time_step),
+      m_acc_variance(default_acc_variance),
+      m_zmp_variance(default_zmp_variance),
+      m_r{default_com_position_noise, 0, 0, default_zmp_position_noise},
+      m_is_steady(false) {
+  updateModel();
+  reset(0, 0, 0);
+}
+
+ComZmpAxisEstimator& ComZmpAxisEstimator::setup(double t_zeta,
+                                                double t_time_step) {
+  if (t_zeta <= 0) {
+    ZRUNERROR("zeta must be positive. (given: %f)", t_zeta);
+    return *this;
+  }
+  if (t_time_step <= 0) {
+    ZRUNERROR("Time step must be positive. (given: %f)", t_time_step);
+    return *this;
+  }
+  m_zeta = t_zeta;
+  m_time_step = t_time_step;
+  updateModel();
+  return *this;
+}
+
+ComZmpAxisEstimator& ComZmpAxisEstimator::set_process_noise(
+    double t_acc_variance, double t_zmp_variance) {
+  if (t_acc_variance < 0 || t_zmp_variance < 0) {
+    ZRUNERROR("Variances must be non-negative. (given: %f, %f)",
+              t_acc_variance, t_zmp_variance);
+    return *this;
+  }
+  m_acc_variance = t_acc_variance;
+  m_zmp_variance = t_zmp_variance;
+  updateModel();
+  return *this;
+}
+
+ComZmpAxisEstimator& ComZmpAxisEstimator::set_measurement_noise(
+    double t_com_position_noise, double t_zmp_position_noise) {
+  if (t_com_position_noise <= 0 || t_zmp_position_noise <= 0) {
+    ZRUNERROR("Measurement noises must be positive. (given: %f, %f)",
+              t_com_position_noise, t_zmp_position_noise);
+    return *this;
+  }
+  m_r = Matrix<2, 2>{t_com_position_noise, 0, 0, t_zmp_position_noise};
+  m_is_steady = false;
+  return *this;
+}
+
+ComZmpAxisEstimator& ComZmpAxisEstimator::reset(double t_position,
+                                                double t_velocity,
+                                                double t_zmp,
+                                                double t_variance) {
+  m_state = State{t_position, t_velocity, t_zmp};
+  if (!m_is_steady) m_covariance = t_variance * Covariance::identity();
+  return *this;
+}
+
+// With c = cosh(zeta dt) and s = sinh(zeta dt), the exact solution for a
+// constant input and ZMP over a step gives
+//   p' = c p + s/zeta v + (1 - c) z + (c - 1)/zeta^2 u
+//   v' = zeta s p + c v - zeta s z + s/zeta u.
+// The acceleration noise enters in the same way as u.
+void ComZmpAxisEstimator::updateModel() {
+  double c = std::cosh(m_zeta * m_time_step);
+  double s = std::sinh(m_zeta * m_time_step);
+  m_a = Covariance{c, s / m_zeta, 1 - c, m_zeta * s, c, -m_zeta * s, 0, 0, 1};
+  m_b = State{(c - 1) / (m_zeta * m_zeta), s / m_zeta, 0};
+  m_q = m_acc_variance * (m_b * m_b.transpose());
+  m_q(2, 2) += m_zmp_variance;
+  m_is_steady = false;
+}
+
+void ComZmpAxisEstimator::predictCovariance() {
+  m_covariance = (m_a * m_covariance * m_a.transpose() + m_q).symmetrize();
+}
+
+bool ComZmpAxisEstimator::correctCovariance() {
+  Matrix<3, 2> pht = m_covariance * kH.transpose();
+  Matrix<2, 2> s_inv;
+  if (!inverse(kH * pht + m_r, &s_inv)) {
+    ZRUNERROR("Innovation covariance is singular.");
+    return false;
+  }
+  m_gain = pht * s_inv;
+  Covariance ikh = Covariance::identity() - m_gain * kH;
+  m_covariance = (ikh * m_covariance * ikh.transpose() +
+                  m_gain * m_r * m_gain.transpose())
+                     .symmetrize();
+  return true;
+}
+
+bool ComZmpAxisEstimator::computeSteadyStateGain(int t_max_iter,
+                                                 double t_tol) {
+  m_is_steady = false;
+  for (int i = 0; i < t_max_iter; ++i) {
+    Gain prev = m_gain;
+    predictCovariance();
+    if (!correctCovariance()) return false;
+    double diff = 0;
+    for (std::size_t j = 0; j < 6; ++j)
+      diff = std::max(diff, std::fabs(m_gain[j] - prev[j]));
+    if (diff < t_tol) {
+      m_is_steady = true;
+      return true;
+    }
+  }
+  ZRUNWARN("Steady-state gain did not converge in %d iterations.",
+           t_max_iter);
+  return false;
+}
+
+void ComZmpAxisEstimator::predict(double t_input) {
+  m_state = m_a * m_state + t_input * m_b;
+  if (!m_is_steady) predictCovariance();
+}
+
+void ComZmpAxisEstimator::correct(double t_com_position,
+                                  double t_zmp_position) {
+  if (!m_is_steady && !correctCovariance()) return;
+  double e0 = t_com_position - m_state[0];
+  double e1 = t_zmp_position - m_state[2];
+  for (std::size_t i = 0; i < 3; ++i)
+    m_state[i] += m_gain(i, 0) * e0 + m_gain(i, 1) * e1;
+}
+
+ComZmpEstimator::ComZmpEstimator() {}
+
+Vec3D ComZmpEstimator::com_position() const {
+  return Vec3D(m_axes[0].position(), m_axes[1].position(),
+               m_axes[2].position());
+}
+
+Vec3D ComZmpEstimator::com_velocity() const {
+  return Vec3D(m_axes[0].velocity(), m_axes[1].velocity(),
+               m_axes[2].velocity());
+}
+
+Vec3D ComZmpEstimator::zmp_position() const {
+  return Vec3D(m_axes[0].zmp(), m_axes[1].zmp(), m_axes[2].zmp());
+}
+
+ComZmpEstimator& ComZmpEstimator::setup(double t_zeta, double t_time_step) {
+  for (auto& axis : m_axes) axis.setup(t_zeta, t_time_step);
+  return *this;
+}
+
+ComZmpEstimator& ComZmpEstimator::setup(const Vec3D& t_com_position,
+                                        const Vec3D& t_zmp_position,
+                                        double t_time_step) {
+  double zeta = com_zmp_model_formula::computeZeta(
+      t_com_position, t_zmp_position, kVec3DZero);
+  if (zeta == 0) return *this;
+  return setup(zeta, t_time_step);
+}
+
+ComZmpEstimator& ComZmpEstimator::set_process_noise(double t_acc_variance,
+                                                    double t_zmp_variance) {
+  for (auto& axis : m_axes)
+    axis.set_process_noise(t_acc_variance, t_zmp_variance);
+  return *this;
+}
+
+ComZmpEstimator& ComZmpEstimator::set_measurement_noise(
+    double t_com_position_noise, double t_zmp_position_noise) {
+  for (auto& axis : m_axes)
+    axis.set_measurement_noise(t_com_position_noise, t_zmp_position_noise);
+  return *this;
+}
+
+// the ZMP is reset at the static balance, namely, right below the COM at
+// the height where the gravity is balanced
+ComZmpEstimator& ComZmpEstimator::reset(const Vec3D& t_com_position,
+                                        const Vec3D& t_com_velocity) {
+  Vec3D zmp = t_com_position;
+  zmp[2] -= RK_G / (zeta() * zeta());
+  return reset(t_com_position, t_com_velocity, zmp);
+}
+
+ComZmpEstimator& ComZmpEstimator::reset(const Vec3D& t_com_position,
+                                        const Vec3D& t_com_velocity,
+                                        const Vec3D& t_zmp_position) {
+  for (std::size_t i = 0; i < 3; ++i)
+    m_axes[i].reset(t_com_position[i], t_com_velocity[i], t_zmp_position[i]);
+  return *this;
+}
+
+bool ComZmpEstimator::computeSteadyStateGain() {
+  bool result = true;
+  for (auto& axis : m_axes) result &= axis.computeSteadyStateGain();
+  return result;
+}
+
+void ComZmpEstimator::disableSteadyState() {
+  for (auto& axis : m_axes) axis.disableSteadyState();
+}
+
+void ComZmpEstimator::update(const Vec3D& t_com_position,
+                             const Vec3D& t_zmp_position,
+                             const Vec3D& t_external_acc) {
+  m_axes[0].update(t_com_position[0], t_zmp_position[0], t_external_acc[0]);
+  m_axes[1].update(t_com_position[1], t_zmp_position[1], t_external_acc[1]);
+  m_axes[2].update(t_com_position[2], t_zmp_position[2],
+                   t_external_acc[2] - RK_G);
+}
+
+}  // namespace holon
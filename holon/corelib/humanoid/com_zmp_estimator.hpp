@@ -0,0 +1,160 @@
+/* com_zmp_estimator - Kalman filter to estimate COM states and ZMP
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_COM_ZMP_ESTIMATOR_HPP_
+#define HOLON_HUMANOID_COM_ZMP_ESTIMATOR_HPP_
+
+#include <array>
+#include "holon/corelib/math/matrix.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+// Linear Kalman filter along one axis of the COM-ZMP model
+//   d^2p/dt^2 = zeta^2 (p - z) + u,
+// whose state is (p, dp/dt, z). The ZMP z is modeled as a random walk, and
+// both the COM position p and the ZMP z are measured. The transition is
+// the exact discretization for a constant zeta, and the covariance is
+// corrected in Joseph form to stay symmetric and positive semidefinite.
+// Once the steady-state gain is computed, correction skips the covariance
+// propagation and costs only a few multiply-adds.
+class ComZmpAxisEstimator {
+  using Self = ComZmpAxisEstimator;
+
+ public:
+  using State = ColumnVector<3>;
+  using Covariance = Matrix<3, 3>;
+  using Gain = Matrix<3, 2>;
+
+  static constexpr double default_zeta = 3.0;
+  static constexpr double default_time_step = 0.001;
+  // variances per time step
+  static constexpr double default_acc_variance = 1e-4;
+  static constexpr double default_zmp_variance = 1e-6;
+  static constexpr double default_com_position_noise = 1e-6;
+  static constexpr double default_zmp_position_noise = 1e-4;
+  static constexpr double default_initial_variance = 1e-2;
+
+ public:
+  ComZmpAxisEstimator();
+
+  // accessors
+  inline const State& state() const noexcept { return m_state; }
+  inline double position() const noexcept { return m_state[0]; }
+  inline double velocity() const noexcept { return m_state[1]; }
+  inline double zmp() const noexcept { return m_state[2]; }
+  inline const Covariance& covariance() const noexcept { return m_covariance; }
+  inline const Gain& gain() const noexcept { return m_gain; }
+  inline const Covariance& transition() const noexcept { return m_a; }
+  inline double zeta() const noexcept { return m_zeta; }
+  inline double time_step() const noexcept { return m_time_step; }
+  inline bool is_steady() const noexcept { return m_is_steady; }
+
+  // mutators
+  // (they invalidate the steady-state gain)
+  Self& setup(double t_zeta, double t_time_step);
+  Self& set_process_noise(double t_acc_variance, double t_zmp_variance);
+  Self& set_measurement_noise(double t_com_position_noise,
+                              double t_zmp_position_noise);
+  // (the covariance is kept in the steady-state mode)
+  Self& reset(double t_position, double t_velocity, double t_zmp,
+              double t_variance = default_initial_variance);
+
+  // Riccati recursion iterated until the gain converges; the covariance
+  // is replaced by the steady-state one
+  bool computeSteadyStateGain(int t_max_iter = 100000, double t_tol = 1e-12);
+  void disableSteadyState() noexcept { m_is_steady = false; }
+
+  // update functions
+  void predict(double t_input = 0);
+  void correct(double t_com_position, double t_zmp_position);
+  void update(double t_com_position, double t_zmp_position,
+              double t_input = 0) {
+    predict(t_input);
+    correct(t_com_position, t_zmp_position);
+  }
+
+ private:
+  double m_zeta;
+  double m_time_step;
+  double m_acc_variance;
+  double m_zmp_variance;
+  Matrix<2, 2> m_r;
+  Covariance m_a;
+  State m_b;
+  Covariance m_q;
+  State m_state;
+  Covariance m_covariance;
+  Gain m_gain;
+  bool m_is_steady;
+
+  void updateModel();
+  void predictCovariance();
+  bool correctCovariance();
+};
+
+// Estimator of the COM position, the COM velocity and the ZMP position from
+// noisy COM kinematics and the ZMP measured by force sensors, which runs
+// the filter above along each axis. The vertical axis takes the gravity as
+// the input. The estimates are meant to be fed back to ComCtrl.
+class ComZmpEstimator {
+  using Self = ComZmpEstimator;
+
+ public:
+  ComZmpEstimator();
+
+  // accessors
+  inline const ComZmpAxisEstimator& axis(std::size_t t_i) const {
+    return m_axes[t_i];
+  }
+  inline ComZmpAxisEstimator& axis(std::size_t t_i) { return m_axes[t_i]; }
+  Vec3D com_position() const;
+  Vec3D com_velocity() const;
+  Vec3D zmp_position() const;
+  inline double zeta() const noexcept { return m_axes[0].zeta(); }
+  inline double time_step() const noexcept { return m_axes[0].time_step(); }
+
+  // mutators
+  Self& setup(double t_zeta, double t_time_step);
+  // zeta at the static balance of the given COM and ZMP
+  Self& setup(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
+              double t_time_step);
+  Self& set_process_noise(double t_acc_variance, double t_zmp_variance);
+  Self& set_measurement_noise(double t_com_position_noise,
+                              double t_zmp_position_noise);
+  Self& reset(const Vec3D& t_com_position,
+              const Vec3D& t_com_velocity = kVec3DZero);
+  Self& reset(const Vec3D& t_com_position, const Vec3D& t_com_velocity,
+              const Vec3D& t_zmp_position);
+  bool computeSteadyStateGain();
+  void disableSteadyState();
+
+  // update function
+  // (t_external_acc is the acceleration due to known external forces)
+  void update(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
+              const Vec3D& t_external_acc = kVec3DZero);
+
+ private:
+  std::array<ComZmpAxisEstimator, 3> m_axes;
+};
+
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_COM_ZMP_ESTIMATOR_HPP_
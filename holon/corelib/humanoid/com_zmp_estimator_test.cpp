@@ -0,0 +1,196 @@
+/* com_zmp_estimator - Kalman filter to estimate COM states and ZMP
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/com_zmp_estimator.hpp"
+
+#include <roki/rk_g.h>
+#include <cmath>
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+const double kZeta = 3.0;
+const double kDt = 0.001;
+
+// noise-free trajectory along an axis with the ZMP following a random walk
+struct AxisTruth {
+  double p, v, z;
+  void step(double t_zmp_step, double t_input = 0) {
+    const int n = 100;
+    const double h = kDt / n;
+    for (int i = 0; i < n; ++i) {
+      v += (kZeta * kZeta * (p - z) + t_input) * h;
+      p += v * h;
+    }
+    z += t_zmp_step;
+  }
+};
+
+TEST_CASE("ComZmpAxisEstimator: constructor", "[ComZmpAxisEstimator][ctor]") {
+  ComZmpAxisEstimator estimator;
+  CHECK(estimator.zeta() == ComZmpAxisEstimator::default_zeta);
+  CHECK(estimator.time_step() == ComZmpAxisEstimator::default_time_step);
+  CHECK(estimator.position() == 0);
+  CHECK(estimator.velocity() == 0);
+  CHECK(estimator.zmp() == 0);
+  CHECK_FALSE(estimator.is_steady());
+  for (std::size_t i = 0; i < 3; ++i)
+    CHECK(estimator.covariance()(i, i) ==
+          ComZmpAxisEstimator::default_initial_variance);
+}
+
+TEST_CASE("ComZmpAxisEstimator: setup", "[ComZmpAxisEstimator]") {
+  ComZmpAxisEstimator estimator;
+  SECTION("transition is the exact discretization") {
+    estimator.setup(kZeta, kDt).reset(0.1, -0.2, 0.03);
+    AxisTruth truth{0.1, -0.2, 0.03};
+    for (int i = 0; i < 100; ++i) {
+      estimator.predict(0.5);
+      truth.step(0, 0.5);
+    }
+    CHECK(estimator.position() == Approx(truth.p).epsilon(1e-4));
+    CHECK(estimator.velocity() == Approx(truth.v).epsilon(1e-4));
+    CHECK(estimator.zmp() == truth.z);
+  }
+  SECTION("reject invalid values") {
+    zEchoOff();
+    estimator.setup(0, kDt);
+    CHECK(estimator.zeta() == ComZmpAxisEstimator::default_zeta);
+    estimator.setup(kZeta, -kDt);
+    CHECK(estimator.time_step() == ComZmpAxisEstimator::default_time_step);
+    zEchoOn();
+  }
+}
+
+double rms(double t_sum_sqr, int t_n) { return std::sqrt(t_sum_sqr / t_n); }
+
+TEST_CASE("ComZmpAxisEstimator: estimate states from noisy measurements",
+          "[ComZmpAxisEstimator]") {
+  const double com_noise = 0.002, zmp_noise = 0.01, zmp_walk = 0.0005;
+  Fuzzer com_fuzz(-com_noise, com_noise);
+  Fuzzer zmp_fuzz(-zmp_noise, zmp_noise);
+  Fuzzer walk_fuzz(-zmp_walk, zmp_walk);
+
+  ComZmpAxisEstimator estimator;
+  estimator.setup(kZeta, kDt)
+      .set_process_noise(1e-4, zmp_walk * zmp_walk / 3)
+      .set_measurement_noise(com_noise * com_noise / 3,
+                             zmp_noise * zmp_noise / 3);
+  SECTION("Kalman gain") {}
+  SECTION("steady-state gain") {
+    REQUIRE(estimator.computeSteadyStateGain());
+    REQUIRE(estimator.is_steady());
+  }
+  estimator.reset(0, 0, 0);
+
+  AxisTruth truth{0, 0, 0};
+  const int n = 5000, settle = 1000;
+  double p_err = 0, v_err = 0, z_err = 0, p_noise = 0, z_noise = 0;
+  for (int i = 0; i < n; ++i) {
+    // keep the ZMP near the COM so that the trajectory does not diverge
+    truth.step(walk_fuzz() + 0.01 * (truth.p + truth.v / kZeta - truth.z));
+    double p_meas = truth.p + com_fuzz();
+    double z_meas = truth.z + zmp_fuzz();
+    estimator.update(p_meas, z_meas);
+    if (i < settle) continue;
+    p_err += std::pow(estimator.position() - truth.p, 2);
+    v_err += std::pow(estimator.velocity() - truth.v, 2);
+    z_err += std::pow(estimator.zmp() - truth.z, 2);
+    p_noise += std::pow(p_meas - truth.p, 2);
+    z_noise += std::pow(z_meas - truth.z, 2);
+  }
+  CHECK(rms(p_err, n - settle) < 0.5 * rms(p_noise, n - settle));
+  CHECK(rms(z_err, n - settle) < 0.5 * rms(z_noise, n - settle));
+  CHECK(rms(v_err, n - settle) < 0.02);
+}
+
+TEST_CASE("ComZmpAxisEstimator: steady-state gain",
+          "[ComZmpAxisEstimator]") {
+  ComZmpAxisEstimator estimator, steady;
+  estimator.setup(kZeta, kDt);
+  steady.setup(kZeta, kDt);
+  REQUIRE(steady.computeSteadyStateGain());
+  for (int i = 0; i < 20000; ++i) estimator.update(0, 0);
+  for (std::size_t i = 0; i < 6; ++i)
+    CHECK(estimator.gain()[i] == Approx(steady.gain()[i]).epsilon(1e-6));
+  for (std::size_t i = 0; i < 3; ++i) {
+    CHECK(steady.covariance()(i, i) > 0);
+    for (std::size_t j = 0; j < 3; ++j)
+      CHECK(steady.covariance()(i, j) == steady.covariance()(j, i));
+  }
+
+  SECTION("steady-state gain is kept while updating") {
+    auto gain = steady.gain();
+    auto covariance = steady.covariance();
+    steady.reset(0.1, 0, 0);
+    for (int i = 0; i < 10; ++i) steady.update(0.1, 0.1);
+    CHECK(steady.gain() == gain);
+    CHECK(steady.covariance() == covariance);
+  }
+  SECTION("changing model invalidates steady-state gain") {
+    steady.setup(2 * kZeta, kDt);
+    CHECK_FALSE(steady.is_steady());
+    REQUIRE(steady.computeSteadyStateGain());
+    steady.set_measurement_noise(1e-2, 1e-2);
+    CHECK_FALSE(steady.is_steady());
+  }
+}
+
+TEST_CASE("ComZmpEstimator: setup at static balance", "[ComZmpEstimator]") {
+  ComZmpEstimator estimator;
+  Vec3D p(0.1, -0.05, 0.42), zmp(0.1, -0.05, 0);
+  estimator.setup(p, zmp, kDt);
+  CHECK(estimator.zeta() == Approx(std::sqrt(RK_G / 0.42)));
+  CHECK(estimator.time_step() == kDt);
+  for (std::size_t i = 0; i < 3; ++i)
+    CHECK(estimator.axis(i).zeta() == estimator.zeta());
+
+  SECTION("stay at rest") {
+    estimator.reset(p);
+    CHECK(estimator.zmp_position()[2] == Approx(0).margin(1e-12));
+    REQUIRE(estimator.computeSteadyStateGain());
+    for (int i = 0; i < 1000; ++i) estimator.update(p, zmp);
+    CHECK(estimator.com_position()[0] == Approx(p[0]));
+    CHECK(estimator.com_position()[1] == Approx(p[1]));
+    CHECK(estimator.com_position()[2] == Approx(p[2]));
+    CHECK(estimator.com_velocity()[0] == Approx(0).margin(1e-9));
+    CHECK(estimator.com_velocity()[1] == Approx(0).margin(1e-9));
+    CHECK(estimator.com_velocity()[2] == Approx(0).margin(1e-9));
+  }
+}
+
+TEST_CASE("ComCtrl: feedback estimates", "[ComZmpEstimator][ComCtrl]") {
+  Fuzzer fuzz;
+  ComCtrl ctrl;
+  ComZmpEstimator estimator;
+  Vec3D p = ctrl.initial_com_position();
+  Vec3D v = fuzz.get<Vec3D>();
+  estimator.setup(p, Vec3D(p[0], p[1], 0), kDt).reset(p, v);
+  ctrl.feedback(estimator);
+  CHECK(ctrl.states().com_position == estimator.com_position());
+  CHECK(ctrl.states().com_velocity == estimator.com_velocity());
+}
+
+}  // namespace
+}  // namespace holon
@@ -86,26 +86,18 @@ ComZmpModel& ComZmpModel::setComAccelerationCallback(CallbackFunc t_f) {
 ComZmpModel& ComZmpModel::setZmpPosition(const Vec3D& t_zmp_position,
                                          optional<double> t_reaction_force_z) {
   double fz = t_reaction_force_z.value_or(mass() * RK_G);
-  auto fz_f = [fz](const Vec3D&, const Vec3D&, const double) {
-    return Vec3D(0, 0, fz);
-  };
-  system().set_reaction_force_f(fz_f);
-  auto zmp_f = [t_zmp_position](const Vec3D&, const Vec3D&, const double) {
-    return t_zmp_position;
-  };
-  system().set_zmp_position_f(zmp_f);
+  system().set_reaction_force(Vec3D(0, 0, fz));
+  system().set_zmp_position(t_zmp_position);
   return *this;
 }
 
 ComZmpModel& ComZmpModel::setReactionForce(const Vec3D& t_reaction_force) {
-  system().set_reaction_force_f([t_reaction_force](
-      const Vec3D&, const Vec3D&, const double) { return t_reaction_force; });
+  system().set_reaction_force(t_reaction_force);
   return *this;
 }
 
 ComZmpModel& ComZmpModel::setExternalForce(const Vec3D& t_external_force) {
-  system().set_external_force_f([t_external_force](
-      const Vec3D&, const Vec3D&, const double) { return t_external_force; });
+  system().set_external_force(t_external_force);
   return *this;
 }
 
@@ -125,6 +117,26 @@ ComZmpModel& ComZmpModel::removeExternalForce() {
   return *this;
 }
 
+std::size_t ComZmpModel::addLiftoffEvent(Event::Callback t_callback,
+                                         bool t_is_terminal) {
+  return addSystemEvent(
+      [](const ComZmpModelSystem& s, const std::array<Vec3D, 2>& x,
+         const double t) { return s.reaction_force(x[0], x[1], t).z(); },
+      t_callback, EventDirection::falling, t_is_terminal);
+}
+
+std::size_t ComZmpModel::addSupportEdgeEvent(const Vec3D& t_point,
+                                             const Vec3D& t_normal,
+                                             Event::Callback t_callback,
+                                             bool t_is_terminal) {
+  return addSystemEvent(
+      [t_point, t_normal](const ComZmpModelSystem& s,
+                          const std::array<Vec3D, 2>& x, const double t) {
+        return (s.zmp_position(x[0], x[1], t) - t_point).dot(t_normal);
+      },
+      t_callback, EventDirection::rising, t_is_terminal);
+}
+
 bool ComZmpModel::isUpdatable(const Vec3D& p, const Vec3D& v) {
   if (!isMassValid(mass())) return false;
   if (system().isZmpPositionSet()) {
@@ -139,7 +151,7 @@ bool ComZmpModel::isUpdatable(const Vec3D& p, const Vec3D& v) {
 
 void ComZmpModel::updateData(const Vec3D& p, const Vec3D& v) {
   std::array<Vec3D, 2> state{{p, v}};
-  state = solver().update(system(), state, time(), time_step());
+  state = integrate(state);
   states().com_position = state[0];
   states().com_velocity = state[1];
   states().com_acceleration = system().com_acceleration(p, v, time());
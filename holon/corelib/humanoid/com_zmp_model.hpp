@@ -74,6 +74,16 @@ class ComZmpModel : public ModelBase<Vec3D, RungeKutta4<std::array<Vec3D, 2>>,
   Self& removeReactionForce();
   Self& removeExternalForce();
 
+  // events
+  // liftoff, where the vertical reaction force falls to zero
+  std::size_t addLiftoffEvent(Event::Callback t_callback = nullptr,
+                              bool t_is_terminal = true);
+  // the ZMP leaving the support region across the edge through t_point,
+  // where t_normal is the outward normal of the edge
+  std::size_t addSupportEdgeEvent(const Vec3D& t_point, const Vec3D& t_normal,
+                                  Event::Callback t_callback = nullptr,
+                                  bool t_is_terminal = true);
+
   virtual bool update() override;
   virtual bool update(double t_time_step) override;
 
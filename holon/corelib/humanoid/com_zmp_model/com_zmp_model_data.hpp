@@ -23,6 +23,7 @@
 
 #include <memory>
 #include "holon/corelib/data/data_set_base.hpp"
+#include "holon/corelib/data/fields.hpp"
 #include "holon/corelib/math/vec3d.hpp"
 
 namespace holon {
@@ -37,6 +38,10 @@ struct ComZmpModelRawData {
   Vec3D reaction_force;
   Vec3D external_force;
   Vec3D total_force;
+
+  HOLON_DEFINE_FIELDS(ComZmpModelRawData, mass, nu, com_position,
+                      com_velocity, com_acceleration, zmp_position,
+                      reaction_force, external_force, total_force)
 };
 
 class ComZmpModelData
@@ -21,6 +21,7 @@
 #include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
 
 #include <roki/rk_g.h>
+#include <cmath>
 
 namespace holon {
 namespace com_zmp_model_formula {
@@ -29,28 +30,36 @@ namespace {
 const Vec3D kG = {0, 0, RK_G};
 }  // namespace
 
-double computeSqrZeta(double t_com_position_z, double t_zmp_position_z,
-                      double t_com_acceleration_z) {
+template <typename T>
+T computeSqrZeta(T t_com_position_z, T t_zmp_position_z,
+                 T t_com_acceleration_z) {
   if (!isComZmpDiffValid(t_com_position_z, t_zmp_position_z) ||
       !isComAccelerationValid(t_com_acceleration_z)) {
-    return 0.0;
+    return 0;
   }
-  double numer = t_com_acceleration_z + RK_G;
-  double denom = t_com_position_z - t_zmp_position_z;
+  T numer = t_com_acceleration_z + T(RK_G);
+  T denom = t_com_position_z - t_zmp_position_z;
   return numer / denom;
 }
 
-double computeSqrZeta(double t_com_position_z, double t_zmp_position_z,
-                      double t_reaction_force_z, double t_mass) {
+template double computeSqrZeta<double>(double, double, double);
+template float computeSqrZeta<float>(float, float, float);
+
+template <typename T>
+T computeSqrZeta(T t_com_position_z, T t_zmp_position_z, T t_reaction_force_z,
+                 T t_mass) {
   if (!isMassValid(t_mass) ||
       !isComZmpDiffValid(t_com_position_z, t_zmp_position_z) ||
       !isReactionForceValid(t_reaction_force_z)) {
-    return 0.0;
+    return 0;
   }
-  double denom = (t_com_position_z - t_zmp_position_z) * t_mass;
+  T denom = (t_com_position_z - t_zmp_position_z) * t_mass;
   return t_reaction_force_z / denom;
 }
 
+template double computeSqrZeta<double>(double, double, double, double);
+template float computeSqrZeta<float>(float, float, float, float);
+
 double computeSqrZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                       const Vec3D& t_com_acceleration, const Vec3D& t_nu) {
   if (!isComZmpDiffValid(t_com_position, t_zmp_position) ||
@@ -75,18 +84,25 @@ double computeSqrZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
   return numer / denom;
 }
 
-double computeZeta(double t_com_position_z, double t_zmp_position_z,
-                   double t_com_acceleration_z) {
-  return sqrt(
+template <typename T>
+T computeZeta(T t_com_position_z, T t_zmp_position_z, T t_com_acceleration_z) {
+  return std::sqrt(
       computeSqrZeta(t_com_position_z, t_zmp_position_z, t_com_acceleration_z));
 }
 
-double computeZeta(double t_com_position_z, double t_zmp_position_z,
-                   double t_reation_force_z, double t_mass) {
-  return sqrt(computeSqrZeta(t_com_position_z, t_zmp_position_z,
-                             t_reation_force_z, t_mass));
+template double computeZeta<double>(double, double, double);
+template float computeZeta<float>(float, float, float);
+
+template <typename T>
+T computeZeta(T t_com_position_z, T t_zmp_position_z, T t_reation_force_z,
+              T t_mass) {
+  return std::sqrt(computeSqrZeta(t_com_position_z, t_zmp_position_z,
+                                  t_reation_force_z, t_mass));
 }
 
+template double computeZeta<double>(double, double, double, double);
+template float computeZeta<float>(float, float, float, float);
+
 double computeZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                    const Vec3D& t_com_acceleration, const Vec3D& t_nu) {
   return sqrt(
@@ -129,6 +145,14 @@ Vec3D computeReactForce(const Vec3D& t_com_position,
   return m_sqr_zeta * (t_com_position - t_zmp_position);
 }
 
+template <typename T>
+T computeComAcc(T t_com_position, T t_zmp_position, T t_sqr_zeta, T t_g) {
+  return t_sqr_zeta * (t_com_position - t_zmp_position) - t_g;
+}
+
+template double computeComAcc<double>(double, double, double, double);
+template float computeComAcc<float>(float, float, float, float);
+
 Vec3D computeComAcc(const Vec3D& t_reaction_force, double t_mass,
                     const Vec3D& t_external_force) {
   return (t_reaction_force + t_external_force) / t_mass - kG;
@@ -149,24 +173,59 @@ Vec3D computeComAcc(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                        t_external_force);
 }
 
-bool isMassValid(double t_mass) {
-  if (zIsTiny(t_mass) || t_mass < 0.0) {
-    ZRUNWARN("The mass must be positive. (given mass = %g)", t_mass);
+ComAccJacobian computeComAccJacobian(const Vec3D& t_com_position,
+                                     const Vec3D& t_zmp_position,
+                                     double t_reaction_force_z, double t_mass,
+                                     const Vec3D& t_nu) {
+  ComAccJacobian jacobian;
+  zMat3DClear(&jacobian.com_position);
+  zMat3DClear(&jacobian.zmp_position);
+  if (!isMassValid(t_mass) ||
+      !isComZmpDiffValid(t_com_position, t_zmp_position, t_nu)) {
+    return jacobian;
+  }
+  // ddp = sqr_zeta * (p - pz) - g + fe / m, sqr_zeta = fz / (m * nu.(p - pz))
+  Vec3D diff = t_com_position - t_zmp_position;
+  double denom = t_nu.dot(diff);
+  double sqr_zeta = t_reaction_force_z / (denom * t_mass);
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      double dadp = -sqr_zeta * diff[i] * t_nu[j] / denom;
+      if (i == j) dadp += sqr_zeta;
+      zMat3DElem(&jacobian.com_position, i, j) = dadp;
+      zMat3DElem(&jacobian.zmp_position, i, j) = -dadp;
+    }
+  }
+  jacobian.reaction_force = diff / (denom * t_mass);
+  return jacobian;
+}
+
+template <typename T>
+bool isMassValid(T t_mass) {
+  if (zIsTiny(t_mass) || t_mass < 0) {
+    ZRUNWARN("The mass must be positive. (given mass = %g)", double(t_mass));
     return false;
   }
   return true;
 }
 
-bool isComZmpDiffValid(double t_com_position_z, double t_zmp_position_z) {
-  double diff = t_com_position_z - t_zmp_position_z;
-  if (zIsTiny(diff) || diff < 0.0) {
+template bool isMassValid<double>(double);
+template bool isMassValid<float>(float);
+
+template <typename T>
+bool isComZmpDiffValid(T t_com_position_z, T t_zmp_position_z) {
+  T diff = t_com_position_z - t_zmp_position_z;
+  if (zIsTiny(diff) || diff < 0) {
     ZRUNWARN("The COM must be above the terrain. (given z = %g, zz = %g)",
-             t_com_position_z, t_zmp_position_z);
+             double(t_com_position_z), double(t_zmp_position_z));
     return false;
   }
   return true;
 }
 
+template bool isComZmpDiffValid<double>(double, double);
+template bool isComZmpDiffValid<float>(float, float);
+
 bool isComZmpDiffValid(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                        const Vec3D& t_nu) {
   double com_side = t_nu.dot(t_com_position - t_zmp_position);
@@ -181,15 +240,19 @@ bool isComZmpDiffValid(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
   return true;
 }
 
-bool isReactionForceValid(double t_reaction_force_z) {
-  if (t_reaction_force_z < 0.0) {
+template <typename T>
+bool isReactionForceValid(T t_reaction_force_z) {
+  if (t_reaction_force_z < 0) {
     ZRUNWARN("The reaction force must be positive. (given %g)",
-             t_reaction_force_z);
+             double(t_reaction_force_z));
     return false;
   }
   return true;
 }
 
+template bool isReactionForceValid<double>(double);
+template bool isReactionForceValid<float>(float);
+
 bool isReactionForceValid(const Vec3D& t_reaction_force, const Vec3D& t_nu) {
   double react_force = t_nu.dot(t_reaction_force);
   if (react_force < 0.0) {
@@ -202,15 +265,19 @@ bool isReactionForceValid(const Vec3D& t_reaction_force, const Vec3D& t_nu) {
   return true;
 }
 
-bool isComAccelerationValid(double t_com_acceleration_z) {
-  if ((t_com_acceleration_z + RK_G) < 0.0) {
+template <typename T>
+bool isComAccelerationValid(T t_com_acceleration_z) {
+  if ((t_com_acceleration_z + T(RK_G)) < 0) {
     ZRUNWARN("The COM acceleration must be greater than -G. (given %g)",
-             t_com_acceleration_z);
+             double(t_com_acceleration_z));
     return false;
   }
   return true;
 }
 
+template bool isComAccelerationValid<double>(double);
+template bool isComAccelerationValid<float>(float);
+
 bool isComAccelerationValid(const Vec3D& t_com_acceleration,
                             const Vec3D& t_nu) {
   double acc = t_nu.dot(t_com_acceleration + kG);
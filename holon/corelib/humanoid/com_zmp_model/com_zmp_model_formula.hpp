@@ -21,16 +21,21 @@
 #ifndef HOLON_HUMANOID_COM_ZMP_MODEL_FORMULA_HPP_
 #define HOLON_HUMANOID_COM_ZMP_MODEL_FORMULA_HPP_
 
+#include <zeo/zeo_mat3d.h>
 #include "holon/corelib/math/vec3d.hpp"
 
 namespace holon {
 namespace com_zmp_model_formula {
 
+// The scalar functions are instantiated for float and double.
+
 // functions to compute squared zeta
-double computeSqrZeta(double t_com_position_z, double t_zmp_position_z,
-                      double t_com_acceleration_z);
-double computeSqrZeta(double t_com_position_z, double t_zmp_position_z,
-                      double t_reation_force_z, double t_mass);
+template <typename T>
+T computeSqrZeta(T t_com_position_z, T t_zmp_position_z,
+                 T t_com_acceleration_z);
+template <typename T>
+T computeSqrZeta(T t_com_position_z, T t_zmp_position_z, T t_reation_force_z,
+                 T t_mass);
 double computeSqrZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                       const Vec3D& t_com_acceleration,
                       const Vec3D& t_nu = kVec3DZ);
@@ -39,10 +44,11 @@ double computeSqrZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                       const Vec3D& t_nu = kVec3DZ);
 
 // functions to compute zeta
-double computeZeta(double t_com_position_z, double t_zmp_position_z,
-                   double t_com_acceleration_z);
-double computeZeta(double t_com_position_z, double t_zmp_position_z,
-                   double t_reation_force_z, double t_mass);
+template <typename T>
+T computeZeta(T t_com_position_z, T t_zmp_position_z, T t_com_acceleration_z);
+template <typename T>
+T computeZeta(T t_com_position_z, T t_zmp_position_z, T t_reation_force_z,
+              T t_mass);
 double computeZeta(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                    const Vec3D& t_com_acceleration,
                    const Vec3D& t_nu = kVec3DZ);
@@ -63,6 +69,10 @@ Vec3D computeReactForce(const Vec3D& t_com_position,
                         const Vec3D& t_zmp_position, double t_reaction_force_z);
 
 // functions to compute COM acceleration
+// (the scalar one is along an axis, on which the gravitational acceleration
+// is t_g, i.e. G along z and 0 along x and y)
+template <typename T>
+T computeComAcc(T t_com_position, T t_zmp_position, T t_sqr_zeta, T t_g);
 Vec3D computeComAcc(const Vec3D& t_reaction_force, double t_mass,
                     const Vec3D& t_external_force = kVec3DZero);
 Vec3D computeComAcc(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
@@ -73,15 +83,36 @@ Vec3D computeComAcc(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                     const Vec3D& t_external_force = kVec3DZero,
                     const Vec3D& t_nu = kVec3DZ);
 
+// partial derivatives of COM acceleration with respect to the COM position,
+// the ZMP position and the reaction force along nu, which are enough to build
+// the linearized COM-ZMP model together with d(dp/dt)/dv = I; the COM
+// acceleration does not depend on the COM velocity, and its derivative with
+// respect to the external force is I/m, which is left to the caller
+struct ComAccJacobian {
+  zMat3D com_position;
+  zMat3D zmp_position;
+  Vec3D reaction_force;
+};
+
+// functions to compute Jacobian of COM acceleration
+ComAccJacobian computeComAccJacobian(const Vec3D& t_com_position,
+                                     const Vec3D& t_zmp_position,
+                                     double t_reaction_force_z, double t_mass,
+                                     const Vec3D& t_nu = kVec3DZ);
+
 // functions to check if some relation is correct
-bool isMassValid(double t_mass);
-bool isComZmpDiffValid(double t_com_position_z, double t_zmp_position_z);
+template <typename T>
+bool isMassValid(T t_mass);
+template <typename T>
+bool isComZmpDiffValid(T t_com_position_z, T t_zmp_position_z);
 bool isComZmpDiffValid(const Vec3D& t_com_position, const Vec3D& t_zmp_position,
                        const Vec3D& t_nu = kVec3DZ);
-bool isReactionForceValid(double t_reaction_force_z);
+template <typename T>
+bool isReactionForceValid(T t_reaction_force_z);
 bool isReactionForceValid(const Vec3D& t_reaction_force,
                           const Vec3D& t_nu = kVec3DZ);
-bool isComAccelerationValid(double t_com_acceleration_z);
+template <typename T>
+bool isComAccelerationValid(T t_com_acceleration_z);
 bool isComAccelerationValid(const Vec3D& t_com_acceleration,
                             const Vec3D& t_nu = kVec3DZ);
 
@@ -22,8 +22,13 @@
 
 #include <roki/rk_g.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "catch.hpp"
 #include "holon/test/util/catch/custom_matchers.hpp"
+#include "holon/test/util/differential/differential.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
 namespace holon {
@@ -33,6 +38,7 @@ using com_zmp_model_formula::computeSqrZeta;
 using com_zmp_model_formula::computeZeta;
 using com_zmp_model_formula::computeReactForce;
 using com_zmp_model_formula::computeComAcc;
+using com_zmp_model_formula::computeComAccJacobian;
 using com_zmp_model_formula::isMassValid;
 using com_zmp_model_formula::isComZmpDiffValid;
 using com_zmp_model_formula::isReactionForceValid;
@@ -742,5 +748,165 @@ TEST_CASE("computeComAcc(Vec3D&,Vec3D&,Vec3D&,double) 2",
   }
 }
 
+TEST_CASE("computeComAccJacobian(Vec3D&,Vec3D&,double,double)",
+          "[corelib][humanoid][com_zmp_model_formula]") {
+  Fuzzer fuzz(-1, 1);
+  Fuzzer positive(0.5, 2);
+  const double eps = 1e-6;
+
+  SECTION("partial derivatives match central differences") {
+    for (auto i = 0; i < 10; ++i) {
+      auto p = fuzz.get<Vec3D>();
+      p.set_z(positive());
+      auto pz = fuzz.get<Vec3D>();
+      pz.set_z(0);
+      double fz = positive() * G;
+      double m = positive();
+      auto acc = [&](const Vec3D& t_p, const Vec3D& t_pz, double t_fz) {
+        return computeComAcc(t_p, t_pz, Vec3D(0, 0, t_fz), m);
+      };
+      auto jacobian = computeComAccJacobian(p, pz, fz, m);
+      for (std::size_t j = 0; j < 3; ++j) {
+        Vec3D dp;
+        dp[j] = eps;
+        auto dadp = (acc(p + dp, pz, fz) - acc(p - dp, pz, fz)) / (2 * eps);
+        auto dadpz = (acc(p, pz + dp, fz) - acc(p, pz - dp, fz)) / (2 * eps);
+        for (std::size_t k = 0; k < 3; ++k) {
+          INFO("p = " << p << ", pz = " << pz << ", (" << k << "," << j
+                      << ")");
+          CHECK(zMat3DElem(&jacobian.com_position, k, j) ==
+                Approx(dadp[k]).margin(1e-6));
+          CHECK(zMat3DElem(&jacobian.zmp_position, k, j) ==
+                Approx(dadpz[k]).margin(1e-6));
+        }
+      }
+      auto dadfz = (acc(p, pz, fz + eps) - acc(p, pz, fz - eps)) / (2 * eps);
+      for (std::size_t k = 0; k < 3; ++k) {
+        CHECK(jacobian.reaction_force[k] == Approx(dadfz[k]).margin(1e-6));
+      }
+    }
+  }
+
+  SECTION("return zeros when the COM is not above the ZMP") {
+    zEchoOff();
+    auto jacobian = computeComAccJacobian({0, 0, 1}, {0, 0, 1}, G, 1);
+    zEchoOn();
+    for (std::size_t i = 0; i < 9; ++i) {
+      CHECK(zMat3DElem9(&jacobian.com_position, i) == 0);
+      CHECK(zMat3DElem9(&jacobian.zmp_position, i) == 0);
+    }
+    CHECK(jacobian.reaction_force == kVec3DZero);
+  }
+}
+
+TEST_CASE("computeComAcc through reaction force against through zeta",
+          "[corelib][humanoid][com_zmp_model_formula][differential]") {
+  // arguments: com position, ZMP position, squared zeta, mass
+  // (edge cases are checked separately below since a zero or infinite mass
+  // gives NaN in different components through the two)
+  auto com = [](const std::array<double, 8>& x) {
+    return Vec3D(x[0], x[1], x[2]);
+  };
+  auto zmp = [](const std::array<double, 8>& x) {
+    return Vec3D(x[3], x[4], x[5]);
+  };
+  EdgeCaseFuzzer fuzz(0.1, 2, 0);
+  UlpStats stats;
+  for (std::size_t i = 0; i < 3; ++i) {
+    auto reference = [&](const std::array<double, 8>& x) {
+      auto f = computeReactForce(com(x), zmp(x), x[6], x[7]);
+      return computeComAcc(f, x[7])[i];
+    };
+    auto candidate = [&](const std::array<double, 8>& x) {
+      return computeComAcc(com(x), zmp(x), x[6], x[7])[i];
+    };
+    auto res = compareUlp<8>(fuzz, fuzz_sample_count(100000), reference,
+                             candidate);
+    stats.merge(res.ulp);
+  }
+  INFO(stats);
+  CHECK(stats.nan_mismatch_count() == 0);
+  CHECK(stats.percentile(0.999) <= 3);
+}
+
+TEST_CASE("computeComAcc through reaction force against through zeta with "
+          "edge cases",
+          "[corelib][humanoid][com_zmp_model_formula][differential]") {
+  // arguments: com position, ZMP position, squared zeta, mass
+  // For a positive and finite mass, the two agree within rounding errors
+  // relative to the operands of the subtraction of gravity, or are the same
+  // infinity or both NaN, unless the reaction force or it divided by the
+  // mass overflows or underflows from finite operands, where it loses the
+  // precision which the other keeps.
+  auto is_edge_case = [](double v) { return !(v >= 0.1 && v <= 2); };
+  auto is_out_of_range = [](double t_product, double t_a, double t_b) {
+    if (!std::isfinite(t_a) || !std::isfinite(t_b)) return false;
+    if (t_a == 0 || t_b == 0) return false;
+    return !std::isnormal(t_product);
+  };
+  EdgeCaseFuzzer fuzz(0.1, 2);
+  std::size_t n_edge_case = 0;
+  zEchoOff();
+  checkProperty<8>(
+      fuzz, fuzz_sample_count(100000), [&](const std::array<double, 8>& x) {
+        Vec3D p(x[0], x[1], x[2]), pz(x[3], x[4], x[5]);
+        double sqr_zeta = x[6], mass = x[7];
+        if (!isMassValid(mass) || !std::isfinite(mass)) return true;
+        double ms = mass * sqr_zeta;
+        if (is_out_of_range(ms, mass, sqr_zeta)) return true;
+        Vec3D f = computeReactForce(p, pz, sqr_zeta, mass);
+        Vec3D expected = computeComAcc(f, mass);
+        Vec3D actual = computeComAcc(p, pz, sqr_zeta, mass);
+        bool is_domain = false;
+        for (std::size_t i = 0; i < 3; ++i) {
+          double d = p[i] - pz[i];
+          if (is_out_of_range(f[i], ms, d) ||
+              is_out_of_range(f[i] / mass, f[i], mass))
+            continue;
+          is_domain = true;
+          if (std::isnan(expected[i]) || std::isnan(actual[i])) {
+            if (std::isnan(expected[i]) != std::isnan(actual[i])) return false;
+            continue;
+          }
+          if (std::isinf(expected[i]) || std::isinf(actual[i])) {
+            if (expected[i] != actual[i]) return false;
+            continue;
+          }
+          double scale = std::fabs(sqr_zeta * d) + (i == 2 ? RK_G : 0);
+          double tol = 4 * std::numeric_limits<double>::epsilon() * scale;
+          if (std::fabs(expected[i] - actual[i]) > tol) return false;
+        }
+        if (is_domain && std::any_of(x.begin(), x.end(), is_edge_case))
+          ++n_edge_case;
+        return true;
+      });
+  zEchoOn();
+  CHECK(n_edge_case > 0);
+}
+
+TEST_CASE("scalar formulas in single precision",
+          "[ComZmpModelFormula][float]") {
+  Fuzzer fuzz(-0.1, 0.1);
+  Fuzzer fuzz_positive(0.5, 2);
+  for (auto i = 0; i < 10; ++i) {
+    double z = fuzz_positive(), zz = fuzz(), fz = G * fuzz_positive();
+    double m = fuzz_positive(), x = fuzz(), xz = fuzz();
+    auto expected_sqr_zeta = computeSqrZeta(z, zz, fz, m);
+    auto sqr_zeta = computeSqrZeta<float>(z, zz, fz, m);
+    CHECK(sqr_zeta == Approx(expected_sqr_zeta).epsilon(1e-5));
+    CHECK(computeZeta<float>(z, zz, fz, m) ==
+          Approx(computeZeta(z, zz, fz, m)).epsilon(1e-5));
+    double az = fz / m - G;
+    CHECK(computeSqrZeta<float>(z, zz, az) ==
+          Approx(computeSqrZeta(z, zz, az)).epsilon(1e-5));
+    auto expected_acc = computeComAcc(Vec3D(x, 0, z), Vec3D(xz, 0, zz),
+                                      expected_sqr_zeta);
+    CHECK(computeComAcc<float>(x, xz, sqr_zeta, 0) ==
+          Approx(expected_acc.x()).epsilon(1e-5).margin(1e-6));
+    CHECK(computeComAcc<float>(z, zz, sqr_zeta, G) ==
+          Approx(expected_acc.z()).epsilon(1e-5).margin(1e-5));
+  }
+}
+
 }  // namespace
 }  // namespace holon
@@ -59,15 +59,14 @@ ComZmpModelSystem::Function ComZmpModelSystem::getDefaultComAccFunc() const {
 ComZmpModelSystem::Function ComZmpModelSystem::getComAccFuncWithReactForce()
     const {
   return [this](const Vec3D& p, const Vec3D& v, const double t) {
-    return computeComAcc(m_reaction_force_f(p, v, t), data().get().mass,
-                         m_external_force_f(p, v, t));
+    return computeComAcc(reaction_force(p, v, t), data().get().mass,
+                         external_force(p, v, t));
   };
 }
 ComZmpModelSystem::Function ComZmpModelSystem::getComAccFuncWithZmpPos() const {
   return [this](const Vec3D& p, const Vec3D& v, const double t) {
-    return computeComAcc(p, m_zmp_position_f(p, v, t),
-                         m_reaction_force_f(p, v, t), data().get().mass,
-                         m_external_force_f(p, v, t));
+    return computeComAcc(p, zmp_position(p, v, t), reaction_force(p, v, t),
+                         data().get().mass, external_force(p, v, t));
   };
 }
 
@@ -102,11 +101,8 @@ ComZmpModelSystem& ComZmpModelSystem::set_reaction_force_f(
     m_reaction_force_f = t_reaction_force_f;
   else
     m_reaction_force_f = getDefaultReactForceFunc();
-
-  if (m_zmp_position_f)
-    return set_com_acceleration_f(getComAccFuncWithZmpPos());
-  else
-    return set_com_acceleration_f(getComAccFuncWithReactForce());
+  m_reaction_force = nullopt;
+  return updateComAccFunc();
 }
 
 ComZmpModelSystem& ComZmpModelSystem::set_external_force_f(
@@ -115,11 +111,8 @@ ComZmpModelSystem& ComZmpModelSystem::set_external_force_f(
     m_external_force_f = t_external_force_f;
   else
     m_external_force_f = getDefaultExtForceFunc();
-
-  if (m_zmp_position_f)
-    return set_com_acceleration_f(getComAccFuncWithZmpPos());
-  else
-    return set_com_acceleration_f(getComAccFuncWithReactForce());
+  m_external_force = nullopt;
+  return updateComAccFunc();
 }
 
 ComZmpModelSystem& ComZmpModelSystem::set_zmp_position_f(
@@ -128,8 +121,38 @@ ComZmpModelSystem& ComZmpModelSystem::set_zmp_position_f(
     m_zmp_position_f = t_zmp_position_f;
   else
     m_zmp_position_f = getDefaultZmpPosFunc();
+  m_zmp_position = nullopt;
+  return updateComAccFunc();
+}
+
+// The COM acceleration function is rebuilt only when a constant input is
+// newly enabled, so that writing it every tick involves no callback.
+ComZmpModelSystem& ComZmpModelSystem::set_reaction_force(
+    const Vec3D& t_reaction_force) {
+  bool is_set = static_cast<bool>(m_reaction_force);
+  m_reaction_force = t_reaction_force;
+  if (is_set) return *this;
+  return updateComAccFunc();
+}
+
+ComZmpModelSystem& ComZmpModelSystem::set_external_force(
+    const Vec3D& t_external_force) {
+  bool is_set = static_cast<bool>(m_external_force);
+  m_external_force = t_external_force;
+  if (is_set) return *this;
+  return updateComAccFunc();
+}
+
+ComZmpModelSystem& ComZmpModelSystem::set_zmp_position(
+    const Vec3D& t_zmp_position) {
+  bool is_set = static_cast<bool>(m_zmp_position);
+  m_zmp_position = t_zmp_position;
+  if (is_set) return *this;
+  return updateComAccFunc();
+}
 
-  if (m_zmp_position_f)
+ComZmpModelSystem& ComZmpModelSystem::updateComAccFunc() {
+  if (isZmpPositionSet())
     return set_com_acceleration_f(getComAccFuncWithZmpPos());
   else
     return set_com_acceleration_f(getComAccFuncWithReactForce());
@@ -21,6 +21,7 @@
 #ifndef HOLON_HUMANOID_COM_ZMP_MODEL_SYSTEM_HPP_
 #define HOLON_HUMANOID_COM_ZMP_MODEL_SYSTEM_HPP_
 
+#include "holon/corelib/common/optional.hpp"
 #include "holon/corelib/control/system_base.hpp"
 #include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_data.hpp"
 #include "holon/corelib/math/vec3d.hpp"
@@ -51,18 +52,21 @@ class ComZmpModelSystem : public SystemBase<Vec3D, ComZmpModelData> {
   }
   inline Vec3D reaction_force(const Vec3D& p, const Vec3D& v,
                               const double t) const {
+    if (m_reaction_force) return *m_reaction_force;
     return m_reaction_force_f(p, v, t);
   }
   inline Vec3D external_force(const Vec3D& p, const Vec3D& v,
                               const double t) const {
+    if (m_external_force) return *m_external_force;
     return m_external_force_f(p, v, t);
   }
   inline Vec3D zmp_position(const Vec3D& p, const Vec3D& v,
                             const double t) const {
+    if (m_zmp_position) return *m_zmp_position;
     return m_zmp_position_f(p, v, t);
   }
   inline bool isZmpPositionSet() const {
-    return static_cast<bool>(m_zmp_position_f);
+    return m_zmp_position || static_cast<bool>(m_zmp_position_f);
   }
 
   // mutators
@@ -71,6 +75,12 @@ class ComZmpModelSystem : public SystemBase<Vec3D, ComZmpModelData> {
   Self& set_external_force_f(Function t_external_force_f);
   Self& set_zmp_position_f(Function t_zmp_position_f);
 
+  // constant inputs, which take precedence over the callback functions
+  // until the corresponding callback function is set again
+  Self& set_reaction_force(const Vec3D& t_reaction_force);
+  Self& set_external_force(const Vec3D& t_external_force);
+  Self& set_zmp_position(const Vec3D& t_zmp_position);
+
   Function getDefaultComAccFunc() const;
   Function getComAccFuncWithReactForce() const;
   Function getComAccFuncWithZmpPos() const;
@@ -79,10 +89,15 @@ class ComZmpModelSystem : public SystemBase<Vec3D, ComZmpModelData> {
   Function getDefaultZmpPosFunc() const;
 
  private:
+  Self& updateComAccFunc();
+
   Function m_com_acceleration_f;
   Function m_reaction_force_f;
   Function m_external_force_f;
   Function m_zmp_position_f;
+  optional<Vec3D> m_reaction_force;
+  optional<Vec3D> m_external_force;
+  optional<Vec3D> m_zmp_position;
 };
 
 }  // namespace holon
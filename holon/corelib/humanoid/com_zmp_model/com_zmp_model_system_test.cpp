@@ -203,5 +203,52 @@ TEST_CASE("ComZmpModelSystem::isZmpPositionSet() returns if it is set",
   CHECK(sys.isZmpPositionSet());
 }
 
+TEST_CASE("ComZmpModelSystem: constant inputs", "[ComZmpModelSystem]") {
+  auto data = make_data<ComZmpModelData>();
+  ComZmpModelSystem sys(data);
+  Fuzzer fuzz;
+  auto p = fuzz.get<Vec3D>();
+  p.set_z(Fuzzer(0.1, 10).get<double>());
+  auto v = fuzz.get<Vec3D>();
+  auto t = fuzz();
+  auto m = data.get().mass;
+  auto ef = fuzz.get<Vec3D>();
+  ComZmpModelSystem::StateArray x{{p, v}};
+
+  SECTION("reaction force") {
+    auto f = fuzz.get<Vec3D>();
+    sys.set_reaction_force(f);
+    CHECK(sys.reaction_force(p, v, t) == f);
+    CHECK(sys(x, t)[1] == computeComAcc(f, m, kVec3DZero));
+    sys.set_reaction_force_f(nullptr);
+    CHECK(sys.reaction_force(p, v, t) == Vec3D(0, 0, m * G));
+  }
+  SECTION("external force") {
+    sys.set_external_force(ef);
+    CHECK(sys.external_force(p, v, t) == ef);
+    CHECK(sys(x, t)[1] == computeComAcc(Vec3D(0, 0, m * G), m, ef));
+    sys.set_external_force_f(nullptr);
+    CHECK(sys.external_force(p, v, t) == kVec3DZero);
+  }
+  SECTION("ZMP position") {
+    Vec3D zmp = {1, -1, 0};
+    REQUIRE_FALSE(sys.isZmpPositionSet());
+    sys.set_zmp_position(zmp);
+    sys.set_external_force(ef);
+    CHECK(sys.isZmpPositionSet());
+    CHECK(sys.zmp_position(p, v, t) == zmp);
+    CHECK(sys(x, t)[1] == computeComAcc(p, zmp, Vec3D(0, 0, m * G), m, ef));
+    sys.set_zmp_position_f(nullptr);
+    CHECK_FALSE(sys.isZmpPositionSet());
+  }
+  SECTION("callback function takes over constant input") {
+    auto f = fuzz.get<Vec3D>();
+    sys.set_reaction_force(fuzz.get<Vec3D>());
+    sys.set_reaction_force_f(
+        [f](const Vec3D&, const Vec3D&, const double) { return f; });
+    CHECK(sys.reaction_force(p, v, t) == f);
+  }
+}
+
 }  // namespace
 }  // namespace holon
@@ -22,9 +22,15 @@
 
 #include <zm/zm_ieee.h>
 #include <roki/rk_g.h>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
 #include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+#include "holon/corelib/math/ode_parareal.hpp"
 
 #include "catch.hpp"
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
 #include "holon/test/util/catch/custom_matchers.hpp"
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
@@ -338,6 +344,30 @@ TEST_CASE("ComZmpModel::removeExternalForce removes external force",
   CHECK(model.system().external_force(p, v, t) == kVec3DZero);
 }
 
+TEST_CASE("Setting constant inputs of ComZmpModel does not allocate memory",
+          "[ComZmpModel][setZmpPosition][setExternalForce]") {
+  ComZmpModel model;
+  Fuzzer fuzz;
+  Vec3D pz = {0.1, -0.1, 0};
+  Vec3D fe = fuzz.get<Vec3D>();
+  Vec3D f = {0, 0, 2 * G};
+  model.setZmpPosition(pz);
+  model.setExternalForce(fe);
+
+  NoAllocRegion region;
+  for (auto i = 0; i < 10; ++i) {
+    model.setZmpPosition(pz, i * G);
+    model.setExternalForce(fe * i);
+    model.update();
+  }
+  model.removeZmpPosition();
+  for (auto i = 0; i < 10; ++i) {
+    model.setReactionForce(f * i);
+    model.update();
+  }
+  CHECK(region.allocations() == 0);
+}
+
 TEST_CASE("ComZmpModel::update counts time", "[ComZmpModel][update]") {
   ComZmpModel model;
   REQUIRE(model.time() == 0.0);
@@ -349,6 +379,15 @@ TEST_CASE("ComZmpModel::update counts time", "[ComZmpModel][update]") {
   REQUIRE(model.time() == Approx(3. * model.time_step()));
 }
 
+TEST_CASE("ComZmpModel::update does not allocate memory after warmup",
+          "[ComZmpModel][update]") {
+  ComZmpModel model;
+  model.reset(Vec3D(0.1, -0.1, 1));
+  REQUIRE(model.update());
+  REQUIRE_NO_ALLOCATIONS(for (auto i = 0; i < 10; ++i) model.update());
+  REQUIRE_NO_ALLOCATIONS(model.update(0.002));
+}
+
 TEST_CASE("ComZmpModel::update(double) modify step time",
           "[ComZmpModel][update]") {
   ComZmpModel model;
@@ -523,5 +562,137 @@ TEST_CASE("ComZmpModel::update() updates external force in data",
   CHECK(data.get().external_force == ext_force);
 }
 
+TEST_CASE("ComZmpModel stops at liftoff", "[ComZmpModel][event]") {
+  // the vertical reaction force decreases linearly and vanishes at T
+  const double T = 0.0234;
+  ComZmpModel model;
+  model.setReactionForceCallback(
+      [&model, T](const Vec3D&, const Vec3D&, const double t) {
+        return Vec3D(0, 0, model.mass() * G * (1 - t / T));
+      });
+  int count = 0;
+  model.addLiftoffEvent([&count](const std::array<Vec3D, 2>&,
+                                 const double) { ++count; });
+  model.set_time_step(0.01);
+  REQUIRE(model.update());
+  CHECK_FALSE(model.stopped_event());
+  REQUIRE(model.update());
+  CHECK_FALSE(model.stopped_event());
+  REQUIRE(model.update());
+  REQUIRE(model.stopped_event());
+  CHECK(count == 1);
+  CHECK(model.time() == Approx(T).epsilon(1e-9));
+}
+
+TEST_CASE("ComZmpModel evaluates events of a copy on its own system",
+          "[ComZmpModel][event]") {
+  const double T = 0.0234;
+  std::unique_ptr<ComZmpModel> original(new ComZmpModel);
+  original->addLiftoffEvent();
+  original->set_time_step(0.01);
+  ComZmpModel copy(*original);
+  original.reset();
+  copy.setReactionForceCallback(
+      [&copy, T](const Vec3D&, const Vec3D&, const double t) {
+        return Vec3D(0, 0, copy.mass() * G * (1 - t / T));
+      });
+  REQUIRE(copy.update());
+  REQUIRE(copy.update());
+  CHECK_FALSE(copy.stopped_event());
+  REQUIRE(copy.update());
+  REQUIRE(copy.stopped_event());
+  CHECK(copy.time() == Approx(T).epsilon(1e-9));
+}
+
+TEST_CASE("ComZmpModel dispatches callback when ZMP crosses support edge",
+          "[ComZmpModel][event]") {
+  // the ZMP moves forward at 0.1 m/s and crosses the toe at x = 0.0025
+  ComZmpModel model;
+  model.setZmpPositionCallback(
+      [](const Vec3D&, const Vec3D&, const double t) {
+        return Vec3D(0.1 * t, 0, 0);
+      });
+  std::vector<double> times;
+  model.addSupportEdgeEvent(
+      Vec3D(0.0025, 0, 0), kVec3DX,
+      [&times](const std::array<Vec3D, 2>&, const double t) {
+        times.push_back(t);
+      },
+      false);
+  for (int i = 0; i < 5; ++i) REQUIRE(model.update(0.01));
+  CHECK_FALSE(model.stopped_event());
+  CHECK(model.time() == Approx(0.05));
+  REQUIRE(times.size() == 1);
+  CHECK(times[0] == Approx(0.025).epsilon(1e-9));
+}
+
+TEST_CASE("ComZmpModel resumes from a checkpoint",
+          "[ComZmpModel][checkpoint]") {
+  const double T = 0.0234;
+  ComZmpModel model;
+  model.setReactionForceCallback(
+      [&model, T](const Vec3D&, const Vec3D&, const double t) {
+        return Vec3D(0, 0, model.mass() * G * (1 - t / T));
+      });
+  model.addLiftoffEvent();
+  model.set_time_step(0.01);
+  for (int i = 0; i < 3; ++i) REQUIRE(model.update());
+  REQUIRE(model.stopped_event());
+
+  // the checkpoint includes the step stopped by the event
+  std::vector<char> image(model.checkpoint_size());
+  CHECK(model.saveCheckpoint(image.data()) == image.data() + image.size());
+  model.removeReactionForce();
+  REQUIRE(model.update());
+  REQUIRE(model.update());
+  auto expected = model.states();
+  double time = model.time();
+
+  CHECK(model.loadCheckpoint(image.data()) == image.data() + image.size());
+  CHECK(model.time() == Approx(T).epsilon(1e-9));
+  REQUIRE(model.stopped_event());
+  REQUIRE(model.update());
+  REQUIRE(model.update());
+  CHECK(model.time() == time);
+  CHECK(model.states().com_position == expected.com_position);
+  CHECK(model.states().com_velocity == expected.com_velocity);
+}
+
+TEST_CASE("ComZmpModel system is integrated by Parareal",
+          "[ComZmpModel][Parareal]") {
+  // the ZMP regulates the COM to the origin
+  ComZmpModel model(Vec3D(0.1, -0.1, 1));
+  model.setZmpPositionCallback(
+      [](const Vec3D& p, const Vec3D& v, const double) {
+        return Vec3D(2 * p.x() + v.x() / std::sqrt(G),
+                     2 * p.y() + v.y() / std::sqrt(G), 0);
+      });
+  using State = ComZmpModel::StateArray;
+  State x0{{model.states().com_position, model.states().com_velocity}};
+  RungeKutta4<State> rk4;
+  State expected = x0;
+  for (int i = 0; i < 400; ++i)
+    expected = rk4.update(model.system(), expected, i * 0.01, 0.01);
+
+  Parareal<State> parareal;
+  parareal.set_slice_num(8).set_fine_step(0.01).set_thread_num(3);
+  SECTION("identical to serial RK4 after as many iterations as slices") {
+    parareal.set_tolerance(0).set_max_iteration(8);
+    State x = parareal.update(model.system(), x0, 0.0, 4.0);
+    CHECK(parareal.iteration() == 8);
+    CHECK(x[0] == expected[0]);
+    CHECK(x[1] == expected[1]);
+  }
+  SECTION("converge before that") {
+    parareal.set_slice_num(16).set_coarse_step_num(5).set_tolerance(1e-10);
+    State x = parareal.update(model.system(), x0, 0.0, 4.0);
+    CHECK(parareal.iteration() < 16);
+    for (std::size_t i = 0; i < 3; ++i) {
+      CHECK(x[0][i] == Approx(expected[0][i]).margin(1e-9));
+      CHECK(x[1][i] == Approx(expected[1][i]).margin(1e-9));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace holon
@@ -0,0 +1,90 @@
+/* random_push_disturbance - reproducible random pushes as external force
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/random_push_disturbance.hpp"
+
+#include <zm/zm_misc.h>
+#include <cmath>
+#include "holon/corelib/math/philox.hpp"
+
+namespace holon {
+
+constexpr double RandomPushDisturbance::default_interval;
+constexpr double RandomPushDisturbance::default_duration;
+constexpr double RandomPushDisturbance::default_max_force;
+
+RandomPushDisturbance::RandomPushDisturbance(std::uint64_t t_seed)
+    : m_seed(t_seed),
+      m_start_time(0),
+      m_interval(default_interval),
+      m_duration(default_duration),
+      m_max_force(default_max_force) {}
+
+RandomPushDisturbance& RandomPushDisturbance::set_seed(std::uint64_t t_seed) {
+  m_seed = t_seed;
+  return *this;
+}
+
+RandomPushDisturbance& RandomPushDisturbance::set_start_time(
+    double t_start_time) {
+  m_start_time = t_start_time;
+  return *this;
+}
+
+RandomPushDisturbance& RandomPushDisturbance::set_interval(double t_interval) {
+  if (t_interval <= 0) {
+    ZRUNWARN("Interval of pushes must be positive. (given: %f)", t_interval);
+    return *this;
+  }
+  m_interval = t_interval;
+  if (m_duration > m_interval) m_duration = m_interval;
+  return *this;
+}
+
+RandomPushDisturbance& RandomPushDisturbance::set_duration(double t_duration) {
+  if (t_duration < 0 || t_duration > m_interval) {
+    ZRUNWARN("Duration of pushes must be within [0, %f]. (given: %f)",
+             m_interval, t_duration);
+    return *this;
+  }
+  m_duration = t_duration;
+  return *this;
+}
+
+RandomPushDisturbance& RandomPushDisturbance::set_max_force(
+    double t_max_force) {
+  m_max_force = t_max_force;
+  return *this;
+}
+
+Vec3D RandomPushDisturbance::force(double t_time) const {
+  double t = t_time - m_start_time;
+  if (t < 0) return kVec3DZero;
+  double window = std::floor(t / m_interval);
+  Philox4x32 rng(m_seed, std::uint64_t(window));
+  double onset =
+      window * m_interval + rng.uniform() * (m_interval - m_duration);
+  if (t < onset || t >= onset + m_duration) return kVec3DZero;
+  double angle = zPIx2 * rng.uniform();
+  double magnitude = m_max_force * rng.uniform();
+  return Vec3D(magnitude * std::cos(angle), magnitude * std::sin(angle), 0);
+}
+
+}  // namespace holon
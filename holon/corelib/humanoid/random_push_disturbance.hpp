@@ -0,0 +1,78 @@
+/* random_push_disturbance - reproducible random pushes as external force
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_HUMANOID_RANDOM_PUSH_DISTURBANCE_HPP_
+#define HOLON_HUMANOID_RANDOM_PUSH_DISTURBANCE_HPP_
+
+#include <cstdint>
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+// Random horizontal pushes to be given as external force to a model.
+// Time is divided into windows of a fixed interval, and a push lasting for
+// a fixed duration starts at a random time in every window with random
+// direction and magnitude. Each push is drawn from a substream of a
+// counter-based generator identified by the index of its window, so that
+// the force at any time is computed in O(1) without internal states, and
+// is identical however many simulations run in parallel.
+class RandomPushDisturbance {
+  using Self = RandomPushDisturbance;
+
+ public:
+  static constexpr double default_interval = 2.0;
+  static constexpr double default_duration = 0.1;
+  static constexpr double default_max_force = 1.0;
+
+ public:
+  explicit RandomPushDisturbance(std::uint64_t t_seed = 0);
+
+  // accessors
+  inline std::uint64_t seed() const noexcept { return m_seed; }
+  inline double start_time() const noexcept { return m_start_time; }
+  inline double interval() const noexcept { return m_interval; }
+  inline double duration() const noexcept { return m_duration; }
+  inline double max_force() const noexcept { return m_max_force; }
+
+  // mutators
+  Self& set_seed(std::uint64_t t_seed);
+  Self& set_start_time(double t_start_time);
+  Self& set_interval(double t_interval);
+  Self& set_duration(double t_duration);
+  Self& set_max_force(double t_max_force);
+
+  Vec3D force(double t_time) const;
+  // callback for ComZmpModel::setExternalForceCallback
+  inline Vec3D operator()(const Vec3D&, const Vec3D&,
+                          const double t_time) const {
+    return force(t_time);
+  }
+
+ private:
+  std::uint64_t m_seed;
+  double m_start_time;
+  double m_interval;
+  double m_duration;
+  double m_max_force;
+};
+
+}  // namespace holon
+
+#endif  // HOLON_HUMANOID_RANDOM_PUSH_DISTURBANCE_HPP_
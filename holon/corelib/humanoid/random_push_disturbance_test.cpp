@@ -0,0 +1,90 @@
+/* random_push_disturbance - reproducible random pushes as external force
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/humanoid/random_push_disturbance.hpp"
+
+#include <cmath>
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("RandomPushDisturbance: constructor", "[RandomPushDisturbance]") {
+  RandomPushDisturbance disturbance(3);
+  CHECK(disturbance.seed() == 3);
+  CHECK(disturbance.start_time() == 0);
+  CHECK(disturbance.interval() == RandomPushDisturbance::default_interval);
+  CHECK(disturbance.duration() == RandomPushDisturbance::default_duration);
+  CHECK(disturbance.max_force() == RandomPushDisturbance::default_max_force);
+}
+
+TEST_CASE("RandomPushDisturbance: one push for each interval",
+          "[RandomPushDisturbance]") {
+  RandomPushDisturbance disturbance(7);
+  disturbance.set_start_time(1).set_interval(1).set_duration(0.1);
+  disturbance.set_max_force(2);
+  const double dt = 0.001;
+  int count = 0;
+  bool pushed = false;
+  for (int i = 0; i < 11000; ++i) {
+    double t = i * dt;
+    Vec3D f = disturbance.force(t);
+    if (t < 1) REQUIRE(f == kVec3DZero);
+    REQUIRE(f.z() == 0);
+    REQUIRE(std::sqrt(f.dot(f)) <= 2);
+    if (f != kVec3DZero) {
+      if (!pushed) ++count;
+      pushed = true;
+    } else {
+      pushed = false;
+    }
+  }
+  CHECK(count == 10);
+}
+
+TEST_CASE("RandomPushDisturbance: reproducible with the same seed",
+          "[RandomPushDisturbance]") {
+  RandomPushDisturbance d1(5), d2(5), d3(6);
+  bool differ = false;
+  for (int i = 0; i < 10000; ++i) {
+    double t = 0.001 * i;
+    REQUIRE(d1.force(t) == d2.force(t));
+    if (d1.force(t) != d3.force(t)) differ = true;
+  }
+  CHECK(differ);
+  // the force does not depend on the order of evaluation
+  CHECK(d1.force(7.5) == RandomPushDisturbance(5).force(7.5));
+}
+
+TEST_CASE("RandomPushDisturbance: usable as external force of ComZmpModel",
+          "[RandomPushDisturbance][ComZmpModel]") {
+  ComZmpModel model;
+  model.reset(Vec3D(0, 0, 1));
+  model.setZmpPosition(Vec3D(0, 0, 0));
+  model.setExternalForceCallback(
+      RandomPushDisturbance(1).set_interval(0.5).set_max_force(10));
+  while (model.time() < 2) model.update();
+  CHECK(model.states().com_position.x() != 0);
+}
+
+}  // namespace
+}  // namespace holon
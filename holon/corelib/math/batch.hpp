@@ -0,0 +1,175 @@
+/* batch - fixed-size batch of scalars with element-wise arithmetic
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_BATCH_HPP_
+#define HOLON_MATH_BATCH_HPP_
+
+#include <cstddef>
+#include <iostream>
+
+namespace holon {
+
+// Batch holds N independent scalars in a contiguous array and applies every
+// arithmetic operation element by element, so that a system templated on
+// State processes N scalar systems at once in structure-of-arrays layout.
+// Each element goes through exactly the same operations as a scalar does.
+template <std::size_t N, typename T = double>
+class Batch {
+  static_assert(N > 0, "Batch must have at least one element.");
+
+  using Self = Batch<N, T>;
+
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+ public:
+  // constructors
+  Batch() : m_v() {}
+  explicit Batch(const T& t_v) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] = t_v;
+  }
+
+  // array subscript operators
+  inline T& operator[](std::size_t idx) { return m_v[idx]; }
+  inline const T& operator[](std::size_t idx) const { return m_v[idx]; }
+
+  // member functions
+  inline constexpr std::size_t size() const noexcept { return N; }
+  inline T* data() noexcept { return m_v; }
+  inline const T* data() const noexcept { return m_v; }
+
+  // compound assignment operators
+  Self& operator+=(const Self& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] += rhs.m_v[i];
+    return *this;
+  }
+  Self& operator-=(const Self& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] -= rhs.m_v[i];
+    return *this;
+  }
+  Self& operator*=(const Self& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] *= rhs.m_v[i];
+    return *this;
+  }
+  Self& operator/=(const Self& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] /= rhs.m_v[i];
+    return *this;
+  }
+  Self& operator+=(const T& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] += rhs;
+    return *this;
+  }
+  Self& operator-=(const T& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] -= rhs;
+    return *this;
+  }
+  Self& operator*=(const T& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] *= rhs;
+    return *this;
+  }
+  Self& operator/=(const T& rhs) {
+    for (std::size_t i = 0; i < N; ++i) m_v[i] /= rhs;
+    return *this;
+  }
+
+  // arithmetic unary operators
+  inline Self operator+() const { return *this; }
+  Self operator-() const {
+    Self res;
+    for (std::size_t i = 0; i < N; ++i) res.m_v[i] = -m_v[i];
+    return res;
+  }
+
+  // relational operators
+  bool operator==(const Self& rhs) const {
+    for (std::size_t i = 0; i < N; ++i)
+      if (m_v[i] != rhs.m_v[i]) return false;
+    return true;
+  }
+  inline bool operator!=(const Self& rhs) const { return !(*this == rhs); }
+
+  // iterators
+  inline iterator begin() noexcept { return m_v; }
+  inline iterator end() noexcept { return m_v + N; }
+  inline const_iterator begin() const noexcept { return m_v; }
+  inline const_iterator end() const noexcept { return m_v + N; }
+
+ private:
+  T m_v[N];
+};
+
+// non-member arithmetic operators
+template <std::size_t N, typename T>
+inline Batch<N, T> operator+(Batch<N, T> lhs, const Batch<N, T>& rhs) {
+  return lhs += rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator-(Batch<N, T> lhs, const Batch<N, T>& rhs) {
+  return lhs -= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator*(Batch<N, T> lhs, const Batch<N, T>& rhs) {
+  return lhs *= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator/(Batch<N, T> lhs, const Batch<N, T>& rhs) {
+  return lhs /= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator+(Batch<N, T> lhs,
+                             const typename Batch<N, T>::value_type& rhs) {
+  return lhs += rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator-(Batch<N, T> lhs,
+                             const typename Batch<N, T>::value_type& rhs) {
+  return lhs -= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator*(Batch<N, T> lhs,
+                             const typename Batch<N, T>::value_type& rhs) {
+  return lhs *= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator/(Batch<N, T> lhs,
+                             const typename Batch<N, T>::value_type& rhs) {
+  return lhs /= rhs;
+}
+template <std::size_t N, typename T>
+inline Batch<N, T> operator*(const typename Batch<N, T>::value_type& lhs,
+                             Batch<N, T> rhs) {
+  for (auto& v : rhs) v = lhs * v;
+  return rhs;
+}
+
+// stream insertion
+template <std::size_t N, typename T>
+std::ostream& operator<<(std::ostream& os, const Batch<N, T>& v) {
+  os << "( ";
+  for (std::size_t i = 0; i < N; ++i) os << v[i] << (i + 1 < N ? ", " : " ");
+  os << ")";
+  return os;
+}
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_BATCH_HPP_
@@ -0,0 +1,83 @@
+/* batch - fixed-size batch of scalars with element-wise arithmetic
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/batch.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Batch4 = Batch<4>;
+
+Batch4 RandomBatch(Fuzzer& fuzz) {
+  Batch4 v;
+  for (auto& e : v) e = fuzz();
+  return v;
+}
+
+TEST_CASE("Batch: constructor", "[Batch][ctor]") {
+  SECTION("default constructor") {
+    Batch4 v;
+    CHECK(v.size() == 4);
+    for (auto e : v) CHECK(e == 0);
+  }
+  SECTION("fill constructor") {
+    double a = Fuzzer().get<double>();
+    Batch4 v(a);
+    for (auto e : v) CHECK(e == a);
+  }
+}
+
+TEST_CASE("Batch: arithmetic operators are applied element-wise",
+          "[Batch]") {
+  Fuzzer fuzz(1, 10);
+  Batch4 a = RandomBatch(fuzz), b = RandomBatch(fuzz);
+  double k = fuzz();
+
+  Batch4 add = a + b, sub = a - b, mul = a * b, div = a / b;
+  Batch4 adds = a + k, subs = a - k, muls = a * k, smul = k * a, divs = a / k;
+  Batch4 neg = -a;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    CHECK(add[i] == a[i] + b[i]);
+    CHECK(sub[i] == a[i] - b[i]);
+    CHECK(mul[i] == a[i] * b[i]);
+    CHECK(div[i] == a[i] / b[i]);
+    CHECK(adds[i] == a[i] + k);
+    CHECK(subs[i] == a[i] - k);
+    CHECK(muls[i] == a[i] * k);
+    CHECK(smul[i] == k * a[i]);
+    CHECK(divs[i] == a[i] / k);
+    CHECK(neg[i] == -a[i]);
+  }
+}
+
+TEST_CASE("Batch: relational operators", "[Batch]") {
+  Fuzzer fuzz;
+  Batch4 a = RandomBatch(fuzz);
+  Batch4 b = a;
+  CHECK(a == b);
+  b[3] += 1;
+  CHECK(a != b);
+}
+
+}  // namespace
+}  // namespace holon
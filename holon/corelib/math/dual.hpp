@@ -0,0 +1,235 @@
+/* dual - dual number for forward-mode automatic differentiation
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_DUAL_HPP_
+#define HOLON_MATH_DUAL_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+namespace holon {
+namespace dual {
+
+// Dual number carrying a value and its partial derivatives with respect to
+// N independent variables. The derivative lanes are stored contiguously and
+// every operation updates them with a plain element-wise loop, so that the
+// compiler packs them into SIMD registers.
+template <std::size_t N, typename T = double>
+class Dual {
+  static_assert(N > 0, "Dual must have at least one derivative lane.");
+
+  using Self = Dual<N, T>;
+
+ public:
+  static constexpr std::size_t size = N;
+  using value_type = T;
+
+ public:
+  // constructors
+  Dual() : m_value(0), m_grad() {}
+  Dual(const T& t_value) : m_value(t_value), m_grad() {}  // NOLINT
+  Dual(const T& t_value, std::size_t t_index) : Dual(t_value) {
+    m_grad[t_index] = T(1);
+  }
+
+  // accessors
+  inline const T& value() const noexcept { return m_value; }
+  inline const T& grad(std::size_t t_index) const noexcept {
+    return m_grad[t_index];
+  }
+  inline const T* grad() const noexcept { return m_grad; }
+
+  // mutators
+  Self& set_value(const T& t_value) {
+    m_value = t_value;
+    return *this;
+  }
+  Self& set_grad(std::size_t t_index, const T& t_grad) {
+    m_grad[t_index] = t_grad;
+    return *this;
+  }
+
+  // compound assignment operators
+  Self& operator+=(const Self& rhs) {
+    m_value += rhs.m_value;
+    for (std::size_t i = 0; i < N; ++i) m_grad[i] += rhs.m_grad[i];
+    return *this;
+  }
+  Self& operator-=(const Self& rhs) {
+    m_value -= rhs.m_value;
+    for (std::size_t i = 0; i < N; ++i) m_grad[i] -= rhs.m_grad[i];
+    return *this;
+  }
+  Self& operator*=(const Self& rhs) {
+    for (std::size_t i = 0; i < N; ++i)
+      m_grad[i] = m_grad[i] * rhs.m_value + m_value * rhs.m_grad[i];
+    m_value *= rhs.m_value;
+    return *this;
+  }
+  Self& operator/=(const Self& rhs) {
+    T inv = T(1) / rhs.m_value;
+    m_value *= inv;
+    for (std::size_t i = 0; i < N; ++i)
+      m_grad[i] = (m_grad[i] - m_value * rhs.m_grad[i]) * inv;
+    return *this;
+  }
+  Self& operator+=(const T& rhs) {
+    m_value += rhs;
+    return *this;
+  }
+  Self& operator-=(const T& rhs) {
+    m_value -= rhs;
+    return *this;
+  }
+  Self& operator*=(const T& rhs) {
+    m_value *= rhs;
+    for (std::size_t i = 0; i < N; ++i) m_grad[i] *= rhs;
+    return *this;
+  }
+  Self& operator/=(const T& rhs) { return *this *= T(1) / rhs; }
+
+  // arithmetic unary operators
+  inline Self operator+() const { return *this; }
+  inline Self operator-() const { return Self() -= *this; }
+
+  // apply chain rule with a value f(x) and its derivative f'(x)
+  Self chain(const T& t_value, const T& t_deriv) const {
+    Self res(t_value);
+    for (std::size_t i = 0; i < N; ++i) res.m_grad[i] = t_deriv * m_grad[i];
+    return res;
+  }
+
+ private:
+  T m_value;
+  T m_grad[N];
+};
+
+template <std::size_t N, typename T>
+constexpr std::size_t Dual<N, T>::size;
+
+// non-member functions
+template <std::size_t N, typename T = double>
+Dual<N, T> make_dual(const T& t_value, std::size_t t_index) {
+  return Dual<N, T>(t_value, t_index);
+}
+
+// non-member arithmetic operators
+// (scalar operands are not deduced so that e.g. integer literals are accepted)
+#define HOLON_DUAL_BINARY_OPERATOR(op)                                        \
+  template <std::size_t N, typename T>                                        \
+  inline Dual<N, T> operator op(Dual<N, T> lhs, const Dual<N, T>& rhs) {      \
+    return lhs op##= rhs;                                                     \
+  }                                                                           \
+  template <std::size_t N, typename T>                                        \
+  inline Dual<N, T> operator op(Dual<N, T> lhs,                               \
+                                const typename Dual<N, T>::value_type& rhs) { \
+    return lhs op##= rhs;                                                     \
+  }                                                                           \
+  template <std::size_t N, typename T>                                        \
+  inline Dual<N, T> operator op(const typename Dual<N, T>::value_type& lhs,   \
+                                const Dual<N, T>& rhs) {                      \
+    return Dual<N, T>(lhs) op##= rhs;                                         \
+  }
+HOLON_DUAL_BINARY_OPERATOR(+)
+HOLON_DUAL_BINARY_OPERATOR(-)
+HOLON_DUAL_BINARY_OPERATOR(*)
+HOLON_DUAL_BINARY_OPERATOR(/)
+#undef HOLON_DUAL_BINARY_OPERATOR
+
+// relational operators compare values only
+#define HOLON_DUAL_RELATIONAL_OPERATOR(op)                                    \
+  template <std::size_t N, typename T>                                        \
+  inline bool operator op(const Dual<N, T>& lhs, const Dual<N, T>& rhs) {     \
+    return lhs.value() op rhs.value();                                        \
+  }                                                                           \
+  template <std::size_t N, typename T>                                        \
+  inline bool operator op(const Dual<N, T>& lhs,                              \
+                          const typename Dual<N, T>::value_type& rhs) {       \
+    return lhs.value() op rhs;                                                \
+  }                                                                           \
+  template <std::size_t N, typename T>                                        \
+  inline bool operator op(const typename Dual<N, T>::value_type& lhs,         \
+                          const Dual<N, T>& rhs) {                            \
+    return lhs op rhs.value();                                                \
+  }
+HOLON_DUAL_RELATIONAL_OPERATOR(==)
+HOLON_DUAL_RELATIONAL_OPERATOR(!=)
+HOLON_DUAL_RELATIONAL_OPERATOR(<)
+HOLON_DUAL_RELATIONAL_OPERATOR(>)
+HOLON_DUAL_RELATIONAL_OPERATOR(<=)
+HOLON_DUAL_RELATIONAL_OPERATOR(>=)
+#undef HOLON_DUAL_RELATIONAL_OPERATOR
+
+// elementary functions
+template <std::size_t N, typename T>
+Dual<N, T> sqrt(const Dual<N, T>& x) {
+  T v = std::sqrt(x.value());
+  return x.chain(v, T(0.5) / v);
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> exp(const Dual<N, T>& x) {
+  T v = std::exp(x.value());
+  return x.chain(v, v);
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> log(const Dual<N, T>& x) {
+  return x.chain(std::log(x.value()), T(1) / x.value());
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> sin(const Dual<N, T>& x) {
+  return x.chain(std::sin(x.value()), std::cos(x.value()));
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> cos(const Dual<N, T>& x) {
+  return x.chain(std::cos(x.value()), -std::sin(x.value()));
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> fabs(const Dual<N, T>& x) {
+  return x.value() < T(0) ? -x : x;
+}
+
+template <std::size_t N, typename T>
+Dual<N, T> abs(const Dual<N, T>& x) {
+  return fabs(x);
+}
+
+// stream insertion
+template <std::size_t N, typename T>
+std::ostream& operator<<(std::ostream& os, const Dual<N, T>& x) {
+  os << x.value() << " [ ";
+  for (std::size_t i = 0; i < N; ++i) os << x.grad(i) << " ";
+  os << "]";
+  return os;
+}
+
+}  // namespace dual
+
+using dual::Dual;
+using dual::make_dual;
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_DUAL_HPP_
@@ -0,0 +1,138 @@
+/* dual - dual number for forward-mode automatic differentiation
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/dual.hpp"
+
+#include <array>
+#include <cmath>
+#include "holon/corelib/math/ode_runge_kutta4.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+using Dual2 = Dual<2>;
+
+TEST_CASE("Dual: constructor", "[Dual][ctor]") {
+  SECTION("default constructor") {
+    Dual2 x;
+    CHECK(x.value() == 0);
+    CHECK(x.grad(0) == 0);
+    CHECK(x.grad(1) == 0);
+  }
+  SECTION("constant") {
+    Dual2 x(1.5);
+    CHECK(x.value() == 1.5);
+    CHECK(x.grad(0) == 0);
+    CHECK(x.grad(1) == 0);
+  }
+  SECTION("independent variable") {
+    auto x = make_dual<2>(1.5, 1);
+    CHECK(x.value() == 1.5);
+    CHECK(x.grad(0) == 0);
+    CHECK(x.grad(1) == 1);
+  }
+}
+
+TEST_CASE("Dual: arithmetic operators", "[Dual]") {
+  Fuzzer fuzz(1, 10);
+  double a = fuzz(), b = fuzz(), k = fuzz();
+  auto x = make_dual<2>(a, 0);
+  auto y = make_dual<2>(b, 1);
+
+  SECTION("addition") {
+    auto z = x + y + k;
+    CHECK(z.value() == Approx(a + b + k));
+    CHECK(z.grad(0) == 1);
+    CHECK(z.grad(1) == 1);
+  }
+  SECTION("subtraction") {
+    auto z = k - x - y;
+    CHECK(z.value() == Approx(k - a - b));
+    CHECK(z.grad(0) == -1);
+    CHECK(z.grad(1) == -1);
+  }
+  SECTION("multiplication") {
+    auto z = k * x * y;
+    CHECK(z.value() == Approx(k * a * b));
+    CHECK(z.grad(0) == Approx(k * b));
+    CHECK(z.grad(1) == Approx(k * a));
+  }
+  SECTION("division") {
+    auto z = x / y / k;
+    CHECK(z.value() == Approx(a / b / k));
+    CHECK(z.grad(0) == Approx(1 / (b * k)));
+    CHECK(z.grad(1) == Approx(-a / (b * b * k)));
+    auto w = k / x;
+    CHECK(w.value() == Approx(k / a));
+    CHECK(w.grad(0) == Approx(-k / (a * a)));
+    CHECK(w.grad(1) == 0);
+  }
+  SECTION("unary minus") {
+    auto z = -x;
+    CHECK(z.value() == -a);
+    CHECK(z.grad(0) == -1);
+    CHECK(z.grad(1) == 0);
+  }
+  SECTION("relational operators compare values") {
+    CHECK((x < a + 1));
+    CHECK((x == a));
+    CHECK((x != y) == (a != b));
+  }
+}
+
+TEST_CASE("Dual: elementary functions", "[Dual]") {
+  Fuzzer fuzz(0.1, 2);
+  double a = fuzz();
+  auto x = make_dual<1>(a, 0);
+
+  CHECK(sqrt(x).grad(0) == Approx(0.5 / std::sqrt(a)));
+  CHECK(exp(x).grad(0) == Approx(std::exp(a)));
+  CHECK(log(x).grad(0) == Approx(1 / a));
+  CHECK(sin(x).grad(0) == Approx(std::cos(a)));
+  CHECK(cos(x).grad(0) == Approx(-std::sin(a)));
+  CHECK(fabs(-x).grad(0) == Approx(1));
+}
+
+template <typename T>
+struct decay_sys {
+  T k;
+  std::array<T, 1> operator()(const std::array<T, 1>& x, const double) const {
+    return std::array<T, 1>{{-k * x[0]}};
+  }
+};
+
+TEST_CASE("Dual: sensitivity through Runge-Kutta method", "[Dual][ode]") {
+  // dx/dt = -k x, x(t) = x0 exp(-k t), dx/dk = -t x(t)
+  const double k = 2, x0 = 1.5, dt = 0.001, T = 1;
+  RungeKutta4<std::array<Dual<1>, 1>> solver;
+  std::array<Dual<1>, 1> x{{Dual<1>(x0)}};
+  decay_sys<Dual<1>> sys{make_dual<1>(k, 0)};
+  double t = 0;
+  for (; t < T - 0.5 * dt; t += dt) x = solver.update(sys, x, t, dt);
+
+  CHECK(x[0].value() == Approx(x0 * std::exp(-k * t)));
+  CHECK(x[0].grad(0) == Approx(-t * x0 * std::exp(-k * t)));
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,206 @@
+/* matrix - fixed-size matrix for small linear algebra
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_MATRIX_HPP_
+#define HOLON_MATH_MATRIX_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+
+namespace holon {
+
+// Matrix holds R x C elements in a row-major array sized at compile time,
+// so that small filters and observers run without heap allocation. Only
+// the operations needed for such algorithms are provided.
+template <std::size_t R, std::size_t C, typename T = double>
+class Matrix {
+  static_assert(R > 0 && C > 0, "Matrix must not be empty.");
+
+  using Self = Matrix<R, C, T>;
+
+ public:
+  using value_type = T;
+  static constexpr std::size_t rows = R;
+  static constexpr std::size_t cols = C;
+
+ public:
+  // constructors
+  Matrix() : m_e() {}
+  Matrix(std::initializer_list<T> t_list) : m_e() {
+    std::size_t i = 0;
+    for (auto it = t_list.begin(); it != t_list.end() && i < R * C; ++it)
+      m_e[i++] = *it;
+  }
+  static Self zero() { return Self(); }
+  static Self identity() {
+    static_assert(R == C, "Identity must be square.");
+    Self m;
+    for (std::size_t i = 0; i < R; ++i) m(i, i) = T(1);
+    return m;
+  }
+
+  // element accessors
+  inline T& operator()(std::size_t i, std::size_t j) { return m_e[i * C + j]; }
+  inline const T& operator()(std::size_t i, std::size_t j) const {
+    return m_e[i * C + j];
+  }
+  inline T& operator[](std::size_t idx) { return m_e[idx]; }
+  inline const T& operator[](std::size_t idx) const { return m_e[idx]; }
+  inline T* data() noexcept { return m_e; }
+  inline const T* data() const noexcept { return m_e; }
+
+  // compound assignment operators
+  Self& operator+=(const Self& rhs) {
+    for (std::size_t i = 0; i < R * C; ++i) m_e[i] += rhs.m_e[i];
+    return *this;
+  }
+  Self& operator-=(const Self& rhs) {
+    for (std::size_t i = 0; i < R * C; ++i) m_e[i] -= rhs.m_e[i];
+    return *this;
+  }
+  Self& operator*=(const T& rhs) {
+    for (std::size_t i = 0; i < R * C; ++i) m_e[i] *= rhs;
+    return *this;
+  }
+
+  // arithmetic unary operators
+  inline Self operator+() const { return *this; }
+  inline Self operator-() const { return Self() -= *this; }
+
+  Matrix<C, R, T> transpose() const {
+    Matrix<C, R, T> m;
+    for (std::size_t i = 0; i < R; ++i)
+      for (std::size_t j = 0; j < C; ++j) m(j, i) = (*this)(i, j);
+    return m;
+  }
+  // (A + A^T) / 2 to wipe out asymmetry accumulated by rounding errors
+  Self symmetrize() const {
+    static_assert(R == C, "Only square matrix can be symmetrized.");
+    Self m;
+    for (std::size_t i = 0; i < R; ++i)
+      for (std::size_t j = 0; j < C; ++j)
+        m(i, j) = T(0.5) * ((*this)(i, j) + (*this)(j, i));
+    return m;
+  }
+
+  // relational operators
+  bool operator==(const Self& rhs) const {
+    for (std::size_t i = 0; i < R * C; ++i)
+      if (m_e[i] != rhs.m_e[i]) return false;
+    return true;
+  }
+  inline bool operator!=(const Self& rhs) const { return !(*this == rhs); }
+
+ private:
+  T m_e[R * C];
+};
+
+template <std::size_t R, std::size_t C, typename T>
+constexpr std::size_t Matrix<R, C, T>::rows;
+template <std::size_t R, std::size_t C, typename T>
+constexpr std::size_t Matrix<R, C, T>::cols;
+
+template <std::size_t N, typename T = double>
+using ColumnVector = Matrix<N, 1, T>;
+
+// non-member arithmetic operators
+template <std::size_t R, std::size_t C, typename T>
+inline Matrix<R, C, T> operator+(Matrix<R, C, T> lhs,
+                                 const Matrix<R, C, T>& rhs) {
+  return lhs += rhs;
+}
+template <std::size_t R, std::size_t C, typename T>
+inline Matrix<R, C, T> operator-(Matrix<R, C, T> lhs,
+                                 const Matrix<R, C, T>& rhs) {
+  return lhs -= rhs;
+}
+template <std::size_t R, std::size_t C, typename T>
+inline Matrix<R, C, T> operator*(
+    Matrix<R, C, T> lhs, const typename Matrix<R, C, T>::value_type& rhs) {
+  return lhs *= rhs;
+}
+template <std::size_t R, std::size_t C, typename T>
+inline Matrix<R, C, T> operator*(
+    const typename Matrix<R, C, T>::value_type& lhs, Matrix<R, C, T> rhs) {
+  return rhs *= lhs;
+}
+template <std::size_t R, std::size_t K, std::size_t C, typename T>
+Matrix<R, C, T> operator*(const Matrix<R, K, T>& lhs,
+                          const Matrix<K, C, T>& rhs) {
+  Matrix<R, C, T> m;
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t k = 0; k < K; ++k)
+      for (std::size_t j = 0; j < C; ++j) m(i, j) += lhs(i, k) * rhs(k, j);
+  return m;
+}
+
+// inverse of a square matrix by Gauss-Jordan elimination with partial
+// pivoting; returns false and leaves t_inv untouched if it is singular
+template <std::size_t N, typename T>
+bool inverse(const Matrix<N, N, T>& t_m, Matrix<N, N, T>* t_inv) {
+  Matrix<N, N, T> a = t_m;
+  Matrix<N, N, T> b = Matrix<N, N, T>::identity();
+  for (std::size_t c = 0; c < N; ++c) {
+    std::size_t p = c;
+    for (std::size_t i = c + 1; i < N; ++i)
+      if (std::fabs(a(i, c)) > std::fabs(a(p, c))) p = i;
+    if (a(p, c) == T(0)) return false;
+    if (p != c) {
+      for (std::size_t j = 0; j < N; ++j) {
+        std::swap(a(p, j), a(c, j));
+        std::swap(b(p, j), b(c, j));
+      }
+    }
+    T inv = T(1) / a(c, c);
+    for (std::size_t j = 0; j < N; ++j) {
+      a(c, j) *= inv;
+      b(c, j) *= inv;
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      if (i == c) continue;
+      T f = a(i, c);
+      if (f == T(0)) continue;
+      for (std::size_t j = 0; j < N; ++j) {
+        a(i, j) -= f * a(c, j);
+        b(i, j) -= f * b(c, j);
+      }
+    }
+  }
+  *t_inv = b;
+  return true;
+}
+
+// stream insertion
+template <std::size_t R, std::size_t C, typename T>
+std::ostream& operator<<(std::ostream& os, const Matrix<R, C, T>& m) {
+  for (std::size_t i = 0; i < R; ++i) {
+    os << (i == 0 ? "[ " : "  ");
+    for (std::size_t j = 0; j < C; ++j) os << m(i, j) << " ";
+    os << (i + 1 < R ? "\n" : "]");
+  }
+  return os;
+}
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_MATRIX_HPP_
@@ -0,0 +1,101 @@
+/* matrix - fixed-size matrix for small linear algebra
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/matrix.hpp"
+
+#include "catch.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("Matrix: constructor", "[Matrix][ctor]") {
+  SECTION("default constructor") {
+    Matrix<2, 3> m;
+    for (std::size_t i = 0; i < 6; ++i) CHECK(m[i] == 0);
+  }
+  SECTION("initializer list in row-major order") {
+    Matrix<2, 3> m{1, 2, 3, 4, 5, 6};
+    CHECK(m(0, 2) == 3);
+    CHECK(m(1, 0) == 4);
+    CHECK(m(1, 2) == 6);
+  }
+  SECTION("identity") {
+    auto m = Matrix<3, 3>::identity();
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j) CHECK(m(i, j) == (i == j ? 1 : 0));
+  }
+}
+
+TEST_CASE("Matrix: arithmetic operators", "[Matrix]") {
+  Fuzzer fuzz;
+  Matrix<2, 3> a, b;
+  for (std::size_t i = 0; i < 6; ++i) a[i] = fuzz(), b[i] = fuzz();
+  double k = fuzz();
+
+  auto c = a + b;
+  auto d = a - b;
+  auto e = k * a;
+  for (std::size_t i = 0; i < 6; ++i) {
+    CHECK(c[i] == a[i] + b[i]);
+    CHECK(d[i] == a[i] - b[i]);
+    CHECK(e[i] == k * a[i]);
+  }
+  CHECK((a * k) == e);
+  CHECK((-a) == (a * -1));
+
+  auto t = a.transpose();
+  for (std::size_t i = 0; i < 2; ++i)
+    for (std::size_t j = 0; j < 3; ++j) CHECK(t(j, i) == a(i, j));
+
+  auto p = a * t;
+  for (std::size_t i = 0; i < 2; ++i)
+    for (std::size_t j = 0; j < 2; ++j)
+      CHECK(p(i, j) == Approx(a(i, 0) * a(j, 0) + a(i, 1) * a(j, 1) +
+                              a(i, 2) * a(j, 2)));
+  CHECK(p.symmetrize() == p);
+}
+
+TEST_CASE("Matrix: inverse", "[Matrix]") {
+  SECTION("regular matrix") {
+    Fuzzer fuzz;
+    Matrix<3, 3> m, inv;
+    for (std::size_t i = 0; i < 9; ++i) m[i] = fuzz();
+    for (std::size_t i = 0; i < 3; ++i) m(i, i) += 40;
+    REQUIRE(inverse(m, &inv));
+    auto id = m * inv;
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        CHECK(id(i, j) == Approx(i == j ? 1 : 0).margin(1e-12));
+  }
+  SECTION("zero pivot needs row exchange") {
+    Matrix<2, 2> m{0, 2, 4, 0}, inv;
+    REQUIRE(inverse(m, &inv));
+    CHECK(inv == (Matrix<2, 2>{0, 0.25, 0.5, 0}));
+  }
+  SECTION("singular matrix") {
+    Matrix<2, 2> m{1, 2, 2, 4}, inv{9, 9, 9, 9};
+    CHECK_FALSE(inverse(m, &inv));
+    CHECK(inv == (Matrix<2, 2>{9, 9, 9, 9}));
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,332 @@
+/* ode_parareal - parallel-in-time integration by Parareal method
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_ODE_PARAREAL_HPP_
+#define HOLON_MATH_ODE_PARAREAL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <zm/zm_misc.h>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "holon/corelib/math/ode_euler.hpp"
+#include "holon/corelib/math/ode_runge_kutta4.hpp"
+#include "holon/corelib/math/ode_solver.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+namespace parareal_detail {
+
+// maximum difference between elements
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, double>::type distance(
+    const T& t_a, const T& t_b) {
+  return std::fabs(t_a - t_b);
+}
+
+inline double distance(const Vec3D& t_a, const Vec3D& t_b) {
+  return std::fmax(std::fabs(t_a[0] - t_b[0]),
+                   std::fmax(std::fabs(t_a[1] - t_b[1]),
+                             std::fabs(t_a[2] - t_b[2])));
+}
+
+template <typename T, std::size_t N>
+double distance(const std::array<T, N>& t_a, const std::array<T, N>& t_b) {
+  double d = 0;
+  for (std::size_t i = 0; i < N; ++i)
+    d = std::fmax(d, distance(t_a[i], t_b[i]));
+  return d;
+}
+
+// correction of the coarse solution with the fine one, g + (f - g_old)
+template <typename State>
+State correct(const State& t_g, const State& t_f, const State& t_g_old) {
+  State out;
+  auto g = t_g.begin();
+  auto f = t_f.begin();
+  auto g_old = t_g_old.begin();
+  for (auto x = out.begin(); x != out.end(); ++x, ++g, ++f, ++g_old)
+    *x = *g + (*f - *g_old);
+  return out;
+}
+
+// Threads which run a job together round after round, where the caller
+// takes part as the worker 0. They are kept during a solve, so that the
+// iterations do not create threads every time.
+class Crew {
+ public:
+  Crew(std::size_t t_thread_num, std::function<void(std::size_t)> t_job)
+      : m_job(std::move(t_job)), m_round(0), m_done(0), m_stop(false) {
+    for (std::size_t i = 1; i < t_thread_num; ++i)
+      m_threads.emplace_back(&Crew::loop, this, i);
+  }
+  ~Crew() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto& thread : m_threads) thread.join();
+  }
+  Crew(const Crew&) = delete;
+  Crew& operator=(const Crew&) = delete;
+
+  // run a round of the job on all the threads and wait for them
+  void run() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      ++m_round;
+      m_done = 0;
+    }
+    m_start.notify_all();
+    m_job(0);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finish.wait(lock, [this] { return m_done == m_threads.size(); });
+  }
+
+ private:
+  std::function<void(std::size_t)> m_job;
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_finish;
+  std::size_t m_round;
+  std::size_t m_done;
+  bool m_stop;
+
+  void loop(std::size_t t_worker) {
+    std::size_t round = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_start.wait(lock, [&] { return m_stop || m_round != round; });
+        if (m_stop) return;
+        round = m_round;
+      }
+      m_job(t_worker);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (++m_done == m_threads.size()) m_finish.notify_one();
+    }
+  }
+};
+
+}  // namespace parareal_detail
+
+// Parareal integrates a system over a long interval by dividing it into
+// time slices. A cheap coarse solver propagates the state over the slices
+// in sequence, and the accurate fine solver integrates every slice from the
+// states at their beginnings in parallel. The coarse propagation is then
+// corrected by the differences between the fine and coarse solutions,
+//   U[n+1] = G(U[n]) + F(U_old[n]) - G(U_old[n]),
+// and repeated until the states at the boundaries of slices change no more
+// than the tolerance. After k iterations the first k slices are identical to
+// those integrated by the fine solver in sequence, so that the result after
+// as many iterations as slices is bit-identical to it. A warning is issued
+// if the iterations run out before either of them.
+//
+// The system is any callable of (state, time) returning the derivative,
+// which is evaluated from several threads at once and so must not modify
+// shared states. State is a fixed-size array of numbers or Vec3D, e.g.
+// std::array<Vec3D, 2> of ModelBase.
+template <typename State, typename Coarse = Euler<State>,
+          typename Fine = RungeKutta4<State>>
+class Parareal : public OdeSolver<Parareal<State, Coarse, Fine>> {
+  static_assert(std::is_base_of<OdeSolver<Coarse>, Coarse>::value,
+                "Coarse must be derived from OdeSolver class.");
+  static_assert(std::is_base_of<OdeSolver<Fine>, Fine>::value,
+                "Fine must be derived from OdeSolver class.");
+
+  using Self = Parareal<State, Coarse, Fine>;
+
+ public:
+  static constexpr std::size_t default_slice_num = 16;
+  static constexpr std::size_t default_coarse_step_num = 1;
+  static constexpr double default_fine_step = 0.001;
+  static constexpr std::size_t default_max_iteration = 16;
+  static constexpr double default_tolerance = 1e-10;
+
+ public:
+  Parareal()
+      : m_slice_num(default_slice_num),
+        m_coarse_step_num(default_coarse_step_num),
+        m_fine_step(default_fine_step),
+        m_max_iteration(default_max_iteration),
+        m_tolerance(default_tolerance),
+        m_thread_num(0),
+        m_iteration(0),
+        m_error(0),
+        m_coarse(),
+        m_fines(),
+        m_states(),
+        m_fine_states(),
+        m_coarse_states() {}
+  virtual ~Parareal() = default;
+
+  // accessors
+  inline std::size_t slice_num() const noexcept { return m_slice_num; }
+  inline std::size_t coarse_step_num() const noexcept {
+    return m_coarse_step_num;
+  }
+  inline double fine_step() const noexcept { return m_fine_step; }
+  inline std::size_t max_iteration() const noexcept { return m_max_iteration; }
+  inline double tolerance() const noexcept { return m_tolerance; }
+  // number of threads, where 0 means the number of hardware threads
+  inline std::size_t thread_num() const noexcept { return m_thread_num; }
+  // number of iterations and the last change of states in the last update
+  inline std::size_t iteration() const noexcept { return m_iteration; }
+  inline double error() const noexcept { return m_error; }
+  // states at the boundaries of the slices in the last update
+  inline const std::vector<State>& slice_states() const noexcept {
+    return m_states;
+  }
+
+  // mutators
+  // (invalid values are replaced with the defaults)
+  Self& set_slice_num(std::size_t t_slice_num) {
+    m_slice_num = t_slice_num > 0 ? t_slice_num : default_slice_num;
+    return *this;
+  }
+  Self& set_coarse_step_num(std::size_t t_coarse_step_num) {
+    m_coarse_step_num =
+        t_coarse_step_num > 0 ? t_coarse_step_num : default_coarse_step_num;
+    return *this;
+  }
+  Self& set_fine_step(double t_fine_step) {
+    m_fine_step = t_fine_step > 0 ? t_fine_step : default_fine_step;
+    return *this;
+  }
+  Self& set_max_iteration(std::size_t t_max_iteration) {
+    m_max_iteration =
+        t_max_iteration > 0 ? t_max_iteration : default_max_iteration;
+    return *this;
+  }
+  Self& set_tolerance(double t_tolerance) {
+    m_tolerance = t_tolerance >= 0 ? t_tolerance : default_tolerance;
+    return *this;
+  }
+  Self& set_thread_num(std::size_t t_thread_num) {
+    m_thread_num = t_thread_num;
+    return *this;
+  }
+
+  template <typename System, typename Time>
+  State update_impl(const System& t_system, const State& t_x, const Time t_t,
+                    const Time t_dt) {
+    const std::size_t n = m_slice_num;
+    const Time slice = t_dt / n;
+    m_states.assign(n + 1, t_x);
+    m_fine_states.resize(n);
+    m_coarse_states.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      m_coarse_states[i] = propagate(&m_coarse, t_system, m_states[i],
+                                     t_t + i * slice, slice, m_coarse_step_num);
+      m_states[i + 1] = m_coarse_states[i];
+    }
+    const std::size_t step_num =
+        std::max<std::size_t>(1, std::ceil(slice / m_fine_step - 1e-9));
+    std::size_t thread_num =
+        m_thread_num > 0 ? m_thread_num : std::thread::hardware_concurrency();
+    thread_num = std::max<std::size_t>(1, std::min(thread_num, n));
+    m_fines.resize(std::max(m_fines.size(), thread_num));
+    // every thread takes the next fine slice from the first unsolved one
+    std::atomic<std::size_t> next(0);
+    parareal_detail::Crew crew(thread_num, [&](std::size_t t_worker) {
+      for (std::size_t i; (i = next++) < n;)
+        m_fine_states[i] = propagate(&m_fines[t_worker], t_system, m_states[i],
+                                     t_t + i * slice, slice, step_num);
+    });
+
+    m_error = 0;
+    for (m_iteration = 0; m_iteration < std::min(m_max_iteration, n);) {
+      next = m_iteration;
+      crew.run();
+      // the slices up to the current iteration start from exact states
+      m_error = 0;
+      for (std::size_t i = m_iteration; i < n; ++i) {
+        State g = i == m_iteration
+                      ? m_coarse_states[i]
+                      : propagate(&m_coarse, t_system, m_states[i],
+                                  t_t + i * slice, slice, m_coarse_step_num);
+        State x = i == m_iteration ? m_fine_states[i]
+                                   : parareal_detail::correct(
+                                         g, m_fine_states[i],
+                                         m_coarse_states[i]);
+        m_error = std::fmax(m_error,
+                            parareal_detail::distance(x, m_states[i + 1]));
+        m_coarse_states[i] = g;
+        m_states[i + 1] = x;
+      }
+      ++m_iteration;
+      if (m_error <= m_tolerance) break;
+    }
+    if (m_error > m_tolerance && m_iteration < n)
+      ZRUNWARN("Parareal did not converge in %lu iterations (error: %g)",
+               static_cast<unsigned long>(m_iteration), m_error);
+    return m_states[n];
+  }
+
+ private:
+  std::size_t m_slice_num;
+  std::size_t m_coarse_step_num;
+  double m_fine_step;
+  std::size_t m_max_iteration;
+  double m_tolerance;
+  std::size_t m_thread_num;
+  std::size_t m_iteration;
+  double m_error;
+  Coarse m_coarse;
+  std::vector<Fine> m_fines;
+  std::vector<State> m_states;
+  std::vector<State> m_fine_states;
+  std::vector<State> m_coarse_states;
+
+  template <typename Solver, typename System, typename Time>
+  static State propagate(Solver* t_solver, const System& t_system, State t_x,
+                         Time t_t, Time t_slice, std::size_t t_step_num) {
+    const Time dt = t_slice / t_step_num;
+    for (std::size_t i = 0; i < t_step_num; ++i)
+      t_x = t_solver->update(t_system, t_x, t_t + i * dt, dt);
+    return t_x;
+  }
+};
+
+template <typename State, typename Coarse, typename Fine>
+constexpr std::size_t Parareal<State, Coarse, Fine>::default_slice_num;
+template <typename State, typename Coarse, typename Fine>
+constexpr std::size_t Parareal<State, Coarse, Fine>::default_coarse_step_num;
+template <typename State, typename Coarse, typename Fine>
+constexpr double Parareal<State, Coarse, Fine>::default_fine_step;
+template <typename State, typename Coarse, typename Fine>
+constexpr std::size_t Parareal<State, Coarse, Fine>::default_max_iteration;
+template <typename State, typename Coarse, typename Fine>
+constexpr double Parareal<State, Coarse, Fine>::default_tolerance;
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_ODE_PARAREAL_HPP_
@@ -0,0 +1,155 @@
+/* ode_parareal - parallel-in-time integration by Parareal method
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/ode_parareal.hpp"
+
+#include <zm/zm_misc.h>
+#include <array>
+#include <cmath>
+#include "holon/corelib/math/vec3d.hpp"
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+using State = std::array<Vec3D, 2>;
+
+// linear inverted pendulum on a fixed ZMP, x'' = zeta^2 (x - p)
+struct lipm_sys {
+  double zeta2;
+  Vec3D zmp;
+  State operator()(const State& x, const double) const {
+    return State{{x[1], (x[0] - zmp) * zeta2}};
+  }
+};
+
+// damped oscillator
+struct oscillator_sys {
+  std::array<double, 2> operator()(const std::array<double, 2>& x,
+                                   const double t) const {
+    return std::array<double, 2>{{x[1], -x[0] - 0.2 * x[1] + std::sin(t)}};
+  }
+};
+
+template <typename Solver, typename System, typename S>
+S integrate(Solver* solver, const System& sys, S x, double t0, double slice,
+            std::size_t slice_num, std::size_t step_num) {
+  for (std::size_t i = 0; i < slice_num; ++i) {
+    double dt = slice / step_num;
+    for (std::size_t j = 0; j < step_num; ++j)
+      x = solver->update(sys, x, t0 + i * slice + j * dt, dt);
+  }
+  return x;
+}
+
+TEST_CASE("Parareal: default parameters", "[ode][Parareal]") {
+  Parareal<State> solver;
+  CHECK(solver.slice_num() == Parareal<State>::default_slice_num);
+  CHECK(solver.coarse_step_num() == 1);
+  CHECK(solver.fine_step() == Parareal<State>::default_fine_step);
+  CHECK(solver.max_iteration() == Parareal<State>::default_max_iteration);
+  CHECK(solver.tolerance() == Parareal<State>::default_tolerance);
+  CHECK(solver.thread_num() == 0);
+  CHECK(solver.iteration() == 0);
+
+  solver.set_slice_num(0).set_fine_step(-1).set_max_iteration(0);
+  CHECK(solver.slice_num() == Parareal<State>::default_slice_num);
+  CHECK(solver.fine_step() == Parareal<State>::default_fine_step);
+  CHECK(solver.max_iteration() == Parareal<State>::default_max_iteration);
+}
+
+TEST_CASE("Parareal: identical to fine solver after as many iterations as "
+          "slices",
+          "[ode][Parareal]") {
+  lipm_sys sys{9.8, Vec3D(0.01, -0.02, 0)};
+  State x0{{Vec3D(0, 0, 1), Vec3D(0.1, 0.05, 0)}};
+  Parareal<State> solver;
+  solver.set_slice_num(8).set_fine_step(0.01).set_tolerance(0);
+  solver.set_max_iteration(8);
+  SECTION("single thread") { solver.set_thread_num(1); }
+  SECTION("multiple threads") { solver.set_thread_num(3); }
+  State x = solver.update(sys, x0, 0.0, 0.8);
+  CHECK(solver.iteration() == 8);
+  REQUIRE(solver.slice_states().size() == 9);
+
+  RungeKutta4<State> fine;
+  State expected = integrate(&fine, sys, x0, 0.0, 0.1, 8, 10);
+  CHECK(x[0] == expected[0]);
+  CHECK(x[1] == expected[1]);
+  CHECK(solver.slice_states()[8][0] == expected[0]);
+}
+
+TEST_CASE("Parareal: converges in fewer iterations than slices",
+          "[ode][Parareal]") {
+  oscillator_sys sys;
+  std::array<double, 2> x0{{1, 0}};
+  Parareal<std::array<double, 2>> solver;
+  solver.set_slice_num(32).set_coarse_step_num(4).set_fine_step(0.01);
+  solver.set_tolerance(1e-8).set_thread_num(4);
+  auto x = solver.update(sys, x0, 0.5, 16.0);
+  CHECK(solver.iteration() < 32);
+  CHECK(solver.error() <= 1e-8);
+
+  RungeKutta4<std::array<double, 2>> fine;
+  auto expected = integrate(&fine, sys, x0, 0.5, 0.5, 32, 50);
+  CHECK(x[0] == Approx(expected[0]).margin(1e-7));
+  CHECK(x[1] == Approx(expected[1]).margin(1e-7));
+}
+
+TEST_CASE("Parareal: coarse solver is replaceable", "[ode][Parareal]") {
+  oscillator_sys sys;
+  std::array<double, 2> x0{{1, 0}};
+  Parareal<std::array<double, 2>, RungeKutta4<std::array<double, 2>>> rk;
+  Parareal<std::array<double, 2>> euler;
+  euler.set_slice_num(16).set_fine_step(0.01).set_tolerance(1e-9);
+  rk.set_slice_num(16).set_fine_step(0.01).set_tolerance(1e-9);
+  auto x1 = euler.update(sys, x0, 0.0, 8.0);
+  auto x2 = rk.update(sys, x0, 0.0, 8.0);
+  CHECK(x1[0] == Approx(x2[0]).margin(1e-8));
+  // a more accurate coarse solver converges faster
+  CHECK(rk.iteration() <= euler.iteration());
+}
+
+TEST_CASE("Parareal: stops at the maximum number of iterations",
+          "[ode][Parareal]") {
+  oscillator_sys sys;
+  std::array<double, 2> x0{{1, 0}};
+  Parareal<std::array<double, 2>> solver;
+  solver.set_slice_num(16).set_fine_step(0.01).set_tolerance(0);
+  solver.set_max_iteration(2).set_thread_num(2);
+  zEchoOff();
+  solver.update(sys, x0, 0.0, 8.0);
+  zEchoOn();
+  CHECK(solver.iteration() == 2);
+  CHECK(solver.error() > 0);
+
+  // the workers are reused over the iterations of later updates as well
+  solver.set_max_iteration(16);
+  auto x = solver.update(sys, x0, 0.0, 8.0);
+  CHECK(solver.iteration() == 16);
+  RungeKutta4<std::array<double, 2>> fine;
+  auto expected = integrate(&fine, sys, x0, 0.0, 0.5, 16, 50);
+  CHECK(x[0] == expected[0]);
+  CHECK(x[1] == expected[1]);
+}
+
+}  // namespace
+}  // namespace holon
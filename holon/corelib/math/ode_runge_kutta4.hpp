@@ -47,8 +47,8 @@ template <typename System, typename Time>
 State RungeKutta4<State>::update_impl(const System& system, const State& x,
                                       const Time t, const Time dt) {
   Time dt1, dt2, dt3;
-  dt1 = dt * 0.5;
-  dt2 = dt / 6;
+  dt1 = dt * Time(0.5);
+  dt2 = dt / Time(6);
   dt3 = dt2 * 2;
   k[0] = system(x, t);
   xm = Base::cat(x, dt1, k[0]);
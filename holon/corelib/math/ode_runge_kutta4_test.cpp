@@ -21,6 +21,7 @@
 #include "holon/corelib/math/ode_runge_kutta4.hpp"
 
 #include <array>
+#include <cmath>
 
 #include "catch.hpp"
 
@@ -48,5 +49,31 @@ TEST_CASE("Check ODE quadrapture with classical Runge-Kutta method",
   CHECK(x[0] == Approx(10.1));
 }
 
+template <typename T>
+struct decay_sys {
+  std::array<T, 1> operator()(const std::array<T, 1>& x, const T) const {
+    return std::array<T, 1>{{-x[0]}};
+  }
+};
+
+template <typename T>
+T decay(T t_dt, int t_steps) {
+  RungeKutta4<std::array<T, 1>> solver;
+  std::array<T, 1> x{{1}};
+  T t = 0;
+  for (auto i = 0; i < t_steps; ++i, t += t_dt)
+    x = solver.update(decay_sys<T>(), x, t, t_dt);
+  return x[0];
+}
+
+TEST_CASE("Runge-Kutta method in single precision",
+          "[ode][RungeKutta4][float]") {
+  const int steps = 1000;
+  auto x_double = decay<double>(0.001, steps);
+  auto x_float = decay<float>(0.001f, steps);
+  CHECK(x_double == Approx(std::exp(-1.0)));
+  CHECK(x_float == Approx(x_double).epsilon(1e-5));
+}
+
 }  // namespace
 }  // namespace holon
@@ -0,0 +1,171 @@
+/* philox - counter-based random number generator
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_PHILOX_HPP_
+#define HOLON_MATH_PHILOX_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+// Philox4x32-10 counter-based random number generator (Salmon et al., 2011).
+// Every block of four 32-bit words is a pure function of a 128-bit counter
+// and a 64-bit key, so that the generator has a tiny state, jumps to any
+// position in O(1) and splits into independent substreams without any
+// communication. Random numbers at a position of a stream are identical no
+// matter how the work is divided among threads.
+//
+// The key is the seed, the lower half of the counter is the block index in
+// a stream and the upper half is the substream identifier.
+class Philox4x32 {
+ public:
+  using result_type = std::uint32_t;
+  using Counter = std::array<std::uint32_t, 4>;
+  using Key = std::array<std::uint32_t, 2>;
+
+  static constexpr std::size_t kRoundNum = 10;
+
+ public:
+  // constructors
+  explicit Philox4x32(std::uint64_t t_seed = 0,
+                      std::uint64_t t_substream = 0) noexcept
+      : m_key{{std::uint32_t(t_seed), std::uint32_t(t_seed >> 32)}},
+        m_substream(t_substream),
+        m_block(0),
+        m_buffer(),
+        m_index(4) {}
+
+  // block function
+  static Counter generate(Counter t_counter, Key t_key) noexcept {
+    for (std::size_t r = 0; r < kRoundNum; ++r) {
+      if (r > 0) {
+        t_key[0] += 0x9E3779B9;
+        t_key[1] += 0xBB67AE85;
+      }
+      std::uint64_t p0 = std::uint64_t(0xD2511F53) * t_counter[0];
+      std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * t_counter[2];
+      t_counter = {{std::uint32_t(p1 >> 32) ^ t_counter[1] ^ t_key[0],
+                    std::uint32_t(p1),
+                    std::uint32_t(p0 >> 32) ^ t_counter[3] ^ t_key[1],
+                    std::uint32_t(p0)}};
+    }
+    return t_counter;
+  }
+
+  // uniform random bit generator interface
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return 0xFFFFFFFF; }
+  result_type operator()() noexcept {
+    if (m_index == 4) refill();
+    return m_buffer[m_index++];
+  }
+
+  // skip the next t_n words in O(1)
+  void discard(std::uint64_t t_n) noexcept {
+    std::uint64_t pos = position() + t_n;
+    m_block = pos / 4;
+    m_index = 4;
+    if (pos % 4 != 0) {
+      refill();
+      m_index = pos % 4;
+    }
+  }
+
+  // independent stream sharing the seed, which starts from the beginning
+  Philox4x32 substream(std::uint64_t t_id) const noexcept {
+    return Philox4x32(seed(), t_id);
+  }
+
+  // accessors
+  std::uint64_t seed() const noexcept {
+    return std::uint64_t(m_key[0]) | (std::uint64_t(m_key[1]) << 32);
+  }
+  std::uint64_t substream_id() const noexcept { return m_substream; }
+  // number of words generated so far
+  std::uint64_t position() const noexcept {
+    return m_index == 4 ? m_block * 4 : (m_block - 1) * 4 + m_index;
+  }
+
+  // uniform real number in [0, 1) with 53 random bits, which consumes two
+  // words
+  double uniform() noexcept {
+    std::uint64_t hi = (*this)();
+    std::uint64_t lo = (*this)();
+    return toUniform(hi, lo);
+  }
+
+  // fill a buffer with uniform real numbers in [t_min, t_max) in bulk, which
+  // gives the same numbers as calling uniform() one by one
+  void fill_uniform(double* t_first, double* t_last, double t_min = 0,
+                    double t_max = 1) noexcept {
+    const double width = t_max - t_min;
+    while (t_first != t_last && m_index != 4)
+      *t_first++ = t_min + width * uniform();
+    for (; t_last - t_first >= 2; t_first += 2) {
+      Counter c = generate(counter(m_block++), m_key);
+      t_first[0] = t_min + width * toUniform(c[0], c[1]);
+      t_first[1] = t_min + width * toUniform(c[2], c[3]);
+    }
+    if (t_first != t_last) *t_first = t_min + width * uniform();
+  }
+  // Vec3D buffers are filled in the order of x, y and z of each vector
+  void fill_uniform(Vec3D* t_first, Vec3D* t_last, double t_min = 0,
+                    double t_max = 1) noexcept {
+    for (; t_first != t_last; ++t_first) {
+      double* e = t_first->get_ptr()->e;
+      fill_uniform(e, e + 3, t_min, t_max);
+    }
+  }
+
+  // relational operators
+  bool operator==(const Philox4x32& rhs) const noexcept {
+    return seed() == rhs.seed() && m_substream == rhs.m_substream &&
+           position() == rhs.position();
+  }
+  bool operator!=(const Philox4x32& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+
+ private:
+  Counter counter(std::uint64_t t_block) const noexcept {
+    return {{std::uint32_t(t_block), std::uint32_t(t_block >> 32),
+             std::uint32_t(m_substream), std::uint32_t(m_substream >> 32)}};
+  }
+  void refill() noexcept {
+    m_buffer = generate(counter(m_block++), m_key);
+    m_index = 0;
+  }
+  static double toUniform(std::uint64_t t_hi, std::uint64_t t_lo) noexcept {
+    return double(((t_hi << 32) | t_lo) >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  Key m_key;
+  std::uint64_t m_substream;
+  std::uint64_t m_block;  // index of the next block
+  Counter m_buffer;
+  std::size_t m_index;    // index of the next word in the buffer
+};
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_PHILOX_HPP_
@@ -0,0 +1,159 @@
+/* philox - counter-based random number generator
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/math/philox.hpp"
+
+#include <random>
+#include <vector>
+#include "holon/corelib/math/batch.hpp"
+
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("Philox4x32: known answers of block function", "[Philox4x32]") {
+  // test vectors taken from Random123
+  using Counter = Philox4x32::Counter;
+  using Key = Philox4x32::Key;
+  CHECK(Philox4x32::generate(Counter{{0, 0, 0, 0}}, Key{{0, 0}}) ==
+        (Counter{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+  CHECK(Philox4x32::generate(
+            Counter{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+            Key{{0xffffffff, 0xffffffff}}) ==
+        (Counter{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+  CHECK(Philox4x32::generate(
+            Counter{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+            Key{{0xa4093822, 0x299f31d0}}) ==
+        (Counter{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+}
+
+TEST_CASE("Philox4x32: same seed gives same sequence", "[Philox4x32]") {
+  Philox4x32 rng1(42), rng2(42), rng3(43);
+  bool differ = false;
+  for (auto i = 0; i < 100; ++i) {
+    auto v = rng1();
+    REQUIRE(v == rng2());
+    if (v != rng3()) differ = true;
+  }
+  CHECK(differ);
+  CHECK(rng1 == rng2);
+  CHECK(rng1.position() == 100);
+}
+
+TEST_CASE("Philox4x32: discard skips ahead", "[Philox4x32]") {
+  for (std::uint64_t n : {0, 1, 3, 4, 5, 17, 1000}) {
+    Philox4x32 rng1(7, 2), rng2(7, 2);
+    for (std::uint64_t i = 0; i < n; ++i) rng1();
+    rng2.discard(n);
+    CHECK(rng2.position() == n);
+    for (auto i = 0; i < 9; ++i) REQUIRE(rng1() == rng2());
+  }
+  SECTION("discard from the middle of a block") {
+    Philox4x32 rng1(7), rng2(7);
+    rng1();
+    rng2();
+    for (auto i = 0; i < 6; ++i) rng1();
+    rng2.discard(6);
+    CHECK(rng1() == rng2());
+  }
+}
+
+TEST_CASE("Philox4x32: substreams are independent", "[Philox4x32]") {
+  Philox4x32 rng(3);
+  auto s1 = rng.substream(1), s1_ = rng.substream(1), s2 = rng.substream(2);
+  CHECK(s1.seed() == rng.seed());
+  CHECK(s1.substream_id() == 1);
+  bool differ = false;
+  for (auto i = 0; i < 100; ++i) {
+    auto v = s1();
+    REQUIRE(v == s1_());
+    if (v != s2()) differ = true;
+  }
+  CHECK(differ);
+}
+
+TEST_CASE("Philox4x32: uniform real numbers", "[Philox4x32]") {
+  Philox4x32 rng(11);
+  double sum = 0;
+  const int n = 10000;
+  for (auto i = 0; i < n; ++i) {
+    double v = rng.uniform();
+    REQUIRE(v >= 0);
+    REQUIRE(v < 1);
+    sum += v;
+  }
+  CHECK(sum / n == Approx(0.5).margin(0.02));
+  CHECK(rng.position() == 2 * n);
+
+  SECTION("usable with standard distributions") {
+    std::normal_distribution<double> dist(0, 1);
+    double x = dist(rng);
+    CHECK(x == x);
+  }
+}
+
+TEST_CASE("Philox4x32: bulk fill equals one by one", "[Philox4x32]") {
+  Philox4x32 rng1(5), rng2(5);
+  rng1();  // start in the middle of a block
+  rng2();
+  std::vector<double> buf(11);
+  rng1.fill_uniform(buf.data(), buf.data() + buf.size(), -1, 1);
+  for (auto v : buf) REQUIRE(v == -1 + 2 * rng2.uniform());
+  CHECK(rng1 == rng2);
+
+  SECTION("Vec3D buffer") {
+    std::vector<Vec3D> vs(5);
+    rng1.fill_uniform(vs.data(), vs.data() + vs.size());
+    for (const auto& v : vs)
+      for (std::size_t i = 0; i < 3; ++i) REQUIRE(v[i] == rng2.uniform());
+  }
+  SECTION("structure-of-arrays buffer") {
+    Batch<8> x, y;
+    rng1.substream(1).fill_uniform(x.begin(), x.end());
+    rng1.substream(2).fill_uniform(y.begin(), y.end());
+    auto sx = rng2.substream(1), sy = rng2.substream(2);
+    for (std::size_t i = 0; i < 8; ++i) {
+      REQUIRE(x[i] == sx.uniform());
+      REQUIRE(y[i] == sy.uniform());
+    }
+  }
+}
+
+TEST_CASE("Philox4x32: results do not depend on how work is divided",
+          "[Philox4x32]") {
+  const std::size_t n = 1000;
+  std::vector<double> serial(n);
+  Philox4x32(9).fill_uniform(serial.data(), serial.data() + n);
+  for (std::size_t chunk : {1, 3, 64, 333}) {
+    // each chunk would be processed by a different thread
+    std::vector<double> parallel(n);
+    for (std::size_t begin = 0; begin < n; begin += chunk) {
+      std::size_t end = std::min(n, begin + chunk);
+      Philox4x32 rng(9);
+      rng.discard(2 * begin);
+      rng.fill_uniform(parallel.data() + begin, parallel.data() + end);
+    }
+    REQUIRE(parallel == serial);
+  }
+}
+
+}  // namespace
+}  // namespace holon
@@ -0,0 +1,36 @@
+/* vec3d_text_writer - writing 3D vectors with TextWriter
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_MATH_VEC3D_TEXT_WRITER_HPP_
+#define HOLON_MATH_VEC3D_TEXT_WRITER_HPP_
+
+#include "holon/corelib/common/text_writer.hpp"
+#include "holon/corelib/math/vec3d.hpp"
+
+namespace holon {
+
+// write elements delimited by the delimiter of the writer
+inline TextWriter& operator<<(TextWriter& writer, const Vec3D& v) {
+  return writer.put(v[0]).delimit().put(v[1]).delimit().put(v[2]);
+}
+
+}  // namespace holon
+
+#endif  // HOLON_MATH_VEC3D_TEXT_WRITER_HPP_
@@ -0,0 +1,60 @@
+/* pd_ctrl_float_example - Example of PD control in single precision
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include <cmath>
+#include <iostream>
+
+using holon::PdCtrl;
+
+// The same scenario as pd_ctrl_example with float states so that the drift
+// from double precision can be compared with pd_ctrl_example.dat.
+const double T = 10;
+const double DT = 0.01;
+const float omega = 2;
+const float amp = 1.0;
+const float phase = 0.0;
+
+float traj(float t) { return amp * std::sin(omega * t - phase); }
+
+float traj_vel(float t) { return amp * omega * std::cos(omega * t - phase); }
+
+void log(const PdCtrl<float>& ctrl) {
+  std::cout << ctrl.time() << " ";
+  std::cout << ctrl.refs().position << " ";
+  std::cout << ctrl.refs().velocity << " ";
+  std::cout << ctrl.states().position << " ";
+  std::cout << ctrl.states().velocity << "\n";
+}
+
+int main() {
+  PdCtrl<float> ctrl;
+  ctrl.refs().stiffness = 100;
+  ctrl.refs().damping = 10;
+
+  log(ctrl);
+  while (ctrl.time() < T) {
+    ctrl.refs().position = traj(ctrl.time());
+    ctrl.refs().velocity = traj_vel(ctrl.time());
+    ctrl.update(DT);
+    log(ctrl);
+  }
+  return 0;
+}
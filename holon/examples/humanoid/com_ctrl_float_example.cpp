@@ -0,0 +1,411 @@
+/* com_ctrl_float_example - examples of COM controller in single precision
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <roki/rk_g.h>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
+#include "holon/corelib/humanoid/com_ctrl/phase_y.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+#include "holon/corelib/math/misc.hpp"
+#include "holon/corelib/math/ode_runge_kutta4.hpp"
+
+// The examples of ComCtrl other than com_regulation_example computed in
+// single precision with the scalar formulas of the controller and the
+// COM-ZMP model, so that the drift from double precision can be compared
+// with their sample data. The log of each example has the same columns as
+// that of the double precision one.
+// Usage: com_ctrl_float_example <example>
+//   where <example> is one of com_regulation_vertical, com_oscillation,
+//   com_longitudinal_moving, com_sideward_moving and
+//   com_regulation_with_disturbance.
+// The time is kept in double precision as the examples do, so that the
+// commands and the external forces switch at the same steps.
+const double DT = 0.01;
+const float kMass = 1;
+const float kG = RK_G;
+
+namespace ctrl_x = holon::com_ctrl_x;
+namespace ctrl_y = holon::com_ctrl_y;
+namespace ctrl_z = holon::com_ctrl_z;
+namespace formula = holon::com_zmp_model_formula;
+namespace phase_y = holon::phase_y;
+using holon::optional;
+
+using Vec = std::array<float, 3>;
+// COM position and velocity
+using State = std::array<float, 6>;
+using Solver = holon::RungeKutta4<State>;
+
+const Vec kZero = {{0, 0, 0}};
+
+// commands given to the controller as ComCtrlCommandsRawData
+struct Commands {
+  optional<float> xd, yd, zd, vxd, vyd, rho, dist;
+};
+
+// references of the controller as ComCtrlRefsRawData
+struct Refs {
+  Vec p, v;
+  float qx1 = ctrl_x::default_q1, qx2 = ctrl_x::default_q2;
+  float qy1 = ctrl_y::default_q1, qy2 = ctrl_y::default_q2;
+  float qz1 = ctrl_z::default_q1, qz2 = ctrl_z::default_q2;
+  float rho = ctrl_y::default_rho, dist = ctrl_y::default_dist;
+  float kr = ctrl_y::default_kr;
+};
+
+// desired ZMP and reaction force along z-axis at a state
+struct Inputs {
+  Vec zmp;
+  float fz;
+};
+
+// ComCtrl in single precision, whose model is driven by the desired ZMP
+// and reaction force
+class FloatComCtrl {
+ public:
+  FloatComCtrl(const Vec& t_p0, float t_dist)
+      : m_x{{t_p0[0], t_p0[1], t_p0[2], 0, 0, 0}},
+        m_default(t_p0),
+        m_canonical_foot_dist(t_dist),
+        m_max_foot_dist(t_dist),
+        m_current_foot_dist(t_dist) {
+    m_refs.dist = t_dist;
+  }
+
+  Commands& commands() { return m_cmd; }
+  State& state() { return m_x; }
+  const Refs& refs() const { return m_refs; }
+  const Inputs& outputs() const { return m_outputs; }
+
+  // reaction force applied to the COM at the state of the last update
+  Vec reaction_force() const {
+    Vec f = {{0, 0, m_outputs.fz}};
+    if (!formula::isComZmpDiffValid(m_out_p[2], m_outputs.zmp[2])) return f;
+    float sqr_zeta = m_outputs.fz / (m_out_p[2] - m_outputs.zmp[2]);
+    for (int i = 0; i < 3; ++i)
+      f[i] = sqr_zeta * (m_out_p[i] - m_outputs.zmp[i]);
+    return f;
+  }
+
+  Inputs inputs(const State& x) const {
+    Inputs u;
+    u.fz = ctrl_z::computeDesReactForce(x[2], x[5], m_refs.p[2], m_refs.qz1,
+                                        m_refs.qz2, kMass);
+    float zeta = formula::computeZeta(x[2], 0.0f, u.fz, kMass);
+    u.zmp[0] = ctrl_x::computeDesZmpPos(x[0], x[3], m_refs.p[0], m_refs.v[0],
+                                        m_refs.qx1, m_refs.qx2, zeta);
+    u.zmp[1] = ctrl_y::computeDesZmpPos(x[1], x[4], m_refs.p[1], m_refs.qy1,
+                                        m_refs.qy2, m_refs.rho, m_refs.dist,
+                                        m_refs.kr, zeta);
+    u.zmp[2] = 0;
+    return u;
+  }
+
+  State operator()(const State& x, const double) const {
+    auto u = inputs(x);
+    float sqr_zeta = formula::computeSqrZeta(x[2], u.zmp[2], u.fz, kMass);
+    State dxdt;
+    dxdt[0] = x[3];
+    dxdt[1] = x[4];
+    dxdt[2] = x[5];
+    dxdt[3] = formula::computeComAcc(x[0], u.zmp[0], sqr_zeta, 0.0f);
+    dxdt[4] = formula::computeComAcc(x[1], u.zmp[1], sqr_zeta, 0.0f);
+    dxdt[5] = formula::computeComAcc(x[2], u.zmp[2], sqr_zeta, kG);
+    return dxdt;
+  }
+
+  void update(double t_time) {
+    updateRefs();
+    m_outputs = inputs(m_x);
+    m_out_p = {{m_x[0], m_x[1], m_x[2]}};
+    m_out_acc_z = (*this)(m_x, t_time)[5];
+    m_x = m_solver.update(*this, m_x, t_time, DT);
+    updateDefaultComPosition();
+  }
+
+ private:
+  void updateSideward() {
+    float zeta = formula::computeZeta(m_x[2], m_outputs.zmp[2], m_out_acc_z);
+    float yd = m_refs.p[1];
+    float vyd = m_refs.v[1];
+    auto pz = phase_y::computeComplexZmp(m_outputs.zmp[1], m_x[4], yd,
+                                         m_refs.qy1, m_refs.qy2, zeta);
+    auto pLin = phase_y::computeComplexInnerEdge(yd, yd, pz, 1);
+    auto pRin = phase_y::computeComplexInnerEdge(yd, yd, pz, -1);
+    float phaseL = phase_y::computePhase(pz, pLin);
+    float phaseR = phase_y::computePhase(pz, pRin);
+    float T = phase_y::computePeriod(m_refs.qy1, m_refs.qy2, zeta);
+    float d0 = m_canonical_foot_dist;
+    float d = m_current_foot_dist;
+    if ((vyd > 0 && phaseR > 0 && phaseR < 1) ||
+        (vyd < 0 && phaseL > 0 && phaseL < 1)) {
+      // following phase
+      float phase = vyd > 0 ? phaseR : phaseL;
+      float d_new = d0 + T * phase * std::fabs(vyd);
+      m_refs.p[1] = yd + 0.5f * (d_new - d) * holon::sgn(vyd);
+      m_refs.dist = d_new;
+      m_max_foot_dist = d_new;
+    } else if ((vyd > 0 && phaseL > 0 && phaseL < 1) ||
+               (vyd < 0 && phaseR > 0 && phaseR < 1)) {
+      // braking phase
+      float phase = vyd > 0 ? phaseL : phaseR;
+      float d_new = m_max_foot_dist + (d0 - m_max_foot_dist) * phase;
+      m_refs.p[1] = yd + 0.5f * (d - d_new) * holon::sgn(vyd);
+      m_refs.dist = d_new;
+    }
+  }
+
+  void updateRefs() {
+    m_refs.p[0] = m_cmd.xd.value_or(m_default[0]);
+    m_refs.p[1] = m_cmd.yd.value_or(m_default[1]);
+    m_refs.p[2] = m_cmd.zd.value_or(m_default[2]);
+    m_refs.v[0] = m_cmd.vxd.value_or(0);
+    m_refs.v[1] = m_cmd.vyd.value_or(0);
+    m_refs.v[2] = 0;
+    m_refs.rho = m_cmd.rho.value_or(ctrl_y::default_rho);
+    m_refs.qx1 = ctrl_x::default_q1;
+    if (m_cmd.dist) m_canonical_foot_dist = m_cmd.dist.value();
+    m_refs.dist = m_cmd.dist.value_or(m_canonical_foot_dist);
+    if (!zIsTiny(m_refs.v[0]) || !zIsTiny(m_refs.v[1])) {
+      m_refs.rho = 1;
+      if (!zIsTiny(m_refs.v[0])) m_refs.qx1 = 0;
+      if (!zIsTiny(m_refs.v[1])) updateSideward();
+    }
+  }
+
+  void updateDefaultComPosition() {
+    if (m_cmd.vxd && !zIsTiny(m_cmd.vxd.value())) m_default[0] = m_x[0];
+    if (m_cmd.vyd && !zIsTiny(m_cmd.vyd.value())) {
+      m_default[1] = m_refs.p[1];
+      m_current_foot_dist = m_refs.dist;
+    }
+    if (m_cmd.zd) m_default[2] = m_cmd.zd.value();
+  }
+
+  Commands m_cmd;
+  State m_x;
+  Refs m_refs;
+  Inputs m_outputs{kZero, kMass * kG};
+  Vec m_out_p = kZero;
+  float m_out_acc_z = 0;
+  Vec m_default;
+  float m_canonical_foot_dist;
+  float m_max_foot_dist;
+  float m_current_foot_dist;
+  Solver m_solver;
+};
+
+// COM-ZMP model in single precision driven by a reaction force or a ZMP
+// held over a step and by an external force as ComZmpModel
+struct FloatComZmpModel {
+  using ExternalForce = Vec (*)(double);
+
+  FloatComZmpModel(const State& t_x, ExternalForce t_external_force)
+      : x(t_x), external_force(t_external_force) {}
+
+  State x;
+  Vec reaction_force = {{0, 0, kMass * kG}};
+  optional<Vec> zmp;
+  ExternalForce external_force;
+  Solver solver;
+
+  State operator()(const State& t_x, const double t) const {
+    Vec fe = external_force(t);
+    State dxdt;
+    for (int i = 0; i < 3; ++i) dxdt[i] = t_x[i + 3];
+    if (zmp) {
+      const Vec& pz = zmp.value();
+      float sqr_zeta =
+          formula::computeSqrZeta(t_x[2], pz[2], reaction_force[2], kMass);
+      for (int i = 0; i < 3; ++i)
+        dxdt[i + 3] = sqr_zeta * (t_x[i] - pz[i]) + fe[i] / kMass;
+    } else {
+      for (int i = 0; i < 3; ++i)
+        dxdt[i + 3] = (reaction_force[i] + fe[i]) / kMass;
+    }
+    dxdt[5] -= kG;
+    return dxdt;
+  }
+
+  void update(double t_time) { x = solver.update(*this, x, t_time, DT); }
+};
+
+void write(double t_time) { std::cout << std::defaultfloat << t_time; }
+
+template <typename Array>
+void write(const Array& t_values, std::size_t t_first, std::size_t t_n) {
+  std::cout << std::scientific;
+  for (std::size_t i = t_first; i < t_first + t_n; ++i)
+    std::cout << " " << t_values[i];
+}
+
+void writeState(const State& t_x, const Vec& t_zmp) {
+  write(t_x, 0, 6);
+  write(t_zmp, 0, 3);
+  std::cout << "\n";
+}
+
+Vec verticalForce(double t) {
+  if (t > 3 && t < 3.1) return {{0, 0, -1}};
+  return kZero;
+}
+
+Vec horizontalForce(double t) {
+  if (t > 4 && t < 4.1) return {{1, -1, 0}};
+  if (t > 6 && t < 6.1) return {{-1.5, 1.5, 0}};
+  return kZero;
+}
+
+void runComRegulationVertical() {
+  FloatComZmpModel model({{0, 0, 0.4f, 0, 0, 0}}, verticalForce);
+  FloatComCtrl ctrl({{0, 0, 0.4f}}, ctrl_y::default_dist);
+  auto& cmd = ctrl.commands();
+  double t = 0;
+  while (t < 10) {
+    ctrl.state() = model.x;
+    cmd.xd = 0;
+    cmd.yd = 0;
+    cmd.zd = t < 6 ? 0.42f : 0.44f;
+    ctrl.update(t);
+    model.reaction_force = ctrl.reaction_force();
+    model.update(t);
+    t += DT;
+    write(t);
+    Vec pd = {{cmd.xd.value(), cmd.yd.value(), cmd.zd.value()}};
+    write(pd, 0, 3);
+    writeState(model.x, kZero);
+  }
+}
+
+void runComOscillation() {
+  FloatComCtrl ctrl({{0, 0, 0.42f}}, ctrl_y::default_dist);
+  ctrl.state()[4] = 0.00001f;
+  auto& cmd = ctrl.commands();
+  cmd.xd = 0;
+  cmd.yd = 0;
+  cmd.zd = 0.42f;
+  cmd.rho = 1;
+  cmd.dist = 0.1f;
+  double t = 0;
+  while (t < 10) {
+    ctrl.update(t);
+    t += DT;
+    write(t);
+    writeState(ctrl.state(), ctrl.outputs().zmp);
+  }
+}
+
+void runComLongitudinalMoving() {
+  FloatComCtrl ctrl({{0, 0, 0.42f}}, ctrl_y::default_dist);
+  ctrl.state()[4] = 0.00001f;
+  auto& cmd = ctrl.commands();
+  cmd.zd = 0.42f;
+  cmd.dist = 0.1f;
+  double t = 0;
+  while (t < 10) {
+    // move forward until t = 5 and then stop
+    cmd.vxd = t < 5 ? 0.1f : 0.0f;
+    ctrl.update(t);
+    t += DT;
+    write(t);
+    Vec vd = {{cmd.vxd.value_or(0), cmd.vyd.value_or(0), 0}};
+    write(vd, 0, 2);
+    writeState(ctrl.state(), ctrl.outputs().zmp);
+  }
+}
+
+void runComSidewardMoving() {
+  FloatComCtrl ctrl({{0, 0, 0.42f}}, 0.1f);
+  ctrl.state()[4] = 0.00001f;
+  auto& cmd = ctrl.commands();
+  cmd.zd = 0.42f;
+  cmd.rho = 1;
+  double t = 0;
+  while (t < 20) {
+    // sideward moving in phases
+    if (t < 3)
+      cmd.vyd = 0;
+    else if (t < 8)
+      cmd.vyd = 0.05f;
+    else if (t < 12)
+      cmd.vyd = 0;
+    else if (t < 17)
+      cmd.vyd = -0.05f;
+    else
+      cmd.vyd = 0;
+    ctrl.update(t);
+    t += DT;
+    write(t);
+    Vec rv = {{ctrl.refs().p[0], ctrl.refs().p[1], 0}};
+    write(rv, 0, 2);
+    Vec vd = {{cmd.vxd.value_or(0), cmd.vyd.value_or(0), 0}};
+    write(vd, 0, 2);
+    writeState(ctrl.state(), ctrl.outputs().zmp);
+  }
+}
+
+void runComRegulationWithDisturbance() {
+  FloatComZmpModel model({{0.1f, -0.1f, 1, 0, 0, 0}}, horizontalForce);
+  FloatComCtrl ctrl({{0.1f, -0.1f, 1}}, ctrl_y::default_dist);
+  auto& cmd = ctrl.commands();
+  double t = 0;
+  while (t < 10) {
+    ctrl.state() = model.x;
+    cmd.xd = 0;
+    cmd.yd = 0;
+    cmd.zd = 1;
+    ctrl.update(t);
+    model.zmp = ctrl.outputs().zmp;
+    model.update(t);
+    t += DT;
+    write(t);
+    writeState(model.x, model.zmp.value());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <example>\n";
+    return 1;
+  }
+  std::cout << std::setprecision(10);
+  if (std::strcmp(argv[1], "com_regulation_vertical") == 0) {
+    runComRegulationVertical();
+  } else if (std::strcmp(argv[1], "com_oscillation") == 0) {
+    runComOscillation();
+  } else if (std::strcmp(argv[1], "com_longitudinal_moving") == 0) {
+    runComLongitudinalMoving();
+  } else if (std::strcmp(argv[1], "com_sideward_moving") == 0) {
+    runComSidewardMoving();
+  } else if (std::strcmp(argv[1], "com_regulation_with_disturbance") == 0) {
+    runComRegulationWithDisturbance();
+  } else {
+    std::cerr << "unknown example: " << argv[1] << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -19,13 +19,41 @@
  */
 
 #include <iostream>
+#include <memory>
+#include "holon/corelib/control/task_scheduler.hpp"
 #include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
 
 const double T = 10;
 const double DT = 0.01;
 
 using holon::Vec3D;
 using holon::ComCtrl;
+using holon::ComCtrlCommandsRawData;
+using holon::Await;
+using holon::Task;
+using holon::TaskScheduler;
+using holon::until;
+
+// move forward until t = 5 and then stop
+class LongitudinalMoving : public Task {
+ public:
+  explicit LongitudinalMoving(std::shared_ptr<ComCtrlCommandsRawData> t_cmd)
+      : m_cmd(t_cmd) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    m_cmd->vxd = 0.1;
+    HOLON_TASK_AWAIT(until(5));
+    m_cmd->vxd = 0;
+    // m_cmd->rho = 0;
+    HOLON_TASK_END;
+  }
+
+ private:
+  std::shared_ptr<ComCtrlCommandsRawData> m_cmd;
+};
 
 int main() {
   ComCtrl ctrl;
@@ -39,21 +67,21 @@ int main() {
   cmd->zd = 0.42;
   // cmd->rho = 1;
   cmd->dist = dist;
+  TaskScheduler scheduler;
+  scheduler.add(std::make_shared<LongitudinalMoving>(cmd));
+  char buf[512];
+  holon::TextWriter writer(buf);
   while (ctrl.time() < T) {
-    if (ctrl.time() < 5) {
-      cmd->vxd = 0.1;
-    } else {
-      cmd->vxd = 0;
-      // cmd->rho = 0;
-    }
+    scheduler.resume(ctrl.time());
     ctrl.update(DT);
 
-    std::cout << ctrl.time() << " ";
-    std::cout << ctrl.commands().vxd.value_or(0) << " ";
-    std::cout << ctrl.commands().vyd.value_or(0) << " ";
-    std::cout << ctrl.states().com_position.data() << " ";
-    std::cout << ctrl.states().com_velocity.data() << " ";
-    std::cout << ctrl.states().zmp_position.data() << "\n";
+    writer.put(ctrl.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << ctrl.commands().vxd.value_or(0) << ' ';
+    writer << ctrl.commands().vyd.value_or(0) << ' ';
+    writer << ctrl.states().com_position << ' ';
+    writer << ctrl.states().com_velocity << ' ';
+    writer << ctrl.states().zmp_position << '\n';
+    writer.flush(std::cout);
   }
   return 0;
 }
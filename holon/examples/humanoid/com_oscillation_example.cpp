@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
 
 const double T = 10;
 const double DT = 0.01;
@@ -42,6 +43,8 @@ int main() {
   double yzmin = 0;
   double yzmax = 0;
   const double& yz = ctrl.states().zmp_position[1];
+  char buf[512];
+  holon::TextWriter writer(buf);
   while (ctrl.time() < T) {
     ctrl.update(DT);
 
@@ -52,10 +55,11 @@ int main() {
       yzmin = yz;
     }
 
-    std::cout << ctrl.time() << " ";
-    std::cout << ctrl.states().com_position.data() << " ";
-    std::cout << ctrl.states().com_velocity.data() << " ";
-    std::cout << ctrl.states().zmp_position.data() << "\n";
+    writer.put(ctrl.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << ctrl.states().com_position << ' ';
+    writer << ctrl.states().com_velocity << ' ';
+    writer << ctrl.states().zmp_position << '\n';
+    writer.flush(std::cout);
   }
   std::cerr << "actual dist = " << (yzmax - yzmin) << "\n";
   return 0;
@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
 
 const double T = 10;
 const double DT = 0.01;
@@ -31,13 +32,16 @@ int main() {
   holon::Vec3D cmd_com_pos = {0, 0, 1};
 
   ctrl.reset(initial_com_pos);
+  char buf[512];
+  holon::TextWriter writer(buf);
   while (ctrl.time() < T) {
     cmd->set_com_position(cmd_com_pos);
     ctrl.update(DT);
-    std::cout << ctrl.time() << " ";
-    std::cout << ctrl.states().com_position.data() << " ";
-    std::cout << ctrl.states().com_velocity.data() << " ";
-    std::cout << ctrl.states().zmp_position.data() << "\n";
+    writer.put(ctrl.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << ctrl.states().com_position << ' ';
+    writer << ctrl.states().com_velocity << ' ';
+    writer << ctrl.states().zmp_position << '\n';
+    writer.flush(std::cout);
   }
   return 0;
 }
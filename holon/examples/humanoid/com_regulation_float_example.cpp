@@ -0,0 +1,96 @@
+/* com_regulation_float_example - example of regulation of COM in single precision
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <roki/rk_g.h>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_y.hpp"
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_z.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+#include "holon/corelib/math/ode_runge_kutta4.hpp"
+
+// The same scenario as com_regulation_example computed in single precision
+// with the scalar formulas of the controller and the COM-ZMP model, so that
+// the drift from double precision can be compared with
+// com_regulation_example.dat.
+const double T = 10;
+const double DT = 0.01;
+const float kMass = 1;
+const float kG = RK_G;
+
+namespace ctrl_x = holon::com_ctrl_x;
+namespace ctrl_y = holon::com_ctrl_y;
+namespace ctrl_z = holon::com_ctrl_z;
+namespace formula = holon::com_zmp_model_formula;
+
+// COM position and velocity
+using State = std::array<float, 6>;
+
+struct Inputs {
+  float xz, yz, fz;
+};
+
+struct ComRegulationSystem {
+  float xd, yd, zd;
+
+  Inputs inputs(const State& x) const {
+    Inputs u;
+    u.fz = ctrl_z::computeDesReactForce(x[2], x[5], zd, 1.0f, 1.0f, kMass);
+    float zeta = formula::computeZeta(x[2], 0.0f, u.fz, kMass);
+    u.xz = ctrl_x::computeDesZmpPos(x[0], x[3], xd, 0.0f, 1.0f, 1.0f, zeta);
+    u.yz = ctrl_y::computeDesZmpPos(x[1], x[4], yd, 1.0f, 1.0f, 0.0f, 0.0f,
+                                    1.0f, zeta);
+    return u;
+  }
+
+  State operator()(const State& x, const float) const {
+    auto u = inputs(x);
+    float sqr_zeta = formula::computeSqrZeta(x[2], 0.0f, u.fz, kMass);
+    State dxdt;
+    dxdt[0] = x[3];
+    dxdt[1] = x[4];
+    dxdt[2] = x[5];
+    dxdt[3] = formula::computeComAcc(x[0], u.xz, sqr_zeta, 0.0f);
+    dxdt[4] = formula::computeComAcc(x[1], u.yz, sqr_zeta, 0.0f);
+    dxdt[5] = formula::computeComAcc(x[2], 0.0f, sqr_zeta, kG);
+    return dxdt;
+  }
+};
+
+int main() {
+  ComRegulationSystem sys{0, 0, 1};
+  holon::RungeKutta4<State> solver;
+  State x{{0.1f, -0.1f, 1, 0, 0, 0}};
+  double t = 0;
+
+  std::cout << std::scientific << std::setprecision(10);
+  while (t < T) {
+    auto u = sys.inputs(x);
+    x = solver.update(sys, x, float(t), float(DT));
+    t += DT;
+    std::cout << std::defaultfloat << t << std::scientific << " ";
+    std::cout << x[0] << " " << x[1] << " " << x[2] << " ";
+    std::cout << x[3] << " " << x[4] << " " << x[5] << " ";
+    std::cout << u.xz << " " << u.yz << " " << 0.0f << "\n";
+  }
+  return 0;
+}
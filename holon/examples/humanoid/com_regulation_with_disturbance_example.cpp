@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
 
 const double T = 10;
 const double DT = 0.01;
@@ -51,6 +52,8 @@ int main() {
 
   model.setExternalForceCallback(external_force);
 
+  char buf[512];
+  holon::TextWriter writer(buf);
   while (model.time() < T) {
     // feedback
     ctrl.feedback(model);
@@ -64,10 +67,11 @@ int main() {
     model.update(DT);
 
     // logging
-    std::cout << model.time() << " ";
-    std::cout << model.states().com_position.data() << " ";
-    std::cout << model.states().com_velocity.data() << " ";
-    std::cout << model.states().zmp_position.data() << "\n";
+    writer.put(model.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << model.states().com_position << ' ';
+    writer << model.states().com_velocity << ' ';
+    writer << model.states().zmp_position << '\n';
+    writer.flush(std::cout);
   }
   return 0;
 }
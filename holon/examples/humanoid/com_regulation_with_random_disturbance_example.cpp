@@ -0,0 +1,76 @@
+/* com_regulation_with_random_disturbance_example - COM regulation example
+ * under random pushes
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/random_push_disturbance.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
+
+const double T = 10;
+const double DT = 0.01;
+
+using holon::Vec3D;
+using holon::ComZmpModel;
+using holon::ComCtrl;
+using holon::RandomPushDisturbance;
+
+// Usage: com_regulation_with_random_disturbance_example [seed]
+// Trials of a Monte-Carlo run are given different seeds, and each of them
+// is reproducible whichever process or thread runs it.
+int main(int argc, char* argv[]) {
+  std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 0;
+
+  ComZmpModel model;
+  model.reset(Vec3D(0.1, -0.1, 1));
+
+  ComCtrl ctrl(model);
+  auto cmd = ctrl.getCommands();
+  Vec3D cmd_com_pos = {0, 0, 1};
+
+  RandomPushDisturbance disturbance(seed);
+  disturbance.set_interval(2).set_duration(0.1).set_max_force(2);
+  model.setExternalForceCallback(disturbance);
+
+  char buf[512];
+  holon::TextWriter writer(buf);
+  while (model.time() < T) {
+    // feedback
+    ctrl.feedback(model);
+
+    // update controller
+    cmd->set_com_position(cmd_com_pos);
+    ctrl.update(DT);
+
+    // update simulator
+    model.setZmpPosition(ctrl.outputs().zmp_position);
+    model.update(DT);
+
+    // logging
+    writer.put(model.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << model.states().com_position << ' ';
+    writer << model.states().com_velocity << ' ';
+    writer << model.states().zmp_position << '\n';
+    writer.flush(std::cout);
+  }
+  return 0;
+}
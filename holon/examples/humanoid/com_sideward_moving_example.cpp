@@ -19,13 +19,48 @@
  */
 
 #include <iostream>
+#include <memory>
+#include "holon/corelib/control/task_scheduler.hpp"
 #include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/math/vec3d_text_writer.hpp"
 
 const double T = 20;
 const double DT = 0.01;
 
 using holon::Vec3D;
 using holon::ComCtrl;
+using holon::ComCtrlCommandsRawData;
+using holon::Await;
+using holon::Task;
+using holon::TaskScheduler;
+using holon::until;
+
+// sideward moving in phases
+class SidewardMoving : public Task {
+ public:
+  explicit SidewardMoving(std::shared_ptr<ComCtrlCommandsRawData> t_cmd)
+      : m_cmd(t_cmd) {}
+
+ protected:
+  Await run() override {
+    HOLON_TASK_BEGIN;
+    m_cmd->vyd = 0;
+    m_cmd->rho = 1;
+    HOLON_TASK_AWAIT(until(3));
+    m_cmd->vyd = 0.05;
+    // m_cmd->vyd = -0.05; // FIXME: this produces jerky behavior
+    HOLON_TASK_AWAIT(until(8));
+    m_cmd->vyd = 0;
+    HOLON_TASK_AWAIT(until(12));
+    m_cmd->vyd = -0.05;
+    HOLON_TASK_AWAIT(until(17));
+    m_cmd->vyd = 0;
+    HOLON_TASK_END;
+  }
+
+ private:
+  std::shared_ptr<ComCtrlCommandsRawData> m_cmd;
+};
 
 int main() {
   ComCtrl ctrl;
@@ -36,30 +71,23 @@ int main() {
   ctrl.reset(p0, dist);
   ctrl.states().com_velocity = {0, 0.00001, 0};
   cmd->zd = 0.42;
+  TaskScheduler scheduler;
+  scheduler.add(std::make_shared<SidewardMoving>(cmd));
+  char buf[512];
+  holon::TextWriter writer(buf);
   while (ctrl.time() < T) {
-    if (ctrl.time() < 3) {
-      cmd->vyd = 0;
-      cmd->rho = 1;
-    } else if (ctrl.time() < 8) {
-      cmd->vyd = 0.05;
-      // cmd->vyd = -0.05; // FIXME: this produces jerky behavior
-    } else if (ctrl.time() < 12) {
-      cmd->vyd = 0;
-    } else if (ctrl.time() < 17) {
-      cmd->vyd = -0.05;
-    } else {
-      cmd->vyd = 0;
-    }
+    scheduler.resume(ctrl.time());
     ctrl.update(DT);
 
-    std::cout << ctrl.time() << " ";
-    std::cout << ctrl.refs().com_position.x() << " ";
-    std::cout << ctrl.refs().com_position.y() << " ";
-    std::cout << ctrl.commands().vxd.value_or(0) << " ";
-    std::cout << ctrl.commands().vyd.value_or(0) << " ";
-    std::cout << ctrl.states().com_position.data() << " ";
-    std::cout << ctrl.states().com_velocity.data() << " ";
-    std::cout << ctrl.states().zmp_position.data() << "\n";
+    writer.put(ctrl.time(), holon::TextWriter::Format::general, 10) << ' ';
+    writer << ctrl.refs().com_position.x() << ' ';
+    writer << ctrl.refs().com_position.y() << ' ';
+    writer << ctrl.commands().vxd.value_or(0) << ' ';
+    writer << ctrl.commands().vyd.value_or(0) << ' ';
+    writer << ctrl.states().com_position << ' ';
+    writer << ctrl.states().com_velocity << ' ';
+    writer << ctrl.states().zmp_position << '\n';
+    writer.flush(std::cout);
   }
   return 0;
 }
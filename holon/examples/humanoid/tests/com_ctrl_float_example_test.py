@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import numpy as np
+from numpy.testing import assert_allclose
+from subprocess import Popen
+import os
+import unittest
+
+THIS_EXAMPLE_NAME = "com_ctrl_float_example"
+TEST_EXECUTABLE = os.path.join("..", THIS_EXAMPLE_NAME)
+# tolerance of drift of single precision from the double precision baseline
+ABSOLUTE_TOLERANCE = 1.0e-5
+# The sideward moving switches the reference of the COM at phases of the
+# oscillation, and a phase reached at a different step in single precision
+# shifts the rest of the motion.
+SIDEWARD_MOVING_ABSOLUTE_TOLERANCE = 1.0e-2
+
+
+def sample_data_filename(baseline):
+    return os.path.join("data", baseline + "_example.dat")
+
+
+def load_sample_data(baseline):
+    data = np.loadtxt(sample_data_filename(baseline))
+    return data
+
+
+def generate_testing_data(baseline):
+    filename = os.path.join(".", baseline + "_float_example.dat")
+    cmd = [TEST_EXECUTABLE, baseline]
+    with open(filename, 'w') as fobj:
+        proc = Popen(cmd, stdout=fobj)
+        proc.wait(timeout=1)
+    data = np.loadtxt(filename)
+    return data
+
+
+class TestComCtrlFloat(unittest.TestCase):
+
+    def setUp(self):
+        # check if excutable exists
+        self.assertTrue(os.path.isfile(TEST_EXECUTABLE),
+                        msg="test executable does not exist")
+        self.assertTrue(os.access(TEST_EXECUTABLE, os.X_OK),
+                        msg="test executable is not executable")
+
+    def check_drift(self, baseline, atol=ABSOLUTE_TOLERANCE):
+        # check if sample data exists
+        self.assertTrue(os.path.isfile(sample_data_filename(baseline)),
+                        msg="sample data does not exist")
+
+        # check if drift from sample data stays within tolerance
+        sample = load_sample_data(baseline)
+        testing = generate_testing_data(baseline)
+        self.assertEqual(sample.shape, testing.shape)
+        drift = np.max(np.abs(sample - testing), axis=0)
+        print(baseline + ": max drift from double precision: " +
+              np.array2string(drift))
+        assert_allclose(sample, testing, rtol=0, atol=atol,
+                        err_msg="drift from double precision is too large")
+
+    def test_com_regulation_vertical(self):
+        self.check_drift("com_regulation_vertical")
+
+    def test_com_oscillation(self):
+        self.check_drift("com_oscillation")
+
+    def test_com_longitudinal_moving(self):
+        self.check_drift("com_longitudinal_moving")
+
+    def test_com_sideward_moving(self):
+        self.check_drift("com_sideward_moving",
+                         SIDEWARD_MOVING_ABSOLUTE_TOLERANCE)
+
+    def test_com_regulation_with_disturbance(self):
+        self.check_drift("com_regulation_with_disturbance")
+
+
+if __name__ == '__main__':
+    unittest.main()
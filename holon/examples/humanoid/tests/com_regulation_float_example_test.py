@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import numpy as np
+from numpy.testing import assert_allclose
+from subprocess import Popen
+import os
+import unittest
+
+THIS_EXAMPLE_NAME = "com_regulation_float_example"
+BASELINE_EXAMPLE_NAME = "com_regulation_example"
+SAMPLE_DATA_FILENAME = os.path.join("data", BASELINE_EXAMPLE_NAME + ".dat")
+# tolerance of drift of single precision from the double precision baseline
+ABSOLUTE_TOLERANCE = 1.0e-6
+TESTING_DATA_FILENAME = os.path.join(".", THIS_EXAMPLE_NAME + ".dat")
+TEST_EXECUTABLE = os.path.join("..", THIS_EXAMPLE_NAME)
+
+
+def load_sample_data():
+    data = np.loadtxt(SAMPLE_DATA_FILENAME)
+    return data
+
+
+def generate_testing_data():
+    cmd = [TEST_EXECUTABLE]
+    with open(TESTING_DATA_FILENAME, 'w') as fobj:
+        proc = Popen(cmd, stdout=fobj)
+        proc.wait(timeout=1)
+    data = np.loadtxt(TESTING_DATA_FILENAME)
+    return data
+
+
+class TestComRegulationFloat(unittest.TestCase):
+
+    def test_result(self):
+        # check if sample data exists
+        self.assertTrue(os.path.isfile(SAMPLE_DATA_FILENAME),
+                        msg="sample data does not exist")
+
+        # check if excutable exists
+        self.assertTrue(os.path.isfile(TEST_EXECUTABLE),
+                        msg="test executable does not exist")
+        self.assertTrue(os.access(TEST_EXECUTABLE, os.X_OK),
+                        msg="test executable is not executable")
+
+        # check if drift from sample data stays within tolerance
+        sample = load_sample_data()
+        testing = generate_testing_data()
+        self.assertEqual(sample.shape, testing.shape)
+        drift = np.max(np.abs(sample - testing), axis=0)
+        print("max drift from double precision: " + np.array2string(drift))
+        assert_allclose(sample, testing, rtol=0, atol=ABSOLUTE_TOLERANCE,
+                        err_msg="drift from double precision is too large")
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Compare two whitespace-separated data files numerically.
+
+Every value of the testing data has to satisfy
+  |testing - sample| <= atol + rtol * |sample|
+which is the criterion of numpy.testing.assert_allclose, so that results
+are compared as the example tests do. Only the Python standard library is
+used so that the comparison runs where NumPy is not installed.
+
+Usage:
+  compare_data.py [--rtol RTOL] [--atol ATOL] SAMPLE TESTING
+"""
+
+import argparse
+import sys
+
+DEFAULT_RTOL = 1.0e-7
+DEFAULT_ATOL = 0.0
+
+
+def load_data(filename):
+    with open(filename) as fobj:
+        return [[float(v) for v in line.split()]
+                for line in fobj if line.strip()]
+
+
+def compare(sample, testing, rtol, atol):
+    if len(sample) != len(testing):
+        return ["number of rows differs: {} != {}".format(
+            len(sample), len(testing))]
+    errors = []
+    for i, (srow, trow) in enumerate(zip(sample, testing)):
+        if len(srow) != len(trow):
+            errors.append("row {}: number of columns differs: {} != {}"
+                          .format(i + 1, len(srow), len(trow)))
+            continue
+        for j, (s, t) in enumerate(zip(srow, trow)):
+            if abs(t - s) > atol + rtol * abs(s):
+                errors.append("row {}, column {}: {!r} != {!r}"
+                              .format(i + 1, j + 1, s, t))
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare two data files numerically.")
+    parser.add_argument("sample", help="sample data file")
+    parser.add_argument("testing", help="testing data file")
+    parser.add_argument("--rtol", type=float, default=DEFAULT_RTOL,
+                        help="relative tolerance (default: %(default)g)")
+    parser.add_argument("--atol", type=float, default=DEFAULT_ATOL,
+                        help="absolute tolerance (default: %(default)g)")
+    args = parser.parse_args()
+
+    errors = compare(load_data(args.sample), load_data(args.testing),
+                     args.rtol, args.atol)
+    for error in errors[:10]:
+        print(error)
+    if len(errors) > 10:
+        print("... and {} more mismatches".format(len(errors) - 10))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
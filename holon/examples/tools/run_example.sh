@@ -3,28 +3,52 @@
 if [[ -z "$1" ]]; then
   echo "usage:"
   echo "  ${0} <executalbe file path in example>"
+  echo "  ${0} <scenario file path> [holon_sim options]"
   echo "example:"
   echo "  ${0} holon/example/humanoid/com_regulation_example"
+  echo "  ${0} ../holon/examples/humanoid/scenarios/com_regulation.ztk"
   exit 1
 fi
 
+# A scenario file is run by `holon/tools/holon_sim`, and its data file and
+# script file are named after the corresponding example, i.e.
+# `holon/example/humanoid/com_regulation_example.dat` and
+# `holon/example/humanoid/tools/com_regulation_example_plot.py` for
+# `holon/examples/humanoid/scenarios/com_regulation.ztk`.
+if [[ "$1" == *.ztk ]]; then
+  SCENARIO="$1"
+  shift
+  SCENARIO_NAME=$(basename "$SCENARIO" .ztk)
+  SCENARIO_DIR=$(basename "$(dirname "$(dirname "$SCENARIO")")")
+  EXE_DIR="holon/examples/${SCENARIO_DIR}"
+  DAT_PATH="$EXE_DIR/${SCENARIO_NAME}_example.dat"
+  PLOT_SCRIPT="$EXE_DIR/tools/${SCENARIO_NAME}_example_plot.py"
+
+  if [[ -f CMakeCache.txt ]]; then
+    cmake --build . --target holon_sim -- -j4
+  fi
+  holon/tools/holon_sim "$@" -o "$DAT_PATH" "$SCENARIO" || exit 1
+fi
+
 # Assuming example to be executed is `holon/example/humanoid/com_regulation_example`,
 # data file should be `holon/example/humanoid/com_regulation_example.dat` and
 # script file should be `holon/example/humanoid/tools/com_regulation_example_plot.py`
-EXE_CMD="$1"
-EXE_FILENAME=$(basename "$EXE_CMD")
-EXE_DIR=$(dirname "$EXE_CMD")
-DAT_PATH="$EXE_DIR/${EXE_FILENAME}.dat"
-PLOT_SCRIPT="$EXE_DIR/tools/${EXE_FILENAME}_plot.py"
-
-if [[ -f CMakeCache.txt ]]; then
-  cmake --build . -- -j4
-fi
+if [[ -z "$SCENARIO" ]]; then
+  EXE_CMD="$1"
+  EXE_FILENAME=$(basename "$EXE_CMD")
+  EXE_DIR=$(dirname "$EXE_CMD")
+  DAT_PATH="$EXE_DIR/${EXE_FILENAME}.dat"
+  PLOT_SCRIPT="$EXE_DIR/tools/${EXE_FILENAME}_plot.py"
 
-if [[ -f $EXE_CMD ]]; then
-  $EXE_CMD > $DAT_PATH
-else
-  echo "$EXE_CMD does not exist."
+  if [[ -f CMakeCache.txt ]]; then
+    cmake --build . -- -j4
+  fi
+
+  if [[ -f $EXE_CMD ]]; then
+    $EXE_CMD > $DAT_PATH
+  else
+    echo "$EXE_CMD does not exist."
+  fi
 fi
 
 cmd_is_available () {
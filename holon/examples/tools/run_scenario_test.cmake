@@ -0,0 +1,36 @@
+# Run a scenario with holon_sim and compare its log with a sample data
+# numerically within tolerances RTOL and ATOL by compare_data.py.
+# Usage:
+#   cmake -DHOLON_SIM=/path/to/holon_sim -DSCENARIO=com_regulation.ztk \
+#     -DSAMPLE=data/com_regulation_example.dat \
+#     -DOUTPUT=com_regulation_scenario.dat \
+#     -DPYTHON_EXECUTABLE=/usr/bin/python3 -P run_scenario_test.cmake
+foreach(var HOLON_SIM SCENARIO SAMPLE OUTPUT PYTHON_EXECUTABLE)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not given")
+  endif()
+endforeach()
+if(NOT DEFINED RTOL)
+  set(RTOL 1.0e-7)
+endif()
+if(NOT DEFINED ATOL)
+  set(ATOL 1.0e-10)
+endif()
+
+execute_process(
+  COMMAND ${HOLON_SIM} -o ${OUTPUT} ${SCENARIO}
+  RESULT_VARIABLE result
+  )
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "holon_sim failed to run ${SCENARIO}")
+endif()
+
+get_filename_component(tools_dir ${CMAKE_CURRENT_LIST_FILE} DIRECTORY)
+execute_process(
+  COMMAND ${PYTHON_EXECUTABLE} ${tools_dir}/compare_data.py
+    --rtol ${RTOL} --atol ${ATOL} ${SAMPLE} ${OUTPUT}
+  RESULT_VARIABLE result
+  )
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OUTPUT} does not match ${SAMPLE}")
+endif()
@@ -0,0 +1,763 @@
+/* holon_module - Python bindings for batch rollouts of holon models
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Python.h should be included before any standard headers.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include "holon/corelib/common/optional.hpp"
+#include "holon/corelib/control/pd_ctrl.hpp"
+#include "holon/corelib/humanoid/batch_rollout.hpp"
+#include "holon/corelib/humanoid/com_ctrl.hpp"
+#include "holon/corelib/humanoid/com_zmp_model.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_data.hpp"
+
+namespace holon {
+namespace {
+
+// Buffer holds a C-contiguous float64 array exposed through the buffer
+// protocol, e.g. a NumPy array, and refers to its memory without a copy.
+// The exporter is locked against resizing until the buffer is released.
+class Buffer {
+ public:
+  Buffer() : m_acquired(false) {}
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+  ~Buffer() {
+    if (m_acquired) PyBuffer_Release(&m_view);
+  }
+
+  // A negative extent in t_shape accepts any size along the dimension.
+  bool acquire(PyObject* t_obj, const char* t_name, bool t_writable,
+               std::initializer_list<Py_ssize_t> t_shape) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+    if (t_writable) flags |= PyBUF_WRITABLE;
+    if (PyObject_GetBuffer(t_obj, &m_view, flags) != 0) return false;
+    m_acquired = true;
+    if (m_view.itemsize != sizeof(double) || !isDoubleFormat()) {
+      PyErr_Format(PyExc_TypeError, "%s must be an array of float64", t_name);
+      return false;
+    }
+    if (m_view.ndim != static_cast<int>(t_shape.size())) {
+      PyErr_Format(PyExc_ValueError, "%s must be a %d-dimensional array",
+                   t_name, static_cast<int>(t_shape.size()));
+      return false;
+    }
+    int i = 0;
+    for (auto extent : t_shape) {
+      if (extent >= 0 && m_view.shape[i] != extent) {
+        PyErr_Format(PyExc_ValueError,
+                     "%s must have %zd elements along axis %d (given: %zd)",
+                     t_name, extent, i, m_view.shape[i]);
+        return false;
+      }
+      ++i;
+    }
+    return true;
+  }
+
+  inline double* data() const { return static_cast<double*>(m_view.buf); }
+  inline Py_ssize_t shape(int t_axis) const { return m_view.shape[t_axis]; }
+  bool overlaps(const Buffer& t_buffer) const {
+    auto a = static_cast<const char*>(m_view.buf);
+    auto b = static_cast<const char*>(t_buffer.m_view.buf);
+    return m_view.len > 0 && t_buffer.m_view.len > 0 &&
+           std::less<const char*>()(a, b + t_buffer.m_view.len) &&
+           std::less<const char*>()(b, a + m_view.len);
+  }
+
+ private:
+  Py_buffer m_view;
+  bool m_acquired;
+
+  bool isDoubleFormat() const {
+    const char* f = m_view.format;
+    if (*f == '@' || *f == '=') ++f;
+    return std::strcmp(f, "d") == 0;
+  }
+};
+
+bool getBatchRollout(Py_ssize_t t_batch_num, Py_ssize_t t_step_num,
+                     double t_time_step, Py_ssize_t t_thread_num,
+                     BatchRollout* t_rollout) {
+  if (t_thread_num < 0) {
+    PyErr_SetString(PyExc_ValueError, "threads must be non-negative");
+    return false;
+  }
+  *t_rollout = BatchRollout{static_cast<std::size_t>(t_batch_num),
+                            static_cast<std::size_t>(t_step_num), t_time_step,
+                            static_cast<std::size_t>(t_thread_num)};
+  return true;
+}
+
+// the output is written while the inputs are read, so that it must not
+// share memory with them
+bool isDisjoint(const Buffer& t_out, const Buffer& t_initial,
+                const Buffer& t_input) {
+  if (!t_out.overlaps(t_initial) && !t_out.overlaps(t_input)) return true;
+  PyErr_SetString(PyExc_ValueError, "out must not overlap the inputs");
+  return false;
+}
+
+// runs a rollout without the GIL, so that other Python threads go on
+PyObject* run(bool (*t_rollout)(void*), void* t_args) {
+  PyThreadState* state = PyEval_SaveThread();
+  bool result = t_rollout(t_args);
+  PyEval_RestoreThread(state);
+  if (!result) {
+    PyErr_SetString(PyExc_ValueError, "rollout failed");
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+struct RolloutArgs {
+  BatchRollout rollout;
+  double mass;
+  double plant_mass;
+  const double* initial;
+  const double* input;
+  double* out;
+};
+
+PyObject* rollout_com_zmp_model(PyObject*, PyObject* t_args,
+                                PyObject* t_kwargs) {
+  using Layout = ComZmpModelRollout;
+  static const char* kwlist[] = {"initial", "zmp",  "out",    "dt",
+                                 "mass",    "threads", nullptr};
+  PyObject *initial_obj, *zmp_obj, *out_obj;
+  RolloutArgs a;
+  a.mass = ComZmpModelData::default_mass;
+  Py_ssize_t thread_num = 0;
+  if (!PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "OOOd|dn",
+                                   const_cast<char**>(kwlist), &initial_obj,
+                                   &zmp_obj, &out_obj, &a.rollout.time_step,
+                                   &a.mass, &thread_num))
+    return nullptr;
+  Buffer initial, zmp, out;
+  if (!initial.acquire(initial_obj, "initial", false,
+                       {-1, Layout::initial_size}))
+    return nullptr;
+  if (!zmp.acquire(zmp_obj, "zmp", false,
+                   {initial.shape(0), -1, Layout::input_size}))
+    return nullptr;
+  if (!out.acquire(out_obj, "out", true,
+                   {initial.shape(0), zmp.shape(1), Layout::output_size}))
+    return nullptr;
+  if (!isDisjoint(out, initial, zmp) ||
+      !getBatchRollout(initial.shape(0), zmp.shape(1), a.rollout.time_step,
+                       thread_num, &a.rollout))
+    return nullptr;
+  a.initial = initial.data();
+  a.input = zmp.data();
+  a.out = out.data();
+  return run(
+      [](void* p) {
+        auto* args = static_cast<RolloutArgs*>(p);
+        return rolloutComZmpModel(args->rollout, args->mass, args->initial,
+                                  args->input, args->out);
+      },
+      &a);
+}
+
+PyObject* rollout_com_ctrl(PyObject*, PyObject* t_args, PyObject* t_kwargs) {
+  using Layout = ComCtrlRollout;
+  static const char* kwlist[] = {"initial", "commands",   "out",
+                                 "dt",      "mass",       "plant_mass",
+                                 "threads", nullptr};
+  PyObject *initial_obj, *commands_obj, *out_obj;
+  PyObject* plant_mass_obj = Py_None;
+  RolloutArgs a;
+  a.mass = ComZmpModelData::default_mass;
+  Py_ssize_t thread_num = 0;
+  if (!PyArg_ParseTupleAndKeywords(
+          t_args, t_kwargs, "OOOd|dOn", const_cast<char**>(kwlist),
+          &initial_obj, &commands_obj, &out_obj, &a.rollout.time_step,
+          &a.mass, &plant_mass_obj, &thread_num))
+    return nullptr;
+  a.plant_mass = a.mass;
+  if (plant_mass_obj != Py_None) {
+    a.plant_mass = PyFloat_AsDouble(plant_mass_obj);
+    if (PyErr_Occurred()) return nullptr;
+  }
+  Buffer initial, commands, out;
+  if (!initial.acquire(initial_obj, "initial", false,
+                       {-1, Layout::initial_size}))
+    return nullptr;
+  if (!commands.acquire(commands_obj, "commands", false,
+                        {initial.shape(0), -1, Layout::input_size}))
+    return nullptr;
+  if (!out.acquire(out_obj, "out", true,
+                   {initial.shape(0), commands.shape(1), Layout::output_size}))
+    return nullptr;
+  if (!isDisjoint(out, initial, commands) ||
+      !getBatchRollout(initial.shape(0), commands.shape(1),
+                       a.rollout.time_step, thread_num, &a.rollout))
+    return nullptr;
+  a.initial = initial.data();
+  a.input = commands.data();
+  a.out = out.data();
+  return run(
+      [](void* p) {
+        auto* args = static_cast<RolloutArgs*>(p);
+        return rolloutComCtrl(args->rollout, args->mass, args->plant_mass,
+                              args->initial, args->input, args->out);
+      },
+      &a);
+}
+
+PyObject* rollout_pd_ctrl(PyObject*, PyObject* t_args, PyObject* t_kwargs) {
+  using Layout = PdCtrlRollout;
+  static const char* kwlist[] = {"initial", "refs", "out", "dt", "threads",
+                                 nullptr};
+  PyObject *initial_obj, *refs_obj, *out_obj;
+  RolloutArgs a;
+  Py_ssize_t thread_num = 0;
+  if (!PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "OOOd|n",
+                                   const_cast<char**>(kwlist), &initial_obj,
+                                   &refs_obj, &out_obj, &a.rollout.time_step,
+                                   &thread_num))
+    return nullptr;
+  Buffer initial, refs, out;
+  if (!initial.acquire(initial_obj, "initial", false,
+                       {-1, Layout::initial_size}))
+    return nullptr;
+  if (!refs.acquire(refs_obj, "refs", false,
+                    {initial.shape(0), Layout::input_size}))
+    return nullptr;
+  if (!out.acquire(out_obj, "out", true,
+                   {initial.shape(0), -1, Layout::output_size}))
+    return nullptr;
+  if (!isDisjoint(out, initial, refs) ||
+      !getBatchRollout(initial.shape(0), out.shape(1), a.rollout.time_step,
+                       thread_num, &a.rollout))
+    return nullptr;
+  a.initial = initial.data();
+  a.input = refs.data();
+  a.out = out.data();
+  return run(
+      [](void* p) {
+        auto* args = static_cast<RolloutArgs*>(p);
+        return rolloutPdCtrl(args->rollout, args->initial, args->input,
+                             args->out);
+      },
+      &a);
+}
+
+// methods taking keywords are stored as PyCFunction, through void (*)()
+// to tell the compiler that the cast is intended
+template <typename F>
+PyCFunction method(F t_f) {
+  return reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(t_f));
+}
+
+// Object wraps an instance of a class of holon allocated on the heap, since
+// controllers bind themselves to the callbacks of their models and cannot
+// be moved. Types are created from specs, so that they are heap types.
+template <typename T>
+struct Object {
+  PyObject_HEAD T* p;
+};
+
+template <typename T>
+T* self(PyObject* t_self) {
+  T* p = reinterpret_cast<Object<T>*>(t_self)->p;
+  if (!p) PyErr_SetString(PyExc_RuntimeError, "object is not initialized");
+  return p;
+}
+
+template <typename T>
+bool init(PyObject* t_self, T* t_p) {
+  auto* obj = reinterpret_cast<Object<T>*>(t_self);
+  delete obj->p;
+  obj->p = t_p;
+  return true;
+}
+
+template <typename T>
+void dealloc(PyObject* t_self) {
+  PyTypeObject* type = Py_TYPE(t_self);
+  delete reinterpret_cast<Object<T>*>(t_self)->p;
+  type->tp_free(t_self);
+#if PY_VERSION_HEX >= 0x03080000
+  Py_DECREF(type);
+#endif
+}
+
+PyObject* toTuple(const Vec3D& t_v) {
+  return Py_BuildValue("(ddd)", t_v.x(), t_v.y(), t_v.z());
+}
+
+// an optional argument, which is absent if it is None
+bool toOptional(PyObject* t_obj, optional<double>* t_value) {
+  if (t_obj == Py_None) {
+    *t_value = nullopt;
+    return true;
+  }
+  double value = PyFloat_AsDouble(t_obj);
+  if (PyErr_Occurred()) return false;
+  *t_value = value;
+  return true;
+}
+
+template <typename T>
+PyObject* update(PyObject* t_self, PyObject* t_args) {
+  T* p = self<T>(t_self);
+  double dt;
+  if (!p || !PyArg_ParseTuple(t_args, "d", &dt)) return nullptr;
+  if (!p->update(dt)) {
+    PyErr_SetString(PyExc_ValueError, "update failed");
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+template <typename T>
+PyObject* getTime(PyObject* t_self, void*) {
+  T* p = self<T>(t_self);
+  return p ? PyFloat_FromDouble(p->time()) : nullptr;
+}
+
+// states of ComZmpModel and ComCtrl, whose members are given by closures
+template <typename T>
+PyObject* getComZmpState(PyObject* t_self, void* t_closure) {
+  T* p = self<T>(t_self);
+  if (!p) return nullptr;
+  auto member = *static_cast<Vec3D ComZmpModelRawData::**>(t_closure);
+  return toTuple(p->states().*member);
+}
+
+Vec3D ComZmpModelRawData::*kComPosition = &ComZmpModelRawData::com_position;
+Vec3D ComZmpModelRawData::*kComVelocity = &ComZmpModelRawData::com_velocity;
+Vec3D ComZmpModelRawData::*kComAcceleration =
+    &ComZmpModelRawData::com_acceleration;
+Vec3D ComZmpModelRawData::*kZmpPosition = &ComZmpModelRawData::zmp_position;
+Vec3D ComZmpModelRawData::*kReactionForce =
+    &ComZmpModelRawData::reaction_force;
+
+template <typename T>
+PyGetSetDef* comZmpGetSet() {
+  static PyGetSetDef getset[] = {
+      {const_cast<char*>("time"), getTime<T>, nullptr, nullptr, nullptr},
+      {const_cast<char*>("com_position"), getComZmpState<T>, nullptr, nullptr,
+       &kComPosition},
+      {const_cast<char*>("com_velocity"), getComZmpState<T>, nullptr, nullptr,
+       &kComVelocity},
+      {const_cast<char*>("com_acceleration"), getComZmpState<T>, nullptr,
+       nullptr, &kComAcceleration},
+      {const_cast<char*>("zmp_position"), getComZmpState<T>, nullptr, nullptr,
+       &kZmpPosition},
+      {const_cast<char*>("reaction_force"), getComZmpState<T>, nullptr,
+       nullptr, &kReactionForce},
+      {nullptr, nullptr, nullptr, nullptr, nullptr}};
+  return getset;
+}
+
+// ComZmpModel
+int ComZmpModel_init(PyObject* t_self, PyObject* t_args, PyObject* t_kwargs) {
+  static const char* kwlist[] = {"com_position", "mass", nullptr};
+  Vec3D p = ComZmpModelData::default_com_position;
+  double mass = ComZmpModelData::default_mass;
+  if (!PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "|(ddd)d",
+                                   const_cast<char**>(kwlist), &p[0], &p[1],
+                                   &p[2], &mass))
+    return -1;
+  init(t_self, new ComZmpModel(p, mass));
+  return 0;
+}
+
+PyObject* ComZmpModel_reset(PyObject* t_self, PyObject* t_args) {
+  auto* p = self<ComZmpModel>(t_self);
+  Vec3D pos;
+  if (!p) return nullptr;
+  if (PyTuple_Size(t_args) == 0) {
+    p->reset();
+    Py_RETURN_NONE;
+  }
+  if (!PyArg_ParseTuple(t_args, "(ddd)", &pos[0], &pos[1], &pos[2]))
+    return nullptr;
+  p->reset(pos);
+  Py_RETURN_NONE;
+}
+
+PyObject* ComZmpModel_set_zmp_position(PyObject* t_self, PyObject* t_args,
+                                       PyObject* t_kwargs) {
+  static const char* kwlist[] = {"zmp_position", "reaction_force_z",
+                                 nullptr};
+  auto* p = self<ComZmpModel>(t_self);
+  Vec3D zmp;
+  PyObject* fz_obj = Py_None;
+  optional<double> fz;
+  if (!p ||
+      !PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "(ddd)|O",
+                                   const_cast<char**>(kwlist), &zmp[0],
+                                   &zmp[1], &zmp[2], &fz_obj) ||
+      !toOptional(fz_obj, &fz))
+    return nullptr;
+  p->setZmpPosition(zmp, fz);
+  Py_RETURN_NONE;
+}
+
+PyObject* ComZmpModel_set_reaction_force(PyObject* t_self, PyObject* t_args) {
+  auto* p = self<ComZmpModel>(t_self);
+  Vec3D f;
+  if (!p || !PyArg_ParseTuple(t_args, "(ddd)", &f[0], &f[1], &f[2]))
+    return nullptr;
+  p->setReactionForce(f);
+  Py_RETURN_NONE;
+}
+
+PyObject* ComZmpModel_set_external_force(PyObject* t_self, PyObject* t_args) {
+  auto* p = self<ComZmpModel>(t_self);
+  Vec3D f;
+  if (!p || !PyArg_ParseTuple(t_args, "(ddd)", &f[0], &f[1], &f[2]))
+    return nullptr;
+  p->setExternalForce(f);
+  Py_RETURN_NONE;
+}
+
+PyMethodDef kComZmpModelMethods[] = {
+    {"reset", ComZmpModel_reset, METH_VARARGS,
+     "reset(com_position=None)\n\n"
+     "Reset the time and the COM to the given or the initial position."},
+    {"set_zmp_position", method(ComZmpModel_set_zmp_position),
+     METH_VARARGS | METH_KEYWORDS,
+     "set_zmp_position(zmp_position, reaction_force_z=None)\n\n"
+     "Drive the model by the ZMP position. The vertical reaction force\n"
+     "defaults to the weight."},
+    {"set_reaction_force", ComZmpModel_set_reaction_force, METH_VARARGS,
+     "set_reaction_force(reaction_force)\n\n"
+     "Drive the model by the reaction force."},
+    {"set_external_force", ComZmpModel_set_external_force, METH_VARARGS,
+     "set_external_force(external_force)"},
+    {"update", update<ComZmpModel>, METH_VARARGS,
+     "update(dt)\n\nIntegrate the model over a time step."},
+    {nullptr, nullptr, 0, nullptr}};
+
+// ComCtrl
+int ComCtrl_init(PyObject* t_self, PyObject* t_args, PyObject* t_kwargs) {
+  static const char* kwlist[] = {"com_position", "mass", nullptr};
+  Vec3D p = ComCtrlData::default_com_position;
+  double mass = ComCtrlData::default_mass;
+  if (!PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "|(ddd)d",
+                                   const_cast<char**>(kwlist), &p[0], &p[1],
+                                   &p[2], &mass))
+    return -1;
+  init(t_self, new ComCtrl(ComZmpModel(p, mass)));
+  return 0;
+}
+
+PyObject* ComCtrl_reset(PyObject* t_self, PyObject* t_args,
+                        PyObject* t_kwargs) {
+  static const char* kwlist[] = {"com_position", "foot_dist", nullptr};
+  auto* p = self<ComCtrl>(t_self);
+  Vec3D pos;
+  PyObject* pos_obj = Py_None;
+  PyObject* dist_obj = Py_None;
+  optional<double> dist;
+  if (!p ||
+      !PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "|OO",
+                                   const_cast<char**>(kwlist), &pos_obj,
+                                   &dist_obj) ||
+      !toOptional(dist_obj, &dist))
+    return nullptr;
+  if (pos_obj == Py_None) {
+    if (dist) {
+      PyErr_SetString(PyExc_TypeError, "foot_dist needs com_position");
+      return nullptr;
+    }
+    p->reset();
+    Py_RETURN_NONE;
+  }
+  if (!PyArg_Parse(pos_obj, "(ddd)", &pos[0], &pos[1], &pos[2]))
+    return nullptr;
+  if (dist)
+    p->reset(pos, dist.value());
+  else
+    p->reset(pos);
+  Py_RETURN_NONE;
+}
+
+// commands given by keywords, each of which is cleared by None
+PyObject* ComCtrl_set_commands(PyObject* t_self, PyObject* t_args,
+                               PyObject* t_kwargs) {
+  using Commands = ComCtrlCommandsRawData;
+  static const struct {
+    const char* name;
+    optional<double> Commands::*member;
+  } kFields[] = {{"xd", &Commands::xd},   {"yd", &Commands::yd},
+                 {"zd", &Commands::zd},   {"vxd", &Commands::vxd},
+                 {"vyd", &Commands::vyd}, {"qx1", &Commands::qx1},
+                 {"qx2", &Commands::qx2}, {"qy1", &Commands::qy1},
+                 {"qy2", &Commands::qy2}, {"qz1", &Commands::qz1},
+                 {"qz2", &Commands::qz2}, {"rho", &Commands::rho},
+                 {"dist", &Commands::dist}, {"kr", &Commands::kr},
+                 {"vhp", &Commands::vhp}};
+  auto* p = self<ComCtrl>(t_self);
+  if (!p) return nullptr;
+  if (PyTuple_Size(t_args) != 0) {
+    PyErr_SetString(PyExc_TypeError, "commands must be given by keywords");
+    return nullptr;
+  }
+  if (!t_kwargs) Py_RETURN_NONE;
+  PyObject *key, *value;
+  Py_ssize_t pos = 0;
+  // validate all the commands before any of them is set
+  Commands commands = p->commands();
+  while (PyDict_Next(t_kwargs, &pos, &key, &value)) {
+    const char* name = PyUnicode_AsUTF8(key);
+    if (!name) return nullptr;
+    bool found = false;
+    for (const auto& field : kFields) {
+      if (std::strcmp(name, field.name) != 0) continue;
+      if (!toOptional(value, &(commands.*field.member))) return nullptr;
+      found = true;
+      break;
+    }
+    if (!found) {
+      PyErr_Format(PyExc_TypeError, "unknown command '%s'", name);
+      return nullptr;
+    }
+  }
+  *p->getCommands() = commands;
+  Py_RETURN_NONE;
+}
+
+PyObject* ComCtrl_clear_commands(PyObject* t_self, PyObject*) {
+  auto* p = self<ComCtrl>(t_self);
+  if (!p) return nullptr;
+  p->getCommands()->clear();
+  Py_RETURN_NONE;
+}
+
+PyObject* ComCtrl_feedback(PyObject* t_self, PyObject* t_args) {
+  auto* p = self<ComCtrl>(t_self);
+  Vec3D pos, vel;
+  if (!p || !PyArg_ParseTuple(t_args, "(ddd)(ddd)", &pos[0], &pos[1],
+                              &pos[2], &vel[0], &vel[1], &vel[2]))
+    return nullptr;
+  p->feedback(pos, vel);
+  Py_RETURN_NONE;
+}
+
+PyMethodDef kComCtrlMethods[] = {
+    {"reset", method(ComCtrl_reset), METH_VARARGS | METH_KEYWORDS,
+     "reset(com_position=None, foot_dist=None)\n\n"
+     "Reset the model to the given or the initial COM position."},
+    {"set_commands", method(ComCtrl_set_commands),
+     METH_VARARGS | METH_KEYWORDS,
+     "set_commands(**commands)\n\n"
+     "Set commands by keywords of xd, yd, zd, vxd, vyd, qx1, qx2, qy1, qy2,\n"
+     "qz1, qz2, rho, dist, kr and vhp. None clears a command."},
+    {"clear_commands", ComCtrl_clear_commands, METH_NOARGS,
+     "clear_commands()"},
+    {"feedback", ComCtrl_feedback, METH_VARARGS,
+     "feedback(com_position, com_velocity)\n\n"
+     "Feed back the COM state measured at the current step."},
+    {"update", update<ComCtrl>, METH_VARARGS,
+     "update(dt)\n\nUpdate the references and the internal model."},
+    {nullptr, nullptr, 0, nullptr}};
+
+// PdCtrl of a scalar point mass
+using ScalarPdCtrl = PdCtrl<double>;
+
+int PdCtrl_init(PyObject* t_self, PyObject* t_args, PyObject* t_kwargs) {
+  static const char* kwlist[] = {"position", "mass", nullptr};
+  double position = 0;
+  double mass = PdCtrlData<double>::default_mass;
+  if (!PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "|dd",
+                                   const_cast<char**>(kwlist), &position,
+                                   &mass))
+    return -1;
+  init(t_self, new ScalarPdCtrl(PointMassModel<double>(position, mass)));
+  return 0;
+}
+
+PyObject* PdCtrl_reset(PyObject* t_self, PyObject* t_args) {
+  auto* p = self<ScalarPdCtrl>(t_self);
+  PyObject* position_obj = Py_None;
+  optional<double> position;
+  if (!p || !PyArg_ParseTuple(t_args, "|O", &position_obj) ||
+      !toOptional(position_obj, &position))
+    return nullptr;
+  if (position)
+    p->reset(position.value());
+  else
+    p->reset();
+  Py_RETURN_NONE;
+}
+
+PyObject* PdCtrl_set_refs(PyObject* t_self, PyObject* t_args,
+                          PyObject* t_kwargs) {
+  static const char* kwlist[] = {"position", "velocity", "stiffness",
+                                 "damping", nullptr};
+  auto* p = self<ScalarPdCtrl>(t_self);
+  PyObject* objs[] = {Py_None, Py_None, Py_None, Py_None};
+  optional<double> refs[4];
+  if (!p || !PyArg_ParseTupleAndKeywords(t_args, t_kwargs, "|OOOO",
+                                         const_cast<char**>(kwlist), &objs[0],
+                                         &objs[1], &objs[2], &objs[3]))
+    return nullptr;
+  for (int i = 0; i < 4; ++i)
+    if (!toOptional(objs[i], &refs[i])) return nullptr;
+  if (refs[0]) p->refs().position = refs[0].value();
+  if (refs[1]) p->refs().velocity = refs[1].value();
+  if (refs[2]) p->refs().stiffness = refs[2].value();
+  if (refs[3]) p->refs().damping = refs[3].value();
+  Py_RETURN_NONE;
+}
+
+PyObject* getPointMassState(PyObject* t_self, void* t_closure) {
+  auto* p = self<ScalarPdCtrl>(t_self);
+  if (!p) return nullptr;
+  auto member = *static_cast<double PointMassModelRawData<double>::**>(
+      t_closure);
+  return PyFloat_FromDouble(p->states().*member);
+}
+
+double PointMassModelRawData<double>::*kPosition =
+    &PointMassModelRawData<double>::position;
+double PointMassModelRawData<double>::*kVelocity =
+    &PointMassModelRawData<double>::velocity;
+double PointMassModelRawData<double>::*kAcceleration =
+    &PointMassModelRawData<double>::acceleration;
+double PointMassModelRawData<double>::*kForce =
+    &PointMassModelRawData<double>::force;
+
+PyGetSetDef kPdCtrlGetSet[] = {
+    {const_cast<char*>("time"), getTime<ScalarPdCtrl>, nullptr, nullptr,
+     nullptr},
+    {const_cast<char*>("position"), getPointMassState, nullptr, nullptr,
+     &kPosition},
+    {const_cast<char*>("velocity"), getPointMassState, nullptr, nullptr,
+     &kVelocity},
+    {const_cast<char*>("acceleration"), getPointMassState, nullptr, nullptr,
+     &kAcceleration},
+    {const_cast<char*>("force"), getPointMassState, nullptr, nullptr,
+     &kForce},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyMethodDef kPdCtrlMethods[] = {
+    {"reset", PdCtrl_reset, METH_VARARGS,
+     "reset(position=None)\n\n"
+     "Reset the mass to the given or the initial position at rest."},
+    {"set_refs", method(PdCtrl_set_refs), METH_VARARGS | METH_KEYWORDS,
+     "set_refs(position=None, velocity=None, stiffness=None, damping=None)\n"
+     "\nSet the given references and keep the others."},
+    {"update", update<ScalarPdCtrl>, METH_VARARGS,
+     "update(dt)\n\nIntegrate the controlled mass over a time step."},
+    {nullptr, nullptr, 0, nullptr}};
+
+template <typename T>
+bool addType(PyObject* t_module, const char* t_name, const char* t_doc,
+             initproc t_init, PyMethodDef* t_methods, PyGetSetDef* t_getset) {
+  PyType_Slot slots[] = {
+      {Py_tp_doc, const_cast<char*>(t_doc)},
+      {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+      {Py_tp_init, reinterpret_cast<void*>(t_init)},
+      {Py_tp_dealloc, reinterpret_cast<void*>(dealloc<T>)},
+      {Py_tp_methods, t_methods},
+      {Py_tp_getset, t_getset},
+      {0, nullptr}};
+  PyType_Spec spec = {t_name, sizeof(Object<T>), 0, Py_TPFLAGS_DEFAULT,
+                      slots};
+  PyObject* type = PyType_FromSpec(&spec);
+  if (!type) return false;
+  if (PyModule_AddObject(t_module, std::strchr(t_name, '.') + 1, type) != 0) {
+    Py_DECREF(type);
+    return false;
+  }
+  return true;
+}
+
+bool addTypes(PyObject* t_module) {
+  return addType<ComZmpModel>(
+             t_module, "holon.ComZmpModel",
+             "ComZmpModel(com_position=(0, 0, 1), mass=1)\n\n"
+             "COM-ZMP model, whose states are read as attributes.",
+             ComZmpModel_init, kComZmpModelMethods,
+             comZmpGetSet<ComZmpModel>()) &&
+         addType<ComCtrl>(
+             t_module, "holon.ComCtrl",
+             "ComCtrl(com_position=(0, 0, 1), mass=1)\n\n"
+             "COM controller, whose internal model states are read as\n"
+             "attributes.",
+             ComCtrl_init, kComCtrlMethods, comZmpGetSet<ComCtrl>()) &&
+         addType<ScalarPdCtrl>(
+             t_module, "holon.PdCtrl",
+             "PdCtrl(position=0, mass=1)\n\n"
+             "PD controller of a scalar point mass, whose states are read as\n"
+             "attributes.",
+             PdCtrl_init, kPdCtrlMethods, kPdCtrlGetSet);
+}
+
+PyMethodDef kMethods[] = {
+    {"rollout_com_zmp_model",
+     method(rollout_com_zmp_model),
+     METH_VARARGS | METH_KEYWORDS,
+     "rollout_com_zmp_model(initial, zmp, out, dt, mass=..., threads=0)\n\n"
+     "Roll out ComZmpModel driven by ZMP positions.\n"
+     "initial: (batch, 6) COM position and velocity\n"
+     "zmp:     (batch, steps, 3) ZMP position at each step\n"
+     "out:     (batch, steps, 6) COM position and velocity, written in place"},
+    {"rollout_com_ctrl", method(rollout_com_ctrl),
+     METH_VARARGS | METH_KEYWORDS,
+     "rollout_com_ctrl(initial, commands, out, dt, mass=..., plant_mass=None,"
+     "\n                 threads=0)\n\n"
+     "Roll out ComCtrl driving ComZmpModel plants by the desired ZMP in a\n"
+     "closed loop. The plant mass defaults to the mass of the controller.\n"
+     "initial:  (batch, 6) COM position and velocity of the plant\n"
+     "commands: (batch, steps, 11) xd, yd, zd, vxd, vyd, qx1, qx2, qy1, qy2,\n"
+     "          qz1, qz2 at each step\n"
+     "out:      (batch, steps, 9) COM position, COM velocity and ZMP\n"
+     "          position of the plant, written in place"},
+    {"rollout_pd_ctrl", method(rollout_pd_ctrl),
+     METH_VARARGS | METH_KEYWORDS,
+     "rollout_pd_ctrl(initial, refs, out, dt, threads=0)\n\n"
+     "Roll out PdCtrl of scalar point masses.\n"
+     "initial: (batch, 2) position and velocity\n"
+     "refs:    (batch, 5) position, velocity, stiffness, damping and mass\n"
+     "out:     (batch, steps, 3) position, velocity and force, written in\n"
+     "         place"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef kModule = {
+    PyModuleDef_HEAD_INIT, "holon",
+    "Batch rollouts of holon models into caller-provided float64 arrays and\n"
+    "bindings of ComZmpModel, ComCtrl and PdCtrl.\n\n"
+    "Arrays are taken through the buffer protocol without copies and must\n"
+    "be C-contiguous. Rollouts run without the GIL on `threads` threads\n"
+    "(0 uses the hardware concurrency).",
+    -1, kMethods, nullptr, nullptr, nullptr, nullptr};
+
+}  // namespace
+}  // namespace holon
+
+PyMODINIT_FUNC PyInit_holon() {
+  PyObject* module = PyModule_Create(&holon::kModule);
+  if (module && !holon::addTypes(module)) {
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import numpy as np
+from numpy.testing import assert_allclose
+import os
+import sys
+import threading
+import unittest
+
+# the module is built in the parent directory
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+import holon  # noqa: E402
+
+DT = 0.01
+STEPS = 500
+
+
+class TestComZmpModelRollout(unittest.TestCase):
+
+    def test_fixed_zmp(self):
+        # COM stays still right above ZMP
+        initial = np.array([[0.1, -0.1, 1, 0, 0, 0],
+                            [0, 0, 0.8, 0, 0, 0]])
+        zmp = np.zeros((2, STEPS, 3))
+        zmp[0, :] = [0.1, -0.1, 0]
+        out = np.full((2, STEPS, 6), np.nan)
+        holon.rollout_com_zmp_model(initial, zmp, out, DT)
+        assert_allclose(out[:, -1], initial, atol=1e-12)
+
+    def test_shape_mismatch(self):
+        initial = np.zeros((2, 6))
+        with self.assertRaises(ValueError):
+            holon.rollout_com_zmp_model(initial, np.zeros((3, STEPS, 3)),
+                                        np.zeros((2, STEPS, 6)), DT)
+        with self.assertRaises(TypeError):
+            holon.rollout_com_zmp_model(initial, np.zeros((2, STEPS, 3)),
+                                        np.zeros((2, STEPS, 6), np.float32),
+                                        DT)
+        with self.assertRaises(BufferError):
+            holon.rollout_com_zmp_model(initial, np.zeros((2, STEPS, 3)),
+                                        np.zeros((2, STEPS, 12))[:, :, ::2],
+                                        DT)
+
+    def test_overlap(self):
+        initial = np.zeros((2, 6))
+        buf = np.zeros(2 * STEPS * 9)
+        zmp = buf[:2 * STEPS * 3].reshape(2, STEPS, 3)
+        with self.assertRaises(ValueError):
+            holon.rollout_com_zmp_model(
+                initial, zmp, buf[-2 * STEPS * 6 - 3:-3].reshape(2, STEPS, 6),
+                DT)
+        holon.rollout_com_zmp_model(
+            initial, zmp, buf[-2 * STEPS * 6:].reshape(2, STEPS, 6), DT)
+
+
+class TestComCtrlRollout(unittest.TestCase):
+
+    def setUp(self):
+        batch = 8
+        self.initial = np.tile([0.1, -0.1, 1, 0, 0, 0], (batch, 1))
+        # tune the gains along x
+        self.commands = np.tile([0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1],
+                                (batch, STEPS, 1))
+        self.commands[:, :, 5] = np.linspace(0.5, 2, batch)[:, None]
+        self.commands[:, :, 6] = np.linspace(0.5, 2, batch)[:, None]
+
+    def test_regulation(self):
+        out = np.zeros((len(self.initial), STEPS, 9))
+        holon.rollout_com_ctrl(self.initial, self.commands, out, DT)
+        assert_allclose(out[:, -1, 0:3], self.commands[:, -1, 0:3],
+                        atol=1e-3)
+
+    def test_command_timeline(self):
+        # the reference is stepped after a quarter of the steps
+        self.initial[:, 0] = 0
+        self.commands[:, STEPS // 4:, 0] = 0.05
+        out = np.zeros((len(self.initial), STEPS, 9))
+        holon.rollout_com_ctrl(self.initial, self.commands, out, DT)
+        assert_allclose(out[:, STEPS // 4 - 1, 0], 0, atol=1e-12)
+        assert_allclose(out[:, -1, 0], 0.05, atol=2e-3)
+
+    def test_plant_mass(self):
+        # the heavier plant sinks below the commanded height
+        out = np.zeros((len(self.initial), STEPS, 9))
+        holon.rollout_com_ctrl(self.initial, self.commands, out, DT,
+                               plant_mass=1.5)
+        self.assertTrue(np.all(out[:, -1, 2] < 1 - 1e-3))
+
+    def test_threads(self):
+        out1 = np.zeros((len(self.initial), STEPS, 9))
+        out4 = np.zeros((len(self.initial), STEPS, 9))
+        holon.rollout_com_ctrl(self.initial, self.commands, out1, DT,
+                               threads=1)
+        holon.rollout_com_ctrl(self.initial, self.commands, out4, DT,
+                               threads=4)
+        np.testing.assert_array_equal(out1, out4)
+
+    def test_release_gil(self):
+        # rollouts from Python threads run concurrently
+        outs = [np.zeros((len(self.initial), STEPS, 9)) for _ in range(4)]
+        threads = [threading.Thread(target=holon.rollout_com_ctrl,
+                                    args=(self.initial, self.commands, out,
+                                          DT),
+                                    kwargs={"threads": 1})
+                   for out in outs]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for out in outs[1:]:
+            np.testing.assert_array_equal(outs[0], out)
+
+
+class TestPdCtrlRollout(unittest.TestCase):
+
+    def test_convergence(self):
+        initial = np.array([[0, 0], [1, 0.5], [-1, 0]])
+        refs = np.array([[1, 0, 10, 5, 1],
+                         [0, 0, 20, 8, 2],
+                         [0.5, 0, 40, 12, 1]])
+        out = np.zeros((3, STEPS, 3))
+        holon.rollout_pd_ctrl(initial, refs, out, DT)
+        assert_allclose(out[:, -1, 0], refs[:, 0], atol=1e-3)
+
+    def test_invalid_values(self):
+        initial = np.zeros((1, 2))
+        out = np.zeros((1, STEPS, 3))
+        with self.assertRaises(ValueError):
+            holon.rollout_pd_ctrl(initial, np.array([[0, 0, 1, 1, 0]]), out,
+                                  DT)
+        with self.assertRaises(ValueError):
+            holon.rollout_pd_ctrl(initial, np.array([[0, 0, 1, 1, 1]]), out,
+                                  DT, threads=-1)
+
+
+class TestClasses(unittest.TestCase):
+
+    def test_com_zmp_model(self):
+        model = holon.ComZmpModel((0.1, -0.1, 1), mass=2)
+        model.set_zmp_position((0.1, -0.1, 0))
+        for _ in range(10):
+            model.update(DT)
+        self.assertAlmostEqual(model.time, 10 * DT)
+        assert_allclose(model.com_position, (0.1, -0.1, 1), atol=1e-12)
+        assert_allclose(model.reaction_force, (0, 0, 2 * 9.80665),
+                        rtol=1e-6)
+        model.reset((0, 0, 0.8))
+        self.assertEqual(model.time, 0)
+        self.assertEqual(model.com_position, (0, 0, 0.8))
+
+    def test_com_ctrl(self):
+        # the same as a rollout of the controller with a plant
+        ctrl = holon.ComCtrl((0.1, -0.1, 1))
+        plant = holon.ComZmpModel((0.1, -0.1, 1))
+        out = np.zeros((1, STEPS, 9))
+        commands = np.tile([0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1], (1, STEPS, 1))
+        holon.rollout_com_ctrl(np.array([[0.1, -0.1, 1, 0, 0, 0]]),
+                               commands, out, DT)
+        for k in range(STEPS):
+            ctrl.feedback(plant.com_position, plant.com_velocity)
+            ctrl.set_commands(xd=0, yd=0, zd=1, vxd=0, vyd=0, qx1=1, qx2=1,
+                              qy1=1, qy2=1, qz1=1, qz2=1)
+            ctrl.update(DT)
+            plant.set_zmp_position(ctrl.zmp_position, ctrl.reaction_force[2])
+            plant.update(DT)
+            np.testing.assert_array_equal(out[0, k, 0:3], plant.com_position)
+        with self.assertRaises(TypeError):
+            ctrl.set_commands(xe=0)
+        ctrl.clear_commands()
+
+    def test_pd_ctrl(self):
+        ctrl = holon.PdCtrl(0, mass=2)
+        ctrl.set_refs(position=1, stiffness=10, damping=5)
+        for _ in range(STEPS):
+            ctrl.update(DT)
+        self.assertAlmostEqual(ctrl.position, 1, places=3)
+        ctrl.reset(0.5)
+        self.assertEqual((ctrl.position, ctrl.velocity), (0.5, 0))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,168 @@
+/* formula_fuzzer - fuzz target for formula kernels of COM controller
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Entry point for libFuzzer. Input bytes are decoded into double-precision
+// arguments, and properties that reference and optimized implementations
+// must share are checked on them. A violated property aborts the program.
+//
+// With Clang:
+//   cmake -DHOLON_BUILD_FUZZERS=ON -DCMAKE_CXX_COMPILER=clang++ ..
+//   ./formula_fuzzer -max_total_time=60 corpus/
+// Otherwise it is built with a standalone driver, which runs the inputs
+// given as files, or random inputs if no file is given.
+
+#include <roki/rk_g.h>
+#include <zm/zm_misc.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "holon/corelib/humanoid/com_ctrl/com_ctrl_x.hpp"
+#include "holon/corelib/humanoid/com_ctrl/phase_y.hpp"
+#include "holon/corelib/humanoid/com_zmp_model/com_zmp_model_formula.hpp"
+
+namespace holon {
+namespace {
+
+const std::size_t kArgNum = 8;
+
+void check(bool t_condition, const char* t_property, const double* t_x) {
+  if (t_condition) return;
+  std::fprintf(stderr, "property violated: %s\n  input:", t_property);
+  for (std::size_t i = 0; i < kArgNum; ++i)
+    std::fprintf(stderr, " %.17g", t_x[i]);
+  std::fprintf(stderr, "\n");
+  std::abort();
+}
+
+bool same(double t_a, double t_b) {
+  return (std::isnan(t_a) && std::isnan(t_b)) ||
+         std::memcmp(&t_a, &t_b, sizeof(double)) == 0;
+}
+
+bool bounded(const double* t_x, double t_bound) {
+  for (std::size_t i = 0; i < kArgNum; ++i)
+    if (!(std::fabs(t_x[i]) <= t_bound)) return false;
+  return true;
+}
+
+void checkComCtrlX(const double* x) {
+  using com_ctrl_x::computeDesZmpPos;
+  com_ctrl_x::Parameters params = {x[2], x[3], x[4], x[5], x[6]};
+  double ref = computeDesZmpPos<double>(x[0], x[1], x[2], x[3], x[4], x[5],
+                                        x[6]);
+  check(same(computeDesZmpPos(Vec3D(x[0], 0, 0), Vec3D(x[1], 0, 0), params),
+             ref),
+        "com_ctrl_x: Vec3D and scalar versions agree", x);
+  if (zIsTiny(x[6]) || x[6] < 0)
+    check(ref == 0, "com_ctrl_x: zero for non-positive zeta", x);
+  if (bounded(x, 1e6)) {
+    // inputs within the range of float do not lead to NaN only in float
+    float f = computeDesZmpPos<float>(x[0], x[1], x[2], x[3], x[4], x[5],
+                                      x[6]);
+    double d = computeDesZmpPos<double>(float(x[0]), float(x[1]), float(x[2]),
+                                        float(x[3]), float(x[4]), float(x[5]),
+                                        float(x[6]));
+    check(std::isnan(f) == std::isnan(d),
+          "com_ctrl_x: float and double agree on NaN", x);
+  }
+}
+
+void checkPhaseY(const double* x) {
+  double phase = phase_y::computePhase<double>(x[0], x[1], x[2], x[3], x[4],
+                                               x[5], x[6], 1);
+  check(std::isnan(phase) || (phase >= 0 && phase <= 1),
+        "phase_y: phase is within [0, 1]", x);
+}
+
+void checkComAcc(const double* x) {
+  namespace formula = com_zmp_model_formula;
+  Vec3D p(x[0], x[1], x[2]), pz(x[3], x[4], 0);
+  double sqr_zeta = x[5], mass = x[6];
+  if (!bounded(x, 1e6) || mass < 1e-3) return;
+  Vec3D f = formula::computeReactForce(p, pz, sqr_zeta, mass);
+  Vec3D acc1 = formula::computeComAcc(f, mass);
+  Vec3D acc2 = formula::computeComAcc(p, pz, sqr_zeta, mass);
+  for (std::size_t i = 0; i < 3; ++i) {
+    // tolerance relative to magnitudes of the terms
+    double scale = std::fabs(sqr_zeta * (p[i] - pz[i])) + RK_G;
+    check(std::fabs(acc1[i] - acc2[i]) <= 1e-12 * scale,
+          "com_zmp_model_formula: COM acceleration through reaction force and "
+          "through zeta agree",
+          x);
+  }
+}
+
+}  // namespace
+}  // namespace holon
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+  zEchoOff();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  double x[holon::kArgNum] = {};
+  std::memcpy(x, data, std::min(size, sizeof(x)));
+  holon::checkComCtrlX(x);
+  holon::checkPhaseY(x);
+  holon::checkComAcc(x);
+  return 0;
+}
+
+#ifdef HOLON_FUZZER_STANDALONE
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+  LLVMFuzzerInitialize(&argc, &argv);
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) {
+      std::ifstream ifs(argv[i], std::ios::binary);
+      std::vector<char> buf((std::istreambuf_iterator<char>(ifs)),
+                            std::istreambuf_iterator<char>());
+      LLVMFuzzerTestOneInput(
+          reinterpret_cast<const std::uint8_t*>(buf.data()), buf.size());
+    }
+    return 0;
+  }
+  // random inputs: raw bit patterns mixed with values of moderate size
+  std::mt19937_64 engine(0);
+  std::uniform_real_distribution<double> dist(-2, 2);
+  for (int n = 0; n < 1000000; ++n) {
+    double x[holon::kArgNum];
+    for (auto& v : x) {
+      std::uint64_t bits = engine();
+      if (bits % 4 == 0)
+        std::memcpy(&v, &bits, sizeof(double));
+      else
+        v = dist(engine);
+    }
+    LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(x),
+                           sizeof(x));
+  }
+  return 0;
+}
+#endif
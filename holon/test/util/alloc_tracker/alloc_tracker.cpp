@@ -0,0 +1,149 @@
+/* alloc_tracker - allocation tracker for real-time safety tests
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define HOLON_ALLOC_TRACKER_MALLOC 1
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void __libc_free(void*);
+}
+#else
+#define HOLON_ALLOC_TRACKER_MALLOC 0
+#endif
+
+namespace {
+
+// counters are trivial so that accessing them never allocates
+thread_local std::size_t allocation_counter = 0;
+thread_local std::size_t deallocation_counter = 0;
+
+// allocate and free without being counted
+inline void* raw_malloc(std::size_t size) {
+#if HOLON_ALLOC_TRACKER_MALLOC
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+inline void raw_free(void* ptr) {
+#if HOLON_ALLOC_TRACKER_MALLOC
+  __libc_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void* tracked_new(std::size_t size) {
+  ++allocation_counter;
+  if (size == 0) size = 1;
+  while (true) {
+    if (void* ptr = raw_malloc(size)) return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void tracked_delete(void* ptr) noexcept {
+  if (!ptr) return;
+  ++deallocation_counter;
+  raw_free(ptr);
+}
+
+}  // namespace
+
+#if HOLON_ALLOC_TRACKER_MALLOC
+extern "C" {
+
+void* malloc(std::size_t size) {
+  ++allocation_counter;
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size) {
+  ++allocation_counter;
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size) {
+  ++allocation_counter;
+  if (ptr) ++deallocation_counter;
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+  if (ptr) ++deallocation_counter;
+  __libc_free(ptr);
+}
+
+}  // extern "C"
+#endif
+
+void* operator new(std::size_t size) { return tracked_new(size); }
+void* operator new[](std::size_t size) { return tracked_new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return tracked_new(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+void operator delete(void* ptr) noexcept { tracked_delete(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  tracked_delete(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  tracked_delete(ptr);
+}
+
+namespace holon {
+namespace alloc_tracker {
+
+std::size_t allocation_count() noexcept { return allocation_counter; }
+std::size_t deallocation_count() noexcept { return deallocation_counter; }
+bool tracks_malloc() noexcept { return HOLON_ALLOC_TRACKER_MALLOC != 0; }
+
+}  // namespace alloc_tracker
+
+NoAllocRegion::NoAllocRegion() noexcept
+    : m_allocation_count(alloc_tracker::allocation_count()),
+      m_deallocation_count(alloc_tracker::deallocation_count()) {}
+
+std::size_t NoAllocRegion::allocations() const noexcept {
+  return alloc_tracker::allocation_count() - m_allocation_count;
+}
+
+std::size_t NoAllocRegion::deallocations() const noexcept {
+  return alloc_tracker::deallocation_count() - m_deallocation_count;
+}
+
+}  // namespace holon
@@ -0,0 +1,81 @@
+/* alloc_tracker - allocation tracker for real-time safety tests
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_TEST_UTIL_ALLOC_TRACKER_ALLOC_TRACKER_HPP_
+#define HOLON_TEST_UTIL_ALLOC_TRACKER_ALLOC_TRACKER_HPP_
+
+#include <cstddef>
+#include "third_party/catch/catch.hpp"
+
+namespace holon {
+namespace alloc_tracker {
+
+// Numbers of heap allocations and deallocations done by the calling thread.
+// Global operator new/delete are replaced in test programs, and malloc,
+// calloc, realloc and free are interposed as well where the C library
+// allows it (glibc).
+std::size_t allocation_count() noexcept;
+std::size_t deallocation_count() noexcept;
+
+// Returns true if malloc and free are tracked besides operator new/delete.
+bool tracks_malloc() noexcept;
+
+}  // namespace alloc_tracker
+
+// Scoped region to count allocations done by the calling thread from its
+// construction.
+class NoAllocRegion {
+ public:
+  NoAllocRegion() noexcept;
+
+  // special member functions
+  NoAllocRegion(const NoAllocRegion&) = delete;
+  NoAllocRegion& operator=(const NoAllocRegion&) = delete;
+
+  std::size_t allocations() const noexcept;
+  std::size_t deallocations() const noexcept;
+
+ private:
+  std::size_t m_allocation_count;
+  std::size_t m_deallocation_count;
+};
+
+}  // namespace holon
+
+// Assert that the given statements neither allocate nor free heap memory.
+// Usage:
+//   model.update();  // warmup
+//   REQUIRE_NO_ALLOCATIONS(model.update());
+#define HOLON_ASSERT_NO_ALLOCATIONS(assertion, ...)    \
+  do {                                                 \
+    ::holon::NoAllocRegion holon_no_alloc_region;      \
+    __VA_ARGS__;                                       \
+    const std::size_t holon_allocations =              \
+        holon_no_alloc_region.allocations();           \
+    const std::size_t holon_deallocations =            \
+        holon_no_alloc_region.deallocations();         \
+    assertion(holon_allocations == 0);                 \
+    assertion(holon_deallocations == 0);               \
+  } while (false)
+#define REQUIRE_NO_ALLOCATIONS(...) \
+  HOLON_ASSERT_NO_ALLOCATIONS(REQUIRE, __VA_ARGS__)
+#define CHECK_NO_ALLOCATIONS(...) HOLON_ASSERT_NO_ALLOCATIONS(CHECK, __VA_ARGS__)
+
+#endif  // HOLON_TEST_UTIL_ALLOC_TRACKER_ALLOC_TRACKER_HPP_
@@ -0,0 +1,91 @@
+/* alloc_tracker - allocation tracker for real-time safety tests
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/alloc_tracker/alloc_tracker.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("NoAllocRegion counts operator new and delete",
+          "[test][util][alloc_tracker]") {
+  NoAllocRegion region;
+  REQUIRE(region.allocations() == 0);
+  REQUIRE(region.deallocations() == 0);
+  int* p = new int(1);
+  CHECK(region.allocations() == 1);
+  delete p;
+  CHECK(region.deallocations() == 1);
+  double* a = new double[4];
+  CHECK(region.allocations() == 2);
+  delete[] a;
+  CHECK(region.deallocations() == 2);
+}
+
+TEST_CASE("NoAllocRegion counts allocations by standard containers",
+          "[test][util][alloc_tracker]") {
+  NoAllocRegion region;
+  {
+    std::vector<double> v;
+    for (auto i = 0; i < 10; ++i) v.push_back(i);
+    CHECK(region.allocations() > 0);
+  }
+  CHECK(region.deallocations() == region.allocations());
+}
+
+TEST_CASE("NoAllocRegion counts malloc and free",
+          "[test][util][alloc_tracker]") {
+  if (!alloc_tracker::tracks_malloc()) return;
+  NoAllocRegion region;
+  void* p = std::malloc(16);
+  CHECK(region.allocations() == 1);
+  p = std::realloc(p, 32);
+  CHECK(region.allocations() == 2);
+  CHECK(region.deallocations() == 1);
+  std::free(p);
+  CHECK(region.deallocations() == 2);
+  std::free(nullptr);
+  CHECK(region.deallocations() == 2);
+}
+
+TEST_CASE("nested NoAllocRegion counts from its own construction",
+          "[test][util][alloc_tracker]") {
+  NoAllocRegion outer;
+  std::unique_ptr<int> p(new int(0));
+  NoAllocRegion inner;
+  CHECK(outer.allocations() == 1);
+  CHECK(inner.allocations() == 0);
+}
+
+TEST_CASE("REQUIRE_NO_ALLOCATIONS passes for statements without allocation",
+          "[test][util][alloc_tracker]") {
+  std::vector<double> v(10);
+  REQUIRE_NO_ALLOCATIONS(for (auto& x : v) x += 1);
+  CHECK_NO_ALLOCATIONS(v[0] = 2, v[1] = 3);
+  CHECK(v[0] == 2);
+  CHECK(v[1] == 3);
+}
+
+}  // namespace
+}  // namespace holon
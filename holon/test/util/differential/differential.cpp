@@ -0,0 +1,87 @@
+/* differential - differential and property testing of numerical kernels
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/differential/differential.hpp"
+
+#include <cstdlib>
+#include <limits>
+
+namespace holon {
+
+namespace {
+
+using limits = std::numeric_limits<double>;
+
+const double kEdgeCases[] = {0.0,
+                             -0.0,
+                             limits::min(),
+                             -limits::min(),
+                             limits::denorm_min(),
+                             -limits::denorm_min(),
+                             limits::epsilon(),
+                             -limits::epsilon(),
+                             1e-300,
+                             -1e-300,
+                             1e300,
+                             -1e300,
+                             limits::max(),
+                             -limits::max(),
+                             limits::infinity(),
+                             -limits::infinity(),
+                             limits::quiet_NaN()};
+
+}  // namespace
+
+EdgeCaseFuzzer::EdgeCaseFuzzer(double t_min, double t_max,
+                               double t_edge_case_rate)
+    : m_uniform(0, 1),
+      m_min(t_min),
+      m_max(t_max),
+      m_edge_case_rate(t_edge_case_rate) {}
+
+EdgeCaseFuzzer::EdgeCaseFuzzer(const std::seed_seq& t_seed, double t_min,
+                               double t_max, double t_edge_case_rate)
+    : m_uniform(t_seed, 0, 1),
+      m_min(t_min),
+      m_max(t_max),
+      m_edge_case_rate(t_edge_case_rate) {}
+
+double EdgeCaseFuzzer::operator()() {
+  if (m_uniform() >= m_edge_case_rate)
+    return m_min + (m_max - m_min) * m_uniform();
+  std::size_t i = std::size_t(m_uniform() * edge_case_num());
+  return kEdgeCases[i < edge_case_num() ? i : edge_case_num() - 1];
+}
+
+const double* EdgeCaseFuzzer::edge_cases() { return kEdgeCases; }
+
+std::size_t EdgeCaseFuzzer::edge_case_num() {
+  return sizeof(kEdgeCases) / sizeof(kEdgeCases[0]);
+}
+
+std::size_t fuzz_sample_count(std::size_t t_default) {
+  const char* env = std::getenv("HOLON_FUZZ_SAMPLES");
+  if (!env) return t_default;
+  char* end;
+  unsigned long n = std::strtoul(env, &end, 10);
+  return (end == env || n == 0) ? t_default : std::size_t(n);
+}
+
+}  // namespace holon
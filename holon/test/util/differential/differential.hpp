@@ -0,0 +1,119 @@
+/* differential - differential and property testing of numerical kernels
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_TEST_UTIL_DIFFERENTIAL_DIFFERENTIAL_HPP_
+#define HOLON_TEST_UTIL_DIFFERENTIAL_DIFFERENTIAL_HPP_
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "holon/test/util/differential/ulp.hpp"
+#include "holon/test/util/fuzzer/fuzzer.hpp"
+#include "third_party/catch/catch.hpp"
+
+namespace holon {
+
+// Generates uniform random values as Fuzzer does, but replaces them at the
+// given rate with edge cases: signed zeros, tiny and subnormal numbers,
+// huge numbers, infinities and NaN.
+class EdgeCaseFuzzer {
+ public:
+  // constructors
+  EdgeCaseFuzzer(double t_min, double t_max, double t_edge_case_rate = 0.05);
+  EdgeCaseFuzzer(const std::seed_seq& t_seed, double t_min, double t_max,
+                 double t_edge_case_rate = 0.05);
+
+  double operator()();
+  template <std::size_t N>
+  std::array<double, N>& randomize(std::array<double, N>& t_values) {
+    for (auto& v : t_values) v = (*this)();
+    return t_values;
+  }
+
+  static const double* edge_cases();
+  static std::size_t edge_case_num();
+
+ private:
+  Fuzzer m_uniform;
+  double m_min;
+  double m_max;
+  double m_edge_case_rate;
+};
+
+// Number of samples for differential and property tests, which is
+// overwritten by environment variable HOLON_FUZZ_SAMPLES if it is set, e.g.
+//   HOLON_FUZZ_SAMPLES=10000000 ./humanoid_test "[differential]"
+std::size_t fuzz_sample_count(std::size_t t_default);
+
+template <std::size_t N>
+std::string to_string(const std::array<double, N>& t_values) {
+  std::ostringstream ss;
+  ss.precision(17);
+  ss << "(";
+  for (std::size_t i = 0; i < N; ++i)
+    ss << (i == 0 ? " " : ", ") << t_values[i];
+  ss << " )";
+  return ss.str();
+}
+
+template <std::size_t N>
+struct DifferentialResult {
+  UlpStats ulp;
+  std::array<double, N> worst_input;
+};
+
+// Run a reference and a candidate implementation side by side on N
+// generated arguments and accumulate ULP errors of the candidate. The
+// result of the reference is rounded to the type of the candidate.
+template <std::size_t N, typename Reference, typename Candidate>
+DifferentialResult<N> compareUlp(EdgeCaseFuzzer& t_fuzz, std::size_t t_n,
+                                 Reference t_reference, Candidate t_candidate) {
+  DifferentialResult<N> result;
+  std::array<double, N> x;
+  result.worst_input.fill(0);
+  for (std::size_t i = 0; i < t_n; ++i) {
+    t_fuzz.randomize(x);
+    auto c = t_candidate(x);
+    auto ulp = ulp_distance(static_cast<decltype(c)>(t_reference(x)), c);
+    if (i == 0 || ulp > result.ulp.max() ||
+        (ulp == kNanMismatch && result.ulp.nan_mismatch_count() == 0))
+      result.worst_input = x;
+    result.ulp.add(ulp);
+  }
+  return result;
+}
+
+// Check if a property holds on N generated arguments, and report the first
+// counterexample on failure.
+template <std::size_t N, typename Property>
+void checkProperty(EdgeCaseFuzzer& t_fuzz, std::size_t t_n,
+                   Property t_property) {
+  std::array<double, N> x;
+  for (std::size_t i = 0; i < t_n; ++i) {
+    t_fuzz.randomize(x);
+    if (!t_property(x)) FAIL("property does not hold for " << to_string(x));
+  }
+  SUCCEED("property holds for " << t_n << " samples");
+}
+
+}  // namespace holon
+
+#endif  // HOLON_TEST_UTIL_DIFFERENTIAL_DIFFERENTIAL_HPP_
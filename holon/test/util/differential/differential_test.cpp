@@ -0,0 +1,91 @@
+/* differential - differential and property testing of numerical kernels
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/differential/differential.hpp"
+
+#include <cmath>
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("EdgeCaseFuzzer mixes edge cases into uniform values",
+          "[test][util][differential]") {
+  EdgeCaseFuzzer fuzz(-1, 1, 0.5);
+  std::size_t n_edge = 0, n_nan = 0;
+  for (auto i = 0; i < 1000; ++i) {
+    double v = fuzz();
+    if (std::isnan(v)) ++n_nan;
+    if (std::isnan(v) || std::fabs(v) > 1 || v == 0) ++n_edge;
+  }
+  CHECK(n_edge > 0);
+  CHECK(n_nan > 0);
+  CHECK(n_edge < 1000);
+}
+
+TEST_CASE("EdgeCaseFuzzer outputs same values with a specific seed",
+          "[test][util][differential]") {
+  std::seed_seq seed{0};
+  EdgeCaseFuzzer fuzz1(seed, -1, 1), fuzz2(seed, -1, 1);
+  for (auto i = 0; i < 100; ++i) REQUIRE(ulp_distance(fuzz1(), fuzz2()) == 0);
+}
+
+TEST_CASE("compareUlp reports ULP errors of candidate implementation",
+          "[test][util][differential]") {
+  EdgeCaseFuzzer fuzz(-10, 10, 0);
+  SECTION("identical implementations") {
+    auto res = compareUlp<2>(
+        fuzz, 1000, [](const std::array<double, 2>& x) { return x[0] * x[1]; },
+        [](const std::array<double, 2>& x) { return x[1] * x[0]; });
+    CHECK(res.ulp.count() == 1000);
+    CHECK(res.ulp.max() == 0);
+  }
+  SECTION("candidate in single precision") {
+    auto res = compareUlp<1>(
+        fuzz, 1000,
+        [](const std::array<double, 1>& x) {
+          return std::sqrt(double(float(x[0])));
+        },
+        [](const std::array<double, 1>& x) {
+          return std::sqrt(float(x[0]));
+        });
+    CHECK(res.ulp.nan_mismatch_count() == 0);
+    CHECK(res.ulp.max() == 0);
+  }
+  SECTION("inaccurate candidate") {
+    auto res = compareUlp<1>(
+        fuzz, 1000, [](const std::array<double, 1>& x) { return x[0]; },
+        [](const std::array<double, 1>& x) { return x[0] * (1 + 1e-10); });
+    CHECK(res.ulp.max() > 0);
+    CHECK(res.ulp.max() == ulp_distance(res.worst_input[0],
+                                        res.worst_input[0] * (1 + 1e-10)));
+  }
+}
+
+TEST_CASE("checkProperty checks property on generated arguments",
+          "[test][util][differential]") {
+  EdgeCaseFuzzer fuzz(-10, 10);
+  checkProperty<2>(fuzz, 1000, [](const std::array<double, 2>& x) {
+    return ulp_distance(x[0] + x[1], x[1] + x[0]) == 0;
+  });
+}
+
+}  // namespace
+}  // namespace holon
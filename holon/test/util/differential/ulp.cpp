@@ -0,0 +1,119 @@
+/* ulp - distance between floating-point numbers in units in the last place
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/differential/ulp.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <type_traits>
+
+namespace holon {
+
+namespace {
+
+// map the bit pattern to integers monotonically increasing with the value
+template <typename Int, typename Float>
+Int ordered(Float t_v) {
+  static_assert(sizeof(Int) == sizeof(Float), "size mismatch");
+  Int i;
+  std::memcpy(&i, &t_v, sizeof(Float));
+  return i < 0 ? std::numeric_limits<Int>::min() - i : i;
+}
+
+template <typename Int, typename Float>
+std::uint64_t distance(Float t_a, Float t_b) {
+  if (std::isnan(t_a) || std::isnan(t_b))
+    return std::isnan(t_a) && std::isnan(t_b) ? 0 : kNanMismatch;
+  Int a = ordered<Int>(t_a);
+  Int b = ordered<Int>(t_b);
+  // subtract in two's complement to avoid overflow
+  using UInt = typename std::make_unsigned<Int>::type;
+  return a > b ? UInt(UInt(a) - UInt(b)) : UInt(UInt(b) - UInt(a));
+}
+
+std::size_t bit_width(std::uint64_t t_v) {
+  std::size_t n = 0;
+  for (; t_v != 0; t_v >>= 1) ++n;
+  return n;
+}
+
+}  // namespace
+
+std::uint64_t ulp_distance(double t_a, double t_b) {
+  return distance<std::int64_t>(t_a, t_b);
+}
+
+std::uint64_t ulp_distance(float t_a, float t_b) {
+  return distance<std::int32_t>(t_a, t_b);
+}
+
+constexpr std::size_t UlpStats::kBucketNum;
+
+UlpStats::UlpStats() : m_count(0), m_nan_mismatch(0), m_max(0), m_bucket() {}
+
+void UlpStats::add(std::uint64_t t_ulp) {
+  ++m_count;
+  if (t_ulp == kNanMismatch) {
+    ++m_nan_mismatch;
+    return;
+  }
+  if (t_ulp > m_max) m_max = t_ulp;
+  ++m_bucket[bit_width(t_ulp)];
+}
+
+UlpStats& UlpStats::merge(const UlpStats& t_stats) {
+  m_count += t_stats.m_count;
+  m_nan_mismatch += t_stats.m_nan_mismatch;
+  if (t_stats.m_max > m_max) m_max = t_stats.m_max;
+  for (std::size_t i = 0; i < kBucketNum; ++i)
+    m_bucket[i] += t_stats.m_bucket[i];
+  return *this;
+}
+
+std::uint64_t UlpStats::percentile(double t_ratio) const {
+  std::size_t n = m_count - m_nan_mismatch;
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i < kBucketNum; ++i) {
+    sum += m_bucket[i];
+    if (sum < t_ratio * n) continue;
+    if (i == 0) return 0;
+    return std::min(m_max, (std::uint64_t(1) << (i - 1)) * 2 - 1);
+  }
+  return m_max;
+}
+
+std::ostream& operator<<(std::ostream& os, const UlpStats& t_stats) {
+  os << "ULP error of " << t_stats.count() << " samples (max "
+     << t_stats.max() << ", NaN mismatch " << t_stats.nan_mismatch_count()
+     << ")\n";
+  for (std::size_t i = 0; i < UlpStats::kBucketNum; ++i) {
+    if (t_stats.bucket(i) == 0) continue;
+    std::uint64_t lower = i == 0 ? 0 : std::uint64_t(1) << (i - 1);
+    std::uint64_t upper = i == 0 ? 0 : lower * 2 - 1;
+    os << "  " << std::setw(10) << lower << " - " << std::setw(10) << upper;
+    os << " : " << std::setw(10) << t_stats.bucket(i) << " ("
+       << 100.0 * t_stats.bucket(i) / t_stats.count() << "%)\n";
+  }
+  return os;
+}
+
+}  // namespace holon
@@ -0,0 +1,72 @@
+/* ulp - distance between floating-point numbers in units in the last place
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLON_TEST_UTIL_DIFFERENTIAL_ULP_HPP_
+#define HOLON_TEST_UTIL_DIFFERENTIAL_ULP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+namespace holon {
+
+// Distance between two floating-point numbers in units in the last place,
+// i.e. the number of representable values between them. Positive and
+// negative zeros are identical, two NaNs are regarded as equal, and NaN and
+// a number are at the maximum distance kNanMismatch.
+constexpr std::uint64_t kNanMismatch = std::numeric_limits<std::uint64_t>::max();
+std::uint64_t ulp_distance(double t_a, double t_b);
+std::uint64_t ulp_distance(float t_a, float t_b);
+
+// Distribution of ULP errors. Errors are accumulated in buckets of powers
+// of two, i.e. 0, 1, 2-3, 4-7, ..., and NaN mismatches separately.
+class UlpStats {
+ public:
+  static constexpr std::size_t kBucketNum = 65;
+
+ public:
+  UlpStats();
+
+  void add(std::uint64_t t_ulp);
+  UlpStats& merge(const UlpStats& t_stats);
+
+  // accessors
+  std::size_t count() const noexcept { return m_count; }
+  std::size_t nan_mismatch_count() const noexcept { return m_nan_mismatch; }
+  std::uint64_t max() const noexcept { return m_max; }
+  std::size_t bucket(std::size_t t_index) const { return m_bucket[t_index]; }
+
+  // upper bound of the errors of the given ratio of samples (NaN mismatches
+  // are excluded), rounded up to the bucket boundary
+  std::uint64_t percentile(double t_ratio) const;
+
+ private:
+  std::size_t m_count;
+  std::size_t m_nan_mismatch;
+  std::uint64_t m_max;
+  std::size_t m_bucket[kBucketNum];
+};
+
+std::ostream& operator<<(std::ostream& os, const UlpStats& t_stats);
+
+}  // namespace holon
+
+#endif  // HOLON_TEST_UTIL_DIFFERENTIAL_ULP_HPP_
@@ -0,0 +1,91 @@
+/* ulp - distance between floating-point numbers in units in the last place
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holon/test/util/differential/ulp.hpp"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include "catch.hpp"
+
+namespace holon {
+namespace {
+
+TEST_CASE("ulp_distance counts representable numbers in between",
+          "[test][util][ulp]") {
+  SECTION("double") {
+    double x = 1.0;
+    CHECK(ulp_distance(x, x) == 0);
+    CHECK(ulp_distance(x, std::nextafter(x, 2.0)) == 1);
+    CHECK(ulp_distance(std::nextafter(x, 2.0), x) == 1);
+    CHECK(ulp_distance(x, std::nextafter(std::nextafter(x, 0.0), 0.0)) == 2);
+  }
+  SECTION("float") {
+    float x = 1.0f;
+    CHECK(ulp_distance(x, x) == 0);
+    CHECK(ulp_distance(x, std::nextafter(x, 2.0f)) == 1);
+    CHECK(ulp_distance(x, std::nextafter(x, 0.0f)) == 1);
+  }
+  SECTION("across zero") {
+    double tiny = std::numeric_limits<double>::denorm_min();
+    CHECK(ulp_distance(0.0, -0.0) == 0);
+    CHECK(ulp_distance(tiny, -tiny) == 2);
+    CHECK(ulp_distance(-1.0, 1.0) == 2 * ulp_distance(0.0, 1.0));
+  }
+  SECTION("infinity and NaN") {
+    double inf = std::numeric_limits<double>::infinity();
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    CHECK(ulp_distance(std::numeric_limits<double>::max(), inf) == 1);
+    CHECK(ulp_distance(nan, nan) == 0);
+    CHECK(ulp_distance(nan, 1.0) == kNanMismatch);
+    CHECK(ulp_distance(inf, nan) == kNanMismatch);
+  }
+}
+
+TEST_CASE("UlpStats accumulates distribution of ULP errors",
+          "[test][util][ulp]") {
+  UlpStats stats;
+  for (auto ulp : {0, 0, 0, 0, 0, 0, 1, 1, 3, 100}) stats.add(ulp);
+  stats.add(kNanMismatch);
+  CHECK(stats.count() == 11);
+  CHECK(stats.nan_mismatch_count() == 1);
+  CHECK(stats.max() == 100);
+  CHECK(stats.bucket(0) == 6);
+  CHECK(stats.bucket(1) == 2);
+  CHECK(stats.bucket(2) == 1);
+  CHECK(stats.bucket(7) == 1);
+  CHECK(stats.percentile(0.5) == 0);
+  CHECK(stats.percentile(0.8) == 1);
+  CHECK(stats.percentile(0.9) == 3);
+  CHECK(stats.percentile(1.0) == 100);
+
+  UlpStats other;
+  other.add(1000);
+  stats.merge(other);
+  CHECK(stats.count() == 12);
+  CHECK(stats.max() == 1000);
+
+  std::ostringstream ss;
+  ss << stats;
+  CHECK(ss.str().find("max 1000") != std::string::npos);
+}
+
+}  // namespace
+}  // namespace holon
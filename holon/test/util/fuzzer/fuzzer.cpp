@@ -20,29 +20,50 @@
 
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
-#include <limits>
+#include <vector>
 
 namespace holon {
 
-Fuzzer::Fuzzer()
-    : m_rd(),
-      m_seed({m_rd(), m_rd(), m_rd(), m_rd(), m_rd()}),
-      m_engine(m_seed),
-      m_distribution(default_min, default_max) {}
+namespace {
+
+std::uint64_t random_seed() {
+  std::random_device rd;
+  return (std::uint64_t(rd()) << 32) | rd();
+}
+
+// std::seed_seq is neither copyable nor usable as const to generate seeds,
+// so that a new one is built from its parameters.
+std::uint64_t make_seed(const std::seed_seq& t_seed) {
+  std::vector<std::uint32_t> params(t_seed.size());
+  t_seed.param(params.begin());
+  std::seed_seq seed(params.begin(), params.end());
+  std::uint32_t words[2];
+  seed.generate(words, words + 2);
+  return (std::uint64_t(words[1]) << 32) | words[0];
+}
+
+}  // namespace
+
+constexpr double Fuzzer::default_min;
+constexpr double Fuzzer::default_max;
+
+Fuzzer::Fuzzer() : Fuzzer(default_min, default_max) {}
 
 Fuzzer::Fuzzer(double t_min, double t_max)
-    : m_rd(),
-      m_seed({m_rd(), m_rd(), m_rd(), m_rd(), m_rd()}),
-      m_engine(m_seed),
-      m_distribution(t_min, t_max) {}
+    : Fuzzer(t_min, t_max, Philox4x32(random_seed())) {}
 
 Fuzzer::Fuzzer(const std::seed_seq& t_seed)
-    : m_seed(t_seed),
-      m_engine(m_seed),
-      m_distribution(default_min, default_max) {}
+    : Fuzzer(t_seed, default_min, default_max) {}
 
 Fuzzer::Fuzzer(const std::seed_seq& t_seed, double t_min, double t_max)
-    : m_seed(t_seed), m_engine(m_seed), m_distribution(t_min, t_max) {}
+    : Fuzzer(t_min, t_max, Philox4x32(make_seed(t_seed))) {}
+
+Fuzzer::Fuzzer(double t_min, double t_max, const Philox4x32& t_engine)
+    : m_engine(t_engine), m_min(t_min), m_max(t_max) {}
+
+Fuzzer Fuzzer::substream(std::uint64_t t_id) const {
+  return Fuzzer(m_min, m_max, m_engine.substream(t_id));
+}
 
 zVec3D Fuzzer::randomize(zVec3D& v) {
   zVec3DCreate(&v, get(), get(), get());
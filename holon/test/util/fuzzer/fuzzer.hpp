@@ -22,14 +22,19 @@
 #define HOLON_TEST_UTIL_FUZZER_FUZZER_HPP_
 
 #include <zeo/zeo_vec3d.h>
+#include <cstdint>
 #include <random>
+#include "holon/corelib/math/philox.hpp"
 #include "holon/corelib/math/vec3d.hpp"
 
 namespace holon {
 
+// Fuzzer draws uniform random values from a counter-based generator, so
+// that it is cheap to construct and splits into independent substreams
+// for parallel runs.
 class Fuzzer {
-  const double default_min = -10;
-  const double default_max = 10;
+  static constexpr double default_min = -10;
+  static constexpr double default_max = 10;
 
  public:
   // constructors
@@ -39,14 +44,19 @@ class Fuzzer {
   Fuzzer(const std::seed_seq& t_seed, double t_min, double t_max);
 
   // special member functions
+  // (copying is not allowed not to duplicate random values accidentally)
   virtual ~Fuzzer() = default;
   Fuzzer(const Fuzzer&) = delete;
-  Fuzzer(Fuzzer&&) = delete;
+  Fuzzer(Fuzzer&&) = default;
   Fuzzer& operator=(const Fuzzer&) = delete;
-  Fuzzer& operator=(Fuzzer&&) = delete;
+  Fuzzer& operator=(Fuzzer&&) = default;
+
+  // independent fuzzer sharing the seed and the range
+  Fuzzer substream(std::uint64_t t_id) const;
+  const Philox4x32& engine() const noexcept { return m_engine; }
 
   // functions
-  double operator()() { return m_distribution(m_engine); }
+  double operator()() { return m_min + (m_max - m_min) * m_engine.uniform(); }
   template <typename T = double>
   T get() {
     return T((*this)());
@@ -55,10 +65,11 @@ class Fuzzer {
   Vec3D randomize(Vec3D& v);
 
  private:
-  std::random_device m_rd;
-  std::seed_seq m_seed;
-  std::mt19937 m_engine;
-  std::uniform_real_distribution<double> m_distribution;
+  Fuzzer(double t_min, double t_max, const Philox4x32& t_engine);
+
+  Philox4x32 m_engine;
+  double m_min;
+  double m_max;
 };
 
 template <>
@@ -20,6 +20,7 @@
 
 #include "holon/test/util/fuzzer/fuzzer.hpp"
 
+#include <utility>
 #include <vector>
 #include "catch.hpp"
 #include "holon/test/util/catch/custom_matchers.hpp"
@@ -77,6 +78,30 @@ TEST_CASE("make uniform distribution with a specific seed",
   }
 }
 
+TEST_CASE("substreams of fuzzer are reproducible and independent",
+          "[test][util][fuzzer]") {
+  Fuzzer fuzz({1}, 0, 10);
+  Fuzzer sub1 = fuzz.substream(1);
+  Fuzzer sub1_ = fuzz.substream(1);
+  Fuzzer sub2 = fuzz.substream(2);
+  for (auto i = 0; i < 10; ++i) {
+    double v = sub1.get();
+    REQUIRE(v == sub1_.get());
+    REQUIRE(v != sub2.get());
+    REQUIRE(v >= 0);
+    REQUIRE(v < 10);
+  }
+}
+
+TEST_CASE("fuzzer can be moved", "[test][util][fuzzer]") {
+  Fuzzer fuzz1({2});
+  Fuzzer fuzz2({2});
+  fuzz1.get();
+  fuzz2.get();
+  Fuzzer moved(std::move(fuzz1));
+  CHECK(moved.get() == fuzz2.get());
+}
+
 TEST_CASE("calling by ()operator", "[test][util][fuzzer]") {
   Fuzzer fuzz;
   std::vector<double> outdated_values;
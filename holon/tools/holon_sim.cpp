@@ -0,0 +1,301 @@
+/* holon_sim - headless runner of COM controller scenarios
+ *
+ * Copyright (c) 2018 Hiroshi Atsuta <atsuta.hiroshi@gmail.com>
+ *
+ * This file is part of the holon.
+ *
+ * The holon is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The holon is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the holon.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "holon/corelib/humanoid/com_ctrl_scenario.hpp"
+
+using holon::ComCtrlScenario;
+using holon::ComCtrlScenarioReader;
+using holon::ComCtrlScenarioRunner;
+
+namespace {
+
+const char* const kUsage =
+    "usage: holon_sim [options] <scenario>\n"
+    "options:\n"
+    "  -o, --output <path>          write log to <path> ('-' for stdout)\n"
+    "                               '{}' is replaced with the index of run\n"
+    "  -b, --binary                 write log as raw native doubles\n"
+    "  -s, --set <tag.key=value>    overwrite a field of the scenario\n"
+    "  -w, --sweep <tag.key=v1,v2>  run for each value; sweeps make a grid\n"
+    "  -r, --repeat <n>             repeat every run n times, where the seed\n"
+    "                               of [random_push] is incremented\n"
+    "  -j, --jobs <n>               number of threads for multiple runs\n"
+    "  -p, --replay <time>          log only the rest of the run from the\n"
+    "                               last checkpoint before <time>\n"
+    "  -c, --checkpoint <n>         take a checkpoint every n steps for\n"
+    "                               --replay (default: 100)\n"
+    "A single run writes its log to stdout unless --output is given.\n"
+    "Multiple runs write logs only when --output is given, and print a\n"
+    "summary of each run to stdout.\n";
+
+struct Options {
+  std::string scenario;
+  std::string output;
+  bool binary = false;
+  std::vector<std::pair<std::string, std::string>> sets;
+  std::vector<std::pair<std::string, std::vector<std::string>>> sweeps;
+  unsigned long repeat = 1;
+  unsigned long jobs = 0;
+  bool replay = false;
+  double replay_time = 0;
+  unsigned long checkpoint_interval = 100;
+};
+
+struct Run {
+  std::vector<std::pair<std::string, std::string>> params;
+  ComCtrlScenario scenario;
+  std::string output;
+  bool succeeded = false;
+  std::size_t step_count = 0;
+  double max_com_error = 0;
+  holon::Vec3D com_position;
+  double elapsed = 0;
+};
+
+bool splitKeyValue(const std::string& t_arg, std::string* t_key,
+                   std::string* t_value) {
+  std::size_t eq = t_arg.find('=');
+  if (eq == std::string::npos) {
+    std::cerr << "field should be given as tag.key=value: " << t_arg << "\n";
+    return false;
+  }
+  *t_key = t_arg.substr(0, eq);
+  *t_value = t_arg.substr(eq + 1);
+  return true;
+}
+
+bool parseCount(const char* t_arg, unsigned long* t_count) {
+  char* end;
+  *t_count = std::strtoul(t_arg, &end, 10);
+  if (end == t_arg || *end != '\0') {
+    std::cerr << "invalid number: " << t_arg << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool parseTime(const char* t_arg, double* t_time) {
+  char* end;
+  *t_time = std::strtod(t_arg, &end);
+  if (end == t_arg || *end != '\0') {
+    std::cerr << "invalid time: " << t_arg << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options* t_opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    std::string key, value;
+    if (arg == "-h" || arg == "--help") {
+      std::cout << kUsage;
+      std::exit(EXIT_SUCCESS);
+    } else if (arg == "-b" || arg == "--binary") {
+      t_opts->binary = true;
+    } else if ((arg == "-o" || arg == "--output") && has_value) {
+      t_opts->output = argv[++i];
+    } else if ((arg == "-s" || arg == "--set") && has_value) {
+      if (!splitKeyValue(argv[++i], &key, &value)) return false;
+      t_opts->sets.emplace_back(key, value);
+    } else if ((arg == "-w" || arg == "--sweep") && has_value) {
+      if (!splitKeyValue(argv[++i], &key, &value)) return false;
+      std::vector<std::string> values;
+      std::istringstream iss(value);
+      while (std::getline(iss, value, ',')) values.push_back(value);
+      if (values.empty()) {
+        std::cerr << "no value to sweep: " << key << "\n";
+        return false;
+      }
+      t_opts->sweeps.emplace_back(key, values);
+    } else if ((arg == "-r" || arg == "--repeat") && has_value) {
+      if (!parseCount(argv[++i], &t_opts->repeat)) return false;
+    } else if ((arg == "-j" || arg == "--jobs") && has_value) {
+      if (!parseCount(argv[++i], &t_opts->jobs)) return false;
+    } else if ((arg == "-p" || arg == "--replay") && has_value) {
+      if (!parseTime(argv[++i], &t_opts->replay_time)) return false;
+      t_opts->replay = true;
+    } else if ((arg == "-c" || arg == "--checkpoint") && has_value) {
+      if (!parseCount(argv[++i], &t_opts->checkpoint_interval)) return false;
+    } else if (arg[0] != '-' && t_opts->scenario.empty()) {
+      t_opts->scenario = arg;
+    } else {
+      std::cerr << "invalid argument: " << arg << "\n";
+      return false;
+    }
+  }
+  if (t_opts->scenario.empty()) {
+    std::cerr << "no scenario is given\n";
+    return false;
+  }
+  return true;
+}
+
+std::string outputPath(const std::string& t_pattern, std::size_t t_index) {
+  std::string path = t_pattern;
+  std::size_t pos = path.find("{}");
+  if (pos != std::string::npos)
+    path.replace(pos, 2, std::to_string(t_index));
+  return path;
+}
+
+// make runs over the grid of sweeps, each of which is repeated
+bool makeRuns(const Options& t_opts, const ComCtrlScenarioReader& t_reader,
+              std::vector<Run>* t_runs) {
+  std::size_t grid_size = 1;
+  for (const auto& sweep : t_opts.sweeps) grid_size *= sweep.second.size();
+  t_runs->resize(grid_size * t_opts.repeat);
+
+  for (std::size_t i = 0; i < t_runs->size(); ++i) {
+    Run& run = (*t_runs)[i];
+    ComCtrlScenarioReader reader = t_reader;
+    std::size_t grid_index = i / t_opts.repeat;
+    for (auto it = t_opts.sweeps.rbegin(); it != t_opts.sweeps.rend(); ++it) {
+      run.params.emplace_back(it->first,
+                              it->second[grid_index % it->second.size()]);
+      grid_index /= it->second.size();
+    }
+    std::reverse(run.params.begin(), run.params.end());
+    for (const auto& param : run.params)
+      if (!reader.set(param.first, param.second)) return false;
+    if (!reader.build(&run.scenario)) return false;
+    if (t_opts.repeat > 1 && run.scenario.random_push) {
+      std::uint64_t seed = run.scenario.random_push->seed() + i % t_opts.repeat;
+      run.scenario.random_push->set_seed(seed);
+      run.params.emplace_back("random_push.seed", std::to_string(seed));
+    }
+    run.output = outputPath(t_opts.output, i);
+  }
+  return true;
+}
+
+void execute(Run* t_run, const Options& t_opts) {
+  bool binary = t_opts.binary;
+  auto format = binary ? ComCtrlScenarioRunner::LogFormat::binary
+                       : ComCtrlScenarioRunner::LogFormat::text;
+  std::ofstream ofs;
+  std::ostream* os = nullptr;
+  if (t_run->output == "-") {
+    os = &std::cout;
+  } else if (!t_run->output.empty()) {
+    ofs.open(t_run->output,
+             binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!ofs) {
+      std::cerr << "cannot open file: " << t_run->output << "\n";
+      return;
+    }
+    os = &ofs;
+  }
+
+  ComCtrlScenarioRunner runner(t_run->scenario);
+  auto start = std::chrono::steady_clock::now();
+  if (t_opts.replay) {
+    // run through once to take checkpoints, and log the replay only
+    runner.set_checkpoint_interval(t_opts.checkpoint_interval);
+    t_run->succeeded = runner.run() &&
+                       runner.set_log(os, format).replay(t_opts.replay_time);
+  } else {
+    runner.set_log(os, format);
+    t_run->succeeded = runner.run();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  t_run->elapsed = elapsed.count();
+  t_run->step_count = runner.step_count();
+  t_run->max_com_error = runner.max_com_error();
+  t_run->com_position = runner.states().com_position;
+}
+
+void printSummary(const std::vector<Run>& t_runs) {
+  std::cout << "% index [params] steps max_com_error com_position elapsed\n";
+  for (std::size_t i = 0; i < t_runs.size(); ++i) {
+    const Run& run = t_runs[i];
+    std::cout << i;
+    for (const auto& param : run.params)
+      std::cout << " " << param.first << "=" << param.second;
+    if (!run.succeeded) {
+      std::cout << " failed\n";
+      continue;
+    }
+    std::cout << " " << run.step_count << " " << run.max_com_error << " "
+              << run.com_position.data() << " " << run.elapsed << "\n";
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options opts;
+  if (!parseOptions(argc, argv, &opts)) {
+    std::cerr << kUsage;
+    return EXIT_FAILURE;
+  }
+
+  ComCtrlScenarioReader reader;
+  if (!reader.readFile(opts.scenario)) return EXIT_FAILURE;
+  for (const auto& set : opts.sets)
+    if (!reader.set(set.first, set.second)) return EXIT_FAILURE;
+
+  std::vector<Run> runs;
+  if (!makeRuns(opts, reader, &runs)) return EXIT_FAILURE;
+
+  // a single run logs to stdout by default
+  if (runs.size() == 1) {
+    if (opts.output.empty()) runs[0].output = "-";
+    execute(&runs[0], opts);
+    return runs[0].succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (!opts.output.empty() && opts.output.find("{}") == std::string::npos) {
+    std::cerr << "output of multiple runs should contain '{}': "
+              << opts.output << "\n";
+    return EXIT_FAILURE;
+  }
+
+  std::size_t jobs =
+      opts.jobs > 0 ? opts.jobs : std::thread::hardware_concurrency();
+  jobs = std::max<std::size_t>(1, std::min(jobs, runs.size()));
+  std::atomic<std::size_t> next(0);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < jobs; ++i) {
+    workers.emplace_back([&]() {
+      for (std::size_t k; (k = next++) < runs.size();)
+        execute(&runs[k], opts);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  printSummary(runs);
+  bool succeeded = std::all_of(runs.begin(), runs.end(),
+                               [](const Run& run) { return run.succeeded; });
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}